@@ -362,6 +362,7 @@ HEADERS += $$PWD/sourceCode/collections/collectionElement.h \
 HEADERS += $$PWD/sourceCode/backwardCompatibility/collisions/collisionObject_old.h \
     $$PWD/sourceCode/shared/backwardCompatibility/collisions/_collisionObject_old.h \
     $$PWD/sourceCode/collisions/collisionRoutines.h \
+    $$PWD/sourceCode/collisions/ikConfigValidator.h \
 
 HEADERS += $$PWD/sourceCode/backwardCompatibility/distances/distanceObject_old.h \
     $$PWD/sourceCode/shared/backwardCompatibility/distances/_distanceObject_old.h \
@@ -387,6 +388,7 @@ HEADERS += $$PWD/sourceCode/sceneObjects/jointObject.h \
     $$PWD/sourceCode/sceneObjects/shape.h \
     $$PWD/sourceCode/sceneObjects/path_old.h \
     $$PWD/sourceCode/sceneObjects/proximitySensor.h \
+    $$PWD/sourceCode/sceneObjects/proximitySensorObjectRelated/proxSensorBroadphase.h \
     $$PWD/sourceCode/sceneObjects/visionSensor.h \
 
 HEADERS += $$PWD/sourceCode/sceneObjects/graphObjectRelated/graphCurve.h \
@@ -402,6 +404,8 @@ HEADERS += $$PWD/sourceCode/sceneObjects/pathObjectRelated/bezierPathPoint_old.h
     $$PWD/sourceCode/sceneObjects/pathObjectRelated/pathCont_old.h \
 
 HEADERS += $$PWD/sourceCode/sceneObjects/shapeObjectRelated/mesh.h \
+    $$PWD/sourceCode/sceneObjects/shapeObjectRelated/meshCalcStructures.h \
+    $$PWD/sourceCode/sceneObjects/shapeObjectRelated/meshCalcStructureCache.h \
     $$PWD/sourceCode/sceneObjects/shapeObjectRelated/meshWrapper.h \
     $$PWD/sourceCode/sceneObjects/shapeObjectRelated/volInt.h \
 
@@ -410,6 +414,7 @@ HEADERS += $$PWD/sourceCode/backwardCompatibility/pathPlanning/pathPlanning_old.
     $$PWD/sourceCode/backwardCompatibility/pathPlanning/holonomicPathNode_old.h \
     $$PWD/sourceCode/backwardCompatibility/pathPlanning/nonHolonomicPathPlanning_old.h \
     $$PWD/sourceCode/backwardCompatibility/pathPlanning/nonHolonomicPathNode_old.h \
+    $$PWD/sourceCode/backwardCompatibility/pathPlanning/nearestNodeIndex_old.h \
 
 HEADERS += $$PWD/sourceCode/communication/tubes/commTube.h \
 
@@ -427,6 +432,7 @@ HEADERS += $$PWD/sourceCode/mainContainers/sceneContainers/drawingContainer.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/textureContainer.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/signalContainer.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/simulation.h \
+    $$PWD/sourceCode/mainContainers/sceneContainers/realTimeScheduler.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/registeredPathPlanningTasks.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/ikGroupContainer.h \
     $$PWD/sourceCode/shared/mainContainers/sceneContainers/_ikGroupContainer_.h \
@@ -448,6 +454,7 @@ HEADERS += $$PWD/sourceCode/mainContainers/sceneContainers/drawingContainer.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/cacheCont.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/customData.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/ghostObjectContainer.h \
+    $$PWD/sourceCode/mainContainers/sceneContainers/ghostTimeIndex.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/pointCloudContainer_old.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/buttonBlockContainer.h \
     $$PWD/sourceCode/mainContainers/sceneContainers/undoBufferCont.h \
@@ -461,6 +468,8 @@ HEADERS += $$PWD/sourceCode/mainContainers/applicationContainers/copyBuffer.h \
 
 HEADERS += $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/simpleFilter.h \
     $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/composedFilter.h \
+    $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/visionSensorRayCaster.h \
+    $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/imageKernels.h \
 
 HEADERS += $$PWD/sourceCode/pathPlanning_old/pathPlanningTask_old.h \
 
@@ -486,6 +495,7 @@ HEADERS += $$PWD/sourceCode/textures/textureObject.h \
 HEADERS += $$PWD/sourceCode/serialization/ser.h \
     $$PWD/sourceCode/serialization/extIkSer.h \
     $$PWD/sourceCode/serialization/huffman.h \
+    $$PWD/sourceCode/serialization/sceneFileWriter.h \
     $$PWD/sourceCode/serialization/tinyxml2.cpp \
 
 HEADERS += $$PWD/sourceCode/strings/simStringTable.h \
@@ -577,6 +587,8 @@ HEADERS += $$PWD/sourceCode/displ/colorObject.h \
     $$PWD/sourceCode/shared/displ/_colorObject_.h \
 
 HEADERS += $$PWD/sourceCode/utils/threadPool.h \
+    $$PWD/sourceCode/utils/benchmarks.h \
+    $$PWD/sourceCode/utils/workerPool.h \
     $$PWD/sourceCode/utils/tt.h \
     $$PWD/sourceCode/utils/ttUtil.h \
     $$PWD/sourceCode/utils/confReaderAndWriter.h \
@@ -604,7 +616,8 @@ WITH_SERIAL {
 WITH_OPENGL {
     HEADERS += $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/offscreenGlContext.h \
         $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/frameBufferObject.h \
-        $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/visionSensorGlStuff.h
+        $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/visionSensorGlStuff.h \
+        $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/visionSensorReadback.h
 
     HEADERS += $$PWD/sourceCode/visual/oGL.h \
         $$PWD/sourceCode/visual/oglExt.h \
@@ -791,6 +804,7 @@ SOURCES += $$PWD/sourceCode/collections/collectionElement.cpp \
 SOURCES += $$PWD/sourceCode/backwardCompatibility/collisions/collisionObject_old.cpp \
     $$PWD/sourceCode/shared/backwardCompatibility/collisions/_collisionObject_old.cpp \
     $$PWD/sourceCode/collisions/collisionRoutines.cpp \
+    $$PWD/sourceCode/collisions/ikConfigValidator.cpp \
 
 SOURCES += $$PWD/sourceCode/backwardCompatibility/distances/distanceObject_old.cpp \
     $$PWD/sourceCode/shared/backwardCompatibility/distances/_distanceObject_old.cpp \
@@ -831,8 +845,11 @@ SOURCES += $$PWD/sourceCode/sceneObjects/pathObjectRelated/bezierPathPoint_old.c
     $$PWD/sourceCode/sceneObjects/pathObjectRelated/pathCont_old.cpp \
 
 SOURCES += $$PWD/sourceCode/sceneObjects/proximitySensorObjectRelated/proxSensorRoutine.cpp \
+    $$PWD/sourceCode/sceneObjects/proximitySensorObjectRelated/proxSensorBroadphase.cpp \
 
 SOURCES += $$PWD/sourceCode/sceneObjects/shapeObjectRelated/mesh.cpp \
+    $$PWD/sourceCode/sceneObjects/shapeObjectRelated/meshCalcStructures.cpp \
+    $$PWD/sourceCode/sceneObjects/shapeObjectRelated/meshCalcStructureCache.cpp \
     $$PWD/sourceCode/sceneObjects/shapeObjectRelated/meshWrapper.cpp \
     $$PWD/sourceCode/sceneObjects/shapeObjectRelated/volInt.cpp \
 
@@ -842,6 +859,7 @@ SOURCES += $$PWD/sourceCode/backwardCompatibility/pathPlanning/pathPlanning_old.
     $$PWD/sourceCode/backwardCompatibility/pathPlanning/holonomicPathNode_old.cpp \
     $$PWD/sourceCode/backwardCompatibility/pathPlanning/nonHolonomicPathPlanning_old.cpp \
     $$PWD/sourceCode/backwardCompatibility/pathPlanning/nonHolonomicPathNode_old.cpp \
+    $$PWD/sourceCode/backwardCompatibility/pathPlanning/nearestNodeIndex_old.cpp \
 
 SOURCES += $$PWD/sourceCode/communication/tubes/commTube.cpp \
 
@@ -858,6 +876,7 @@ SOURCES += $$PWD/sourceCode/mainContainers/sceneContainers/bannerContainer.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/drawingContainer.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/textureContainer.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/simulation.cpp \
+    $$PWD/sourceCode/mainContainers/sceneContainers/realTimeScheduler.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/signalContainer.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/registeredPathPlanningTasks.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/ikGroupContainer.cpp \
@@ -880,6 +899,7 @@ SOURCES += $$PWD/sourceCode/mainContainers/sceneContainers/bannerContainer.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/cacheCont.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/apiErrors.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/ghostObjectContainer.cpp \
+    $$PWD/sourceCode/mainContainers/sceneContainers/ghostTimeIndex.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/pointCloudContainer_old.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/buttonBlockContainer.cpp \
     $$PWD/sourceCode/mainContainers/sceneContainers/undoBufferCont.cpp \
@@ -893,6 +913,8 @@ SOURCES += $$PWD/sourceCode/mainContainers/applicationContainers/copyBuffer.cpp
 
 SOURCES += $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/simpleFilter.cpp \
     $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/composedFilter.cpp \
+    $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/visionSensorRayCaster.cpp \
+    $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/imageKernels.cpp \
 
 SOURCES += $$PWD/sourceCode/pathPlanning_old/pathPlanningTask_old.cpp \
 
@@ -916,6 +938,7 @@ SOURCES += $$PWD/sourceCode/textures/textureObject.cpp \
     $$PWD/sourceCode/textures/textureProperty.cpp \
 
 SOURCES += $$PWD/sourceCode/serialization/ser.cpp \
+    $$PWD/sourceCode/serialization/sceneFileWriter.cpp \
     $$PWD/sourceCode/serialization/extIkSer.cpp \
     $$PWD/sourceCode/serialization/huffman.c \
     $$PWD/sourceCode/serialization/tinyxml2.cpp \
@@ -1004,6 +1027,8 @@ SOURCES += $$PWD/sourceCode/displ/colorObject.cpp \
 SOURCES += $$PWD/sourceCode/visual/thumbnail.cpp \
 
 SOURCES += $$PWD/sourceCode/utils/threadPool.cpp \
+    $$PWD/sourceCode/utils/benchmarks.cpp \
+    $$PWD/sourceCode/utils/workerPool.cpp \
     $$PWD/sourceCode/utils/ttUtil.cpp \
     $$PWD/sourceCode/utils/tt.cpp \
     $$PWD/sourceCode/utils/confReaderAndWriter.cpp \
@@ -1032,6 +1057,7 @@ WITH_OPENGL {
     SOURCES += $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/offscreenGlContext.cpp \
         $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/frameBufferObject.cpp \
         $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/visionSensorGlStuff.cpp \
+        $$PWD/sourceCode/sceneObjects/visionSensorObjectRelated/visionSensorReadback.cpp \
 
     SOURCES += $$PWD/sourceCode/visual/oGL.cpp \
         $$PWD/sourceCode/visual/oglExt.cpp \
@@ -61,6 +61,7 @@ CHolonomicPathPlanning_old::CHolonomicPathPlanning_old(int theStartDummyID,int t
 
     angularCoeff=theAngularCoeff;
     stepSize=theStepSize;
+    _setUpNodeIndexes();
     _directionConstraintsOn=false;
 
     for (int i=0;i<4;i++)
@@ -92,6 +93,7 @@ CHolonomicPathPlanning_old::~CHolonomicPathPlanning_old()
 void CHolonomicPathPlanning_old::setAngularCoefficient(float coeff)
 {
     angularCoeff=coeff;
+    _setNodeIndexWeights();
 }
 
 void CHolonomicPathPlanning_old::setStepSize(float size)
@@ -99,6 +101,53 @@ void CHolonomicPathPlanning_old::setStepSize(float size)
     stepSize=size;
 }
 
+void CHolonomicPathPlanning_old::_setUpNodeIndexes()
+{ // the nodes are indexed by their position and planar angle values, i.e. their first values. Orientations from quaternions are not indexed
+    int dimCnt=0;
+    bool angular[NEAREST_NODE_INDEX_MAX_DIM]={false,false,false,false};
+    if (planningType==sim_holonomicpathplanning_xy)
+        dimCnt=2;
+    if (planningType==sim_holonomicpathplanning_xg)
+    {
+        dimCnt=2;
+        angular[1]=true;
+    }
+    if (planningType==sim_holonomicpathplanning_xyz)
+        dimCnt=3;
+    if (planningType==sim_holonomicpathplanning_xyg)
+    {
+        dimCnt=3;
+        angular[2]=true;
+    }
+    if (planningType==sim_holonomicpathplanning_xyzg)
+    {
+        dimCnt=4;
+        angular[3]=true;
+    }
+    if (planningType==sim_holonomicpathplanning_xabg)
+        dimCnt=1;
+    if (planningType==sim_holonomicpathplanning_xyabg)
+        dimCnt=2;
+    if (planningType==sim_holonomicpathplanning_xyzabg)
+        dimCnt=3;
+    _fromStartIndex.setDimensions(dimCnt,angular);
+    _fromGoalIndex.setDimensions(dimCnt,angular);
+    _setNodeIndexWeights();
+}
+
+void CHolonomicPathPlanning_old::_setNodeIndexWeights()
+{ // same metric as in _getNodeDistance
+    float weights[NEAREST_NODE_INDEX_MAX_DIM]={1.0f,1.0f,1.0f,1.0f};
+    if (planningType==sim_holonomicpathplanning_xg)
+        weights[1]=angularCoeff*angularCoeff;
+    if (planningType==sim_holonomicpathplanning_xyg)
+        weights[2]=angularCoeff*angularCoeff;
+    if (planningType==sim_holonomicpathplanning_xyzg)
+        weights[3]=angularCoeff*angularCoeff;
+    _fromStartIndex.setWeights(weights);
+    _fromGoalIndex.setWeights(weights);
+}
+
 void CHolonomicPathPlanning_old::getSearchTreeData(std::vector<float>& data,bool fromTheStart)
 {
     std::vector<CHolonomicPathNode_old*>* cont;
@@ -278,220 +327,197 @@ bool CHolonomicPathPlanning_old::setPartialPath()
 
 CHolonomicPathNode_old* CHolonomicPathPlanning_old::getClosestNode(std::vector<CHolonomicPathNode_old*>& nodes,CHolonomicPathNode_old* sample)
 {
+    CNearestNodeIndex_old* nodeIndex=_getNodeIndex(nodes);
+    if (nodeIndex!=nullptr)
+    {
+        int closest=nodeIndex->getClosestPoint(sample->values,[&](int i)->float { return(_getNodeDistance(nodes[i],sample)); });
+        if (closest!=-1)
+            return(nodes[closest]);
+        return(nullptr);
+    }
     float minD=SIM_MAX_FLOAT;
     int index=-1;
+    for (int i=0;i<int(nodes.size());i++)
+    {
+        float d=_getNodeDistance(nodes[i],sample);
+        if (d<minD)
+        {
+            minD=d;
+            index=i;
+        }
+    }
+    if (index!=-1)
+        return(nodes[index]);
+    return(nullptr);
+}
+
+CNearestNodeIndex_old* CHolonomicPathPlanning_old::_getNodeIndex(std::vector<CHolonomicPathNode_old*>& nodes)
+{ // the search trees only grow: nodes added since the last query are added to the index here
+    CNearestNodeIndex_old* index=nullptr;
+    if (&nodes==&fromStart)
+        index=&_fromStartIndex;
+    if (&nodes==&fromGoal)
+        index=&_fromGoalIndex;
+    if (index!=nullptr)
+    {
+        if (index->getPointCount()>int(nodes.size()))
+            index->clear();
+        for (int i=index->getPointCount();i<int(nodes.size());i++)
+            index->addPoint(nodes[i]->values);
+    }
+    return(index);
+}
+
+float CHolonomicPathPlanning_old::_getNodeDistance(CHolonomicPathNode_old* node,CHolonomicPathNode_old* sample)
+{ // squared distance, SIM_MAX_FLOAT if the direction constraints are not respected
     if (planningType==sim_holonomicpathplanning_xy)
     {
-        for (int i=0;i<int(nodes.size());i++)
+        float vect[2];
+        vect[0]=sample->values[0]-node->values[0];
+        vect[1]=sample->values[1]-node->values[1];
+        if (areDirectionConstraintsRespected(vect))
         {
-            float vect[2];
-            vect[0]=sample->values[0]-nodes[i]->values[0];
-            vect[1]=sample->values[1]-nodes[i]->values[1];
-            if (areDirectionConstraintsRespected(vect))
-            {
-                float d=vect[0]*vect[0]+vect[1]*vect[1];
-                if (d<minD)
-                {
-                    minD=d;
-                    index=i;
-                }
-            }
+            float d=vect[0]*vect[0]+vect[1]*vect[1];
+            return(d);
         }
     }
     else if (planningType==sim_holonomicpathplanning_xg)
     {
-        for (int i=0;i<int(nodes.size());i++)
+        float vect[2];
+        vect[0]=sample->values[0]-node->values[0];
+        vect[1]=CPathPlanningInterface::getNormalizedAngle(sample->values[1]-node->values[1]);
+        if (areDirectionConstraintsRespected(vect))
         {
-            float vect[2];
-            vect[0]=sample->values[0]-nodes[i]->values[0];
-            vect[1]=CPathPlanningInterface::getNormalizedAngle(sample->values[1]-nodes[i]->values[1]);
-            if (areDirectionConstraintsRespected(vect))
-            {
-                vect[1]*=angularCoeff;
-                float d=vect[0]*vect[0]+vect[1]*vect[1];
-                if (d<minD)
-                {
-                    minD=d;
-                    index=i;
-                }
-            }
+            vect[1]*=angularCoeff;
+            float d=vect[0]*vect[0]+vect[1]*vect[1];
+            return(d);
         }
     }
     else if (planningType==sim_holonomicpathplanning_xyz)
     {
-        for (int i=0;i<int(nodes.size());i++)
+        float vect[3];
+        vect[0]=sample->values[0]-node->values[0];
+        vect[1]=sample->values[1]-node->values[1];
+        vect[2]=sample->values[2]-node->values[2];
+        if (areDirectionConstraintsRespected(vect))
         {
-            float vect[3];
-            vect[0]=sample->values[0]-nodes[i]->values[0];
-            vect[1]=sample->values[1]-nodes[i]->values[1];
-            vect[2]=sample->values[2]-nodes[i]->values[2];
-            if (areDirectionConstraintsRespected(vect))
-            {
-                float d=vect[0]*vect[0]+vect[1]*vect[1]+vect[2]*vect[2];
-                if (d<minD)
-                {
-                    minD=d;
-                    index=i;
-                }
-            }
+            float d=vect[0]*vect[0]+vect[1]*vect[1]+vect[2]*vect[2];
+            return(d);
         }
     }
     else if (planningType==sim_holonomicpathplanning_xyg)
     {
-        for (int i=0;i<int(nodes.size());i++)
+        float vect[3];
+        vect[0]=sample->values[0]-node->values[0];
+        vect[1]=sample->values[1]-node->values[1];
+        vect[2]=CPathPlanningInterface::getNormalizedAngle(sample->values[2]-node->values[2]);
+        if (areDirectionConstraintsRespected(vect))
         {
-            float vect[3];
-            vect[0]=sample->values[0]-nodes[i]->values[0];
-            vect[1]=sample->values[1]-nodes[i]->values[1];
-            vect[2]=CPathPlanningInterface::getNormalizedAngle(sample->values[2]-nodes[i]->values[2]);
-            if (areDirectionConstraintsRespected(vect))
-            {
-                vect[2]*=angularCoeff;
-                float d=vect[0]*vect[0]+vect[1]*vect[1]+vect[2]*vect[2];
-                if (d<minD)
-                {
-                    minD=d;
-                    index=i;
-                }
-            }
+            vect[2]*=angularCoeff;
+            float d=vect[0]*vect[0]+vect[1]*vect[1]+vect[2]*vect[2];
+            return(d);
         }
     }
     else if (planningType==sim_holonomicpathplanning_abg)
     {
-        for (int i=0;i<int(nodes.size());i++)
+        float vect[4];
+        C4Vector toP,fromP;
+        C3Vector dum;
+        sample->getAllValues(dum,toP);
+        node->getAllValues(dum,fromP);
+        C4Vector diff(fromP.getInverse()*toP);
+        vect[0]=diff(0);
+        vect[1]=diff(1);
+        vect[2]=diff(2);
+        vect[3]=diff(3);
+        if (areDirectionConstraintsRespected(vect))
         {
-            float vect[4];
-            C4Vector toP,fromP;
-            C3Vector dum;
-            sample->getAllValues(dum,toP);
-            nodes[i]->getAllValues(dum,fromP);
-            C4Vector diff(fromP.getInverse()*toP);
-            vect[0]=diff(0);
-            vect[1]=diff(1);
-            vect[2]=diff(2);
-            vect[3]=diff(3);
-            if (areDirectionConstraintsRespected(vect))
-            {
-                float d=angularCoeff*fromP.getAngleBetweenQuaternions(toP);
-                d*=d;
-                if (d<minD)
-                {
-                    minD=d;
-                    index=i;
-                }
-            }
+            float d=angularCoeff*fromP.getAngleBetweenQuaternions(toP);
+            d*=d;
+            return(d);
         }
     }
     else if (planningType==sim_holonomicpathplanning_xyzg)
     {
-        for (int i=0;i<int(nodes.size());i++)
+        float vect[4];
+        vect[0]=sample->values[0]-node->values[0];
+        vect[1]=sample->values[1]-node->values[1];
+        vect[2]=sample->values[2]-node->values[2];
+        vect[3]=CPathPlanningInterface::getNormalizedAngle(sample->values[3]-node->values[3]);
+        if (areDirectionConstraintsRespected(vect))
         {
-            float vect[4];
-            vect[0]=sample->values[0]-nodes[i]->values[0];
-            vect[1]=sample->values[1]-nodes[i]->values[1];
-            vect[2]=sample->values[2]-nodes[i]->values[2];
-            vect[3]=CPathPlanningInterface::getNormalizedAngle(sample->values[3]-nodes[i]->values[3]);
-            if (areDirectionConstraintsRespected(vect))
-            {
-                vect[3]*=angularCoeff;
-                float d=vect[0]*vect[0]+vect[1]*vect[1]+vect[2]*vect[2]+vect[3]*vect[3];
-                if (d<minD)
-                {
-                    minD=d;
-                    index=i;
-                }
-            }
+            vect[3]*=angularCoeff;
+            float d=vect[0]*vect[0]+vect[1]*vect[1]+vect[2]*vect[2]+vect[3]*vect[3];
+            return(d);
         }
     }
     else if (planningType==sim_holonomicpathplanning_xabg)
     {
-        for (int i=0;i<int(nodes.size());i++)
+        float vect[5];
+        vect[0]=sample->values[0]-node->values[0];
+        C4Vector toP,fromP;
+        C3Vector dum;
+        sample->getAllValues(dum,toP);
+        node->getAllValues(dum,fromP);
+        C4Vector diff(fromP.getInverse()*toP);
+        vect[1]=diff(0);
+        vect[2]=diff(1);
+        vect[3]=diff(2);
+        vect[4]=diff(3);
+        if (areDirectionConstraintsRespected(vect))
         {
-            float vect[5];
-            vect[0]=sample->values[0]-nodes[i]->values[0];
-            C4Vector toP,fromP;
-            C3Vector dum;
-            sample->getAllValues(dum,toP);
-            nodes[i]->getAllValues(dum,fromP);
-            C4Vector diff(fromP.getInverse()*toP);
-            vect[1]=diff(0);
-            vect[2]=diff(1);
-            vect[3]=diff(2);
-            vect[4]=diff(3);
-            if (areDirectionConstraintsRespected(vect))
-            {
-                float ad=angularCoeff*fromP.getAngleBetweenQuaternions(toP);
-                float d=vect[0]*vect[0]+ad*ad;
-                if (d<minD)
-                {
-                    minD=d;
-                    index=i;
-                }
-            }
+            float ad=angularCoeff*fromP.getAngleBetweenQuaternions(toP);
+            float d=vect[0]*vect[0]+ad*ad;
+            return(d);
         }
     }
     else if (planningType==sim_holonomicpathplanning_xyabg)
     {
-        for (int i=0;i<int(nodes.size());i++)
+        float vect[6];
+        vect[0]=sample->values[0]-node->values[0];
+        vect[1]=sample->values[1]-node->values[1];
+        C4Vector toP,fromP;
+        C3Vector dum;
+        sample->getAllValues(dum,toP);
+        node->getAllValues(dum,fromP);
+        C4Vector diff(fromP.getInverse()*toP);
+        vect[2]=diff(0);
+        vect[3]=diff(1);
+        vect[4]=diff(2);
+        vect[5]=diff(3);
+        if (areDirectionConstraintsRespected(vect))
         {
-            float vect[6];
-            vect[0]=sample->values[0]-nodes[i]->values[0];
-            vect[1]=sample->values[1]-nodes[i]->values[1];
-            C4Vector toP,fromP;
-            C3Vector dum;
-            sample->getAllValues(dum,toP);
-            nodes[i]->getAllValues(dum,fromP);
-            C4Vector diff(fromP.getInverse()*toP);
-            vect[2]=diff(0);
-            vect[3]=diff(1);
-            vect[4]=diff(2);
-            vect[5]=diff(3);
-            if (areDirectionConstraintsRespected(vect))
-            {
-                float ad=angularCoeff*fromP.getAngleBetweenQuaternions(toP);
-                float d=vect[0]*vect[0]+vect[1]*vect[1]+ad*ad;
-                if (d<minD)
-                {
-                    minD=d;
-                    index=i;
-                }
-            }
+            float ad=angularCoeff*fromP.getAngleBetweenQuaternions(toP);
+            float d=vect[0]*vect[0]+vect[1]*vect[1]+ad*ad;
+            return(d);
         }
     }
     else // (planningType==sim_holonomicpathplanning_xyzabg)
     {
-        for (int i=0;i<int(nodes.size());i++)
+        float vect[7];
+        vect[0]=sample->values[0]-node->values[0];
+        vect[1]=sample->values[1]-node->values[1];
+        vect[2]=sample->values[2]-node->values[2];
+        C4Vector toP,fromP;
+        C3Vector dum;
+        sample->getAllValues(dum,toP);
+        node->getAllValues(dum,fromP);
+        C4Vector diff(fromP.getInverse()*toP);
+        vect[3]=diff(0);
+        vect[4]=diff(1);
+        vect[5]=diff(2);
+        vect[6]=diff(3);
+        if (areDirectionConstraintsRespected(vect))
         {
-            float vect[7];
-            vect[0]=sample->values[0]-nodes[i]->values[0];
-            vect[1]=sample->values[1]-nodes[i]->values[1];
-            vect[2]=sample->values[2]-nodes[i]->values[2];
-            C4Vector toP,fromP;
-            C3Vector dum;
-            sample->getAllValues(dum,toP);
-            nodes[i]->getAllValues(dum,fromP);
-            C4Vector diff(fromP.getInverse()*toP);
-            vect[3]=diff(0);
-            vect[4]=diff(1);
-            vect[5]=diff(2);
-            vect[6]=diff(3);
-            if (areDirectionConstraintsRespected(vect))
-            {
-                float ad=angularCoeff*fromP.getAngleBetweenQuaternions(toP);
-                float d=vect[0]*vect[0]+vect[1]*vect[1]+vect[2]*vect[2]+ad*ad;
-                if (d<minD)
-                {
-                    minD=d;
-                    index=i;
-                }
-            }
+            float ad=angularCoeff*fromP.getAngleBetweenQuaternions(toP);
+            float d=vect[0]*vect[0]+vect[1]*vect[1]+vect[2]*vect[2]+ad*ad;
+            return(d);
         }
     }
-    if (index!=-1)
-        return(nodes[index]);
-    return(nullptr);
+    return(SIM_MAX_FLOAT);
 }
 
+
 CHolonomicPathNode_old* CHolonomicPathPlanning_old::extend(std::vector<CHolonomicPathNode_old*>* nodeList,CHolonomicPathNode_old* toBeExtended,CHolonomicPathNode_old* extention,bool connect,CDummyDummy* dummy)
 {   // Return value is !=nullptr if extention was performed and connect is false
     // If connect is true, then return value indicates that connection can be performed!
@@ -2,6 +2,7 @@
 
 #include "pathPlanning_old.h"
 #include "holonomicPathNode_old.h"
+#include "nearestNodeIndex_old.h"
 #include "dummyClasses.h"
 #include <vector>
 #include "4Vector.h"
@@ -37,6 +38,10 @@ private:
     bool doCollide(float* dist);
 
     CHolonomicPathNode_old* getClosestNode(std::vector<CHolonomicPathNode_old*>& nodes,CHolonomicPathNode_old* sample);
+    CNearestNodeIndex_old* _getNodeIndex(std::vector<CHolonomicPathNode_old*>& nodes);
+    float _getNodeDistance(CHolonomicPathNode_old* node,CHolonomicPathNode_old* sample);
+    void _setUpNodeIndexes();
+    void _setNodeIndexWeights();
     CHolonomicPathNode_old* extend(std::vector<CHolonomicPathNode_old*>* nodeList,CHolonomicPathNode_old* toBeExtended,CHolonomicPathNode_old* extention,bool connect,CDummyDummy* dummy);
     int getVector(CHolonomicPathNode_old* fromPoint,CHolonomicPathNode_old* toPoint,float vect[7],float e,float& artificialLength,bool dontDivide);
     bool addVector(C3Vector& pos,C4Vector& orient,float vect[7]);
@@ -54,6 +59,9 @@ private:
     int _directionConstraints[4];
     bool _directionConstraintsOn;
 
+    CNearestNodeIndex_old _fromStartIndex;
+    CNearestNodeIndex_old _fromGoalIndex;
+
     C4Vector _gammaAxisRotation;
     C4Vector _gammaAxisRotationInv;
 
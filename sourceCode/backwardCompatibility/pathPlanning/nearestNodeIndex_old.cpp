@@ -0,0 +1,230 @@
+#include "nearestNodeIndex_old.h"
+#include "pathPlanningInterface.h"
+#include "simInternal.h"
+#include <algorithm>
+
+const int NEAREST_NODE_INDEX_LEAF_SIZE=16;
+
+CNearestNodeIndex_old::CNearestNodeIndex_old()
+{
+    _dimCnt=0;
+    for (int i=0;i<NEAREST_NODE_INDEX_MAX_DIM;i++)
+    {
+        _angular[i]=false;
+        _weights[i]=1.0f;
+    }
+    _root=-1;
+    _pointCntAtLastRebuild=0;
+}
+
+CNearestNodeIndex_old::~CNearestNodeIndex_old()
+{
+}
+
+void CNearestNodeIndex_old::setDimensions(int dimCnt,const bool angular[NEAREST_NODE_INDEX_MAX_DIM])
+{
+    clear();
+    _dimCnt=std::min<int>(dimCnt,NEAREST_NODE_INDEX_MAX_DIM);
+    for (int i=0;i<NEAREST_NODE_INDEX_MAX_DIM;i++)
+        _angular[i]=angular[i];
+}
+
+void CNearestNodeIndex_old::setWeights(const float weights[NEAREST_NODE_INDEX_MAX_DIM])
+{ // the tree layout doesn't depend on the weights
+    for (int i=0;i<NEAREST_NODE_INDEX_MAX_DIM;i++)
+        _weights[i]=weights[i];
+}
+
+void CNearestNodeIndex_old::clear()
+{
+    _coords.clear();
+    _nodes.clear();
+    _root=-1;
+    _pointCntAtLastRebuild=0;
+}
+
+int CNearestNodeIndex_old::getPointCount() const
+{
+    if (_dimCnt==0)
+        return(int(_coords.size()));
+    return(int(_coords.size())/_dimCnt);
+}
+
+void CNearestNodeIndex_old::addPoint(const float* coords)
+{
+    int pointIndex=getPointCount();
+    if (_dimCnt==0)
+        _coords.push_back(0.0f); // we still need to count the points
+    for (int i=0;i<_dimCnt;i++)
+    {
+        if (_angular[i])
+            _coords.push_back(CPathPlanningInterface::getNormalizedAngle(coords[i]));
+        else
+            _coords.push_back(coords[i]);
+    }
+    if (_root==-1)
+    {
+        SKdNode root;
+        root.axis=-1;
+        root.split=0.0f;
+        _nodes.push_back(root);
+        _root=0;
+    }
+    // Points are inserted incrementally into the leaves, which can unbalance the tree when the search tree grows
+    // in one direction. Rebuilding it each time the point count doubled keeps it balanced at an amortized O(log n) per point:
+    if ( (pointIndex+1>2*NEAREST_NODE_INDEX_LEAF_SIZE)&&(pointIndex+1>=2*_pointCntAtLastRebuild) )
+        _rebuild();
+    else
+        _insertIntoTree(pointIndex);
+}
+
+int CNearestNodeIndex_old::getClosestPoint(const float* coords,const std::function<float(int)>& distance) const
+{
+    float minDist=SIM_MAX_FLOAT;
+    int minIndex=-1;
+    if (_root!=-1)
+    {
+        float q[NEAREST_NODE_INDEX_MAX_DIM];
+        float offsets[NEAREST_NODE_INDEX_MAX_DIM];
+        for (int i=0;i<_dimCnt;i++)
+        {
+            q[i]=coords[i];
+            if (_angular[i])
+                q[i]=CPathPlanningInterface::getNormalizedAngle(q[i]);
+            offsets[i]=0.0f;
+        }
+        _search(_root,0.0f,offsets,q,distance,minDist,minIndex);
+    }
+    return(minIndex);
+}
+
+void CNearestNodeIndex_old::_insertIntoTree(int pointIndex)
+{
+    int node=_root;
+    while (_nodes[node].axis!=-1)
+    {
+        if (_coords[pointIndex*_dimCnt+_nodes[node].axis]>=_nodes[node].split)
+            node=_nodes[node].children[1];
+        else
+            node=_nodes[node].children[0];
+    }
+    _nodes[node].points.push_back(pointIndex);
+    if ( (_dimCnt>0)&&(_nodes[node].points.size()>2*NEAREST_NODE_INDEX_LEAF_SIZE) )
+        _splitLeaf(node);
+}
+
+void CNearestNodeIndex_old::_splitLeaf(int node)
+{
+    std::vector<int> points;
+    points.swap(_nodes[node].points);
+    int child=_build(points,0,int(points.size()));
+    if (_nodes[child].axis==-1)
+    { // points can't be split (e.g. all identical)
+        _nodes[child].points.swap(_nodes[node].points);
+        _nodes.pop_back();
+        return;
+    }
+    _nodes[node]=_nodes[child];
+    _nodes.pop_back(); // the child was the last node added
+}
+
+void CNearestNodeIndex_old::_rebuild()
+{
+    std::vector<int> points;
+    int cnt=getPointCount();
+    for (int i=0;i<cnt;i++)
+        points.push_back(i);
+    _nodes.clear();
+    _root=_build(points,0,cnt); // the root is added last
+    _pointCntAtLastRebuild=cnt;
+}
+
+int CNearestNodeIndex_old::_build(std::vector<int>& points,int from,int to)
+{ // the returned node is added last, after its children. Points in children[0] are <= split, in children[1] >= split
+    int axis=-1;
+    float maxSpread=0.0f;
+    if (to-from>NEAREST_NODE_INDEX_LEAF_SIZE)
+    {
+        for (int a=0;a<_dimCnt;a++)
+        {
+            float mmin=SIM_MAX_FLOAT;
+            float mmax=-SIM_MAX_FLOAT;
+            for (int i=from;i<to;i++)
+            {
+                float v=_coords[points[i]*_dimCnt+a];
+                mmin=std::min<float>(mmin,v);
+                mmax=std::max<float>(mmax,v);
+            }
+            float spread=(mmax-mmin)*sqrt(_weights[a]);
+            if (spread>maxSpread)
+            {
+                maxSpread=spread;
+                axis=a;
+            }
+        }
+    }
+    SKdNode n;
+    n.axis=axis;
+    n.split=0.0f;
+    n.children[0]=-1;
+    n.children[1]=-1;
+    if (axis==-1)
+        n.points.assign(points.begin()+from,points.begin()+to);
+    else
+    {
+        int mid=(from+to)/2;
+        std::nth_element(points.begin()+from,points.begin()+mid,points.begin()+to,[&](int a,int b){ return(_coords[a*_dimCnt+axis]<_coords[b*_dimCnt+axis]); });
+        n.split=_coords[points[mid]*_dimCnt+axis];
+        n.children[0]=_build(points,from,mid);
+        n.children[1]=_build(points,mid,to);
+    }
+    _nodes.push_back(n);
+    return(int(_nodes.size())-1);
+}
+
+void CNearestNodeIndex_old::_search(int node,float lowerBound,float offsets[NEAREST_NODE_INDEX_MAX_DIM],const float* coords,const std::function<float(int)>& distance,float& minDist,int& minIndex) const
+{ // lowerBound is slightly relaxed, since the caller might compute its distance with a different rounding. Equal distances are not pruned, for the tie rule
+    if (lowerBound*0.9999f>minDist)
+        return;
+    const SKdNode& n=_nodes[node];
+    if (n.axis==-1)
+    {
+        for (size_t i=0;i<n.points.size();i++)
+        {
+            int p=n.points[i];
+            float d=distance(p);
+            if ( (d<minDist)||((d==minDist)&&(minIndex!=-1)&&(p<minIndex)) )
+            {
+                minDist=d;
+                minIndex=p;
+            }
+        }
+        return;
+    }
+    int nearChild=0;
+    if (coords[n.axis]>=n.split)
+        nearChild=1;
+    _search(n.children[nearChild],lowerBound,offsets,coords,distance,minDist,minIndex);
+    float oldOffset=offsets[n.axis];
+    float offset=std::max<float>(oldOffset,_getAxisOffset(n.axis,coords[n.axis],n.split,nearChild==0));
+    offsets[n.axis]=offset;
+    _search(n.children[1-nearChild],lowerBound+_weights[n.axis]*(offset*offset-oldOffset*oldOffset),offsets,coords,distance,minDist,minIndex);
+    offsets[n.axis]=oldOffset;
+}
+
+float CNearestNodeIndex_old::_getAxisOffset(int axis,float value,float split,bool upperSide) const
+{ // distance from value to [split;max] (upperSide) or [min;split]. Angular values can also be reached through +-pi
+    if (upperSide)
+    {
+        if (value>=split)
+            return(0.0f);
+        if (_angular[axis])
+            return(std::min<float>(split-value,value+piValue_f));
+        return(split-value);
+    }
+    if (value<=split)
+        return(0.0f);
+    if (_angular[axis])
+        return(std::min<float>(value-split,piValue_f-value));
+    return(value-split);
+}
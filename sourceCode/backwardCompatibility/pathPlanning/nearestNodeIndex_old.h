@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+
+const int NEAREST_NODE_INDEX_MAX_DIM=4;
+
+// KD-tree over the first coordinates of the nodes of a search tree, for nearest node queries. Points are
+// only ever added (e.g. when a search tree is extended), and are identified by their insertion index.
+// Angular coordinates are in [-pi;+pi] and wrap around. The distance to a point is the weighted sum of
+// squared coordinate differences, plus a part the index doesn't know about (e.g. an orientation or a
+// constraint) that the caller adds on top
+class CNearestNodeIndex_old
+{
+public:
+    CNearestNodeIndex_old();
+    virtual ~CNearestNodeIndex_old();
+
+    void setDimensions(int dimCnt,const bool angular[NEAREST_NODE_INDEX_MAX_DIM]);
+    void setWeights(const float weights[NEAREST_NODE_INDEX_MAX_DIM]);
+    void clear();
+    void addPoint(const float* coords);
+    int getPointCount() const;
+
+    // distance(i) returns the full distance to point i (SIM_MAX_FLOAT if point i doesn't qualify), and must not
+    // be smaller than the weighted distance over the indexed coordinates. Ties go to the point added first, as with
+    // a linear scan. Returns -1 if no point qualifies
+    int getClosestPoint(const float* coords,const std::function<float(int)>& distance) const;
+
+protected:
+    struct SKdNode
+    {
+        int axis; // -1 for leaves
+        float split;
+        int children[2];
+        std::vector<int> points;
+    };
+
+    void _insertIntoTree(int pointIndex);
+    void _splitLeaf(int node);
+    void _rebuild();
+    int _build(std::vector<int>& points,int from,int to);
+    void _search(int node,float lowerBound,float offsets[NEAREST_NODE_INDEX_MAX_DIM],const float* coords,const std::function<float(int)>& distance,float& minDist,int& minIndex) const;
+    float _getAxisOffset(int axis,float value,float split,bool upperSide) const;
+
+    int _dimCnt;
+    bool _angular[NEAREST_NODE_INDEX_MAX_DIM];
+    float _weights[NEAREST_NODE_INDEX_MAX_DIM];
+    std::vector<float> _coords;
+    std::vector<SKdNode> _nodes;
+    int _root;
+    int _pointCntAtLastRebuild;
+};
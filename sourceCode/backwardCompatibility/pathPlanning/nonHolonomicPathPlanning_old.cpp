@@ -17,6 +17,9 @@ CNonHolonomicPathPlanning_old::CNonHolonomicPathPlanning_old(int theStartDummyID
     obstacleClearanceAndMaxDistance[1]=clearanceAndMaxDistance[1];
     fromStart.reserve(300000);
     fromGoal.reserve(300000);
+    bool angular[NEAREST_NODE_INDEX_MAX_DIM]={false,false,false,false};
+    _fromStartIndex.setDimensions(2,angular); // the node distance only depends on x and y
+    _fromGoalIndex.setDimensions(2,angular);
     stepSize=theStepSize;
     angularCoeff=theAngularCoeff;
     steeringAngleCoeff=theSteeringAngleCoeff;
@@ -240,13 +243,11 @@ bool CNonHolonomicPathPlanning_old::setPartialPath()
 
 
 CNonHolonomicPathNode_old* CNonHolonomicPathPlanning_old::getClosestNode(std::vector<CNonHolonomicPathNode_old*>& nodes,CNonHolonomicPathNode_old* sample,bool forward,bool forConnection)
-{
-    float minD=SIM_MAX_FLOAT;
-    int index=-1;
+{ // nodes too close to the sample (i.e. within the turning circles) are ignored
     float dPart2=2.0f*minTurningRadius;
     if (forConnection)
         dPart2=6.0f*minTurningRadius;
-    for (int i=0;i<int(nodes.size());i++)
+    auto distance=[&](int i)->float
     {
         float vect[3];
         vect[0]=sample->values[0]-nodes[i]->values[0];
@@ -254,13 +255,26 @@ CNonHolonomicPathNode_old* CNonHolonomicPathPlanning_old::getClosestNode(std::ve
         vect[2]=sample->values[2]-nodes[i]->values[2];
         float dPart1=vect[0]*vect[0]+vect[1]*vect[1];
         if ( (dPart1>dPart2))
+            return(dPart1);//+fabs(vect[2])*0.01f;
+        return(SIM_MAX_FLOAT);
+    };
+    CNearestNodeIndex_old* nodeIndex=_getNodeIndex(nodes);
+    if (nodeIndex!=nullptr)
+    {
+        int closest=nodeIndex->getClosestPoint(sample->values,distance);
+        if (closest!=-1)
+            return(nodes[closest]);
+        return(nullptr);
+    }
+    float minD=SIM_MAX_FLOAT;
+    int index=-1;
+    for (int i=0;i<int(nodes.size());i++)
+    {
+        float d=distance(i);
+        if (d<minD)
         {
-            float d=dPart1;//+fabs(vect[2])*0.01f;
-            if (d<minD)
-            {
-                minD=d;
-                index=i;
-            }
+            minD=d;
+            index=i;
         }
     }
     if (index!=-1)
@@ -268,6 +282,23 @@ CNonHolonomicPathNode_old* CNonHolonomicPathPlanning_old::getClosestNode(std::ve
     return(nullptr);
 }
 
+CNearestNodeIndex_old* CNonHolonomicPathPlanning_old::_getNodeIndex(std::vector<CNonHolonomicPathNode_old*>& nodes)
+{ // the search trees only grow: nodes added since the last query are added to the index here
+    CNearestNodeIndex_old* index=nullptr;
+    if (&nodes==&fromStart)
+        index=&_fromStartIndex;
+    if (&nodes==&fromGoal)
+        index=&_fromGoalIndex;
+    if (index!=nullptr)
+    {
+        if (index->getPointCount()>int(nodes.size()))
+            index->clear();
+        for (int i=index->getPointCount();i<int(nodes.size());i++)
+            index->addPoint(nodes[i]->values);
+    }
+    return(index);
+}
+
 CNonHolonomicPathNode_old* CNonHolonomicPathPlanning_old::extend(std::vector<CNonHolonomicPathNode_old*>* currentList,CNonHolonomicPathNode_old* toBeExtended,CNonHolonomicPathNode_old* extention,bool forward,CDummyDummy* startDummy)
 {   // Return value is !=nullptr if extention was performed to some extent
     bool specialCase=( (fromStart==currentList[0])&&(toBeExtended==fromStart[0])&&(_startConfInterferenceState!=SIM_MAX_FLOAT) );
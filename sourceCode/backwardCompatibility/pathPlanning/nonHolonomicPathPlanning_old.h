@@ -2,6 +2,7 @@
 
 #include "pathPlanning_old.h"
 #include "nonHolonomicPathNode_old.h"
+#include "nearestNodeIndex_old.h"
 #include "dummyClasses.h"
 #include <vector>
 #include "7Vector.h"
@@ -33,6 +34,7 @@ private:
     bool doCollide(float* dist);
 
     CNonHolonomicPathNode_old* getClosestNode(std::vector<CNonHolonomicPathNode_old*>& nodes,CNonHolonomicPathNode_old* sample,bool forward,bool forConnection);
+    CNearestNodeIndex_old* _getNodeIndex(std::vector<CNonHolonomicPathNode_old*>& nodes);
     CNonHolonomicPathNode_old* extend(std::vector<CNonHolonomicPathNode_old*>* currentList,CNonHolonomicPathNode_old* toBeExtended,CNonHolonomicPathNode_old* extention,bool forward,CDummyDummy* startDummy);
     CNonHolonomicPathNode_old* connect(std::vector<CNonHolonomicPathNode_old*>* currentList,std::vector<CNonHolonomicPathNode_old*>* nextList,CNonHolonomicPathNode_old* toBeExtended,CNonHolonomicPathNode_old* extention,bool forward,bool connect,bool test,CDummyDummy* startDummy);
 
@@ -48,6 +50,8 @@ private:
     float searchRange[2];
     C7Vector _startDummyCTM;
     C7Vector _startDummyLTM;
+    CNearestNodeIndex_old _fromStartIndex;
+    CNearestNodeIndex_old _fromGoalIndex;
 
     int numberOfRandomConnectionTries_forSteppedSmoothing;
     int numberOfRandomConnectionTriesLeft_forSteppedSmoothing;
@@ -0,0 +1,391 @@
+#include "ikConfigValidator.h"
+#include "jointObject.h"
+#include "shape.h"
+#include "octree.h"
+#include "pointCloud.h"
+#include "dummy.h"
+#include "pluginContainer.h"
+#include "workerPool.h"
+#include "app.h"
+#include "tt.h"
+#include <atomic>
+#include <algorithm>
+
+const int IK_VALIDATOR_MIN_PARALLEL_PAIRS=8; // below that, the worker pool overhead is not worth it
+
+static thread_local CIkConfigValidator* _currentValidator=nullptr;
+
+CIkConfigValidator::CIkConfigValidator(int jointCnt,const int* jointHandles,int collisionPairCnt,const int* collisionPairs)
+{
+    _fixedPartCollides=false;
+
+    // The configuration's joints, then the joints that depend on them:
+    for (int i=0;i<jointCnt;i++)
+    {
+        _jointHandles.push_back(jointHandles[i]);
+        SIkValidatorJoint j;
+        j.confIndex=i;
+        _joints.push_back(j);
+    }
+    bool added=true;
+    while (added)
+    {
+        added=false;
+        for (size_t i=0;i<App::currentWorld->sceneObjects->getJointCount();i++)
+        {
+            CJoint* joint=App::currentWorld->sceneObjects->getJointFromIndex(i);
+            if ( ((joint->getJointMode()==sim_jointmode_dependent)||(joint->getJointMode()==sim_jointmode_reserved_previously_ikdependent))&&(_getJointIndex(joint->getObjectHandle())==-1)&&(_getJointIndex(joint->getDependencyMasterJointHandle())!=-1) )
+            {
+                _jointHandles.push_back(joint->getObjectHandle());
+                SIkValidatorJoint j;
+                j.confIndex=-1;
+                _joints.push_back(j);
+                added=true;
+            }
+        }
+    }
+    for (size_t i=0;i<_joints.size();i++)
+    {
+        SIkValidatorJoint* j=&_joints[i];
+        CJoint* joint=App::currentWorld->sceneObjects->getJointFromHandle(_jointHandles[i]);
+        j->master=-1;
+        j->masterPosition=0.0f;
+        j->mult=1.0f;
+        j->offset=0.0f;
+        j->cyclic=true;
+        j->minPos=0.0f;
+        j->range=0.0f;
+        j->type=sim_joint_revolute_subtype;
+        j->screwPitch=0.0f;
+        j->sphericalTransformation.setIdentity();
+        if (joint==nullptr)
+            continue;
+        j->cyclic=joint->getPositionIsCyclic();
+        j->minPos=joint->getPositionIntervalMin();
+        j->range=joint->getPositionIntervalRange();
+        j->type=joint->getJointType();
+        j->screwPitch=joint->getScrewPitch();
+        if (j->type==sim_joint_spherical_subtype)
+            j->sphericalTransformation=joint->getSphericalTransformation();
+        if ( (joint->getJointMode()==sim_jointmode_dependent)||(joint->getJointMode()==sim_jointmode_reserved_previously_ikdependent) )
+        { // same as in CJoint::setPosition
+            j->confIndex=-1;
+            j->mult=joint->getDependencyJointMult();
+            j->offset=joint->getDependencyJointOffset();
+            j->master=_getJointIndex(joint->getDependencyMasterJointHandle());
+            CJoint* master=App::currentWorld->sceneObjects->getJointFromHandle(joint->getDependencyMasterJointHandle());
+            if (master!=nullptr)
+                j->masterPosition=master->getPosition();
+            else
+                j->mult=0.0f;
+        }
+    }
+
+    for (int i=0;i<collisionPairCnt;i++)
+    {
+        if (collisionPairs[2*i+0]>=0)
+        {
+            int env=collisionPairs[2*i+1];
+            if (env==sim_handle_all)
+                env=-1;
+            _addEntityPair(collisionPairs[2*i+0],env);
+        }
+    }
+}
+
+CIkConfigValidator::~CIkConfigValidator()
+{
+}
+
+CIkConfigValidator* CIkConfigValidator::setCurrentValidator(CIkConfigValidator* validator)
+{
+    CIkConfigValidator* retVal=_currentValidator;
+    _currentValidator=validator;
+    return(retVal);
+}
+
+bool CIkConfigValidator::validationCallback(float* conf)
+{
+    if (_currentValidator==nullptr)
+        return(true);
+    return(_currentValidator->isCollisionFree(conf));
+}
+
+bool CIkConfigValidator::isCollisionFree(const float* conf) const
+{
+    if (_fixedPartCollides)
+        return(false);
+    std::vector<float> jointPositions;
+    _getJointPositions(conf,jointPositions);
+    std::vector<C7Vector> trs(_objects.size());
+    for (size_t i=0;i<_objects.size();i++)
+        trs[i]=_getObjectTransformation(_objects[i],jointPositions);
+    int pairCnt=int(_pairs.size()/2);
+    if (pairCnt<IK_VALIDATOR_MIN_PARALLEL_PAIRS)
+    {
+        for (int i=0;i<pairCnt;i++)
+        {
+            int o1=_pairs[2*i+0];
+            int o2=_pairs[2*i+1];
+            if (_doObjectsCollide(_objects[o1],trs[o1],_objects[o2],trs[o2]))
+                return(false);
+        }
+        return(true);
+    }
+    std::atomic<bool> collides(false);
+    CWorkerPool::parallelFor(pairCnt,[&](int i)
+    {
+        if (collides)
+            return;
+        int o1=_pairs[2*i+0];
+        int o2=_pairs[2*i+1];
+        if (_doObjectsCollide(_objects[o1],trs[o1],_objects[o2],trs[o2]))
+            collides=true;
+    });
+    return(!collides);
+}
+
+void CIkConfigValidator::_addEntityPair(int entity1,int entity2)
+{ // same pairs and collidable flag handling as CCollisionRoutine::doEntitiesCollide, with objects that are not part of a collection needing their collidable flag
+    CSceneObject* object1=App::currentWorld->sceneObjects->getObjectFromHandle(entity1);
+    CSceneObject* object2=App::currentWorld->sceneObjects->getObjectFromHandle(entity2);
+    std::vector<CSceneObject*> group1;
+    std::vector<CSceneObject*> group2;
+    if (object1!=nullptr)
+    {
+        if ((object1->getCumulativeObjectSpecialProperty()&sim_objectspecialproperty_collidable)!=0)
+            group1.push_back(object1);
+    }
+    else
+        App::currentWorld->collections->getCollidableObjectsFromCollection(entity1,group1);
+    if (object2!=nullptr)
+    {
+        if ((object2->getCumulativeObjectSpecialProperty()&sim_objectspecialproperty_collidable)!=0)
+            group2.push_back(object2);
+    }
+    else
+    {
+        if (entity2==-1)
+        {
+            std::vector<CSceneObject*> exception;
+            if (object1!=nullptr)
+                exception.push_back(object1);
+            else
+                exception.assign(group1.begin(),group1.end());
+            App::currentWorld->sceneObjects->getAllCollidableObjectsFromSceneExcept(&exception,group2);
+        }
+        else
+            App::currentWorld->collections->getCollidableObjectsFromCollection(entity2,group2);
+    }
+    bool selfCollision=( (object1==nullptr)&&(entity1==entity2) );
+    for (size_t i=0;i<group1.size();i++)
+    {
+        for (size_t j=0;j<group2.size();j++)
+        {
+            CSceneObject* obj1=group1[i];
+            CSceneObject* obj2=group2[j];
+            if (obj1==obj2)
+                continue;
+            if ( selfCollision&&(abs(obj1->getCollectionSelfCollisionIndicator()-obj2->getCollectionSelfCollisionIndicator())==1) )
+                continue;
+            int t1=obj1->getObjectType();
+            int t2=obj2->getObjectType();
+            if (t2==sim_object_octree_type)
+            { // octrees go first, except against shapes
+                std::swap(obj1,obj2);
+                std::swap(t1,t2);
+            }
+            if ( (t1==sim_object_octree_type)&&(t2==sim_object_shape_type) )
+            {
+                std::swap(obj1,obj2);
+                std::swap(t1,t2);
+            }
+            bool supported=( (t1==sim_object_shape_type)&&((t2==sim_object_shape_type)||(t2==sim_object_octree_type)) );
+            supported=supported||( (t1==sim_object_octree_type)&&((t2==sim_object_octree_type)||(t2==sim_object_dummy_type)||(t2==sim_object_pointcloud_type)) );
+            if (!supported)
+                continue;
+            int o1=_getObjectIndex(obj1);
+            int o2=_getObjectIndex(obj2);
+            if ( (o1==-1)||(o2==-1) )
+                continue;
+            bool present=false;
+            for (size_t k=0;k<_pairs.size()/2;k++)
+            {
+                if ( ((_pairs[2*k+0]==o1)&&(_pairs[2*k+1]==o2))||((_pairs[2*k+0]==o2)&&(_pairs[2*k+1]==o1)) )
+                {
+                    present=true;
+                    break;
+                }
+            }
+            if (present)
+                continue;
+            if ( _objects[o1].variable||_objects[o2].variable )
+            {
+                _pairs.push_back(o1);
+                _pairs.push_back(o2);
+            }
+            else
+            { // this pair doesn't depend on the configuration
+                if ( (!_fixedPartCollides)&&_doObjectsCollide(_objects[o1],obj1->getFullCumulativeTransformation(),_objects[o2],obj2->getFullCumulativeTransformation()) )
+                    _fixedPartCollides=true;
+            }
+        }
+    }
+}
+
+int CIkConfigValidator::_getObjectIndex(CSceneObject* object)
+{ // adds the object to the snapshot if needed. Returns -1 for empty objects
+    for (size_t i=0;i<_sceneObjects.size();i++)
+    {
+        if (_sceneObjects[i]==object)
+            return(int(i));
+    }
+    SIkValidatorObject obj;
+    obj.type=object->getObjectType();
+    obj.calcStruct=nullptr;
+    if (obj.type==sim_object_shape_type)
+    { // built here, since the checks can run in worker threads:
+        CShape* shape=(CShape*)object;
+        shape->initializeMeshCalculationStructureIfNeeded();
+        obj.calcStruct=shape->_meshCalculationStructure;
+        obj.halfSizes=shape->getBoundingBoxHalfSizes();
+    }
+    if (obj.type==sim_object_octree_type)
+        obj.calcStruct=((COctree*)object)->getOctreeInfo();
+    if (obj.type==sim_object_pointcloud_type)
+        obj.calcStruct=((CPointCloud*)object)->getPointCloudInfo();
+    if ( (obj.calcStruct==nullptr)&&(obj.type!=sim_object_dummy_type) )
+        return(-1);
+
+    // The chain of transformations, from the world to the object. Consecutive fixed transformations are merged:
+    std::vector<CSceneObject*> ancestors;
+    CSceneObject* it=object;
+    while (it!=nullptr)
+    {
+        ancestors.insert(ancestors.begin(),it);
+        it=it->getParent();
+    }
+    obj.variable=false;
+    SIkValidatorChainItem fixedPart;
+    fixedPart.joint=-1;
+    fixedPart.tr.setIdentity();
+    for (size_t i=0;i<ancestors.size();i++)
+    {
+        int jointIndex=-1;
+        if (ancestors[i]->getObjectType()==sim_object_joint_type)
+            jointIndex=_getJointIndex(ancestors[i]->getObjectHandle());
+        if (jointIndex==-1)
+            fixedPart.tr=fixedPart.tr*ancestors[i]->getFullLocalTransformation();
+        else
+        {
+            obj.chain.push_back(fixedPart);
+            SIkValidatorChainItem jointItem;
+            jointItem.joint=jointIndex;
+            jointItem.tr=ancestors[i]->getLocalTransformation();
+            obj.chain.push_back(jointItem);
+            fixedPart.tr.setIdentity();
+            obj.variable=true;
+        }
+    }
+    obj.chain.push_back(fixedPart);
+    _sceneObjects.push_back(object);
+    _objects.push_back(obj);
+    return(int(_objects.size())-1);
+}
+
+int CIkConfigValidator::_getJointIndex(int jointHandle) const
+{
+    for (size_t i=0;i<_jointHandles.size();i++)
+    {
+        if (_jointHandles[i]==jointHandle)
+            return(int(i));
+    }
+    return(-1);
+}
+
+void CIkConfigValidator::_getJointPositions(const float* conf,std::vector<float>& positions) const
+{
+    positions.resize(_joints.size());
+    std::vector<bool> done(_joints.size(),false);
+    for (size_t i=0;i<_joints.size();i++)
+        _getJointPosition(int(i),conf,positions,done);
+}
+
+float CIkConfigValidator::_getJointPosition(int index,const float* conf,std::vector<float>& positions,std::vector<bool>& done) const
+{ // same limits and dependencies as in CJoint::setPosition
+    if (!done[index])
+    {
+        done[index]=true; // also breaks dependency loops
+        const SIkValidatorJoint& j=_joints[index];
+        float pos;
+        if (j.confIndex==-1)
+        {
+            float masterPos=j.masterPosition;
+            if (j.master!=-1)
+                masterPos=_getJointPosition(j.master,conf,positions,done);
+            pos=j.mult*masterPos+j.offset;
+        }
+        else
+        {
+            pos=conf[j.confIndex];
+            if (j.cyclic)
+                pos=tt::getNormalizedAngle(pos);
+            else
+            {
+                if (pos>j.minPos+j.range)
+                    pos=j.minPos+j.range;
+                if (pos<j.minPos)
+                    pos=j.minPos;
+            }
+        }
+        positions[index]=pos;
+    }
+    return(positions[index]);
+}
+
+C7Vector CIkConfigValidator::_getObjectTransformation(const SIkValidatorObject& obj,const std::vector<float>& jointPositions) const
+{ // same as CJoint::getFullLocalTransformation for the joints
+    C7Vector tr(obj.chain[0].tr);
+    for (size_t i=1;i<obj.chain.size();i++)
+    {
+        const SIkValidatorChainItem& item=obj.chain[i];
+        tr=tr*item.tr;
+        if (item.joint!=-1)
+        {
+            const SIkValidatorJoint& j=_joints[item.joint];
+            float pos=jointPositions[item.joint];
+            C7Vector jointTr;
+            jointTr.setIdentity();
+            if (j.type==sim_joint_revolute_subtype)
+            {
+                jointTr.Q.setAngleAndAxis(pos,C3Vector(0.0f,0.0f,1.0f));
+                jointTr.X(2)=pos*j.screwPitch;
+            }
+            if (j.type==sim_joint_prismatic_subtype)
+                jointTr.X(2)=pos;
+            if (j.type==sim_joint_spherical_subtype)
+                jointTr.Q=j.sphericalTransformation;
+            tr=tr*jointTr;
+        }
+    }
+    return(tr);
+}
+
+bool CIkConfigValidator::_doObjectsCollide(const SIkValidatorObject& obj1,const C7Vector& tr1,const SIkValidatorObject& obj2,const C7Vector& tr2) const
+{ // obj1 is a shape or an octree. Only reads the calculation structures, can run in parallel
+    if (obj1.type==sim_object_shape_type)
+    {
+        if (obj2.type==sim_object_shape_type)
+        {
+            if (!CPluginContainer::geomPlugin_getBoxBoxCollision(tr1,obj1.halfSizes,tr2,obj2.halfSizes,true))
+                return(false);
+            return(CPluginContainer::geomPlugin_getMeshMeshCollision(obj1.calcStruct,tr1,obj2.calcStruct,tr2));
+        }
+        return(CPluginContainer::geomPlugin_getMeshOctreeCollision(obj1.calcStruct,tr1,obj2.calcStruct,tr2));
+    }
+    if (obj2.type==sim_object_octree_type)
+        return(CPluginContainer::geomPlugin_getOctreeOctreeCollision(obj1.calcStruct,tr1,obj2.calcStruct,tr2));
+    if (obj2.type==sim_object_dummy_type)
+        return(CPluginContainer::geomPlugin_getOctreePointCollision(obj1.calcStruct,tr1,tr2.X));
+    return(CPluginContainer::geomPlugin_getOctreePtcloudCollision(obj1.calcStruct,tr1,obj2.calcStruct,tr2));
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "sceneObject.h"
+#include <vector>
+
+struct SIkValidatorJoint
+{
+    int confIndex; // -1 for dependent joints
+    int master; // index of the master joint, -1 if it is not part of the snapshot (masterPosition is then used)
+    float masterPosition;
+    float mult;
+    float offset;
+    bool cyclic;
+    float minPos;
+    float range;
+    int type;
+    float screwPitch;
+    C4Vector sphericalTransformation; // spherical joints only. Not part of the configuration, kept as is
+};
+
+struct SIkValidatorChainItem
+{
+    int joint; // -1 for a fixed transformation
+    C7Vector tr; // for joints, the local transformation without the joint's intrinsic part
+};
+
+struct SIkValidatorObject
+{
+    int type;
+    const void* calcStruct;
+    C3Vector halfSizes; // shapes only
+    bool variable;
+    std::vector<SIkValidatorChainItem> chain; // from the world to the object
+};
+
+// Checks robot configurations for collisions on a kinematic snapshot of the scene: joint positions are never written
+// to the scene, the transformations of the involved objects are computed for each configuration instead.
+// After construction, isCollisionFree can be called from any thread
+class CIkConfigValidator
+{
+public:
+    CIkConfigValidator(int jointCnt,const int* jointHandles,int collisionPairCnt,const int* collisionPairs);
+    virtual ~CIkConfigValidator();
+
+    bool isCollisionFree(const float* conf) const;
+
+    static bool validationCallback(float* conf); // for the IK plugin. Uses the current validator of the calling thread
+    static CIkConfigValidator* setCurrentValidator(CIkConfigValidator* validator); // returns the previous one
+
+protected:
+    void _addEntityPair(int entity1,int entity2);
+    int _getObjectIndex(CSceneObject* object);
+    int _getJointIndex(int jointHandle) const;
+    void _getJointPositions(const float* conf,std::vector<float>& positions) const;
+    float _getJointPosition(int index,const float* conf,std::vector<float>& positions,std::vector<bool>& done) const;
+    C7Vector _getObjectTransformation(const SIkValidatorObject& obj,const std::vector<float>& jointPositions) const;
+    bool _doObjectsCollide(const SIkValidatorObject& obj1,const C7Vector& tr1,const SIkValidatorObject& obj2,const C7Vector& tr2) const;
+
+    std::vector<int> _jointHandles;
+    std::vector<SIkValidatorJoint> _joints;
+    std::vector<CSceneObject*> _sceneObjects;
+    std::vector<SIkValidatorObject> _objects;
+    std::vector<int> _pairs; // object indices, 2 per pair. Pairs with at least one variable object
+    bool _fixedPartCollides; // pairs of fixed objects are only checked once
+};
@@ -4,6 +4,7 @@
 #include "imgLoaderSaver.h"
 #include "app.h"
 #include "simFlavor.h"
+#include "workerPool.h"
 #include <QMimeData>
 #include <QScrollBar>
 
@@ -101,6 +102,94 @@ void CModelListWidget::_addThumbnailItemToList(int index)
 }
 
 CThumbnail* CModelListWidget::loadModelThumbnail(const char* pathAndFilename,int& result,C7Vector& modelTr,C3Vector& modelBoundingBoxSize,float& modelNonDefaultTranslationStepSize)
+{ // result: -1=model not recognized, 0=model has no thumbnail, 1=model has thumbnail
+    bool needsSceneLoad;
+    CThumbnail* retThumbnail=extractModelThumbnail(pathAndFilename,result,modelTr,modelBoundingBoxSize,modelNonDefaultTranslationStepSize,needsSceneLoad);
+    if (needsSceneLoad)
+        retThumbnail=_loadModelThumbnailViaScene(pathAndFilename,result,modelTr,modelBoundingBoxSize,modelNonDefaultTranslationStepSize);
+    return(retThumbnail);
+}
+
+CThumbnail* CModelListWidget::extractModelThumbnail(const char* pathAndFilename,int& result,C7Vector& modelTr,C3Vector& modelBoundingBoxSize,float& modelNonDefaultTranslationStepSize,bool& needsSceneLoad)
+{ // result: -1=model not recognized, 0=model has no thumbnail, 1=model has thumbnail
+  // Does not touch the scene, and can be called from any thread. needsSceneLoad is set if the thumbnail is not at the
+  // beginning of the data, in which case the model has to be loaded via _loadModelThumbnailViaScene
+    result=-1;
+    needsSceneLoad=false;
+    modelTr.setIdentity();
+    modelBoundingBoxSize.clear();
+    modelNonDefaultTranslationStepSize=0.0;
+    CThumbnail* retThumbnail=nullptr;
+    if (VFile::doesFileExist(pathAndFilename))
+    {
+        // Newer model files have an uncompressed thumbnail section at the end, that can be read on its own:
+        CSer sectionSerObj(pathAndFilename,CSer::getFileTypeFromName(pathAndFilename));
+        if (sectionSerObj.readOpenBinaryThumbnailSection()==1)
+        {
+            retThumbnail=new CThumbnail();
+            if (!_readThumbnailChunks(sectionSerObj,retThumbnail,modelTr,modelBoundingBoxSize,modelNonDefaultTranslationStepSize))
+            {
+                delete retThumbnail;
+                retThumbnail=nullptr;
+            }
+            sectionSerObj.readClose();
+        }
+        if (retThumbnail==nullptr)
+        { // Older files are read and uncompressed as a whole:
+            CSer serObj(pathAndFilename,CSer::getFileTypeFromName(pathAndFilename));
+            int serializationVersion;
+            unsigned short csimVersionThatWroteThis;
+            int licenseTypeThatWroteThis;
+            char revisionNumber;
+            result=serObj.readOpenBinary(serializationVersion,csimVersionThatWroteThis,licenseTypeThatWroteThis,revisionNumber,true);
+            if (result==1)
+            {
+                retThumbnail=new CThumbnail();
+                if (!_readThumbnailChunks(serObj,retThumbnail,modelTr,modelBoundingBoxSize,modelNonDefaultTranslationStepSize))
+                {
+                    delete retThumbnail;
+                    retThumbnail=nullptr;
+                    needsSceneLoad=true;
+                }
+                serObj.readClose();
+            }
+        }
+        if (retThumbnail!=nullptr)
+        {
+            result=0;
+            if (retThumbnail->getPointerToUncompressedImage()!=nullptr)
+                result=1;
+        }
+    }
+    return(retThumbnail);
+}
+
+bool CModelListWidget::_readThumbnailChunks(CSer& ar,CThumbnail* thumbnail,C7Vector& modelTr,C3Vector& modelBoundingBoxSize,float& modelNonDefaultTranslationStepSize)
+{ // the model infos and the thumbnail come first in model files. Returns false if something else comes first
+    while (ar.getFileBufferReadPointer()+3<=int(ar.getFileBuffer()->size()))
+    {
+        int byteQuantity;
+        std::string theName=ar.readDataName();
+        if (theName.compare(SER_MODEL_THUMBNAIL_INFO)==0)
+        {
+            ar >> byteQuantity;
+            thumbnail->serializeAdditionalModelInfos(ar,modelTr,modelBoundingBoxSize,modelNonDefaultTranslationStepSize);
+        }
+        else
+        {
+            if (theName.compare(SER_MODEL_THUMBNAIL)==0)
+            {
+                ar >> byteQuantity;
+                thumbnail->serialize(ar);
+                return(true);
+            }
+            return(false);
+        }
+    }
+    return(false);
+}
+
+CThumbnail* CModelListWidget::_loadModelThumbnailViaScene(const char* pathAndFilename,int& result,C7Vector& modelTr,C3Vector& modelBoundingBoxSize,float& modelNonDefaultTranslationStepSize)
 { // result: -1=model not recognized, 0=model has no thumbnail, 1=model has thumbnail
     result=-1;
     CThumbnail* retThumbnail=nullptr;
@@ -231,20 +320,32 @@ void CModelListWidget::setFolder(const char* folderPath)
         {
             clearAll();
             _folderPath=folderPath;
-            for (int i=0;i<int(allModelNames.size());i++)
+            // The model files are read in parallel. Only models with an unusual layout are loaded via the scene, further down:
+            size_t fileCnt=allModelNames.size();
+            std::vector<CThumbnail*> thumbnails(fileCnt,nullptr);
+            std::vector<int> results(fileCnt,-1);
+            std::vector<C7Vector> modelTrs(fileCnt);
+            std::vector<C3Vector> modelBBs(fileCnt);
+            std::vector<float> ndss(fileCnt,0.0);
+            std::vector<unsigned char> needsSceneLoad(fileCnt,0);
+            std::string path(_folderPath+"/");
+            CWorkerPool::parallelFor(int(fileCnt),[&](int i)
+            {
+                if (allModelOrFolder[i]==1)
+                {
+                    bool sceneLoad;
+                    thumbnails[i]=extractModelThumbnail((path+allModelNames[i]).c_str(),results[i],modelTrs[i],modelBBs[i],ndss[i],sceneLoad);
+                    needsSceneLoad[i]=sceneLoad;
+                }
+            });
+            for (int i=0;i<int(fileCnt);i++)
             {
                 if (allModelOrFolder[i]==1)
                 { // we have a model here
-                    std::string nameAndPath(_folderPath);
-                    nameAndPath+="/";
-                    nameAndPath+=allModelNames[i];
-                    int result;
-                    C7Vector modelTr;
-                    C3Vector modelBBs;
-                    float ndss;
-                    CThumbnail* thumbnail=loadModelThumbnail(nameAndPath.c_str(),result,modelTr,modelBBs,ndss);
-                    if (thumbnail!=nullptr)
-                        addThumbnail(thumbnail,allModelNames[i].c_str(),allModelCreationTimes[i],1,result>=0,&modelTr,&modelBBs,&ndss);
+                    if (needsSceneLoad[i]!=0)
+                        thumbnails[i]=_loadModelThumbnailViaScene((path+allModelNames[i]).c_str(),results[i],modelTrs[i],modelBBs[i],ndss[i]);
+                    if (thumbnails[i]!=nullptr)
+                        addThumbnail(thumbnails[i],allModelNames[i].c_str(),allModelCreationTimes[i],1,results[i]>=0,&modelTrs[i],&modelBBs[i],&ndss[i]);
                 }
                 else
                 { // we have a folder here!
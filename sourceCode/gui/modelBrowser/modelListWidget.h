@@ -32,12 +32,15 @@ public:
     SModelThumbnailInfo* getThumbnailInfoFromModelName(const char* nameWithExtension,int* index);
     void addThumbnail(CThumbnail* thumbN,const char* nameWithExtension,unsigned int creationTime,unsigned char modelOrFolder,bool validFileformat,C7Vector* optionalModelTr,C3Vector* optionalModelBoundingBoxSize,float* optionalModelNonDefaultTranslationStepSize);
     static CThumbnail* loadModelThumbnail(const char* pathAndFilename,int& result,C7Vector& modelTr,C3Vector& modelBoundingBoxSize,float& modelNonDefaultTranslationStepSize);
+    static CThumbnail* extractModelThumbnail(const char* pathAndFilename,int& result,C7Vector& modelTr,C3Vector& modelBoundingBoxSize,float& modelNonDefaultTranslationStepSize,bool& needsSceneLoad);
     void serializePart1(CSer& ar);
     void serializePart2(CSer& ar);
 
 private:
     void clearAll();
     void _addThumbnailItemToList(int index);
+    static CThumbnail* _loadModelThumbnailViaScene(const char* pathAndFilename,int& result,C7Vector& modelTr,C3Vector& modelBoundingBoxSize,float& modelNonDefaultTranslationStepSize);
+    static bool _readThumbnailChunks(CSer& ar,CThumbnail* thumbnail,C7Vector& modelTr,C3Vector& modelBoundingBoxSize,float& modelNonDefaultTranslationStepSize);
 
     std::string _folderPath;
     std::vector<SModelThumbnailInfo> _allThumbnailsInfo;
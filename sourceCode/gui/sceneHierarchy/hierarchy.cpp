@@ -43,6 +43,8 @@ void CHierarchy::removeAll()
     for (int i=0;i<int(rootElements.size());i++)
         delete rootElements[i];
     rootElements.clear();
+    _objectElements.clear();
+    _changedObjects.clear();
     refreshViewFlag=App::userSettings->hierarchyRefreshCnt;
     rebuildHierarchyFlag=true;
     resetViewFlag=true;
@@ -92,6 +94,8 @@ void CHierarchy::rebuildHierarchy()
     for (size_t i=0;i<rootElements.size();i++)
         delete rootElements[i];
     rootElements.clear();
+    _objectElements.clear();
+    _changedObjects.clear();
 
     if (App::getEditModeType()==NO_EDIT_MODE)
     {
@@ -113,6 +117,7 @@ void CHierarchy::rebuildHierarchy()
         std::string sceneName=App::currentWorld->mainSettings->getSceneName();
         newEl->setSceneName(sceneName.c_str());
         rootElements.push_back(newEl);
+        _registerElements(newEl);
     }
     if (App::getEditModeType()&VERTEX_EDIT_MODE)
     {
@@ -145,6 +150,121 @@ void CHierarchy::rebuildHierarchy()
     refreshViewFlag=App::userSettings->hierarchyRefreshCnt;
 }
 
+void CHierarchy::_updateHierarchy()
+{ // Only the elements of the objects that changed are moved, created or destroyed
+    if ( (App::getEditModeType()!=NO_EDIT_MODE)||(rootElements.size()!=1)||(rootElements[0]->getLinkedObjectID()!=-App::worldContainer->getCurrentWorldIndex()-1) )
+    {
+        rebuildHierarchy();
+        return;
+    }
+    for (std::set<int>::iterator itr=_changedObjects.begin();itr!=_changedObjects.end();itr++)
+    { // an object without element that has children (e.g. re-parented out of a hidden model child) needs its whole subtree built
+        CSceneObject* obj=App::currentWorld->sceneObjects->getObjectFromHandle(*itr);
+        if ( (obj!=nullptr)&&(obj->getChildCount()>0)&&(_objectElements.find(*itr)==_objectElements.end()) )
+        {
+            rebuildHierarchy();
+            return;
+        }
+    }
+    CHierarchyElement* worldElement=rootElements[0];
+    std::string sceneName=App::currentWorld->mainSettings->getSceneName();
+    worldElement->setSceneName(sceneName.c_str());
+
+    // 1. Detach the elements of changed objects, and create the elements of new objects:
+    std::vector<CHierarchyElement*> toPlace;
+    std::vector<CHierarchyElement*> removed;
+    for (std::set<int>::iterator itr=_changedObjects.begin();itr!=_changedObjects.end();itr++)
+    {
+        CSceneObject* obj=App::currentWorld->sceneObjects->getObjectFromHandle(*itr);
+        std::map<int,CHierarchyElement*>::iterator elIt=_objectElements.find(*itr);
+        if (elIt!=_objectElements.end())
+        {
+            elIt->second->removeFromParent();
+            if (obj!=nullptr)
+                toPlace.push_back(elIt->second);
+            else
+            {
+                removed.push_back(elIt->second);
+                _objectElements.erase(elIt);
+            }
+        }
+        else
+        {
+            if (obj!=nullptr)
+            {
+                CHierarchyElement* el=new CHierarchyElement(*itr);
+                _objectElements[*itr]=el;
+                toPlace.push_back(el);
+            }
+        }
+    }
+    _changedObjects.clear();
+
+    // 2. Elements of removed objects go. Their remaining children have to be placed again:
+    for (size_t i=0;i<removed.size();i++)
+    {
+        CHierarchyElement* el=removed[i];
+        while (el->children.size()>0)
+        {
+            CHierarchyElement* child=el->children[0];
+            child->removeFromParent();
+            if (App::currentWorld->sceneObjects->getObjectFromHandle(child->getLinkedObjectID())!=nullptr)
+                toPlace.push_back(child);
+            else
+                _removeElementTree(child);
+        }
+        delete el;
+    }
+
+    // 3. Place the elements under the element of their object's parent (if it has one):
+    for (size_t i=0;i<toPlace.size();i++)
+    {
+        CHierarchyElement* el=toPlace[i];
+        CSceneObject* obj=App::currentWorld->sceneObjects->getObjectFromHandle(el->getLinkedObjectID());
+        CHierarchyElement* parentEl=nullptr;
+        if (obj->getParent()==nullptr)
+            parentEl=worldElement;
+        else
+        {
+            if (!obj->hiddenInSceneHierarchy())
+            {
+                std::map<int,CHierarchyElement*>::iterator parentIt=_objectElements.find(obj->getParent()->getObjectHandle());
+                if (parentIt!=_objectElements.end())
+                    parentEl=parentIt->second;
+            }
+        }
+        if (parentEl!=nullptr)
+            parentEl->addChild(el);
+        else
+            _removeElementTree(el); // not displayed
+    }
+    worldElement->computeNumberOfElements();
+    refreshViewFlag=App::userSettings->hierarchyRefreshCnt;
+}
+
+void CHierarchy::_registerElements(CHierarchyElement* element)
+{
+    if (element->getLinkedObjectID()>=0)
+        _objectElements[element->getLinkedObjectID()]=element;
+    for (size_t i=0;i<element->children.size();i++)
+        _registerElements(element->children[i]);
+}
+
+void CHierarchy::_removeElementTree(CHierarchyElement* element)
+{
+    std::vector<CHierarchyElement*> toExplore;
+    toExplore.push_back(element);
+    while (toExplore.size()>0)
+    {
+        CHierarchyElement* el=toExplore.back();
+        toExplore.pop_back();
+        _objectElements.erase(el->getLinkedObjectID());
+        toExplore.insert(toExplore.end(),el->children.begin(),el->children.end());
+    }
+    element->removeFromParent();
+    delete element;
+}
+
 void CHierarchy::looseFocus()
 {
     refreshViewFlag=App::userSettings->hierarchyRefreshCnt;
@@ -294,9 +414,12 @@ bool CHierarchy::render()
     TRACE_INTERNAL;
     if (viewPosition[0]<-20000) // From -2000 to -20000 on 3/4/2011 // somehow there is a bug I can't put the finger on right now (2009/12/16)
         viewPosition[0]=0;
-    if (rebuildHierarchyFlag)
+    if ( rebuildHierarchyFlag||(_changedObjects.size()>0) )
     {
-        rebuildHierarchy();
+        if (rebuildHierarchyFlag)
+            rebuildHierarchy();
+        else
+            _updateHierarchy();
         if (App::mainWindow->sceneHierarchyWidget->isVisible())
             App::mainWindow->sceneHierarchyWidget->rebuild();
     }
@@ -1342,6 +1465,12 @@ void CHierarchy::setRebuildHierarchyFlag()
     refreshViewFlag=App::userSettings->hierarchyRefreshCnt;
 }
 
+void CHierarchy::setObjectChangedFlag(int objectHandle)
+{
+    _changedObjects.insert(objectHandle);
+    refreshViewFlag=App::userSettings->hierarchyRefreshCnt;
+}
+
 void CHierarchy::setResetViewFlag()
 {
     resetViewFlag=true;
@@ -1614,6 +1743,9 @@ bool CHierarchy::processCommand(int commandID)
 void CHierarchy::_drawLinesLinkingDummies(int maxRenderedPos[2])
 {
     std::vector<int> positions; // contains only objects that have a dummy linking to another, as child (or the dummy itself)
+    std::map<int,size_t> lineIndices; // object handle to its first index in the lineLastPosition list
+    for (size_t j=0;j<lineLastPosition.size()/3;j++)
+        lineIndices.insert(std::make_pair(lineLastPosition[3*j+2],j));
     for (size_t i=0;i<App::currentWorld->sceneObjects->getDummyCount();i++)
     {
         CDummy* dummy=App::currentWorld->sceneObjects->getDummyFromIndex(i);
@@ -1626,25 +1758,23 @@ void CHierarchy::_drawLinesLinkingDummies(int maxRenderedPos[2])
             while ( (!found)&&(obj!=nullptr) )
             {
                 int idToSearch=obj->getObjectHandle();
-                for (size_t j=0;j<lineLastPosition.size()/3;j++)
-                {
-                    if (idToSearch==lineLastPosition[3*j+2])
-                    { // we found a pos
-                        positions.push_back(lineLastPosition[3*j+0]);
-                        positions.push_back(lineLastPosition[3*j+1]);
-                        positions.push_back(dummyID);
-                        positions.push_back(linkedDummyID);
-                        positions.push_back(j); // index in the lineLastPosition list
-                        int wv=0;
-                        if (dummyID==idToSearch)
-                            wv|=1; // the dummy is visible (otherwise it is not visible (built on a collapsed item))
-                        if (App::currentWorld->sceneObjects->isObjectSelected(dummyID)||App::currentWorld->sceneObjects->isObjectSelected(linkedDummyID))
-                            wv|=2; // one of the dummies is selected
-                        positions.push_back(wv);
-                        positions.push_back(dummy->getLinkType());
-                        found=true;
-                        break;
-                    }
+                std::map<int,size_t>::iterator lineIt=lineIndices.find(idToSearch);
+                if (lineIt!=lineIndices.end())
+                { // we found a pos
+                    size_t j=lineIt->second;
+                    positions.push_back(lineLastPosition[3*j+0]);
+                    positions.push_back(lineLastPosition[3*j+1]);
+                    positions.push_back(dummyID);
+                    positions.push_back(linkedDummyID);
+                    positions.push_back(j); // index in the lineLastPosition list
+                    int wv=0;
+                    if (dummyID==idToSearch)
+                        wv|=1; // the dummy is visible (otherwise it is not visible (built on a collapsed item))
+                    if (App::currentWorld->sceneObjects->isObjectSelected(dummyID)||App::currentWorld->sceneObjects->isObjectSelected(linkedDummyID))
+                        wv|=2; // one of the dummies is selected
+                    positions.push_back(wv);
+                    positions.push_back(dummy->getLinkType());
+                    found=true;
                 }
                 if (!found)
                     obj=obj->getParent();
@@ -4,6 +4,8 @@
 
 #include "hierarchyElement.h"
 #include "vMenubar.h"
+#include <map>
+#include <set>
 
 class CHierarchy  
 {
@@ -27,6 +29,7 @@ public:
     void validateViewPosition();
 
     void setRebuildHierarchyFlag();
+    void setObjectChangedFlag(int objectHandle); // object was added, removed, renamed or got a new parent. Only its element is updated
     void setRefreshViewFlag();
     void setResetViewFlag();
 
@@ -69,7 +72,13 @@ public:
     int editionTextEditPos;
 
 private:
+    void _updateHierarchy();
+    void _registerElements(CHierarchyElement* element);
+    void _removeElementTree(CHierarchyElement* element);
+
     int _caughtElements;
+    std::map<int,CHierarchyElement*> _objectElements; // scene object handle to its element, when not in an edit mode
+    std::set<int> _changedObjects;
     int renderingSize[2];
     int renderingPosition[2];
     std::vector<CHierarchyElement*> rootElements;
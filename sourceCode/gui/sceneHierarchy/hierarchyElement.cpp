@@ -8,13 +8,18 @@
 #include "tt.h"
 #include "mesh.h"
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
 
 const int CONST_VAL_6=6;
 
 CHierarchyElement::CHierarchyElement(int theObjectID)
 {
     children.clear();
+    parentElement=nullptr;
     objectID=theObjectID;
+    numberOfElements=1;
+    _renderOrderAlphabetical=false;
+    _lineWidth=-1;
 }
 
 CHierarchyElement::~CHierarchyElement()
@@ -72,6 +77,7 @@ void CHierarchyElement::addYourChildren()
             {
                 CHierarchyElement* aKid=new CHierarchyElement(objIDs[i]);
                 aKid->addYourChildren();
+                aKid->parentElement=this;
                 children.push_back(aKid);
             }
         }
@@ -94,6 +100,7 @@ void CHierarchyElement::addYourChildren()
                 {
                     CHierarchyElement* aKid=new CHierarchyElement(objIDs[i]);
                     aKid->addYourChildren();
+                    aKid->parentElement=this;
                     children.push_back(aKid);
                 }
 #else
@@ -111,6 +118,7 @@ void CHierarchyElement::addYourChildren()
                 {
                     CHierarchyElement* aKid=new CHierarchyElement(objIDs[i]);
                     aKid->addYourChildren();
+                    aKid->parentElement=this;
                     children.push_back(aKid);
                 }
 #endif
@@ -120,6 +128,49 @@ void CHierarchyElement::addYourChildren()
     // Nothing needed for the various edit modes (for now!)
 }
 
+void CHierarchyElement::addChild(CHierarchyElement* child)
+{
+    std::string name(child->_getSortName());
+    size_t low=0;
+    size_t high=children.size();
+    while (low<high)
+    {
+        size_t mid=(low+high)/2;
+        if (name<children[mid]->_getSortName())
+            high=mid;
+        else
+            low=mid+1;
+    }
+    children.insert(children.begin()+low,child);
+    child->parentElement=this;
+}
+
+void CHierarchyElement::removeFromParent()
+{
+    if (parentElement!=nullptr)
+    {
+        for (size_t i=0;i<parentElement->children.size();i++)
+        {
+            if (parentElement->children[i]==this)
+            {
+                parentElement->children.erase(parentElement->children.begin()+i);
+                break;
+            }
+        }
+        parentElement=nullptr;
+    }
+    _lineWidth=-1; // e.g. the object was renamed
+}
+
+std::string CHierarchyElement::_getSortName() const
+{
+    std::string retVal;
+    CSceneObject* it=App::currentWorld->sceneObjects->getObjectFromHandle(objectID);
+    if (it!=nullptr)
+        retVal=tt::getLowerUpperCaseString(it->getObjectName(),false);
+    return(retVal);
+}
+
 int CHierarchyElement::getLinkedObjectID()
 {
     return(objectID);
@@ -507,6 +558,20 @@ void CHierarchyElement::renderElement_sceneObject(CHierarchy* hier,int labelEdit
 
     bool textInside=(textPos[1]<renderingSize[1]+HIERARCHY_INTER_LINE_SPACE*App::sc);
     CSceneObject* it=App::currentWorld->sceneObjects->getObjectFromHandle(objectID);
+
+    if ( (!forDragAndDrop)&&(dontDisplay||(!textInside))&&(it!=nullptr)&&(_lineWidth>=0) )
+    { // The row is outside of the view: we only need its layout. The line width is the one measured when the row was last laid out
+        int lineLastPos=textPos[0]+_lineWidth;
+        if (lineLastPos>maxRenderedPos[0])
+            maxRenderedPos[0]=lineLastPos;
+        hier->lineLastPosition.push_back(lineLastPos);
+        hier->lineLastPosition.push_back(textPos[1]+HIERARCHY_TEXT_CENTER_OFFSET*App::sc);
+        hier->lineLastPosition.push_back(objectID);
+        textPos[1]=textPos[1]-HIERARCHY_INTER_LINE_SPACE*App::sc;
+        if ((it->getLocalObjectProperty()&sim_objectproperty_collapsed)==0)
+            _renderChildren_sceneObject(hier,labelEditObjectID,bright,dontDisplay,renderingSize,textPos,indentNb,vertLines,minRenderedPos,maxRenderedPos,forDragAndDrop,transparentForTreeObjects,dropID);
+        return;
+    }
     std::string theText;
     if (it!=nullptr)
         theText=it->getObjectName();
@@ -872,6 +937,7 @@ void CHierarchyElement::renderElement_sceneObject(CHierarchy* hier,int labelEdit
             hier->lineLastPosition.push_back(it->getObjectHandle());
         else
             hier->lineLastPosition.push_back(-1);
+        _lineWidth=lineLastPos-textPos[0];
     }
 
 
@@ -896,68 +962,60 @@ void CHierarchyElement::renderElement_sceneObject(CHierarchy* hier,int labelEdit
 
 
     if ( ( (it!=nullptr)&&((it->getLocalObjectProperty()&sim_objectproperty_collapsed)==0) )||(objectID<0) )
-    {
-        int xPosCopy=textPos[0];
-        textPos[0]=textPos[0]+horizontalShift;
-        int indentCopy=indentNb+1;
+        _renderChildren_sceneObject(hier,labelEditObjectID,bright,dontDisplay,renderingSize,textPos,indentNb,vertLines,minRenderedPos,maxRenderedPos,forDragAndDrop,transparentForTreeObjects,dropID);
+}
 
-        ogl::setMaterialColor(sim_colorcomponent_emission,ogl::HIERARCHY_AND_BROWSER_LINE_COLOR);
+void CHierarchyElement::_renderChildren_sceneObject(CHierarchy* hier,int labelEditObjectID,bool& bright,bool dontDisplay,
+        int renderingSize[2],int textPos[2],int indentNb,std::vector<int>* vertLines,int minRenderedPos[2],int maxRenderedPos[2],
+        bool forDragAndDrop,int transparentForTreeObjects,int dropID)
+{
+    const unsigned char horizontalShift=13*App::sc;
+    int xPosCopy=textPos[0];
+    textPos[0]=textPos[0]+horizontalShift;
+    int indentCopy=indentNb+1;
 
-        std::vector<CHierarchyElement*> el;
-        std::vector<int> elNb;
+    ogl::setMaterialColor(sim_colorcomponent_emission,ogl::HIERARCHY_AND_BROWSER_LINE_COLOR);
 
-        for (int i=0;i<int(children.size());i++)
-        { // This is needed to order the elements from least sub-elements to most sub-elements
-            int els=children[i]->getNumberOfElements();
-            if (App::userSettings->orderHierarchyAlphabetically)
-                els=1;
-            int j;
-            for (j=0;j<int(elNb.size());j++)
-            {
-                if (els<elNb[j])
-                    break;
-            }
-            elNb.insert(elNb.begin()+j,els);
-            el.insert(el.begin()+j,children[i]);
-        }
+    if ( (_renderOrder.size()!=children.size())||(_renderOrderAlphabetical!=App::userSettings->orderHierarchyAlphabetically) )
+        _updateRenderOrder();
+    const std::vector<CHierarchyElement*>& el=_renderOrder;
 
-        for (int i=0;i<int(el.size());i++)
-        {
-            if (i!=int(el.size())-1)
-            { // Vertical line going through (a T turned counter-clockwise)
-                vertLines->push_back(indentNb);
-                int txtYTmp=textPos[1];
-                el[i]->renderElement_sceneObject(hier,labelEditObjectID,bright,dontDisplay,
-                                            renderingSize,textPos,indentCopy,
-                                            vertLines,minRenderedPos,maxRenderedPos,forDragAndDrop,transparentForTreeObjects,dropID);
-                vertLines->erase(vertLines->end()-1);
-                if ((!dontDisplay)&&(!forDragAndDrop))
+    for (int i=0;i<int(el.size());i++)
+    {
+        int txtYTmp=textPos[1];
+        bool rowInView=(txtYTmp>=-HIERARCHY_INTER_LINE_SPACE*App::sc)&&(txtYTmp<renderingSize[1]+HIERARCHY_INTER_LINE_SPACE*App::sc);
+        if (i!=int(el.size())-1)
+        { // Vertical line going through (a T turned counter-clockwise)
+            vertLines->push_back(indentNb);
+            el[i]->renderElement_sceneObject(hier,labelEditObjectID,bright,dontDisplay,
+                                        renderingSize,textPos,indentCopy,
+                                        vertLines,minRenderedPos,maxRenderedPos,forDragAndDrop,transparentForTreeObjects,dropID);
+            vertLines->erase(vertLines->end()-1);
+            if ((!dontDisplay)&&(!forDragAndDrop)&&rowInView)
+            {
+                if (el[i]->children.size()==0) //-//
                 {
-                    if (el[i]->children.size()==0) //-//
-                    {
-                        ogl::drawSingle2dLine_i(xPosCopy+10*App::sc,txtYTmp+(HIERARCHY_TEXT_CENTER_OFFSET+HIERARCHY_HALF_INTER_LINE_SPACE)*App::sc,xPosCopy+10*App::sc,txtYTmp+(HIERARCHY_TEXT_CENTER_OFFSET-HIERARCHY_HALF_INTER_LINE_SPACE)*App::sc);
-                        ogl::drawSingle2dLine_i(xPosCopy+10*App::sc,txtYTmp+HIERARCHY_TEXT_CENTER_OFFSET*App::sc,xPosCopy+17*App::sc,txtYTmp+HIERARCHY_TEXT_CENTER_OFFSET*App::sc);
-                    }
+                    ogl::drawSingle2dLine_i(xPosCopy+10*App::sc,txtYTmp+(HIERARCHY_TEXT_CENTER_OFFSET+HIERARCHY_HALF_INTER_LINE_SPACE)*App::sc,xPosCopy+10*App::sc,txtYTmp+(HIERARCHY_TEXT_CENTER_OFFSET-HIERARCHY_HALF_INTER_LINE_SPACE)*App::sc);
+                    ogl::drawSingle2dLine_i(xPosCopy+10*App::sc,txtYTmp+HIERARCHY_TEXT_CENTER_OFFSET*App::sc,xPosCopy+17*App::sc,txtYTmp+HIERARCHY_TEXT_CENTER_OFFSET*App::sc);
                 }
             }
-            else
-            { // Vertical line stopping in the middle (L)
-                int txtYTmp=textPos[1];
-                el[i]->renderElement_sceneObject(hier,labelEditObjectID,bright,dontDisplay,
-                                            renderingSize,textPos,indentCopy,
-                                            vertLines,minRenderedPos,maxRenderedPos,forDragAndDrop,transparentForTreeObjects,dropID);
-                if ((!dontDisplay)&&(!forDragAndDrop))
+        }
+        else
+        { // Vertical line stopping in the middle (L)
+            el[i]->renderElement_sceneObject(hier,labelEditObjectID,bright,dontDisplay,
+                                        renderingSize,textPos,indentCopy,
+                                        vertLines,minRenderedPos,maxRenderedPos,forDragAndDrop,transparentForTreeObjects,dropID);
+            if ((!dontDisplay)&&(!forDragAndDrop)&&rowInView)
+            {
+                if (el[i]->children.size()==0) //-//
                 {
-                    if (el[i]->children.size()==0) //-//
-                    {
-                        ogl::drawSingle2dLine_i(xPosCopy+10*App::sc,txtYTmp+(HIERARCHY_TEXT_CENTER_OFFSET+HIERARCHY_HALF_INTER_LINE_SPACE)*App::sc,xPosCopy+10*App::sc,txtYTmp+HIERARCHY_TEXT_CENTER_OFFSET*App::sc);
-                        ogl::drawSingle2dLine_i(xPosCopy+10*App::sc,txtYTmp+HIERARCHY_TEXT_CENTER_OFFSET*App::sc,xPosCopy+17*App::sc,txtYTmp+HIERARCHY_TEXT_CENTER_OFFSET*App::sc);
-                    }
+                    ogl::drawSingle2dLine_i(xPosCopy+10*App::sc,txtYTmp+(HIERARCHY_TEXT_CENTER_OFFSET+HIERARCHY_HALF_INTER_LINE_SPACE)*App::sc,xPosCopy+10*App::sc,txtYTmp+HIERARCHY_TEXT_CENTER_OFFSET*App::sc);
+                    ogl::drawSingle2dLine_i(xPosCopy+10*App::sc,txtYTmp+HIERARCHY_TEXT_CENTER_OFFSET*App::sc,xPosCopy+17*App::sc,txtYTmp+HIERARCHY_TEXT_CENTER_OFFSET*App::sc);
                 }
             }
         }
-        textPos[0]=xPosCopy;
     }
+    textPos[0]=xPosCopy;
 }
 #endif
 
@@ -1512,7 +1570,16 @@ int CHierarchyElement::computeNumberOfElements()
         children[i]->computeNumberOfElements();
         numberOfElements=numberOfElements+children[i]->getNumberOfElements();
     }
+    _updateRenderOrder();
     return(numberOfElements);
 }
 
+void CHierarchyElement::_updateRenderOrder()
+{ // from least to most sub-elements. Elements with the same count keep their alphabetical order
+    _renderOrder=children;
+    _renderOrderAlphabetical=App::userSettings->orderHierarchyAlphabetically;
+    if (!_renderOrderAlphabetical)
+        std::stable_sort(_renderOrder.begin(),_renderOrder.end(),[](CHierarchyElement* a,CHierarchyElement* b){ return(a->getNumberOfElements()<b->getNumberOfElements()); });
+}
+
 
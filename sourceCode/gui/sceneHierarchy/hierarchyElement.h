@@ -23,6 +23,8 @@ public:
     CHierarchyElement(int theObjectID);
     virtual ~CHierarchyElement();
     void addYourChildren();
+    void addChild(CHierarchyElement* child); // keeps the children ordered like addYourChildren does
+    void removeFromParent();
     int getLinkedObjectID();
     int getNumberOfElements();
     int computeNumberOfElements();
@@ -39,6 +41,7 @@ public:
     bool isLocalWorld();
 
     std::vector<CHierarchyElement*> children;
+    CHierarchyElement* parentElement;
 
 private:
 #ifdef KEYWORD__NOT_DEFINED_FORMELY_XR
@@ -46,9 +49,17 @@ private:
 #else
     int _drawIcon_sceneObject(CHierarchy* hier,int tPosX,int tPosY,CSceneObject* it,int pictureID,bool drawIt,float transparencyFactor,bool forDragAndDrop);
 #endif
+    void _renderChildren_sceneObject(CHierarchy* hier,int labelEditObjectID,bool& bright,bool dontDisplay,
+        int renderingSize[2],int textPos[2],int indentNb,std::vector<int>* vertLines,int minRenderedPos[2],int maxRenderedPos[2],
+        bool forDragAndDrop,int transparentForTreeObjects,int dropID);
+    void _updateRenderOrder();
+    std::string _getSortName() const;
     int _drawIcon_editModeList(CHierarchy* hier,int tPosX,int tPosY,int pictureID,bool drawIt);
     void _drawTexturedIcon(int tPosX,int tPosY,int sizeX,int sizeY,float transparencyFactor);
     int objectID;
     std::string _sceneName;
     int numberOfElements;
+    std::vector<CHierarchyElement*> _renderOrder; // the children, from least to most sub-elements. Updated in computeNumberOfElements
+    bool _renderOrderAlphabetical;
+    int _lineWidth; // as measured when the row was last laid out. -1 if unknown
 };
@@ -311,7 +311,47 @@ CInterfaceStackTable* CInterfaceStack::_generateTableArrayFromLuaStack(luaWrap_l
 { // there must be a table at the given index.
     CInterfaceStackTable* table=new CInterfaceStackTable();
     int arraySize=int(luaWrap_lua_rawlen(L,index));
-    for (int i=0;i<arraySize;i++)
+    // Purely numeric arrays (e.g. point clouds, images) are collected into a packed buffer:
+    std::vector<double> numbers;
+    std::vector<int> integers;
+    int i=0;
+    while (i<arraySize)
+    {
+        luaWrap_lua_rawgeti(L,index,i+1);
+        int t=luaWrap_lua_stype(L,-1);
+        if ( (t==STACK_OBJECT_NUMBER)&&(integers.size()==0) )
+            numbers.push_back(luaWrap_lua_tonumber(L,-1));
+        else if ( (t==STACK_OBJECT_INTEGER)&&(numbers.size()==0) )
+        {
+            luaWrap_lua_Integer v=luaWrap_lua_tointeger(L,-1);
+            if (v!=(luaWrap_lua_Integer)((int)v))
+            {
+                luaWrap_lua_pop(L,1);
+                break;
+            }
+            integers.push_back((int)v);
+        }
+        else
+        {
+            luaWrap_lua_pop(L,1);
+            break;
+        }
+        luaWrap_lua_pop(L,1);
+        i++;
+    }
+    if ( (i==arraySize)&&(i>0) )
+    {
+        if (numbers.size()>0)
+            table->setDoubleArray(&numbers[0],arraySize);
+        else
+            table->setInt32Array(&integers[0],arraySize);
+        return(table);
+    }
+    for (size_t j=0;j<numbers.size();j++)
+        table->appendArrayObject(new CInterfaceStackNumber(numbers[j]));
+    for (size_t j=0;j<integers.size();j++)
+        table->appendArrayObject(new CInterfaceStackInteger(integers[j]));
+    for (;i<arraySize;i++)
     {
         // Push the element i+1 of the table to the top of Lua's stack:
         luaWrap_lua_rawgeti(L,index,i+1);
@@ -370,6 +410,18 @@ CInterfaceStackObject* CInterfaceStack::_generateObjectFromLuaStack(luaWrap_lua_
     }
     else
     { // following types translate to strings (i.e. can't be handled outside of the Lua state)
+        if (t==STACK_OBJECT_USERDAT)
+        { // except for packed arrays, which are transferred as a single block:
+            int arrayType,count;
+            void* data=luaWrap_toPackedArray(L,index,&arrayType,&count);
+            if (data!=nullptr)
+            {
+                CInterfaceStackTable* table=new CInterfaceStackTable();
+                table->setPackedArray(arrayType,data,count);
+                table->setPackedAsLuaUserdata(true);
+                return(table);
+            }
+        }
         void* p=(void*)luaWrap_lua_topointer(L,index);
         char num[21];
         snprintf(num,20,"%p",p);
@@ -423,6 +475,19 @@ void CInterfaceStack::buildOntoLuaStack(luaWrap_lua_State* L,bool takeOnlyTop) c
     }
 }
 
+void CInterfaceStack::_pushNumberOntoLuaStack(luaWrap_lua_State* L,double v) const
+{
+#ifdef LUA_STACK_COMPATIBILITY_MODE
+    luaWrap_lua_Integer w=(luaWrap_lua_Integer)v;
+    if (v==(double)w)
+        luaWrap_lua_pushinteger(L,w);
+    else
+        luaWrap_lua_pushnumber(L,v);
+#else
+    luaWrap_lua_pushnumber(L,v);
+#endif
+}
+
 void CInterfaceStack::_pushOntoLuaStack(luaWrap_lua_State* L,CInterfaceStackObject* obj) const
 {
     int t=obj->getObjectType();
@@ -431,18 +496,7 @@ void CInterfaceStack::_pushOntoLuaStack(luaWrap_lua_State* L,CInterfaceStackObje
     else if (t==STACK_OBJECT_BOOL)
         luaWrap_lua_pushboolean(L,((CInterfaceStackBool*)obj)->getValue());
     else if (t==STACK_OBJECT_NUMBER)
-    {
-#ifdef LUA_STACK_COMPATIBILITY_MODE
-        double v=((CInterfaceStackNumber*)obj)->getValue();
-        luaWrap_lua_Integer w=(luaWrap_lua_Integer)v;
-        if (v==(double)w)
-            luaWrap_lua_pushinteger(L,w);
-        else
-            luaWrap_lua_pushnumber(L,v);
-#else
-        luaWrap_lua_pushnumber(L,((CInterfaceStackNumber*)obj)->getValue());
-#endif
-    }
+        _pushNumberOntoLuaStack(L,((CInterfaceStackNumber*)obj)->getValue());
     else if (t==STACK_OBJECT_INTEGER)
         luaWrap_lua_pushinteger(L,((CInterfaceStackInteger*)obj)->getValue());
     else if (t==STACK_OBJECT_STRING)
@@ -453,8 +507,29 @@ void CInterfaceStack::_pushOntoLuaStack(luaWrap_lua_State* L,CInterfaceStackObje
     }
     else if (t==STACK_OBJECT_TABLE)
     {
-        luaWrap_lua_newtable(L);
         CInterfaceStackTable* table=(CInterfaceStackTable*)obj;
+        int packedType,cnt;
+        const unsigned char* data=(const unsigned char*)table->getPackedArrayData(packedType,cnt);
+        if (data!=nullptr)
+        {
+            if ( table->getPackedAsLuaUserdata()&&luaWrap_pushPackedArray(L,packedType,data,cnt) )
+                return;
+            luaWrap_lua_createtable(L,cnt,0);
+            for (int i=0;i<cnt;i++)
+            {
+                if (packedType==PACKED_ARRAY_UINT8)
+                    luaWrap_lua_pushinteger(L,data[i]);
+                else if (packedType==PACKED_ARRAY_INT32)
+                    luaWrap_lua_pushinteger(L,((const int*)data)[i]);
+                else if (packedType==PACKED_ARRAY_FLOAT32)
+                    _pushNumberOntoLuaStack(L,((const float*)data)[i]);
+                else
+                    _pushNumberOntoLuaStack(L,((const double*)data)[i]);
+                luaWrap_lua_rawseti(L,-2,i+1);
+            }
+            return;
+        }
+        luaWrap_lua_newtable(L);
         if (table->isTableArray())
         { // array-type table
             for (int i=0;i<table->getArraySize();i++)
@@ -562,6 +637,17 @@ bool CInterfaceStack::getStackDoubleArray(double* array,int count) const
     return(table->getDoubleArray(array,count));
 }
 
+const void* CInterfaceStack::getStackPackedArray(int& arrayType,int& count) const
+{ // returns the packed buffer of the top item, or nullptr if that item is not a packed array
+    if (_stackObjects.size()==0)
+        return(nullptr);
+    CInterfaceStackObject* obj=_stackObjects[_stackObjects.size()-1];
+    if (obj->getObjectType()!=STACK_OBJECT_TABLE)
+        return(nullptr);
+    CInterfaceStackTable* table=(CInterfaceStackTable*)obj;
+    return(table->getPackedArrayData(arrayType,count));
+}
+
 bool CInterfaceStack::getStackMapFloatArray(const char* fieldName,float* array,int count) const
 {
     const CInterfaceStackObject* obj=getStackMapObject(fieldName);
@@ -788,6 +874,14 @@ void CInterfaceStack::pushDoubleArrayTableOntoStack(const double* arr,int l)
     _stackObjects.push_back(table);
 }
 
+void CInterfaceStack::pushPackedArrayTableOntoStack(int arrayType,const void* data,int l,bool asLuaUserdata)
+{ // asLuaUserdata: the array is handed to Lua as a userdata-backed array, i.e. without individual table entries
+    CInterfaceStackTable* table=new CInterfaceStackTable();
+    table->setPackedArray(arrayType,data,l);
+    table->setPackedAsLuaUserdata(asLuaUserdata);
+    _stackObjects.push_back(table);
+}
+
 void CInterfaceStack::pushTableOntoStack()
 {
     _stackObjects.push_back(new CInterfaceStackTable());
@@ -33,6 +33,7 @@ public:
     void pushInt64ArrayTableOntoStack(const luaWrap_lua_Integer* arr,int l);
     void pushFloatArrayTableOntoStack(const float* arr,int l);
     void pushDoubleArrayTableOntoStack(const double* arr,int l);
+    void pushPackedArrayTableOntoStack(int arrayType,const void* data,int l,bool asLuaUserdata);
     void pushTableOntoStack();
     bool insertDataIntoStackTable();
     bool pushTableFromBuffer(const char* data,unsigned int l);
@@ -57,6 +58,7 @@ public:
     bool getStackInt64Array(luaWrap_lua_Integer* array,int count) const;
     bool getStackFloatArray(float* array,int count) const;
     bool getStackDoubleArray(double* array,int count) const;
+    const void* getStackPackedArray(int& arrayType,int& count) const;
     bool unfoldStackTable();
     CInterfaceStackObject* getStackMapObject(const char* fieldName) const;
     bool getStackMapBoolValue(const char* fieldName,bool& val) const;
@@ -79,6 +81,7 @@ protected:
     int _countLuaStackTableEntries(luaWrap_lua_State* L,int index);
 
     void _pushOntoLuaStack(luaWrap_lua_State* L,CInterfaceStackObject* obj) const;
+    void _pushNumberOntoLuaStack(luaWrap_lua_State* L,double v) const;
 
     int _interfaceStackId;
     std::vector<CInterfaceStackObject*> _stackObjects;
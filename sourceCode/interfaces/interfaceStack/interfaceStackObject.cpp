@@ -5,6 +5,99 @@
 #include "interfaceStackBool.h"
 #include "interfaceStackString.h"
 #include "interfaceStackTable.h"
+#include <vector>
+#include <atomic>
+
+#define INTERFACESTACK_POOL_GRANULARITY 8
+#define INTERFACESTACK_POOL_BUCKETS 16 // i.e. objects up to 120 bytes are pooled
+#define INTERFACESTACK_POOL_MAX_FREE_BLOCKS 4096 // per bucket and thread
+
+struct SInterfaceStackObjectPool;
+static thread_local int _poolState=0; // 0=not yet created, 1=alive, 2=destroyed (thread exiting)
+static std::atomic<bool> _poolingEnabled(true);
+
+struct SInterfaceStackObjectPool
+{
+    SInterfaceStackObjectPool()
+    {
+        allocations=0;
+        recycled=0;
+        _poolState=1;
+    }
+    ~SInterfaceStackObjectPool()
+    {
+        _poolState=2;
+        for (size_t i=0;i<INTERFACESTACK_POOL_BUCKETS;i++)
+        {
+            for (size_t j=0;j<freeBlocks[i].size();j++)
+                ::operator delete(freeBlocks[i][j]);
+        }
+    }
+    std::vector<void*> freeBlocks[INTERFACESTACK_POOL_BUCKETS];
+    unsigned long long allocations;
+    unsigned long long recycled;
+};
+static thread_local SInterfaceStackObjectPool _pool;
+
+void* CInterfaceStackObject::operator new(size_t size)
+{
+    size_t bucket=(size+INTERFACESTACK_POOL_GRANULARITY-1)/INTERFACESTACK_POOL_GRANULARITY;
+    if (bucket>=INTERFACESTACK_POOL_BUCKETS)
+        return(::operator new(size));
+    // Always allocate the full bucket size, so that blocks are interchangeable within a bucket:
+    if ( _poolingEnabled&&(_poolState!=2) )
+    {
+        SInterfaceStackObjectPool& pool=_pool;
+        pool.allocations++;
+        std::vector<void*>& blocks=pool.freeBlocks[bucket];
+        if (blocks.size()>0)
+        {
+            void* p=blocks[blocks.size()-1];
+            blocks.pop_back();
+            pool.recycled++;
+            return(p);
+        }
+    }
+    return(::operator new(bucket*INTERFACESTACK_POOL_GRANULARITY));
+}
+
+void CInterfaceStackObject::operator delete(void* p,size_t size)
+{
+    if (p==nullptr)
+        return;
+    size_t bucket=(size+INTERFACESTACK_POOL_GRANULARITY-1)/INTERFACESTACK_POOL_GRANULARITY;
+    if ( (bucket<INTERFACESTACK_POOL_BUCKETS)&&_poolingEnabled&&(_poolState!=2) )
+    { // blocks freed in another thread than they were allocated simply migrate to that thread's pool
+        std::vector<void*>& blocks=_pool.freeBlocks[bucket];
+        if (blocks.size()<INTERFACESTACK_POOL_MAX_FREE_BLOCKS)
+        {
+            blocks.push_back(p);
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
+void CInterfaceStackObject::setPoolingEnabled(bool enabled)
+{
+    _poolingEnabled=enabled;
+}
+
+bool CInterfaceStackObject::getPoolingEnabled()
+{
+    return(_poolingEnabled);
+}
+
+void CInterfaceStackObject::getPoolStatistics(unsigned long long& allocations,unsigned long long& recycled)
+{
+    allocations=0;
+    recycled=0;
+    if (_poolState!=2)
+    {
+        allocations=_pool.allocations;
+        recycled=_pool.recycled;
+    }
+}
 
 CInterfaceStackObject::CInterfaceStackObject()
 {
@@ -17,6 +17,13 @@ public:
 
     int getObjectType() const;
 
+    // Stack objects are small and short-lived. They are recycled via per-thread free-lists:
+    static void* operator new(size_t size);
+    static void operator delete(void* p,size_t size);
+    static void setPoolingEnabled(bool enabled);
+    static bool getPoolingEnabled();
+    static void getPoolStatistics(unsigned long long& allocations,unsigned long long& recycled); // for the calling thread
+
 protected:
     int _objectType;
 };
@@ -6,12 +6,44 @@
 #include "interfaceStackString.h"
 #include "interfaceStackTable.h"
 #include <algorithm> // std::sort, etc.
+#include <cstring>
+
+template<class T>
+static void _readPackedArray(int arrayType,const unsigned char* data,T* array,size_t count)
+{
+    if (arrayType==PACKED_ARRAY_UINT8)
+    {
+        for (size_t i=0;i<count;i++)
+            array[i]=(T)data[i];
+    }
+    else if (arrayType==PACKED_ARRAY_INT32)
+    {
+        const int* d=(const int*)data;
+        for (size_t i=0;i<count;i++)
+            array[i]=(T)d[i];
+    }
+    else if (arrayType==PACKED_ARRAY_FLOAT32)
+    {
+        const float* d=(const float*)data;
+        for (size_t i=0;i<count;i++)
+            array[i]=(T)d[i];
+    }
+    else if (arrayType==PACKED_ARRAY_FLOAT64)
+    {
+        const double* d=(const double*)data;
+        for (size_t i=0;i<count;i++)
+            array[i]=(T)d[i];
+    }
+}
 
 CInterfaceStackTable::CInterfaceStackTable()
 {
     _objectType=STACK_OBJECT_TABLE;
     _isTableArray=true;
     _isCircularRef=false;
+    _packedType=PACKED_ARRAY_NONE;
+    _packedCount=0;
+    _packedAsLuaUserdata=false;
 }
 
 CInterfaceStackTable::~CInterfaceStackTable()
@@ -29,6 +61,9 @@ int CInterfaceStackTable::getArraySize() const
 {
     if (!_isTableArray)
         return(0);
+    std::lock_guard<std::mutex> lock(_packedMutex);
+    if (_packedType!=PACKED_ARRAY_NONE)
+        return(_packedCount);
     return((int)_tableObjects.size());
 }
 
@@ -54,6 +89,15 @@ bool CInterfaceStackTable::getUCharArray(unsigned char* array,int count) const
 {
     if (!_isTableArray)
         return(false);
+    std::lock_guard<std::mutex> lock(_packedMutex);
+    if (_packedType!=PACKED_ARRAY_NONE)
+    {
+        size_t c=std::min<size_t>(size_t(count),size_t(_packedCount));
+        _readPackedArray(_packedType,&_packedData[0],array,c);
+        for (size_t i=c;i<(size_t)count;i++)
+            array[i]=0; // fill with zeros
+        return(true);
+    }
     bool retVal=true;
     size_t c=(size_t)count;
     if (c>_tableObjects.size())
@@ -80,6 +124,15 @@ bool CInterfaceStackTable::getInt32Array(int* array,int count) const
 {
     if (!_isTableArray)
         return(false);
+    std::lock_guard<std::mutex> lock(_packedMutex);
+    if (_packedType!=PACKED_ARRAY_NONE)
+    {
+        size_t c=std::min<size_t>(size_t(count),size_t(_packedCount));
+        _readPackedArray(_packedType,&_packedData[0],array,c);
+        for (size_t i=c;i<(size_t)count;i++)
+            array[i]=0; // fill with zeros
+        return(true);
+    }
     bool retVal=true;
     size_t c=(size_t)count;
     if (c>_tableObjects.size())
@@ -106,6 +159,15 @@ bool CInterfaceStackTable::getInt64Array(luaWrap_lua_Integer* array,int count) c
 {
     if (!_isTableArray)
         return(false);
+    std::lock_guard<std::mutex> lock(_packedMutex);
+    if (_packedType!=PACKED_ARRAY_NONE)
+    {
+        size_t c=std::min<size_t>(size_t(count),size_t(_packedCount));
+        _readPackedArray(_packedType,&_packedData[0],array,c);
+        for (size_t i=c;i<(size_t)count;i++)
+            array[i]=0; // fill with zeros
+        return(true);
+    }
     bool retVal=true;
     size_t c=(size_t)count;
     if (c>_tableObjects.size())
@@ -132,6 +194,15 @@ bool CInterfaceStackTable::getFloatArray(float* array,int count) const
 {
     if (!_isTableArray)
         return(false);
+    std::lock_guard<std::mutex> lock(_packedMutex);
+    if (_packedType!=PACKED_ARRAY_NONE)
+    {
+        size_t c=std::min<size_t>(size_t(count),size_t(_packedCount));
+        _readPackedArray(_packedType,&_packedData[0],array,c);
+        for (size_t i=c;i<(size_t)count;i++)
+            array[i]=0; // fill with zeros
+        return(true);
+    }
     bool retVal=true;
     size_t c=(size_t)count;
     if (c>_tableObjects.size())
@@ -158,6 +229,15 @@ bool CInterfaceStackTable::getDoubleArray(double* array,int count) const
 {
     if (!_isTableArray)
         return(false);
+    std::lock_guard<std::mutex> lock(_packedMutex);
+    if (_packedType!=PACKED_ARRAY_NONE)
+    {
+        size_t c=std::min<size_t>(size_t(count),size_t(_packedCount));
+        _readPackedArray(_packedType,&_packedData[0],array,c);
+        for (size_t i=c;i<(size_t)count;i++)
+            array[i]=0; // fill with zeros
+        return(true);
+    }
     bool retVal=true;
     size_t c=(size_t)count;
     if (c>_tableObjects.size())
@@ -284,11 +364,13 @@ bool CInterfaceStackTable::removeFromKey(const CInterfaceStackObject* keyToRemov
 
 void CInterfaceStackTable::appendArrayObject(CInterfaceStackObject* obj)
 {
+    _unpack();
     _tableObjects.push_back(obj);
 }
 
 void CInterfaceStackTable::appendMapObject(CInterfaceStackObject* obj,const char* key,size_t l)
 {
+    _unpack();
     _isTableArray=false;
     _tableObjects.push_back(new CInterfaceStackString(key,l));
     _tableObjects.push_back(obj);
@@ -296,6 +378,7 @@ void CInterfaceStackTable::appendMapObject(CInterfaceStackObject* obj,const char
 
 void CInterfaceStackTable::appendMapObject(CInterfaceStackObject* obj,double key)
 {
+    _unpack();
     _isTableArray=false;
     _tableObjects.push_back(new CInterfaceStackNumber(key));
     _tableObjects.push_back(obj);
@@ -303,6 +386,7 @@ void CInterfaceStackTable::appendMapObject(CInterfaceStackObject* obj,double key
 
 void CInterfaceStackTable::appendMapObject(CInterfaceStackObject* obj,luaWrap_lua_Integer key)
 {
+    _unpack();
     _isTableArray=false;
     _tableObjects.push_back(new CInterfaceStackInteger(key));
     _tableObjects.push_back(obj);
@@ -310,6 +394,7 @@ void CInterfaceStackTable::appendMapObject(CInterfaceStackObject* obj,luaWrap_lu
 
 void CInterfaceStackTable::appendMapObject(CInterfaceStackObject* obj,bool key)
 {
+    _unpack();
     _isTableArray=false;
     _tableObjects.push_back(new CInterfaceStackBool(key));
     _tableObjects.push_back(obj);
@@ -319,6 +404,7 @@ void CInterfaceStackTable::appendArrayOrMapObject(CInterfaceStackObject* obj,CIn
 {   // here we basically treat this table as an array, until the key is:
     // 1) not a number, 2) not consecutive, 3) does not start at 1.
     // In that case, we then convert that table from array to map representation
+    _unpack();
     bool valueInserted=false;
     if (_isTableArray)
     {
@@ -358,8 +444,9 @@ void CInterfaceStackTable::appendArrayOrMapObject(CInterfaceStackObject* obj,CIn
 
 CInterfaceStackObject* CInterfaceStackTable::getArrayItemAtIndex(int ind) const
 {
-    if ( (!_isTableArray)||(ind>=(int)_tableObjects.size()) )
+    if ( (!_isTableArray)||(ind>=getArraySize()) )
         return(nullptr);
+    _unpack();
     return(_tableObjects[ind]);
 }
 
@@ -396,16 +483,22 @@ CInterfaceStackObject* CInterfaceStackTable::getMapItemAtIndex(int ind,std::stri
 
 CInterfaceStackObject* CInterfaceStackTable::copyYourself() const
 {
+    std::lock_guard<std::mutex> lock(_packedMutex);
     CInterfaceStackTable* retVal=new CInterfaceStackTable();
     for (size_t i=0;i<_tableObjects.size();i++)
         retVal->_tableObjects.push_back(_tableObjects[i]->copyYourself());
     retVal->_isTableArray=_isTableArray;
     retVal->_isCircularRef=_isCircularRef;
+    retVal->_packedType=_packedType;
+    retVal->_packedData.assign(_packedData.begin(),_packedData.end());
+    retVal->_packedCount=_packedCount;
+    retVal->_packedAsLuaUserdata=_packedAsLuaUserdata;
     return(retVal);
 }
 
 void CInterfaceStackTable::getAllObjectsAndClearTable(std::vector<CInterfaceStackObject*>& allObjs)
 {
+    _unpack();
     allObjs.clear();
     allObjs.assign(_tableObjects.begin(),_tableObjects.end());
     _tableObjects.clear();
@@ -414,23 +507,17 @@ void CInterfaceStackTable::getAllObjectsAndClearTable(std::vector<CInterfaceStac
 
 void CInterfaceStackTable::setUCharArray(const unsigned char* array,int l)
 {
-    _tableObjects.clear();
-    _isTableArray=true;
-    for (int i=0;i<l;i++)
-        _tableObjects.push_back(new CInterfaceStackInteger(array[i]));
+    setPackedArray(PACKED_ARRAY_UINT8,array,l);
 }
 
 void CInterfaceStackTable::setInt32Array(const int* array,int l)
 {
-    _tableObjects.clear();
-    _isTableArray=true;
-    for (int i=0;i<l;i++)
-        _tableObjects.push_back(new CInterfaceStackInteger(array[i]));
+    setPackedArray(PACKED_ARRAY_INT32,array,l);
 }
 
 void CInterfaceStackTable::setInt64Array(const luaWrap_lua_Integer* array,int l)
 {
-    _tableObjects.clear();
+    _clearObjects();
     _isTableArray=true;
     for (int i=0;i<l;i++)
         _tableObjects.push_back(new CInterfaceStackInteger(array[i]));
@@ -438,18 +525,81 @@ void CInterfaceStackTable::setInt64Array(const luaWrap_lua_Integer* array,int l)
 
 void CInterfaceStackTable::setFloatArray(const float* array,int l)
 {
-    _tableObjects.clear();
-    _isTableArray=true;
-    for (int i=0;i<l;i++)
-        _tableObjects.push_back(new CInterfaceStackNumber((float)array[i]));
+    setPackedArray(PACKED_ARRAY_FLOAT32,array,l);
 }
 
 void CInterfaceStackTable::setDoubleArray(const double* array,int l)
 {
-    _tableObjects.clear();
+    setPackedArray(PACKED_ARRAY_FLOAT64,array,l);
+}
+
+void CInterfaceStackTable::setPackedArray(int arrayType,const void* data,int l)
+{ // data can be nullptr, in which case the array is zero-initialized
+    _clearObjects();
     _isTableArray=true;
-    for (int i=0;i<l;i++)
-        _tableObjects.push_back(new CInterfaceStackNumber(array[i]));
+    size_t s=size_t(luaWrap_getPackedArrayElementSize(arrayType))*size_t(l);
+    if (s>0)
+    {
+        _packedType=arrayType;
+        _packedCount=l;
+        if (data!=nullptr)
+            _packedData.assign((const unsigned char*)data,((const unsigned char*)data)+s);
+        else
+            _packedData.assign(s,0);
+    }
+}
+
+const void* CInterfaceStackTable::getPackedArrayData(int& arrayType,int& count) const
+{ // type, count and buffer are read together, since another thread could unpack the table in between
+    std::lock_guard<std::mutex> lock(_packedMutex);
+    arrayType=_packedType;
+    count=_packedCount;
+    if (_packedType==PACKED_ARRAY_NONE)
+        return(nullptr);
+    return(&_packedData[0]);
+}
+
+void CInterfaceStackTable::setPackedAsLuaUserdata(bool userdata)
+{
+    _packedAsLuaUserdata=userdata;
+}
+
+bool CInterfaceStackTable::getPackedAsLuaUserdata() const
+{
+    return(_packedAsLuaUserdata);
+}
+
+void CInterfaceStackTable::_clearObjects()
+{
+    for (size_t i=0;i<_tableObjects.size();i++)
+        delete _tableObjects[i];
+    _tableObjects.clear();
+    _packedType=PACKED_ARRAY_NONE;
+    _packedData.clear();
+    _packedCount=0;
+}
+
+void CInterfaceStackTable::_unpack() const
+{ // generates the individual items from the packed buffer
+    std::lock_guard<std::mutex> lock(_packedMutex);
+    if (_packedType==PACKED_ARRAY_NONE)
+        return;
+    _tableObjects.reserve(_tableObjects.size()+_packedCount);
+    const unsigned char* data=&_packedData[0];
+    for (int i=0;i<_packedCount;i++)
+    {
+        if (_packedType==PACKED_ARRAY_UINT8)
+            _tableObjects.push_back(new CInterfaceStackInteger(data[i]));
+        else if (_packedType==PACKED_ARRAY_INT32)
+            _tableObjects.push_back(new CInterfaceStackInteger(((const int*)data)[i]));
+        else if (_packedType==PACKED_ARRAY_FLOAT32)
+            _tableObjects.push_back(new CInterfaceStackNumber((float)((const float*)data)[i]));
+        else
+            _tableObjects.push_back(new CInterfaceStackNumber(((const double*)data)[i]));
+    }
+    _packedType=PACKED_ARRAY_NONE;
+    _packedData.clear();
+    _packedCount=0;
 }
 
 int CInterfaceStackTable::getTableInfo(int infoType) const
@@ -478,6 +628,14 @@ int CInterfaceStackTable::getTableInfo(int infoType) const
 
 bool CInterfaceStackTable::_areAllValueThis(int what,bool integerAndDoubleTolerant) const
 {
+    std::lock_guard<std::mutex> lock(_packedMutex);
+    if (_packedType!=PACKED_ARRAY_NONE)
+    {
+        bool integers=( (_packedType==PACKED_ARRAY_UINT8)||(_packedType==PACKED_ARRAY_INT32) );
+        if ( integerAndDoubleTolerant&&((what==STACK_OBJECT_NUMBER)||(what==STACK_OBJECT_INTEGER)) )
+            return(true);
+        return( (integers&&(what==STACK_OBJECT_INTEGER))||((!integers)&&(what==STACK_OBJECT_NUMBER)) );
+    }
     if (_tableObjects.size()==0)
         return(true);
     if (_isTableArray)
@@ -517,6 +675,7 @@ bool CInterfaceStackTable::_areAllValueThis(int what,bool integerAndDoubleTolera
 
 void CInterfaceStackTable::printContent(int spaces,std::string& buffer) const
 {
+    _unpack();
     for (int i=0;i<spaces;i++)
         buffer+=" ";
     if (_isCircularRef)
@@ -549,6 +708,7 @@ void CInterfaceStackTable::printContent(int spaces,std::string& buffer) const
 
 std::string CInterfaceStackTable::getObjectData() const
 {
+    _unpack(); // the serialized format is item-based
     std::string retVal;
 
     if (_isCircularRef)
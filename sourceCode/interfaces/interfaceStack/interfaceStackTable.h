@@ -2,6 +2,7 @@
 
 #include "interfaceStackObject.h"
 #include <vector>
+#include <mutex>
 
 class CInterfaceStackTable : public CInterfaceStackObject
 {
@@ -30,6 +31,13 @@ public:
     void setInt64Array(const luaWrap_lua_Integer* array,int l);
     void setFloatArray(const float* array,int l);
     void setDoubleArray(const double* array,int l);
+    void setPackedArray(int arrayType,const void* data,int l);
+
+    // Numeric arrays are kept as a single packed buffer, until items are individually accessed.
+    // The returned buffer is valid until the table is modified or its items are individually accessed:
+    const void* getPackedArrayData(int& arrayType,int& count) const;
+    void setPackedAsLuaUserdata(bool userdata);
+    bool getPackedAsLuaUserdata() const;
 
     void appendArrayObject(CInterfaceStackObject* obj);
     void appendMapObject(CInterfaceStackObject* obj,const char* key,size_t l);
@@ -51,8 +59,15 @@ public:
 
 protected:
     bool _areAllValueThis(int what,bool integerAndDoubleTolerant) const;
+    void _unpack() const;
+    void _clearObjects();
 
-    std::vector<CInterfaceStackObject*> _tableObjects;
+    mutable std::vector<CInterfaceStackObject*> _tableObjects; // lazily generated from the packed buffer
+    mutable int _packedType;
+    mutable std::vector<unsigned char> _packedData;
+    mutable int _packedCount;
+    mutable std::mutex _packedMutex; // const accessors may unpack the buffer, possibly from several threads
+    bool _packedAsLuaUserdata;
     bool _isTableArray;
     bool _isCircularRef;
 };
@@ -12,6 +12,7 @@
 #include "app.h"
 #include "apiErrors.h"
 #include "interfaceStack.h"
+#include "benchmarks.h"
 #include "fileOperations.h"
 #include "ttUtil.h"
 #include "imgLoaderSaver.h"
@@ -112,6 +113,7 @@ const SLuaCommands simLuaCommands[]=
     {"sim.handleDynamics",_simHandleDynamics,                    "int result=sim.handleDynamics(float deltaTime)",true},
     {"sim.handleProximitySensor",_simHandleProximitySensor,      "int result,float distance,table[3] detectedPoint,int detectedObjectHandle,table[3] normalVector=\nsim.handleProximitySensor(int sensorHandle)",true},
     {"sim.readProximitySensor",_simReadProximitySensor,          "int result,float distance,table[3] detectedPoint,int detectedObjectHandle,table[3] normalVector=\nsim.readProximitySensor(int sensorHandle)",true},
+    {"sim.getProximitySensorCalculationTime",_simGetProximitySensorCalculationTime,"float calcTime=sim.getProximitySensorCalculationTime(int sensorHandle)",true},
     {"sim.resetProximitySensor",_simResetProximitySensor,        "sim.resetProximitySensor(int objectHandle)",true},
     {"sim.checkProximitySensor",_simCheckProximitySensor,        "int result,float distance,table[3] detectedPoint=sim.checkProximitySensor(int sensorHandle,int entityHandle)",true},
     {"sim.checkProximitySensorEx",_simCheckProximitySensorEx,    "int result,float distance,table[3] detectedPoint,int detectedObjectHandle,table[3] normalVector=\nsim.checkProximitySensorEx(int sensorHandle,int entityHandle,int mode,float threshold,float maxAngle)",true},
@@ -207,6 +209,7 @@ const SLuaCommands simLuaCommands[]=
     {"sim.removeObjectFromSelection",_simRemoveObjectFromSelection,"sim.removeObjectFromSelection(int what,int objectHandle)\nint result=sim.removeObjectFromSelection(table[1..*] objectHandles)",true},
     {"sim.getObjectSelection",_simGetObjectSelection,            "table[] selectedObjectHandles=sim.getObjectSelection()",true},
     {"sim.getRealTimeSimulation",_simGetRealTimeSimulation,      "int result=sim.getRealTimeSimulation()",true},
+    {"sim.getRealTimeStatistics",_simGetRealTimeStatistics,      "table[6] counters,table[16] histogram,table[11] times=sim.getRealTimeStatistics()",true},
     {"sim.setNavigationMode",_simSetNavigationMode,              "sim.setNavigationMode(int navigationMode)",true},
     {"sim.getNavigationMode",_simGetNavigationMode,              "int navigationMode=sim.getNavigationMode()",true},
     {"sim.setPage",_simSetPage,                                  "sim.setPage(int pageIndex)",true},
@@ -238,6 +241,7 @@ const SLuaCommands simLuaCommands[]=
     {"sim.unpackDoubleTable",_simUnpackDoubleTable,              "table[] doubleNumbers=sim.unpackDoubleTable(string data,int startDoubleIndex=0,int doubleCount=0,int additionalByteOffset=0)",true},
     {"sim.unpackUInt8Table",_simUnpackUInt8Table,                "table[] uint8Numbers=sim.unpackUInt8Table(string data,int startUint8Index=0,int uint8count=0)",true},
     {"sim.unpackUInt16Table",_simUnpackUInt16Table,              "table[] uint16Numbers=sim.unpackUInt16Table(string data,int startUint16Index=0,int uint16Count=0,int additionalByteOffset=0)",true},
+    {"sim.createPackedArray",_simCreatePackedArray,              "userdata packedArray=sim.createPackedArray(int arrayType,table[] values)\nuserdata packedArray=sim.createPackedArray(int arrayType,int count)",true},
     {"sim.packTable",_simPackTable,                              "string buffer=sim.packTable(table[] aTable)",true},
     {"sim.unpackTable",_simUnpackTable,                          "table[] aTable=sim.unpackTable(string buffer)",true},
     {"sim.transformBuffer",_simTransformBuffer,                  "string outBuffer=sim.transformBuffer(string inBuffer,int inFormat,float multiplier,float offset,int outFormat)",true},
@@ -294,6 +298,7 @@ const SLuaCommands simLuaCommands[]=
     {"sim._serialRead",_simSerialRead,                           "",false}, // partially implemented in sim.lua
     {"sim.serialCheck",_simSerialCheck,                          "int byteCount=sim.serialCheck(int portHandle)",true},
     {"sim.getContactInfo",_simGetContactInfo,                    "table[2] collidingObjects,table[3] collisionPoint,table[3] reactionForce,table[3] normalVector=sim.getContactInfo(int dynamicPass,\nint objectHandle,int index)",true},
+    {"sim.getContacts",_simGetContacts,                          "table objectHandles,table contactInfo=sim.getContacts(int dynamicPass,int objectHandle)",true},
     {"sim.auxiliaryConsoleOpen",_simAuxiliaryConsoleOpen,        "int consoleHandle=sim.auxiliaryConsoleOpen(string title,int maxLines,int mode,table[2] position=nil,table[2] size=nil,\ntable[3] textColor=nil,table[3] backgroundColor=nil)",true},
     {"sim.auxiliaryConsoleClose",_simAuxiliaryConsoleClose,      "int result=sim.auxiliaryConsoleClose(int consoleHandle)",true},
     {"sim.auxiliaryConsolePrint",_simAuxiliaryConsolePrint,      "int result=sim.auxiliaryConsolePrint(int consoleHandle,string text)",true},
@@ -440,16 +445,16 @@ const SLuaCommands simLuaCommands[]=
     {"sim.isDynamicallyEnabled",_simIsDynamicallyEnabled,        "boolean enabled=sim.isDynamicallyEnabled(int objectHandle)",true},
     {"sim.generateShapeFromPath",_simGenerateShapeFromPath,      "int shapeHandle=sim.generateShapeFromPath(table[] path,table[] section,int options=0,table[3] upVector={0.0,0.0,1.0})",true},
     {"sim.initScript",_simInitScript,                            "bool result=sim.initScript(int scriptHandle)",true},
+    {"sim.handleMill",_simHandleMill,                            "int milledObjectCount,table[2] removedSurfaceAndVolume=sim.handleMill(int millHandle)",true},
+    {"sim.resetMill",_simResetMill,                              "int result=sim.resetMill(int millHandle)",true},
 
-    {"sim.test",_simTest,                                        "test function - shouldn't be used",true},
+    {"sim.test",_simTest,                                        "string report,table results=sim.test(string benchmarkName,number iterations=0)\n(internal benchmarks - shouldn't be used otherwise)",true},
 
     // deprecated
     {"sim.addStatusbarMessage",_simAddStatusbarMessage,         "Deprecated. Use 'sim.addLog' instead",false},
     {"sim.getNameSuffix",_simGetNameSuffix,                     "Deprecated",false},
     {"sim.setNameSuffix",_simSetNameSuffix,                     "Deprecated",false},
-    {"sim.resetMill",_simResetMill,                             "Deprecated. Has no effect",false},
     {"sim.resetMilling",_simResetMilling,                       "Deprecated. Has no effect",false},
-    {"sim.handleMill",_simHandleMill,                           "Deprecated. Has no effect",false},
     {"sim.openTextEditor",_simOpenTextEditor,                    "Deprecated. Use 'sim.textEditorOpen' instead",false},
     {"sim.closeTextEditor",_simCloseTextEditor,                  "Deprecated. Use 'sim.textEditorClose' instead",false},
     {"simHandlePath",_simHandlePath,                                "Deprecated",false},
@@ -2063,6 +2068,11 @@ const SLuaVariables simLuaVariables[]=
     {"sim.rml_recompute_trajectory",simrml_recompute_trajectory,true},
     {"sim.rml_disable_extremum_motion_states_calc",simrml_disable_extremum_motion_states_calc,true},
     {"sim.rml_keep_current_vel_if_fallback_strategy",simrml_keep_current_vel_if_fallback_strategy,true},
+    // packed array types:
+    {"sim.packedarray_uint8",PACKED_ARRAY_UINT8,true},
+    {"sim.packedarray_int32",PACKED_ARRAY_INT32,true},
+    {"sim.packedarray_float32",PACKED_ARRAY_FLOAT32,true},
+    {"sim.packedarray_float64",PACKED_ARRAY_FLOAT64,true},
 
 
     // deprecated!
@@ -4641,6 +4651,20 @@ int _simReadProximitySensor(luaWrap_lua_State* L)
     LUA_END(1);
 }
 
+int _simGetProximitySensorCalculationTime(luaWrap_lua_State* L)
+{
+    TRACE_LUA_API;
+    LUA_START("sim.getProximitySensorCalculationTime");
+
+    float retVal=-1.0f; // means error
+    if (checkInputArguments(L,&errorString,lua_arg_number,0))
+        retVal=simGetProximitySensorCalculationTime_internal(luaToInt(L,1));
+
+    LUA_RAISE_ERROR_OR_YIELD_IF_NEEDED(); // we might never return from this!
+    luaWrap_lua_pushnumber(L,retVal);
+    LUA_END(1);
+}
+
 int _simHandleVisionSensor(luaWrap_lua_State* L)
 {
     TRACE_LUA_API;
@@ -7408,6 +7432,26 @@ int _simGetRealTimeSimulation(luaWrap_lua_State* L)
     LUA_END(1);
 }
 
+int _simGetRealTimeStatistics(luaWrap_lua_State* L)
+{ // see simGetRealTimeStatistics_internal for the table layouts
+    TRACE_LUA_API;
+    LUA_START("sim.getRealTimeStatistics");
+
+    int counters[REAL_TIME_COUNTER_CNT];
+    int histogram[REAL_TIME_HISTOGRAM_SIZE];
+    float times[REAL_TIME_TIME_CNT];
+    if (simGetRealTimeStatistics_internal(counters,histogram,times)==1)
+    {
+        pushIntTableOntoStack(L,REAL_TIME_COUNTER_CNT,counters);
+        pushIntTableOntoStack(L,REAL_TIME_HISTOGRAM_SIZE,histogram);
+        pushFloatTableOntoStack(L,REAL_TIME_TIME_CNT,times);
+        LUA_END(3);
+    }
+
+    LUA_RAISE_ERROR_OR_YIELD_IF_NEEDED(); // we might never return from this!
+    LUA_END(0);
+}
+
 int _simLaunchExecutable(luaWrap_lua_State* L)
 {
     TRACE_LUA_API;
@@ -7495,6 +7539,27 @@ int _simTest(luaWrap_lua_State* L)
 {
     TRACE_LUA_API;
     LUA_START("sim.test");
+
+    if (checkInputArguments(L,&errorString,lua_arg_string,0))
+    {
+        int iterations=0;
+        int res=checkOneGeneralInputArgument(L,2,lua_arg_number,0,true,false,&errorString);
+        if (res>=0)
+        {
+            if (res==2)
+                iterations=luaToInt(L,2);
+            std::string report;
+            std::vector<float> results;
+            if (CBenchmarks::run(luaWrap_lua_tostring(L,1),iterations,report,results))
+            {
+                luaWrap_lua_pushstring(L,report.c_str());
+                pushFloatTableOntoStack(L,int(results.size()),&results[0]);
+                LUA_END(2);
+            }
+            errorString=SIM_ERROR_INVALID_ARGUMENT;
+        }
+    }
+
     LUA_RAISE_ERROR_OR_YIELD_IF_NEEDED(); // we might never return from this!
     LUA_END(0);
 }
@@ -8790,6 +8855,59 @@ int _simUnpackFloatTable(luaWrap_lua_State* L)
     LUA_END(0);
 }
 
+int _simCreatePackedArray(luaWrap_lua_State* L)
+{ // userdata-backed numeric array, that transfers to/from plugins as a single block
+    TRACE_LUA_API;
+    LUA_START("sim.createPackedArray");
+
+    if (checkInputArguments(L,&errorString,lua_arg_number,0))
+    {
+        int arrayType=luaToInt(L,1);
+        if (luaWrap_getPackedArrayElementSize(arrayType)>0)
+        {
+            bool fromTable=luaWrap_lua_istable(L,2);
+            if ( fromTable||(checkInputArguments(L,&errorString,lua_arg_number,0,lua_arg_number,0)) )
+            {
+                int cnt;
+                if (fromTable)
+                    cnt=int(luaWrap_lua_rawlen(L,2));
+                else
+                    cnt=std::max<int>(0,luaToInt(L,2));
+                std::vector<double> values(cnt,0.0);
+                for (int i=0;fromTable&&(i<cnt);i++)
+                {
+                    luaWrap_lua_rawgeti(L,2,i+1);
+                    values[i]=luaWrap_lua_tonumber(L,-1);
+                    luaWrap_lua_pop(L,1);
+                }
+                CInterfaceStack stack;
+                stack.pushPackedArrayTableOntoStack(PACKED_ARRAY_FLOAT64,(values.size()>0)?&values[0]:nullptr,cnt,false);
+                std::vector<unsigned char> buff(size_t(luaWrap_getPackedArrayElementSize(arrayType))*size_t(cnt)+1);
+                if (arrayType==PACKED_ARRAY_UINT8)
+                    stack.getStackUCharArray(&buff[0],cnt);
+                else if (arrayType==PACKED_ARRAY_INT32)
+                    stack.getStackInt32Array((int*)&buff[0],cnt);
+                else if (arrayType==PACKED_ARRAY_FLOAT32)
+                    stack.getStackFloatArray((float*)&buff[0],cnt);
+                else
+                    stack.getStackDoubleArray((double*)&buff[0],cnt);
+                if (!luaWrap_pushPackedArray(L,arrayType,&buff[0],cnt))
+                { // e.g. with an external Lua library. We return a regular table instead
+                    stack.clear();
+                    stack.pushPackedArrayTableOntoStack(arrayType,&buff[0],cnt,false);
+                    stack.buildOntoLuaStack(L,true);
+                }
+                LUA_END(1);
+            }
+        }
+        else
+            errorString=SIM_ERROR_INVALID_ARGUMENT;
+    }
+
+    LUA_RAISE_ERROR_OR_YIELD_IF_NEEDED(); // we might never return from this!
+    LUA_END(0);
+}
+
 int _simUnpackDoubleTable(luaWrap_lua_State* L)
 {
     TRACE_LUA_API;
@@ -11483,6 +11601,30 @@ int _simGetContactInfo(luaWrap_lua_State* L)
     LUA_END(0);
 }
 
+int _simGetContacts(luaWrap_lua_State* L)
+{ // packed version of sim.getContactInfo: objectHandles has 2 values per contact, contactInfo has 9 values (position, force, normal) per contact
+    TRACE_LUA_API;
+    LUA_START("sim.getContacts");
+
+    if (checkInputArguments(L,&errorString,lua_arg_number,0,lua_arg_number,0))
+    {
+        int* objectHandles;
+        float* contactInfo;
+        int cnt=simGetContacts_internal(luaToInt(L,1),luaToInt(L,2),&objectHandles,&contactInfo);
+        if (cnt>=0)
+        {
+            pushIntTableOntoStack(L,cnt*2,objectHandles);
+            pushFloatTableOntoStack(L,cnt*9,contactInfo);
+            delete[] objectHandles;
+            delete[] contactInfo;
+            LUA_END(2);
+        }
+    }
+
+    LUA_RAISE_ERROR_OR_YIELD_IF_NEEDED(); // we might never return from this!
+    LUA_END(0);
+}
+
 int _simAuxiliaryConsoleOpen(luaWrap_lua_State* L)
 {
     TRACE_LUA_API;
@@ -15447,15 +15589,40 @@ int _simGetRandom(luaWrap_lua_State* L)
 //****************************************************
 
 int _simResetMill(luaWrap_lua_State* L)
-{ // DEPRECATED since V4.0.1. has no effect anymore
-    LUA_START("sim.ResetMill");
-    LUA_END(0);
+{
+    TRACE_LUA_API;
+    LUA_START("sim.resetMill");
+
+    int retVal=-1; // means error
+    if (checkInputArguments(L,&errorString,lua_arg_number,0))
+        retVal=simResetMill_internal(luaToInt(L,1));
+
+    LUA_RAISE_ERROR_OR_YIELD_IF_NEEDED(); // we might never return from this!
+    luaWrap_lua_pushinteger(L,retVal);
+    LUA_END(1);
 }
 
 int _simHandleMill(luaWrap_lua_State* L)
-{ // DEPRECATED since V4.0.1. has no effect anymore
-    LUA_START("sim.HandleMill");
-    LUA_END(0);
+{
+    TRACE_LUA_API;
+    LUA_START("sim.handleMill");
+
+    int retVal=-1; // means error
+    if (checkInputArguments(L,&errorString,lua_arg_number,0))
+    {
+        float surfaceAndVolume[2];
+        retVal=simHandleMill_internal(luaToInt(L,1),surfaceAndVolume);
+        if (retVal!=-1)
+        {
+            luaWrap_lua_pushinteger(L,retVal);
+            pushFloatTableOntoStack(L,2,surfaceAndVolume);
+            LUA_END(2);
+        }
+    }
+
+    LUA_RAISE_ERROR_OR_YIELD_IF_NEEDED(); // we might never return from this!
+    luaWrap_lua_pushinteger(L,retVal);
+    LUA_END(1);
 }
 
 int _simResetMilling(luaWrap_lua_State* L)
@@ -135,6 +135,7 @@ extern int _simHandleModule(luaWrap_lua_State* L);
 extern int _simHandleDynamics(luaWrap_lua_State* L);
 extern int _simHandleProximitySensor(luaWrap_lua_State* L);
 extern int _simReadProximitySensor(luaWrap_lua_State* L);
+extern int _simGetProximitySensorCalculationTime(luaWrap_lua_State* L);
 extern int _simResetProximitySensor(luaWrap_lua_State* L);
 extern int _simCheckProximitySensor(luaWrap_lua_State* L);
 extern int _simCheckProximitySensorEx(luaWrap_lua_State* L);
@@ -232,6 +233,7 @@ extern int _simGetObjectSelectionSize(luaWrap_lua_State* L);
 extern int _simGetObjectLastSelection(luaWrap_lua_State* L);
 extern int _simGetObjectSelection(luaWrap_lua_State* L);
 extern int _simGetRealTimeSimulation(luaWrap_lua_State* L);
+extern int _simGetRealTimeStatistics(luaWrap_lua_State* L);
 extern int _simLockInterface(luaWrap_lua_State* L);
 extern int _simSetNavigationMode(luaWrap_lua_State* L);
 extern int _simGetNavigationMode(luaWrap_lua_State* L);
@@ -268,6 +270,7 @@ extern int _simUnpackInt32Table(luaWrap_lua_State* L);
 extern int _simUnpackUInt32Table(luaWrap_lua_State* L);
 extern int _simUnpackFloatTable(luaWrap_lua_State* L);
 extern int _simUnpackDoubleTable(luaWrap_lua_State* L);
+extern int _simCreatePackedArray(luaWrap_lua_State* L);
 extern int _simUnpackUInt8Table(luaWrap_lua_State* L);
 extern int _simUnpackUInt16Table(luaWrap_lua_State* L);
 extern int _simTransformBuffer(luaWrap_lua_State* L);
@@ -476,6 +479,7 @@ extern int _simSetShapeInertia(luaWrap_lua_State* L);
 extern int _simIsDynamicallyEnabled(luaWrap_lua_State* L);
 extern int _simGenerateShapeFromPath(luaWrap_lua_State* L);
 extern int _simInitScript(luaWrap_lua_State* L);
+extern int _simGetContacts(luaWrap_lua_State* L);
 
 // DEPRECATED
 int _genericFunctionHandler_old(luaWrap_lua_State* L,CLuaCustomFunction* func);
@@ -1536,6 +1536,30 @@ SIM_DLLEXPORT simInt simInitScript(simInt scriptHandle)
 {
     return(simInitScript_internal(scriptHandle));
 }
+SIM_DLLEXPORT simInt simGetContacts(simInt dynamicPass,simInt objectHandle,simInt** objectHandles,simFloat** contactInfo)
+{
+    return(simGetContacts_internal(dynamicPass,objectHandle,objectHandles,contactInfo));
+}
+SIM_DLLEXPORT simInt simPushPackedArrayOntoStack(simInt stackHandle,simInt arrayType,const simVoid* data,simInt count,simBool asLuaUserdata)
+{
+    return(simPushPackedArrayOntoStack_internal(stackHandle,arrayType,data,count,asLuaUserdata));
+}
+SIM_DLLEXPORT const simVoid* simGetStackPackedArray(simInt stackHandle,simInt* arrayType,simInt* count)
+{
+    return(simGetStackPackedArray_internal(stackHandle,arrayType,count));
+}
+SIM_DLLEXPORT simInt simRunSimulationBatch(simInt sceneCount,const simChar* const* sceneFiles,simFloat simulationDuration,simInt threadCount,simInt* stepCounts)
+{
+    return(simRunSimulationBatch_internal(sceneCount,sceneFiles,simulationDuration,threadCount,stepCounts));
+}
+SIM_DLLEXPORT simFloat simGetProximitySensorCalculationTime(simInt sensorHandle)
+{
+    return(simGetProximitySensorCalculationTime_internal(sensorHandle));
+}
+SIM_DLLEXPORT simInt simGetRealTimeStatistics(simInt* counters,simInt* histogram,simFloat* times)
+{
+    return(simGetRealTimeStatistics_internal(counters,histogram,times));
+}
 SIM_DLLEXPORT simInt _simGetContactCallbackCount()
 {
     return(_simGetContactCallbackCount_internal());
@@ -2264,11 +2288,11 @@ SIM_DLLEXPORT simInt simSetJointForce(simInt objectHandle,simFloat forceOrTorque
 }
 SIM_DLLEXPORT simInt simHandleMill(simInt millHandle,simFloat* removedSurfaceAndVolume)
 {
-    return(-1);
+    return(simHandleMill_internal(millHandle,removedSurfaceAndVolume));
 }
 SIM_DLLEXPORT simInt simResetMill(simInt millHandle)
 {
-    return(-1);
+    return(simResetMill_internal(millHandle));
 }
 SIM_DLLEXPORT simInt simResetMilling(simInt objectHandle)
 {
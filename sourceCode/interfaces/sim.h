@@ -398,6 +398,12 @@ SIM_DLLEXPORT simInt simSetShapeInertia(simInt shapeHandle,const simFloat* inert
 SIM_DLLEXPORT simInt simIsDynamicallyEnabled(simInt objectHandle);
 SIM_DLLEXPORT simInt simGenerateShapeFromPath(const simFloat* path,simInt pathSize,const simFloat* section,simInt sectionSize,simInt options,const simFloat* upVector,simFloat reserved);
 SIM_DLLEXPORT simInt simInitScript(simInt scriptHandle);
+SIM_DLLEXPORT simInt simGetContacts(simInt dynamicPass,simInt objectHandle,simInt** objectHandles,simFloat** contactInfo);
+SIM_DLLEXPORT simInt simPushPackedArrayOntoStack(simInt stackHandle,simInt arrayType,const simVoid* data,simInt count,simBool asLuaUserdata);
+SIM_DLLEXPORT const simVoid* simGetStackPackedArray(simInt stackHandle,simInt* arrayType,simInt* count);
+SIM_DLLEXPORT simInt simRunSimulationBatch(simInt sceneCount,const simChar* const* sceneFiles,simFloat simulationDuration,simInt threadCount,simInt* stepCounts);
+SIM_DLLEXPORT simFloat simGetProximitySensorCalculationTime(simInt sensorHandle);
+SIM_DLLEXPORT simInt simGetRealTimeStatistics(simInt* counters,simInt* histogram,simFloat* times);
 
 
 SIM_DLLEXPORT simInt _simGetContactCallbackCount();
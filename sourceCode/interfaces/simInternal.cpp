@@ -24,8 +24,10 @@
 #include "sigHandler.h"
 #include "luaScriptFunctions.h"
 #include "memorizedConf.h"
+#include "imageKernels.h"
 #include <algorithm>
 #include <iostream>
+#include <cstring>
 #include "tinyxml2.h"
 #include "simFlavor.h"
 #include <boost/lexical_cast.hpp>
@@ -296,6 +298,7 @@ void simulatorLoop()
     if ( stepSimIfRunning && (simGetSimulationState_internal()&sim_simulation_advancing)!=0 )
     {
         wasRunning=true;
+        App::currentWorld->simulation->waitForRealTimeCalculationStep();
         if ( (simGetRealTimeSimulation_internal()!=1)||(simIsRealTimeSimulationStepNeeded_internal()==1) )
         {
             if ((simHandleMainScript_internal()&sim_script_main_script_not_called)==0)
@@ -4948,7 +4951,9 @@ simInt simHandleProximitySensor_internal(simInt sensorHandle,simFloat* detectedP
                 float smallestL=SIM_MAX_FLOAT;
                 int detectedObj;
                 C3Vector detectedSurf;
+                App::currentWorld->simulation->getRealTimeScheduler()->phaseStart(REAL_TIME_PHASE_SENSORS);
                 bool detected=it->handleSensor(false,detectedObj,detectedSurf);
+                App::currentWorld->simulation->getRealTimeScheduler()->phaseEnd(REAL_TIME_PHASE_SENSORS);
                 if (detected)
                 {
                     smallest=it->getDetectedPoint();
@@ -4980,24 +4985,29 @@ simInt simHandleProximitySensor_internal(simInt sensorHandle,simFloat* detectedP
             int detectedObjectID=-1;
             C3Vector detectedSurfaceNormal;
             float allSmallestL=SIM_MAX_FLOAT;
+            std::vector<CProxSensor*> sensors;
             for (size_t i=0;i<App::currentWorld->sceneObjects->getProximitySensorCount();i++)
-            {
-                int detectedObj;
-                C3Vector detectedSurf;
-                CProxSensor* it=App::currentWorld->sceneObjects->getProximitySensorFromIndex(i);
-                bool detected=false;
-                detected=it->handleSensor(sensorHandle==sim_handle_all_except_explicit,detectedObj,detectedSurf);
-                if (detected)
+                sensors.push_back(App::currentWorld->sceneObjects->getProximitySensorFromIndex(i));
+            std::vector<bool> detected;
+            std::vector<C3Vector> detectedPts;
+            std::vector<int> detectedObjs;
+            std::vector<C3Vector> detectedSurfs;
+            App::currentWorld->simulation->getRealTimeScheduler()->phaseStart(REAL_TIME_PHASE_SENSORS);
+            CProxSensorRoutine::handleSensors(sensors,sensorHandle==sim_handle_all_except_explicit,detected,detectedPts,detectedObjs,detectedSurfs);
+            App::currentWorld->simulation->getRealTimeScheduler()->phaseEnd(REAL_TIME_PHASE_SENSORS);
+            for (size_t i=0;i<sensors.size();i++)
+            {
+                if (detected[i])
                 {
-                    C3Vector smallest(it->getDetectedPoint());
+                    C3Vector smallest(detectedPts[i]);
                     float smallestL=smallest.getLength();
 
                     if (smallestL<allSmallestL)
                     {
                         allSmallest=smallest;
                         allSmallestL=smallestL;
-                        detectedObjectID=detectedObj;
-                        detectedSurfaceNormal=detectedSurf;
+                        detectedObjectID=detectedObjs[i];
+                        detectedSurfaceNormal=detectedSurfs[i];
                         retVal=1;
                     }
                 }
@@ -5174,11 +5184,13 @@ simInt simHandleMainScript_internal()
         if (it!=nullptr)
         {
             App::worldContainer->calcInfo->simulationPassStart();
+            App::currentWorld->simulation->realTimeStepStart();
 
             App::currentWorld->embeddedScriptContainer->broadcastDataContainer.removeTimedOutObjects(float(App::currentWorld->simulation->getSimulationTime_us())/1000000.0f); // remove invalid elements
             CThreadPool::prepareAllThreadsForResume_calledBeforeMainScript();
 
             retVal=it->callMainScript(-1,nullptr,nullptr,nullptr);
+            App::currentWorld->simulation->realTimeStepEnd();
             App::worldContainer->calcInfo->simulationPassEnd();
         }
         else
@@ -5600,6 +5612,96 @@ simInt simResetProximitySensor_internal(simInt sensorHandle)
     return(-1);
 }
 
+simInt simHandleMill_internal(simInt millHandle,simFloat* removedSurfaceAndVolume)
+{
+    TRACE_C_API;
+
+    if (!isSimulatorInitialized(__func__))
+        return(-1);
+
+    IF_C_API_SIM_OR_UI_THREAD_CAN_WRITE_DATA
+    {
+        if ( (millHandle!=sim_handle_all)&&(millHandle!=sim_handle_all_except_explicit) )
+        {
+            if (!isMill(__func__,millHandle))
+                return(-1);
+        }
+        std::vector<CMill*> mills;
+        if (millHandle>=0)
+        { // explicit handling
+            CMill* it=App::currentWorld->sceneObjects->getMillFromHandle(millHandle);
+            if (!it->getExplicitHandling())
+            {
+                CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_OBJECT_NOT_TAGGED_FOR_EXPLICIT_HANDLING);
+                return(-1);
+            }
+            mills.push_back(it);
+        }
+        else
+        {
+            for (size_t i=0;i<App::currentWorld->sceneObjects->getMillCount();i++)
+                mills.push_back(App::currentWorld->sceneObjects->getMillFromIndex(i));
+        }
+        int retVal=0;
+        float surface=0.0f;
+        float volume=0.0f;
+        App::currentWorld->simulation->getRealTimeScheduler()->phaseStart(REAL_TIME_PHASE_SENSORS);
+        for (size_t i=0;i<mills.size();i++)
+        {
+            float surf,vol;
+            retVal+=mills[i]->handleMill(millHandle==sim_handle_all_except_explicit,surf,vol,false);
+            surface+=surf;
+            volume+=vol;
+        }
+        App::currentWorld->simulation->getRealTimeScheduler()->phaseEnd(REAL_TIME_PHASE_SENSORS);
+        if (removedSurfaceAndVolume!=nullptr)
+        {
+            removedSurfaceAndVolume[0]=surface;
+            removedSurfaceAndVolume[1]=volume;
+        }
+        return(retVal);
+    }
+    CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_COULD_NOT_LOCK_RESOURCES_FOR_WRITE);
+    return(-1);
+}
+
+simInt simResetMill_internal(simInt millHandle)
+{
+    TRACE_C_API;
+
+    if (!isSimulatorInitialized(__func__))
+        return(-1);
+
+    IF_C_API_SIM_OR_UI_THREAD_CAN_WRITE_DATA
+    {
+        if ( (millHandle!=sim_handle_all)&&(millHandle!=sim_handle_all_except_explicit) )
+        {
+            if (!isMill(__func__,millHandle))
+                return(-1);
+        }
+        for (size_t i=0;i<App::currentWorld->sceneObjects->getMillCount();i++)
+        {
+            CMill* it=App::currentWorld->sceneObjects->getMillFromIndex(i);
+            if (millHandle>=0)
+            { // Explicit handling
+                it=App::currentWorld->sceneObjects->getMillFromHandle(millHandle);
+                if (!it->getExplicitHandling())
+                {
+                    CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_OBJECT_NOT_TAGGED_FOR_EXPLICIT_HANDLING);
+                    return(-1);
+                }
+                it->resetMill(false);
+                break;
+            }
+            else
+                it->resetMill(millHandle==sim_handle_all_except_explicit);
+        }
+        return(1);
+    }
+    CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_COULD_NOT_LOCK_RESOURCES_FOR_WRITE);
+    return(-1);
+}
+
 simInt simCheckProximitySensor_internal(simInt sensorHandle,simInt entityHandle,simFloat* detectedPoint)
 {
     TRACE_C_API;
@@ -6962,9 +7064,9 @@ simInt simCopyPasteObjects_internal(simInt* objectHandles,simInt objectCount,sim
         App::worldContainer->copyBuffer->copyCurrentSelection(&sel,App::currentWorld->environment->getSceneLocked());
         App::currentWorld->sceneObjects->deselectObjects();
         if (options&1)
-            App::worldContainer->copyBuffer->pasteBuffer(App::currentWorld->environment->getSceneLocked(),3);
+            App::worldContainer->copyBuffer->pasteBuffer(App::currentWorld->environment->getSceneLocked(),3,true);
         else
-            App::worldContainer->copyBuffer->pasteBuffer(App::currentWorld->environment->getSceneLocked(),1);
+            App::worldContainer->copyBuffer->pasteBuffer(App::currentWorld->environment->getSceneLocked(),1,true);
         int retVal=int(App::currentWorld->sceneObjects->getSelectionCount());
         for (int i=0;i<retVal;i++)
             objectHandles[i]=App::currentWorld->sceneObjects->getObjectHandleFromSelectionIndex(size_t(i));
@@ -11429,6 +11531,7 @@ simInt simHandleVisionSensor_internal(simInt visionSensorHandle,simFloat** auxVa
         if (auxValuesCount!=nullptr)
             auxValuesCount[0]=nullptr;
         int retVal=0;
+        std::vector<CVisionSensor*> sensors;
         for (size_t i=0;i<App::currentWorld->sceneObjects->getVisionSensorCount();i++)
         {
             CVisionSensor* it=App::currentWorld->sceneObjects->getVisionSensorFromIndex(i);
@@ -11440,7 +11543,9 @@ simInt simHandleVisionSensor_internal(simInt visionSensorHandle,simFloat** auxVa
                     CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_OBJECT_NOT_TAGGED_FOR_EXPLICIT_HANDLING);
                     return(-1);
                 }
+                App::currentWorld->simulation->getRealTimeScheduler()->phaseStart(REAL_TIME_PHASE_SENSORS);
                 retVal=it->handleSensor();
+                App::currentWorld->simulation->getRealTimeScheduler()->phaseEnd(REAL_TIME_PHASE_SENSORS);
                 if ( (auxValues!=nullptr)&&(auxValuesCount!=nullptr) )
                 {
                     auxValuesCount[0]=new int[1+int(it->sensorAuxiliaryResult.size())];
@@ -11461,11 +11566,17 @@ simInt simHandleVisionSensor_internal(simInt visionSensorHandle,simFloat** auxVa
             else
             {
                 if ( (!it->getExplicitHandling())||(visionSensorHandle==sim_handle_all) )
-                    retVal+=it->handleSensor();
+                    sensors.push_back(it);
             }
             if (visionSensorHandle>=0)
                 break;
         }
+        if (sensors.size()>0)
+        {
+            App::currentWorld->simulation->getRealTimeScheduler()->phaseStart(REAL_TIME_PHASE_SENSORS);
+            retVal=CVisionSensor::handleSensors(sensors); // one UI thread round trip for all sensors
+            App::currentWorld->simulation->getRealTimeScheduler()->phaseEnd(REAL_TIME_PHASE_SENSORS);
+        }
         return(retVal);
     }
     CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_COULD_NOT_LOCK_RESOURCES_FOR_READ);
@@ -11702,20 +11813,9 @@ simFloat* simGetVisionSensorImage_internal(simInt sensorHandle)
         float* buff=new float[res[0]*res[1]*valPerPixel];
         unsigned char* imgBuff=it->getRgbBufferPointer();
         if ((handleFlags&sim_handleflag_greyscale)!=0)
-        {
-            for (int i=0;i<res[0]*res[1];i++)
-            {
-                float v=float(imgBuff[3*i+0])/255.0f;
-                v+=float(imgBuff[3*i+1])/255.0f;
-                v+=float(imgBuff[3*i+2])/255.0f;
-                buff[i]=v/3.0f;
-            }
-        }
+            CImageKernels::rgbToGreyFloat(imgBuff,buff,res[0]*res[1]);
         else
-        {
-            for (int i=0;i<res[0]*res[1]*3;i++)
-                buff[i]=float(imgBuff[i])/255.0f;
-        }
+            CImageKernels::charToFloat(imgBuff,buff,res[0]*res[1]*3);
         return(buff);
     }
     CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_COULD_NOT_LOCK_RESOURCES_FOR_READ);
@@ -11757,22 +11857,9 @@ simUChar* simGetVisionSensorCharImage_internal(simInt sensorHandle,simInt* resol
         unsigned char* buff=new unsigned char[res[0]*res[1]*valPerPixel];
         unsigned char* imgBuff=it->getRgbBufferPointer();
         if ((handleFlags&sim_handleflag_greyscale)!=0)
-        {
-            int n=res[0]*res[1];
-            for (int i=0;i<n;i++)
-            {
-                unsigned int v=imgBuff[3*i+0];
-                v+=imgBuff[3*i+1];
-                v+=imgBuff[3*i+2];
-                buff[i]=(unsigned char)(v/3);
-            }
-        }
+            CImageKernels::rgbToGreyChar(imgBuff,buff,1,res[0]*res[1]);
         else
-        {
-            int n=res[0]*res[1]*3;
-            for (int i=0;i<n;i++)
-                buff[i]=imgBuff[i];
-        }
+            std::memcpy(buff,imgBuff,res[0]*res[1]*3);
         return(buff);
     }
     CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_COULD_NOT_LOCK_RESOURCES_FOR_READ);
@@ -12917,6 +13004,137 @@ simInt simInitScript_internal(simInt scriptHandle)
     return(-1);
 }
 
+simInt simRunSimulationBatch_internal(simInt sceneCount,const simChar* const* sceneFiles,simFloat simulationDuration,simInt threadCount,simInt* stepCounts)
+{ // headless only. Each scene runs for simulationDuration seconds in its own world, concurrently with the others.
+    // stepCounts (can be nullptr) receives the executed steps per scene, or -1 if the scene could not be loaded.
+    // Scenes containing child or customization scripts are not run (the main script is replaced by its default behaviour)
+    TRACE_C_API;
+
+    if (!isSimulatorInitialized(__func__))
+        return(-1);
+
+    if (!VThread::isCurrentThreadTheMainSimulationThread())
+    {
+        CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_CANNOT_BE_CALLED_FROM_THIS_THREAD);
+        return(-1);
+    }
+#ifdef SIM_WITH_GUI
+    if (App::mainWindow!=nullptr)
+    {
+        CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_ONLY_AVAILABLE_IN_HEADLESS_MODE);
+        return(-1);
+    }
+#endif
+    if (!App::currentWorld->simulation->isSimulationStopped())
+    {
+        CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_SIMULATION_NOT_STOPPED);
+        return(-1);
+    }
+    if ( (sceneCount<0)||((sceneCount>0)&&(sceneFiles==nullptr))||(simulationDuration<=0.0f) )
+    {
+        CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_INVALID_ARGUMENTS);
+        return(-1);
+    }
+    std::vector<std::string> scenes;
+    for (int i=0;i<sceneCount;i++)
+        scenes.push_back(sceneFiles[i]);
+    std::vector<int> steps;
+    int retVal=App::worldContainer->runSimulationBatch(scenes,simulationDuration,threadCount,steps);
+    if (stepCounts!=nullptr)
+    {
+        for (size_t i=0;i<steps.size();i++)
+            stepCounts[i]=steps[i];
+    }
+    return(retVal);
+}
+
+simFloat simGetProximitySensorCalculationTime_internal(simInt sensorHandle)
+{ // in seconds, for the last handling of the sensor. Sensors handled in parallel report their own calculation time
+    TRACE_C_API;
+
+    if (!isSimulatorInitialized(__func__))
+        return(-1.0f);
+
+    IF_C_API_SIM_OR_UI_THREAD_CAN_READ_DATA
+    {
+        if (!isSensor(__func__,sensorHandle))
+            return(-1.0f);
+        CProxSensor* it=App::currentWorld->sceneObjects->getProximitySensorFromHandle(sensorHandle);
+        return(it->getCalculationTime());
+    }
+    CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_COULD_NOT_LOCK_RESOURCES_FOR_READ);
+    return(-1.0f);
+}
+
+simInt simGetRealTimeStatistics_internal(simInt* counters,simInt* histogram,simFloat* times)
+{ // statistics of the real-time steps since the simulation start. Any of the buffers can be nullptr:
+  // counters (6 values): steps, missed deadlines, missed deadlines in scripts, in dynamics, in sensors, skipped releases
+  // histogram (16 values): step completion time after the step's release, in 1/8 of a step period (values 8-15 are missed deadlines)
+  // times (11 values, in seconds): avg/max for scripts, dynamics, sensors and the whole step, avg/max wake-up jitter, max lateness
+    TRACE_C_API;
+
+    if (!isSimulatorInitialized(__func__))
+        return(-1);
+
+    IF_C_API_SIM_OR_UI_THREAD_CAN_READ_DATA
+    {
+        int c[REAL_TIME_COUNTER_CNT];
+        int h[REAL_TIME_HISTOGRAM_SIZE];
+        float t[REAL_TIME_TIME_CNT];
+        App::currentWorld->simulation->getRealTimeScheduler()->getStatistics(c,h,t);
+        if (counters!=nullptr)
+        {
+            for (int i=0;i<REAL_TIME_COUNTER_CNT;i++)
+                counters[i]=c[i];
+        }
+        if (histogram!=nullptr)
+        {
+            for (int i=0;i<REAL_TIME_HISTOGRAM_SIZE;i++)
+                histogram[i]=h[i];
+        }
+        if (times!=nullptr)
+        {
+            for (int i=0;i<REAL_TIME_TIME_CNT;i++)
+                times[i]=t[i];
+        }
+        return(1);
+    }
+    CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_COULD_NOT_LOCK_RESOURCES_FOR_READ);
+    return(-1);
+}
+
+simInt simGetContacts_internal(simInt dynamicPass,simInt objectHandle,simInt** objectHandles,simFloat** contactInfo)
+{ // returns the contact count. objectHandles: 2 values per contact, contactInfo: 9 values per contact (position, force, normal)
+    // Both buffers have to be released with simReleaseBuffer
+    TRACE_C_API;
+
+    if (!isSimulatorInitialized(__func__))
+        return(-1);
+
+    IF_C_API_SIM_OR_UI_THREAD_CAN_READ_DATA
+    {
+        if ( (objectHandle!=sim_handle_all)&&(!doesObjectExist(__func__,objectHandle)) )
+            return(-1);
+        std::vector<int> handles;
+        std::vector<float> info;
+        int cnt=App::currentWorld->dynamicsContainer->getContactForces(dynamicPass,objectHandle,handles,info);
+        objectHandles[0]=nullptr;
+        contactInfo[0]=nullptr;
+        if (cnt>0)
+        {
+            objectHandles[0]=new int[handles.size()];
+            contactInfo[0]=new float[info.size()];
+            for (size_t i=0;i<handles.size();i++)
+                objectHandles[0][i]=handles[i];
+            for (size_t i=0;i<info.size();i++)
+                contactInfo[0][i]=info[i];
+        }
+        return(cnt);
+    }
+    CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_COULD_NOT_LOCK_RESOURCES_FOR_READ);
+    return(-1);
+}
+
 simInt simGroupShapes_internal(const simInt* shapeHandles,simInt shapeCount)
 {
     TRACE_C_API;
@@ -15029,6 +15247,34 @@ simInt simPushDoubleTableOntoStack_internal(simInt stackHandle,const simDouble*
     return(-1);
 }
 
+simInt simPushPackedArrayOntoStack_internal(simInt stackHandle,simInt arrayType,const simVoid* data,simInt count,simBool asLuaUserdata)
+{ // arrayType: 1=uint8, 2=int32, 3=float32, 4=float64. The buffer is copied as a single block
+    TRACE_C_API;
+
+    if (!isSimulatorInitialized(__func__))
+        return(-1);
+
+    IF_C_API_SIM_OR_UI_THREAD_CAN_WRITE_DATA
+    {
+        CInterfaceStack* stack=App::worldContainer->interfaceStackContainer->getStack(stackHandle);
+        if (stack!=nullptr)
+        {
+            if ( (luaWrap_getPackedArrayElementSize(arrayType)>0)&&(count>=0)&&((data!=nullptr)||(count==0)) )
+            {
+                stack->pushPackedArrayTableOntoStack(arrayType,data,count,asLuaUserdata!=0);
+                return(1);
+            }
+            CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_INVALID_ARGUMENT);
+            return(-1);
+        }
+        CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_INVALID_HANDLE);
+        return(-1);
+    }
+
+    CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_COULD_NOT_LOCK_RESOURCES_FOR_READ);
+    return(-1);
+}
+
 simInt simPushTableOntoStack_internal(simInt stackHandle)
 {
     TRACE_C_API;
@@ -15535,6 +15781,38 @@ simInt simGetStackFloatTable_internal(simInt stackHandle,simFloat* array,simInt
     return(-1);
 }
 
+const simVoid* simGetStackPackedArray_internal(simInt stackHandle,simInt* arrayType,simInt* count)
+{ // returns a pointer to the packed buffer of the top item (valid until the stack is modified), or nullptr
+    TRACE_C_API;
+
+    if (!isSimulatorInitialized(__func__))
+        return(nullptr);
+
+    IF_C_API_SIM_OR_UI_THREAD_CAN_READ_DATA
+    {
+        CInterfaceStack* stack=App::worldContainer->interfaceStackContainer->getStack(stackHandle);
+        if (stack!=nullptr)
+        {
+            int t=PACKED_ARRAY_NONE;
+            int c=0;
+            const void* retVal=stack->getStackPackedArray(t,c);
+            if (retVal!=nullptr)
+            {
+                arrayType[0]=t;
+                count[0]=c;
+                return(retVal);
+            }
+            CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_INVALID_STACK_CONTENT);
+            return(nullptr);
+        }
+        CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_INVALID_HANDLE);
+        return(nullptr);
+    }
+
+    CApiErrors::setCapiCallErrorMessage(__func__,SIM_ERROR_COULD_NOT_LOCK_RESOURCES_FOR_READ);
+    return(nullptr);
+}
+
 simInt simGetStackDoubleTable_internal(simInt stackHandle,simDouble* array,simInt count)
 {
     TRACE_C_API;
@@ -17990,6 +18268,17 @@ simInt _simHandleCustomContact_internal(simInt objHandle1,simInt objHandle2,simI
 { // Careful with this function: it can also be called from any other thread (e.g. generated by the physics engine)
     TRACE_C_API;
 
+    // 0. Batched filtering (all candidate pairs handled in one script call per dyn. step):
+    if ( ((engine&1024)==0)&&App::currentWorld->embeddedScriptContainer->isContactCallbackBatchFunctionAvailable() )
+    {
+        int response;
+        if (App::currentWorld->embeddedScriptContainer->handleContactCallbackBatch(objHandle1,objHandle2,engine,response))
+        {
+            dataInt[0]=0;
+            return(response); // 0: no collision, 1: collision with the contact parameters pre-filled by the engine
+        }
+    }
+
     // 1. We handle the new calling method:
     if ( ((engine&1024)==0)&&App::currentWorld->embeddedScriptContainer->isContactCallbackFunctionAvailable() ) // the engine flag 1024 means: the calling thread is not the simulation thread. We would have problems with the scripts
     {
@@ -18563,7 +18852,7 @@ simInt simCopyPasteSelectedObjects_internal()
         App::worldContainer->copyBuffer->memorizeBuffer();
         App::worldContainer->copyBuffer->copyCurrentSelection(&sel,App::currentWorld->environment->getSceneLocked());
         App::currentWorld->sceneObjects->deselectObjects();
-        App::worldContainer->copyBuffer->pasteBuffer(App::currentWorld->environment->getSceneLocked(),3);
+        App::worldContainer->copyBuffer->pasteBuffer(App::currentWorld->environment->getSceneLocked(),3,true);
         App::worldContainer->copyBuffer->restoreBuffer();
         App::worldContainer->copyBuffer->clearMemorizedBuffer();
         return(1);
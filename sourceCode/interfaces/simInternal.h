@@ -105,6 +105,8 @@ simInt simAddScript_internal(simInt scriptProperty);
 simInt simRemoveScript_internal(simInt scriptHandle);
 simInt simRefreshDialogs_internal(simInt refreshDegree);
 simInt simResetProximitySensor_internal(simInt sensorHandle);
+simInt simHandleMill_internal(simInt millHandle,simFloat* removedSurfaceAndVolume);
+simInt simResetMill_internal(simInt millHandle);
 simInt simCheckProximitySensor_internal(simInt sensorHandle,simInt entityHandle,simFloat* detectedPoint);
 simInt simCheckProximitySensorEx_internal(simInt sensorHandle,simInt entityHandle,simInt detectionMode,simFloat detectionThreshold,simFloat maxAngle,simFloat* detectedPoint,simInt* detectedObjectHandle,simFloat* normalVector);
 simInt simCheckProximitySensorEx2_internal(simInt sensorHandle,simFloat* vertexPointer,simInt itemType,simInt itemCount,simInt detectionMode,simFloat detectionThreshold,simFloat maxAngle,simFloat* detectedPoint,simFloat* normalVector);
@@ -387,6 +389,12 @@ simInt simSetShapeInertia_internal(simInt shapeHandle,const simFloat* inertiaMat
 simInt simIsDynamicallyEnabled_internal(simInt objectHandle);
 simInt simGenerateShapeFromPath_internal(const simFloat* path,simInt pathSize,const simFloat* section,simInt sectionSize,simInt options,const simFloat* upVector,simFloat reserved);
 simInt simInitScript_internal(simInt scriptHandle);
+simInt simGetContacts_internal(simInt dynamicPass,simInt objectHandle,simInt** objectHandles,simFloat** contactInfo);
+simInt simPushPackedArrayOntoStack_internal(simInt stackHandle,simInt arrayType,const simVoid* data,simInt count,simBool asLuaUserdata);
+const simVoid* simGetStackPackedArray_internal(simInt stackHandle,simInt* arrayType,simInt* count);
+simInt simRunSimulationBatch_internal(simInt sceneCount,const simChar* const* sceneFiles,simFloat simulationDuration,simInt threadCount,simInt* stepCounts);
+simFloat simGetProximitySensorCalculationTime_internal(simInt sensorHandle);
+simInt simGetRealTimeStatistics_internal(simInt* counters,simInt* histogram,simFloat* times);
 
 
 simInt _simGetContactCallbackCount_internal();
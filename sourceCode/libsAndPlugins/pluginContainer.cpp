@@ -7,6 +7,7 @@
 #include "ttUtil.h"
 #include "apiErrors.h"
 #include "collisionRoutines.h"
+#include "ikConfigValidator.h"
 #include <algorithm>
 
 CPlugin::CPlugin(const char* filename,const char* pluginName)
@@ -15,6 +16,7 @@ CPlugin::CPlugin(const char* filename,const char* pluginName)
     _name=pluginName;
     instance=nullptr;
     geomPlugin_createMesh=nullptr;
+    dynPlugin_getContactForces=nullptr;
     ikPlugin_createEnvironment=nullptr;
     _codeEditor_openModal=nullptr;
     _customUi_msgBox=nullptr;
@@ -161,6 +163,7 @@ int CPlugin::load()
                 dynPlugin_getParticles=(ptr_dynPlugin_getParticles)(VVarious::resolveLibraryFuncName(lib,"dynPlugin_getParticles"));
                 dynPlugin_getParticleData=(ptr_dynPlugin_getParticleData)(VVarious::resolveLibraryFuncName(lib,"dynPlugin_getParticleData"));
                 dynPlugin_getContactForce=(ptr_dynPlugin_getContactForce)(VVarious::resolveLibraryFuncName(lib,"dynPlugin_getContactForce"));
+                dynPlugin_getContactForces=(ptr_dynPlugin_getContactForces)(VVarious::resolveLibraryFuncName(lib,"dynPlugin_getContactForces")); // optional
                 dynPlugin_reportDynamicWorldConfiguration=(ptr_dynPlugin_reportDynamicWorldConfiguration)(VVarious::resolveLibraryFuncName(lib,"dynPlugin_reportDynamicWorldConfiguration"));
                 dynPlugin_getDynamicStepDivider=(ptr_dynPlugin_getDynamicStepDivider)(VVarious::resolveLibraryFuncName(lib,"dynPlugin_getDynamicStepDivider"));
                 dynPlugin_getEngineInfo=(ptr_dynPlugin_getEngineInfo)(VVarious::resolveLibraryFuncName(lib,"dynPlugin_getEngineInfo"));
@@ -853,6 +856,39 @@ bool CPluginContainer::dyn_getContactForce(int dynamicPass,int objectHandle,int
     return(false);
 }
 
+int CPluginContainer::dyn_getContactForces(int dynamicPass,int objectHandle,std::vector<int>& objectHandles,std::vector<float>& contactInfo)
+{ // returns all contacts of a pass in one go: 2 handles and 9 values (position, force, normal) per contact
+    objectHandles.clear();
+    contactInfo.clear();
+    if (currentDynEngine==nullptr)
+        return(0);
+    if (currentDynEngine->dynPlugin_getContactForces!=nullptr)
+    { // the engine supports the bulk export. First get the count, then the data:
+        int cnt=currentDynEngine->dynPlugin_getContactForces(dynamicPass,objectHandle,0,nullptr,nullptr);
+        if (cnt>0)
+        {
+            objectHandles.resize(size_t(cnt)*2);
+            contactInfo.resize(size_t(cnt)*9);
+            cnt=currentDynEngine->dynPlugin_getContactForces(dynamicPass,objectHandle,cnt,&objectHandles[0],&contactInfo[0]);
+            objectHandles.resize(size_t(cnt)*2);
+            contactInfo.resize(size_t(cnt)*9);
+        }
+        return(int(objectHandles.size()/2));
+    }
+    // Older engines: we still fetch the contacts one by one, but without going through the API each time:
+    int handles[2];
+    float info[9];
+    int index=0;
+    while (currentDynEngine->dynPlugin_getContactForce(dynamicPass,objectHandle,index+sim_handleflag_extended,handles,info)!=0)
+    {
+        objectHandles.push_back(handles[0]);
+        objectHandles.push_back(handles[1]);
+        contactInfo.insert(contactInfo.end(),info,info+9);
+        index++;
+    }
+    return(index);
+}
+
 void CPluginContainer::dyn_reportDynamicWorldConfiguration(int totalPassesCount,char doNotApplyJointIntrinsicPositions,float simulationTime)
 {
     if (currentDynEngine!=nullptr)
@@ -2520,44 +2556,6 @@ int CPluginContainer::ikPlugin_getConfigForTipPose(int ikGroupHandle,int jointCn
     return(retVal);
 }
 
-static std::vector<int> _ikValidationCb_collisionPairs;
-static std::vector<int> _ikValidationCb_jointHandles;
-
-bool _validationCallback(float* conf)
-{
-    bool collisionFree=true;
-    std::vector<float> memorized;
-    std::vector<CJoint*> joints;
-    for (size_t i=0;i<_ikValidationCb_jointHandles.size();i++)
-    {
-        CJoint* it=App::currentWorld->sceneObjects->getJointFromHandle(_ikValidationCb_jointHandles[i]);
-        joints.push_back(it);
-        memorized.push_back(it->getPosition());
-        it->setPosition(conf[i]);
-    }
-    for (size_t i=0;i<_ikValidationCb_collisionPairs.size()/2;i++)
-    {
-        int robot=_ikValidationCb_collisionPairs[2*i+0];
-        if (robot>=0)
-        {
-            int env=_ikValidationCb_collisionPairs[2*i+1];
-            if (env==sim_handle_all)
-                env=-1;
-            if (CCollisionRoutine::doEntitiesCollide(robot,env,nullptr,false,false,nullptr))
-            {
-                collisionFree=false;
-                break;
-            }
-        }
-    }
-    for (size_t i=0;i<_ikValidationCb_jointHandles.size();i++)
-    {
-        CJoint* it=joints[i];
-        it->setPosition(memorized[i]);
-    }
-    return(collisionFree);
-}
-
 int CPluginContainer::ikPlugin_getConfigForTipPose(int ikGroupHandle,int jointCnt,const int* jointHandles,float thresholdDist,int maxIterationsOrTimeInMs,float* retConfig,const float* metric,int collisionPairCnt,const int* collisionPairs,const int* jointOptions,const float* lowLimits,const float* ranges,std::string& errString)
 {
     int retVal=-1;
@@ -2567,8 +2565,6 @@ int CPluginContainer::ikPlugin_getConfigForTipPose(int ikGroupHandle,int jointCn
         bool err=false;
         if ( (collisionPairCnt>0)&&(collisionPairs!=nullptr) )
         {
-            _ikValidationCb_jointHandles.assign(jointHandles,jointHandles+jointCnt);
-            _ikValidationCb_collisionPairs.clear();
             for (size_t i=0;i<size_t(collisionPairCnt);i++)
             {
                 CSceneObject* eo1=App::currentWorld->sceneObjects->getObjectFromHandle(collisionPairs[2*i+0]);
@@ -2576,15 +2572,27 @@ int CPluginContainer::ikPlugin_getConfigForTipPose(int ikGroupHandle,int jointCn
                 CSceneObject* eo2=App::currentWorld->sceneObjects->getObjectFromHandle(collisionPairs[2*i+1]);
                 CCollection* ec2=App::currentWorld->collections->getObjectFromHandle(collisionPairs[2*i+1]);
                 err=err||( ((eo1==nullptr)&&(ec1==nullptr)) || ((eo2==nullptr)&&(ec2==nullptr)&&(collisionPairs[2*i+1]!=sim_handle_all)) );
-                _ikValidationCb_collisionPairs.push_back(collisionPairs[2*i+0]);
-                _ikValidationCb_collisionPairs.push_back(collisionPairs[2*i+1]);
             }
-            _validationCB=_validationCallback;
+            _validationCB=CIkConfigValidator::validationCallback;
             if (err)
                 errString=SIM_ERROR_INVALID_COLLISION_PAIRS;
         }
         if (!err)
+        { // candidate configurations are checked on a snapshot of the scene, the joints of the scene are not touched
+            CIkConfigValidator* previousValidator=nullptr;
+            CIkConfigValidator* validator=nullptr;
+            if (_validationCB!=nullptr)
+            {
+                validator=new CIkConfigValidator(jointCnt,jointHandles,collisionPairCnt,collisionPairs);
+                previousValidator=CIkConfigValidator::setCurrentValidator(validator);
+            }
             retVal=ikPlugin_getConfigForTipPose(ikGroupHandle,jointCnt,jointHandles,thresholdDist,maxIterationsOrTimeInMs,retConfig,metric,_validationCB,jointOptions,lowLimits,ranges,errString);
+            if (validator!=nullptr)
+            {
+                CIkConfigValidator::setCurrentValidator(previousValidator);
+                delete validator;
+            }
+        }
     }
     else
         errString=SIM_ERROR_IK_PLUGIN_NOT_FOUND;
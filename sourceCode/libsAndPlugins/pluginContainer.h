@@ -30,6 +30,7 @@ typedef float* (__cdecl *ptr_dynPlugin_getContactPoints)(int*);
 typedef void** (__cdecl *ptr_dynPlugin_getParticles)(int,int*,int*,float**);
 typedef char (__cdecl *ptr_dynPlugin_getParticleData)(const void*,float*,float*,int*,float**);
 typedef char (__cdecl *ptr_dynPlugin_getContactForce)(int,int,int,int*,float*);
+typedef int (__cdecl *ptr_dynPlugin_getContactForces)(int,int,int,int*,float*); // optional bulk export
 typedef void (__cdecl *ptr_dynPlugin_reportDynamicWorldConfiguration)(int,char,float);
 typedef int (__cdecl *ptr_dynPlugin_getDynamicStepDivider)(void);
 typedef int (__cdecl *ptr_dynPlugin_getEngineInfo)(int*,int*,char*,char*);
@@ -213,6 +214,7 @@ public:
     ptr_dynPlugin_getParticles dynPlugin_getParticles;
     ptr_dynPlugin_getParticleData dynPlugin_getParticleData;
     ptr_dynPlugin_getContactForce dynPlugin_getContactForce;
+    ptr_dynPlugin_getContactForces dynPlugin_getContactForces;
     ptr_dynPlugin_reportDynamicWorldConfiguration dynPlugin_reportDynamicWorldConfiguration;
     ptr_dynPlugin_getDynamicStepDivider dynPlugin_getDynamicStepDivider;
     ptr_dynPlugin_getEngineInfo dynPlugin_getEngineInfo;
@@ -412,6 +414,7 @@ public:
     static bool dyn_addParticleObjectItem(int objectHandle,const float* itemData,float simulationTime);
     static bool dyn_getParticleData(const void* particle,float* pos,float* size,int* objectType,float** additionalColor);
     static bool dyn_getContactForce(int dynamicPass,int objectHandle,int index,int objectHandles[2],float contactInfo[6]);
+    static int dyn_getContactForces(int dynamicPass,int objectHandle,std::vector<int>& objectHandles,std::vector<float>& contactInfo);
     static void dyn_endSimulation();
     static void dyn_step(float timeStep,float simulationTime);
     static void dyn_serializeDynamicContent(const char* filenameAndPath,int bulletSerializationBuffer);
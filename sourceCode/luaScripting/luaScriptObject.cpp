@@ -1960,7 +1960,9 @@ CLuaScriptObject::CLuaScriptObject(int scriptTypeOrMinusOneForSerialization)
     _scriptType=scriptTypeOrMinusOneForSerialization;
     _compatibilityModeOrFirstTimeCall_sysCallbacks=true;
     _containsJointCallbackFunction=false;
+    _containsJointCallbackBatchFunction=false;
     _containsContactCallbackFunction=false;
+    _containsContactCallbackBatchFunction=false;
     _containsDynCallbackFunction=false;
     _containsVisionCallbackFunction=false;
     _containsTriggerCallbackFunction=false;
@@ -2505,11 +2507,21 @@ bool CLuaScriptObject::getContainsJointCallbackFunction() const
     return(_containsJointCallbackFunction);
 }
 
+bool CLuaScriptObject::getContainsJointCallbackBatchFunction() const
+{
+    return(_containsJointCallbackBatchFunction);
+}
+
 bool CLuaScriptObject::getContainsContactCallbackFunction() const
 {
     return(_containsContactCallbackFunction);
 }
 
+bool CLuaScriptObject::getContainsContactCallbackBatchFunction() const
+{
+    return(_containsContactCallbackBatchFunction);
+}
+
 bool CLuaScriptObject::getContainsDynCallbackFunction() const
 {
     return(_containsDynCallbackFunction);
@@ -3228,6 +3240,14 @@ bool CLuaScriptObject::launchThreadedChildScript_oldThreads()
     if (CThreadPool::getSimulationStopRequested())// will also return true in case of emergency stop request
         return(false);
 
+    if (CCurrentWorld::getThreadWorld()!=nullptr)
+    { // worlds of a simulation batch run on a worker thread, and can't use the (global) thread pool
+        if (_numberOfPasses==0)
+            App::logMsg(sim_verbosity_warnings,"legacy threaded child scripts are not run in a simulation batch.");
+        _numberOfPasses++;
+        return(false);
+    }
+
     _threadedExecutionUnderWay_oldThreads=true;
     _globalMutex_oldThreads.lock("CLuaScriptObject::launchThreadedChildScript()");
     toBeCalledByThread_oldThreads.push_back(this);
@@ -3528,8 +3548,12 @@ int CLuaScriptObject::_callScriptFunction(int callType,const CInterfaceStack* in
         { // do this only once
             luaWrap_lua_getglobal(L,getSystemCallbackString(sim_syscb_jointcallback,false).c_str());
             _containsJointCallbackFunction=luaWrap_lua_isfunction(L,-1);
+            luaWrap_lua_getglobal(L,JOINT_CALLBACK_BATCH_FUNCTION_NAME);
+            _containsJointCallbackBatchFunction=luaWrap_lua_isfunction(L,-1);
             luaWrap_lua_getglobal(L,getSystemCallbackString(sim_syscb_contactcallback,false).c_str());
             _containsContactCallbackFunction=luaWrap_lua_isfunction(L,-1);
+            luaWrap_lua_getglobal(L,CONTACT_CALLBACK_BATCH_FUNCTION_NAME);
+            _containsContactCallbackBatchFunction=luaWrap_lua_isfunction(L,-1);
             luaWrap_lua_getglobal(L,getSystemCallbackString(sim_syscb_dyncallback,false).c_str());
             _containsDynCallbackFunction=luaWrap_lua_isfunction(L,-1);
             luaWrap_lua_getglobal(L,getSystemCallbackString(sim_syscb_vision,false).c_str());
@@ -3538,7 +3562,7 @@ int CLuaScriptObject::_callScriptFunction(int callType,const CInterfaceStack* in
             _containsTriggerCallbackFunction=luaWrap_lua_isfunction(L,-1);
             luaWrap_lua_getglobal(L,getSystemCallbackString(sim_syscb_userconfig,false).c_str());
             _containsUserConfigCallbackFunction=luaWrap_lua_isfunction(L,-1);
-            luaWrap_lua_pop(L,6);
+            luaWrap_lua_pop(L,8);
         }
         // Push the function name onto the stack (will be automatically popped from stack after _luaPCall):
         std::string funcName(getSystemCallbackString(callType,false));
@@ -4239,7 +4263,9 @@ bool CLuaScriptObject::_killLuaState()
     _addOn_executionState=sim_syscb_init;
     _compatibilityModeOrFirstTimeCall_sysCallbacks=true;
     _containsJointCallbackFunction=false;
+    _containsJointCallbackBatchFunction=false;
     _containsContactCallbackFunction=false;
+    _containsContactCallbackBatchFunction=false;
     _containsDynCallbackFunction=false;
     _containsVisionCallbackFunction=false;
     _containsTriggerCallbackFunction=false;
@@ -5988,10 +6014,6 @@ void CLuaScriptObject::_adjustScriptText13(CLuaScriptObject* scriptObject,bool d
             App::logMsg(sim_verbosity_errors,"Contains sim.getNameSuffix...");
         if (_containsScriptText(scriptObject,"sim.setNameSuffix"))
             App::logMsg(sim_verbosity_errors,"Contains sim.setNameSuffix...");
-        if (_containsScriptText(scriptObject,"sim.resetMill"))
-            App::logMsg(sim_verbosity_errors,"Contains sim.resetMill...");
-        if (_containsScriptText(scriptObject,"sim.handleMill"))
-            App::logMsg(sim_verbosity_errors,"Contains sim.handleMill...");
         if (_containsScriptText(scriptObject,"sim.resetMilling"))
             App::logMsg(sim_verbosity_errors,"Contains sim.resetMilling...");
         if (_containsScriptText(scriptObject,"sim.openTextEditor"))
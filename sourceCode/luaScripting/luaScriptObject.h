@@ -18,6 +18,8 @@
 
 #define SIM_SCRIPT_NAME_INDEX "sim_script_name_index" // keep this global, e.g. not _S.sim_script_name_index
 #define SIM_SCRIPT_HANDLE "sim_script_handle" // keep this global, e.g. not _S.sim_script_handle
+#define JOINT_CALLBACK_BATCH_FUNCTION_NAME "sysCall_jointCallbackBatch" // opt-in: handles all joints of a model in one call per dyn. pass
+#define CONTACT_CALLBACK_BATCH_FUNCTION_NAME "sysCall_contactCallbackBatch" // opt-in: filters all contact pairs in one call per dyn. step
 
 class CLuaScriptObject
 {
@@ -135,7 +137,9 @@ public:
     int extractCommandFromOutsideCommandQueue(int auxVals[4],float aux2Vals[8],int& aux2Count);
 
     bool getContainsJointCallbackFunction() const;
+    bool getContainsJointCallbackBatchFunction() const;
     bool getContainsContactCallbackFunction() const;
+    bool getContainsContactCallbackBatchFunction() const;
     bool getContainsDynCallbackFunction() const;
     bool getContainsVisionCallbackFunction() const;
     bool getContainsTriggerCallbackFunction() const;
@@ -276,7 +280,9 @@ protected:
     std::string _lastError;
     bool _compatibilityModeOrFirstTimeCall_sysCallbacks;
     bool _containsJointCallbackFunction;
+    bool _containsJointCallbackBatchFunction;
     bool _containsContactCallbackFunction;
+    bool _containsContactCallbackBatchFunction;
     bool _containsDynCallbackFunction;
     bool _containsVisionCallbackFunction;
     bool _containsTriggerCallbackFunction;
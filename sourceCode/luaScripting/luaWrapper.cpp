@@ -1,6 +1,7 @@
 #include "luaWrapper.h"
 #include "vVarious.h"
 #include "app.h"
+#include <cstring>
 
 typedef int (__cdecl *pluaLibGet_LUA_MULTRET)(void);
 typedef int (__cdecl *pluaLibGet_LUA_MASKCOUNT)(void);
@@ -913,3 +914,136 @@ int luaWrap_lua_error(luaWrap_lua_State* L)
     else
         return(lua_error((lua_State*)L));
 }
+
+#define PACKED_ARRAY_METATABLE "sim.packedArray"
+#define PACKED_ARRAY_HEADER_SIZE 16 // keeps the payload aligned for doubles
+
+struct SPackedArrayHeader
+{
+    int arrayType;
+    int count;
+};
+
+int luaWrap_getPackedArrayElementSize(int arrayType)
+{
+    if (arrayType==PACKED_ARRAY_UINT8)
+        return(1);
+    if ( (arrayType==PACKED_ARRAY_INT32)||(arrayType==PACKED_ARRAY_FLOAT32) )
+        return(4);
+    if (arrayType==PACKED_ARRAY_FLOAT64)
+        return(8);
+    return(0);
+}
+
+static SPackedArrayHeader* _toPackedArrayHeader(lua_State* L,int idx)
+{
+    void* p=lua_touserdata(L,idx);
+    if (p!=nullptr)
+    {
+        if (lua_getmetatable(L,idx))
+        {
+            luaL_getmetatable(L,PACKED_ARRAY_METATABLE);
+            bool same=(lua_rawequal(L,-1,-2)!=0);
+            lua_pop(L,2);
+            if (same)
+                return((SPackedArrayHeader*)p);
+        }
+    }
+    return(nullptr);
+}
+
+static int _packedArray_index(lua_State* L)
+{ // arr[i], 1-based
+    SPackedArrayHeader* h=_toPackedArrayHeader(L,1);
+    if ( (h!=nullptr)&&lua_isnumber(L,2) )
+    {
+        lua_Integer i=lua_tointeger(L,2)-1;
+        if ( (i>=0)&&(i<h->count) )
+        {
+            unsigned char* data=((unsigned char*)h)+PACKED_ARRAY_HEADER_SIZE;
+            if (h->arrayType==PACKED_ARRAY_UINT8)
+                lua_pushinteger(L,data[i]);
+            else if (h->arrayType==PACKED_ARRAY_INT32)
+                lua_pushinteger(L,((int*)data)[i]);
+            else if (h->arrayType==PACKED_ARRAY_FLOAT32)
+                lua_pushnumber(L,((float*)data)[i]);
+            else
+                lua_pushnumber(L,((double*)data)[i]);
+            return(1);
+        }
+    }
+    lua_pushnil(L);
+    return(1);
+}
+
+static int _packedArray_newindex(lua_State* L)
+{ // arr[i]=v, 1-based, the size is fixed
+    SPackedArrayHeader* h=_toPackedArrayHeader(L,1);
+    if ( (h!=nullptr)&&lua_isnumber(L,2)&&lua_isnumber(L,3) )
+    {
+        lua_Integer i=lua_tointeger(L,2)-1;
+        if ( (i>=0)&&(i<h->count) )
+        {
+            unsigned char* data=((unsigned char*)h)+PACKED_ARRAY_HEADER_SIZE;
+            if (h->arrayType==PACKED_ARRAY_UINT8)
+                data[i]=(unsigned char)lua_tointeger(L,3);
+            else if (h->arrayType==PACKED_ARRAY_INT32)
+                ((int*)data)[i]=(int)lua_tointeger(L,3);
+            else if (h->arrayType==PACKED_ARRAY_FLOAT32)
+                ((float*)data)[i]=(float)lua_tonumber(L,3);
+            else
+                ((double*)data)[i]=lua_tonumber(L,3);
+            return(0);
+        }
+    }
+    luaL_error(L,"invalid packed array index or value.");
+    return(0);
+}
+
+static int _packedArray_len(lua_State* L)
+{
+    SPackedArrayHeader* h=_toPackedArrayHeader(L,1);
+    lua_pushinteger(L,(h!=nullptr)?h->count:0);
+    return(1);
+}
+
+bool luaWrap_pushPackedArray(luaWrap_lua_State* L,int arrayType,const void* data,int count)
+{ // data can be nullptr, in which case the array is zero-initialized
+    int s=luaWrap_getPackedArrayElementSize(arrayType);
+    if ( (lib!=nullptr)||(s==0)||(count<0) )
+        return(false);
+    lua_State* l=(lua_State*)L;
+    SPackedArrayHeader* h=(SPackedArrayHeader*)lua_newuserdata(l,PACKED_ARRAY_HEADER_SIZE+size_t(s)*size_t(count));
+    h->arrayType=arrayType;
+    h->count=count;
+    unsigned char* payload=((unsigned char*)h)+PACKED_ARRAY_HEADER_SIZE;
+    if (data!=nullptr)
+        memcpy(payload,data,size_t(s)*size_t(count));
+    else
+        memset(payload,0,size_t(s)*size_t(count));
+    if (luaL_newmetatable(l,PACKED_ARRAY_METATABLE))
+    { // first use in this Lua state
+        lua_pushcfunction(l,_packedArray_index);
+        lua_setfield(l,-2,"__index");
+        lua_pushcfunction(l,_packedArray_newindex);
+        lua_setfield(l,-2,"__newindex");
+        lua_pushcfunction(l,_packedArray_len);
+        lua_setfield(l,-2,"__len");
+    }
+    lua_setmetatable(l,-2);
+    return(true);
+}
+
+void* luaWrap_toPackedArray(luaWrap_lua_State* L,int idx,int* arrayType,int* count)
+{ // returns nullptr if the value at idx is not a packed array
+    if (lib!=nullptr)
+        return(nullptr);
+    SPackedArrayHeader* h=_toPackedArrayHeader((lua_State*)L,idx);
+    if (h==nullptr)
+        return(nullptr);
+    if (arrayType!=nullptr)
+        arrayType[0]=h->arrayType;
+    if (count!=nullptr)
+        count[0]=h->count;
+    return(((unsigned char*)h)+PACKED_ARRAY_HEADER_SIZE);
+}
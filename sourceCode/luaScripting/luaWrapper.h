@@ -18,6 +18,13 @@ enum {  STACK_OBJECT_NULL=0,
         STACK_OBJECT_INTEGER
 };
 
+enum {  PACKED_ARRAY_NONE=0, // i.e. a regular table
+        PACKED_ARRAY_UINT8,
+        PACKED_ARRAY_INT32,
+        PACKED_ARRAY_FLOAT32,
+        PACKED_ARRAY_FLOAT64
+};
+
 struct luaWrap_lua_Debug
 {
   int event;
@@ -116,3 +123,8 @@ int luaWrap_lua_next(luaWrap_lua_State* L,int idx);
 int luaWrap_lua_stype(luaWrap_lua_State* L,int idx);
 int luaWrap_lua_error(luaWrap_lua_State* L);
 
+// Userdata-backed numeric arrays (not available with an external Lua library):
+int luaWrap_getPackedArrayElementSize(int arrayType);
+bool luaWrap_pushPackedArray(luaWrap_lua_State* L,int arrayType,const void* data,int count);
+void* luaWrap_toPackedArray(luaWrap_lua_State* L,int idx,int* arrayType,int* count);
+
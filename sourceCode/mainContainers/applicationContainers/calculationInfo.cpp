@@ -8,6 +8,13 @@
 #include "simStrings.h"
 #include "vDateTime.h"
 
+thread_local CCalculationInfo* CCurrentCalcInfo::_threadCalcInfo=nullptr;
+
+void CCurrentCalcInfo::setThreadCalcInfo(CCalculationInfo* c)
+{
+    _threadCalcInfo=c;
+}
+
 CCalculationInfo::CCalculationInfo()
 {
     resetInfo(true);
@@ -38,9 +45,14 @@ void CCalculationInfo::resetInfo(bool clearDisp)
     _sensCalcCount=0;
     _sensDetectCount=0;
     _sensCalcDuration=0;
+    _sensParallelCalcCount=0;
+    _sensParallelDuration_us=0;
     _rendSensCalcCount=0;
     _rendSensDetectCount=0;
     _rendSensCalcDuration=0;
+    _rendSensReadbackStall_us=0;
+    _rendSensUiRoundTrips=0;
+    _rendSensUiHandoff_us=0;
     _mainScriptDuration=0;
     _simulationScriptExecCount=0;
     _simulationPassDuration=0;
@@ -48,6 +60,10 @@ void CCalculationInfo::resetInfo(bool clearDisp)
     _dynamicsCalcPasses=0;
     _dynamicsCalcDuration=0;
 
+    _jointCallbackDuration_us=0;
+    _jointCallbackCalls=0;
+    _jointCallbackHandledJoints=0;
+
     _renderingDuration=0;
     if (clearDisp)
     {
@@ -59,6 +75,8 @@ void CCalculationInfo::resetInfo(bool clearDisp)
         _visionSensTxt[1]="";
         _dynamicsTxt[0]="";
         _dynamicsTxt[1]="";
+        _jointCallbackTxt[0]="";
+        _jointCallbackTxt[1]="";
     }
 }
 
@@ -85,7 +103,11 @@ void CCalculationInfo::formatInfo()
     _sensTxt[1]="Calculations: ";
     _sensTxt[1]+=boost::lexical_cast<std::string>(_sensCalcCount)+", detections: ";
     _sensTxt[1]+=boost::lexical_cast<std::string>(_sensDetectCount)+" (";
-    _sensTxt[1]+=boost::lexical_cast<std::string>(_sensCalcDuration)+" ms)";
+    _sensTxt[1]+=boost::lexical_cast<std::string>(_sensCalcDuration+int(_sensParallelDuration_us/1000))+" ms";
+    if (_sensParallelCalcCount>0)
+        _sensTxt[1]+=", "+boost::lexical_cast<std::string>(_sensParallelCalcCount)+" in parallel)";
+    else
+        _sensTxt[1]+=")";
 
     // Vision sensor calculation:
     if (!App::currentWorld->mainSettings->visionSensorsEnabled)
@@ -95,7 +117,12 @@ void CCalculationInfo::formatInfo()
     _visionSensTxt[1]="Calculations: ";
     _visionSensTxt[1]+=boost::lexical_cast<std::string>(_rendSensCalcCount)+", detections: ";
     _visionSensTxt[1]+=boost::lexical_cast<std::string>(_rendSensDetectCount)+" (";
-    _visionSensTxt[1]+=boost::lexical_cast<std::string>(_rendSensCalcDuration)+" ms)";
+    _visionSensTxt[1]+=boost::lexical_cast<std::string>(_rendSensCalcDuration)+" ms";
+    if (_rendSensReadbackStall_us>0)
+        _visionSensTxt[1]+=", readback stall: "+boost::lexical_cast<std::string>(_rendSensReadbackStall_us)+" us";
+    if (_rendSensUiRoundTrips>0)
+        _visionSensTxt[1]+=", UI thread round trips: "+boost::lexical_cast<std::string>(_rendSensUiRoundTrips)+" (handoff: "+boost::lexical_cast<std::string>(_rendSensUiHandoff_us)+" us)";
+    _visionSensTxt[1]+=")";
 
     // Dynamics calculation:
     if (!App::currentWorld->dynamicsContainer->getDynamicsEnabled())
@@ -131,11 +158,22 @@ void CCalculationInfo::formatInfo()
     }
     else
         _dynamicsTxt[1]+="0 (no dynamic content)";
+
+    // Joint callbacks (per-joint or batched):
+    _jointCallbackTxt[0]="";
+    _jointCallbackTxt[1]="";
+    if (_jointCallbackCalls>0)
+    {
+        _jointCallbackTxt[0]="Joint callback calls";
+        _jointCallbackTxt[1]=boost::lexical_cast<std::string>(_jointCallbackCalls)+" for ";
+        _jointCallbackTxt[1]+=boost::lexical_cast<std::string>(_jointCallbackHandledJoints)+" joint controls (";
+        _jointCallbackTxt[1]+=boost::lexical_cast<std::string>(int(getJointCallbackTimePerCall_us()))+" us per call)";
+    }
 }
 
 float CCalculationInfo::getProximitySensorCalculationTime()
 {
-    return(float(_sensCalcDuration)*0.001f);
+    return(float(_sensCalcDuration)*0.001f+float(_sensParallelDuration_us)*0.000001f);
 }
 
 float CCalculationInfo::getVisionSensorCalculationTime()
@@ -163,6 +201,18 @@ float CCalculationInfo::getRenderingDuration()
     return(float(_renderingDuration)*0.001f);
 }
 
+int CCalculationInfo::getJointCallbackCallCount()
+{
+    return(_jointCallbackCalls);
+}
+
+float CCalculationInfo::getJointCallbackTimePerCall_us()
+{
+    if (_jointCallbackCalls==0)
+        return(0.0f);
+    return(float(_jointCallbackDuration_us)/float(_jointCallbackCalls));
+}
+
 void CCalculationInfo::setMainScriptExecutionTime(int duration)
 {
     _mainScriptDuration=duration;
@@ -196,6 +246,15 @@ void CCalculationInfo::proximitySensorSimulationEnd(bool detected)
     _sensCalcDuration+=VDateTime::getTimeDiffInMs(_sensStartTime);
 }
 
+void CCalculationInfo::proximitySensorSimulationAdd(bool detected,unsigned long long int durationInUs)
+{ // for sensors computed in worker threads. The duration is the sensor's own calculation time
+    _sensCalcCount++;
+    if (detected)
+        _sensDetectCount++;
+    _sensParallelCalcCount++;
+    _sensParallelDuration_us+=durationInUs;
+}
+
 void CCalculationInfo::visionSensorSimulationStart()
 {
     _rendSensStartTime=VDateTime::getTimeInMs();
@@ -209,6 +268,29 @@ void CCalculationInfo::visionSensorSimulationEnd(bool detected)
     _rendSensCalcDuration+=VDateTime::getTimeDiffInMs(_rendSensStartTime);
 }
 
+void CCalculationInfo::visionSensorSimulationAdd(bool detected)
+{ // for sensors handled together. Their duration is added with visionSensorSimulationBatchEnd
+    _rendSensCalcCount++;
+    if (detected)
+        _rendSensDetectCount++;
+}
+
+void CCalculationInfo::visionSensorSimulationBatchEnd()
+{
+    _rendSensCalcDuration+=VDateTime::getTimeDiffInMs(_rendSensStartTime);
+}
+
+void CCalculationInfo::visionSensorUiThreadHandoffAdd(unsigned long long int handoffTimeInUs)
+{ // time lost handing a rendering job over to the UI thread and back
+    _rendSensUiRoundTrips++;
+    _rendSensUiHandoff_us+=handoffTimeInUs;
+}
+
+void CCalculationInfo::visionSensorReadbackAdd(unsigned long long int stallTimeInUs)
+{ // time spent waiting for the GPU while reading back images. Part of the vision sensor calculation time
+    _rendSensReadbackStall_us+=stallTimeInUs;
+}
+
 void CCalculationInfo::renderingStart()
 {
     _renderingStartTime=VDateTime::getTimeInMs();
@@ -236,6 +318,18 @@ void CCalculationInfo::dynamicsEnd(int calcPasses,bool dynamicContent)
     _dynamicsContentAvailable=dynamicContent;
 }
 
+void CCalculationInfo::jointCallbackStart()
+{
+    _jointCallbackStartTime_us=VDateTime::getTimeInUs();
+}
+
+void CCalculationInfo::jointCallbackEnd(int handledJoints)
+{
+    _jointCallbackCalls++;
+    _jointCallbackHandledJoints+=handledJoints;
+    _jointCallbackDuration_us+=VDateTime::getTimeInUs()-_jointCallbackStartTime_us;
+}
+
 #ifdef SIM_WITH_GUI
 void CCalculationInfo::printInformation()
 {
@@ -429,6 +523,12 @@ void CCalculationInfo::printInformation()
             // Dynamics calculation:
             App::currentWorld->buttonBlockContainer->getInfoBoxButton(pos,0)->label=_dynamicsTxt[0];
             App::currentWorld->buttonBlockContainer->getInfoBoxButton(pos++,1)->label=_dynamicsTxt[1];
+            // Joint callbacks:
+            if ( (_jointCallbackTxt[0].size()>0)&&(pos<INFO_BOX_ROW_COUNT) )
+            {
+                App::currentWorld->buttonBlockContainer->getInfoBoxButton(pos,0)->label=_jointCallbackTxt[0];
+                App::currentWorld->buttonBlockContainer->getInfoBoxButton(pos++,1)->label=_jointCallbackTxt[1];
+            }
         }
     }
 }
@@ -20,9 +20,14 @@ public:
 
     void proximitySensorSimulationStart();
     void proximitySensorSimulationEnd(bool detected);
+    void proximitySensorSimulationAdd(bool detected,unsigned long long int durationInUs);
 
     void visionSensorSimulationStart();
     void visionSensorSimulationEnd(bool detected);
+    void visionSensorSimulationAdd(bool detected);
+    void visionSensorSimulationBatchEnd();
+    void visionSensorReadbackAdd(unsigned long long int stallTimeInUs);
+    void visionSensorUiThreadHandoffAdd(unsigned long long int handoffTimeInUs);
 
     void renderingStart();
     void renderingEnd();
@@ -31,6 +36,9 @@ public:
     void dynamicsStart();
     void dynamicsEnd(int calcPasses,bool dynamicContent);
 
+    void jointCallbackStart();
+    void jointCallbackEnd(int handledJoints);
+
     void simulationPassStart();
     void simulationPassEnd();
 
@@ -40,6 +48,8 @@ public:
     float getDynamicsCalculationTime();
     float getSimulationPassExecutionTime();
     float getRenderingDuration();
+    int getJointCallbackCallCount();
+    float getJointCallbackTimePerCall_us();
 
 #ifdef SIM_WITH_GUI
     void printInformation();
@@ -59,19 +69,45 @@ private:
     int _sensDetectCount;
     int _sensStartTime;
     int _sensCalcDuration;
+    int _sensParallelCalcCount;
+    unsigned long long int _sensParallelDuration_us;
 
     int _rendSensCalcCount;
     int _rendSensDetectCount;
     int _rendSensStartTime;
     int _rendSensCalcDuration;
+    unsigned long long int _rendSensReadbackStall_us;
+    int _rendSensUiRoundTrips;
+    unsigned long long int _rendSensUiHandoff_us;
 
     int _dynamicsStartTime;
     int _dynamicsCalcDuration;
     int _dynamicsCalcPasses;
     bool _dynamicsContentAvailable;
 
+    unsigned long long int _jointCallbackStartTime_us;
+    unsigned long long int _jointCallbackDuration_us;
+    int _jointCallbackCalls;
+    int _jointCallbackHandledJoints;
+
     std::string _scriptTxt[2];
     std::string _sensTxt[2];
     std::string _visionSensTxt[2];
     std::string _dynamicsTxt[2];
+    std::string _jointCallbackTxt[2];
+};
+
+class CCurrentCalcInfo
+{ // behaves like a CCalculationInfo*. Threads of a simulation batch see their own instance instead of the global one
+public:
+    CCurrentCalcInfo() {_calcInfo=nullptr;}
+    inline CCalculationInfo* operator->() const {return((_threadCalcInfo!=nullptr)?_threadCalcInfo:_calcInfo);}
+    inline operator CCalculationInfo*() const {return((_threadCalcInfo!=nullptr)?_threadCalcInfo:_calcInfo);}
+    inline CCurrentCalcInfo& operator=(CCalculationInfo* c) {_calcInfo=c;return(*this);}
+
+    static void setThreadCalcInfo(CCalculationInfo* c); // nullptr: the thread uses the global instance again
+
+private:
+    CCalculationInfo* _calcInfo;
+    static thread_local CCalculationInfo* _threadCalcInfo;
 };
@@ -4,6 +4,7 @@
 #include "mesh.h"
 #include "simStrings.h"
 #include "app.h"
+#include <set>
 
 CCopyBuffer::CCopyBuffer()
 {
@@ -93,31 +94,22 @@ void CCopyBuffer::clearMemorizedBuffer()
 }
 
 void CCopyBuffer::memorizeBuffer()
-{
+{ // We move the buffer content instead of copying it, since the buffer is anyway overwritten after this call
     // 1. We delete previously memorized objects:
     clearMemorizedBuffer();
 
-    // 2. we copy all objects to the memorized buffer:
-    for (size_t i=0;i<objectBuffer.size();i++)
-        objectBuffer_memorized.push_back(objectBuffer[i]->copyYourself());
-    for (size_t i=0;i<luaScriptBuffer.size();i++)
-        luaScriptBuffer_memorized.push_back(luaScriptBuffer[i]->copyYourself());
-    for (size_t i=0;i<textureObjectBuffer.size();i++)
-        textureObjectBuffer_memorized.push_back(textureObjectBuffer[i]->copyYourself());
+    // 2. we move all objects to the memorized buffer:
+    objectBuffer_memorized.swap(objectBuffer);
+    luaScriptBuffer_memorized.swap(luaScriptBuffer);
+    textureObjectBuffer_memorized.swap(textureObjectBuffer);
 
     // Old:
-    for (size_t i=0;i<collectionBuffer.size();i++)
-        collectionBuffer_memorized.push_back(collectionBuffer[i]->copyYourself());
-    for (size_t i=0;i<collisionBuffer.size();i++)
-        collisionBuffer_memorized.push_back(collisionBuffer[i]->copyYourself());
-    for (size_t i=0;i<distanceBuffer.size();i++)
-        distanceBuffer_memorized.push_back(distanceBuffer[i]->copyYourself());
-    for (size_t i=0;i<ikGroupBuffer.size();i++)
-        ikGroupBuffer_memorized.push_back(ikGroupBuffer[i]->copyYourself());
-    for (size_t i=0;i<pathPlanningTaskBuffer.size();i++)
-        pathPlanningTaskBuffer_memorized.push_back(pathPlanningTaskBuffer[i]->copyYourself());
-    for (size_t i=0;i<buttonBlockBuffer.size();i++)
-        buttonBlockBuffer_memorized.push_back(buttonBlockBuffer[i]->copyYourself());
+    collectionBuffer_memorized.swap(collectionBuffer);
+    collisionBuffer_memorized.swap(collisionBuffer);
+    distanceBuffer_memorized.swap(distanceBuffer);
+    ikGroupBuffer_memorized.swap(ikGroupBuffer);
+    pathPlanningTaskBuffer_memorized.swap(pathPlanningTaskBuffer);
+    buttonBlockBuffer_memorized.swap(buttonBlockBuffer);
 
     _bufferIsFromLockedScene_memorized=_bufferIsFromLockedScene;
 }
@@ -126,32 +118,23 @@ void CCopyBuffer::restoreBuffer()
 {
     // 1. We clear the buffer:
     clearBuffer();
-    // 2. We copy all memorized objects to the buffer:
-    for (size_t i=0;i<objectBuffer_memorized.size();i++)
-        objectBuffer.push_back(objectBuffer_memorized[i]->copyYourself());
-    for (size_t i=0;i<luaScriptBuffer_memorized.size();i++)
-        luaScriptBuffer.push_back(luaScriptBuffer_memorized[i]->copyYourself());
-    for (size_t i=0;i<textureObjectBuffer_memorized.size();i++)
-        textureObjectBuffer.push_back(textureObjectBuffer_memorized[i]->copyYourself());
+    // 2. We move all memorized objects back to the buffer:
+    objectBuffer.swap(objectBuffer_memorized);
+    luaScriptBuffer.swap(luaScriptBuffer_memorized);
+    textureObjectBuffer.swap(textureObjectBuffer_memorized);
 
     // Old:
-    for (size_t i=0;i<collectionBuffer_memorized.size();i++)
-        collectionBuffer.push_back(collectionBuffer_memorized[i]->copyYourself());
-    for (size_t i=0;i<collisionBuffer_memorized.size();i++)
-        collisionBuffer.push_back(collisionBuffer_memorized[i]->copyYourself());
-    for (size_t i=0;i<distanceBuffer_memorized.size();i++)
-        distanceBuffer.push_back(distanceBuffer_memorized[i]->copyYourself());
-    for (size_t i=0;i<ikGroupBuffer_memorized.size();i++)
-        ikGroupBuffer.push_back(ikGroupBuffer_memorized[i]->copyYourself());
-    for (size_t i=0;i<pathPlanningTaskBuffer_memorized.size();i++)
-        pathPlanningTaskBuffer.push_back(pathPlanningTaskBuffer_memorized[i]->copyYourself());
-    for (size_t i=0;i<buttonBlockBuffer_memorized.size();i++)
-        buttonBlockBuffer.push_back(buttonBlockBuffer_memorized[i]->copyYourself());
+    collectionBuffer.swap(collectionBuffer_memorized);
+    collisionBuffer.swap(collisionBuffer_memorized);
+    distanceBuffer.swap(distanceBuffer_memorized);
+    ikGroupBuffer.swap(ikGroupBuffer_memorized);
+    pathPlanningTaskBuffer.swap(pathPlanningTaskBuffer_memorized);
+    buttonBlockBuffer.swap(buttonBlockBuffer_memorized);
 
     _bufferIsFromLockedScene=_bufferIsFromLockedScene_memorized;
 }
 
-int CCopyBuffer::pasteBuffer(bool intoLockedScene,int selectionMode)
+int CCopyBuffer::pasteBuffer(bool intoLockedScene,int selectionMode,bool consumeBuffer)
 { // return -1 means the operation cannot procceed because the scene is not locked (but buffer is), 0=empty buffer, 1=successful
     // This function is very similar to a model-loading operation:
     // Everything is inserted (sceneObjects, collections, etc. ) and then
@@ -168,42 +151,77 @@ int CCopyBuffer::pasteBuffer(bool intoLockedScene,int selectionMode)
     }
 //-------------------------------- Buffer copy -----------------------------------------    
     _copyIsForPasting=true;
-    // First we need to copy the copy-buffers:
+    // First we need to copy the copy-buffers (or take them over, if consumeBuffer is true):
     std::vector<CSceneObject*> objectCopy;
     for (size_t i=0;i<objectBuffer.size();i++)
-        objectCopy.push_back(objectBuffer[i]->copyYourself());
+    {
+        if ( consumeBuffer&&(objectBuffer[i]->getObjectType()!=sim_object_dummy_type) )
+            objectCopy.push_back(objectBuffer[i]);
+        else // dummies adjust their path offset when copied for pasting
+            objectCopy.push_back(objectBuffer[i]->copyYourself());
+    }
+    if (consumeBuffer)
+    {
+        for (size_t i=0;i<objectBuffer.size();i++)
+        {
+            if (objectCopy[i]==objectBuffer[i])
+                objectCopy[i]->setParent(nullptr,false); // like a fresh copy. The parent is set again in the object mapping
+        }
+        for (size_t i=0;i<objectBuffer.size();i++)
+        {
+            if (objectCopy[i]!=objectBuffer[i])
+                delete objectBuffer[i];
+        }
+        objectBuffer.clear();
+    }
 
     std::vector<CLuaScriptObject*> luaScriptCopy;
+    if (consumeBuffer)
+        luaScriptCopy.swap(luaScriptBuffer);
     for (size_t i=0;i<luaScriptBuffer.size();i++)
         luaScriptCopy.push_back(luaScriptBuffer[i]->copyYourself());
 
     std::vector<CTextureObject*> textureObjectCopy;
+    if (consumeBuffer)
+        textureObjectCopy.swap(textureObjectBuffer);
     for (size_t i=0;i<textureObjectBuffer.size();i++)
         textureObjectCopy.push_back(textureObjectBuffer[i]->copyYourself());
 
 
     // Old:
     std::vector<CCollection*> collectionCopy;
+    if (consumeBuffer)
+        collectionCopy.swap(collectionBuffer);
     for (size_t i=0;i<collectionBuffer.size();i++)
         collectionCopy.push_back(collectionBuffer[i]->copyYourself());
 
     std::vector<CCollisionObject_old*> collisionCopy;
+    if (consumeBuffer)
+        collisionCopy.swap(collisionBuffer);
     for (size_t i=0;i<collisionBuffer.size();i++)
         collisionCopy.push_back(collisionBuffer[i]->copyYourself());
 
     std::vector<CDistanceObject_old*> distanceCopy;
+    if (consumeBuffer)
+        distanceCopy.swap(distanceBuffer);
     for (size_t i=0;i<distanceBuffer.size();i++)
         distanceCopy.push_back(distanceBuffer[i]->copyYourself());
 
     std::vector<CIkGroup_old*> ikGroupCopy;
+    if (consumeBuffer)
+        ikGroupCopy.swap(ikGroupBuffer);
     for (size_t i=0;i<ikGroupBuffer.size();i++)
         ikGroupCopy.push_back(ikGroupBuffer[i]->copyYourself());
 
     std::vector<CPathPlanningTask*> pathPlanningTaskCopy;
+    if (consumeBuffer)
+        pathPlanningTaskCopy.swap(pathPlanningTaskBuffer);
     for (size_t i=0;i<pathPlanningTaskBuffer.size();i++)
         pathPlanningTaskCopy.push_back(pathPlanningTaskBuffer[i]->copyYourself());
 
     std::vector<CButtonBlock*> buttonBlockCopy;
+    if (consumeBuffer)
+        buttonBlockCopy.swap(buttonBlockBuffer);
     for (size_t i=0;i<buttonBlockBuffer.size();i++)
         buttonBlockCopy.push_back(buttonBlockBuffer[i]->copyYourself());
 
@@ -336,15 +354,28 @@ void CCopyBuffer::copyCurrentSelection(std::vector<int>* sel,bool fromLockedScen
             objectBuffer[i]->setParentHandle_forSerializationOnly(-1);
     }
 
-    // Other object copy:
+    std::set<int> selectedHandles(sel->begin(),sel->end());
+    std::vector<int> unselected;
+    std::set<int> erasedIds; // unselected objects, and 2D elements attached to them
+    for (size_t i=0;i<App::currentWorld->sceneObjects->getObjectCount();i++)
+    {
+        CSceneObject* obj=App::currentWorld->sceneObjects->getObjectFromIndex(i);
+        if (selectedHandles.find(obj->getObjectHandle())==selectedHandles.end())
+        {
+            unselected.push_back(obj->getObjectHandle());
+            erasedIds.insert(obj->getObjectHandle());
+        }
+    }
+
+    // Other object copy. Items that would anyway be erased further down, when unselected objects are announced
+    // as erased, are not copied in the first place (scripts, 2D elements and textures only depend on scene objects):
     for (size_t i=0;i<App::currentWorld->embeddedScriptContainer->allScripts.size();i++)
     { // Copy only child scripts or customization scripts:
         int st=App::currentWorld->embeddedScriptContainer->allScripts[i]->getScriptType();
-        if ( ( (st==sim_scripttype_childscript)||(st==sim_scripttype_customizationscript) )&&(App::currentWorld->embeddedScriptContainer->allScripts[i]->getObjectHandleThatScriptIsAttachedTo()!=-1) )
+        int attachedTo=App::currentWorld->embeddedScriptContainer->allScripts[i]->getObjectHandleThatScriptIsAttachedTo();
+        if ( ( (st==sim_scripttype_childscript)||(st==sim_scripttype_customizationscript) )&&(attachedTo!=-1)&&(selectedHandles.find(attachedTo)!=selectedHandles.end()) )
             luaScriptBuffer.push_back(App::currentWorld->embeddedScriptContainer->allScripts[i]->copyYourself());
     }
-    for (size_t i=0;i<App::currentWorld->textureContainer->_allTextureObjects.size();i++)
-        textureObjectBuffer.push_back(App::currentWorld->textureContainer->_allTextureObjects[i]->copyYourself());
 
     // Old:
     for (size_t i=0;i<App::currentWorld->collections->getObjectCount();i++)
@@ -363,16 +394,21 @@ void CCopyBuffer::copyCurrentSelection(std::vector<int>* sel,bool fromLockedScen
         pathPlanningTaskBuffer.push_back(App::currentWorld->pathPlanning->allObjects[i]->copyYourself());
     for (size_t i=0;i<App::currentWorld->buttonBlockContainer->allBlocks.size();i++)
     {
-        if ( ((App::currentWorld->buttonBlockContainer->allBlocks[i]->getAttributes()&sim_ui_property_systemblock)==0)&&(App::currentWorld->buttonBlockContainer->allBlocks[i]->getObjectIDAttachedTo()!=-1) )
-            buttonBlockBuffer.push_back(App::currentWorld->buttonBlockContainer->allBlocks[i]->copyYourself());
+        CButtonBlock* block=App::currentWorld->buttonBlockContainer->allBlocks[i];
+        if ( ((block->getAttributes()&sim_ui_property_systemblock)==0)&&(block->getObjectIDAttachedTo()!=-1) )
+        {
+            if (selectedHandles.find(block->getObjectIDAttachedTo())!=selectedHandles.end())
+                buttonBlockBuffer.push_back(block->copyYourself());
+            else
+                erasedIds.insert(block->getBlockID());
+        }
     }
 
-    std::vector<int> unselected;
-    for (size_t i=0;i<App::currentWorld->sceneObjects->getObjectCount();i++)
-    {
-        CSceneObject* obj=App::currentWorld->sceneObjects->getObjectFromIndex(i);
-        if (!App::currentWorld->sceneObjects->isObjectInSelection(obj->getObjectHandle(),sel))
-            unselected.push_back(obj->getObjectHandle());
+    for (size_t i=0;i<App::currentWorld->textureContainer->_allTextureObjects.size();i++)
+    { // a texture is erased once it has no dependent object left
+        CTextureObject* tex=App::currentWorld->textureContainer->_allTextureObjects[i];
+        if ( (erasedIds.size()==0)||tex->hasDependentObjectNotIn(erasedIds) )
+            textureObjectBuffer.push_back(tex->copyYourself());
     }
 
     // Now we make sure the linked info is consistent: we announce to the selected objects
@@ -409,6 +445,7 @@ void CCopyBuffer::serializeCurrentSelection(CSer &ar,std::vector<int>* sel,C7Vec
     //***************************************************
 
     //------------------------------------------------------------
+    int thumbnailSectionStart=int(ar.getFileBuffer()->size());
     if (ar.isBinary())
     {
         ar.storeDataName(SER_MODEL_THUMBNAIL_INFO);
@@ -432,6 +469,7 @@ void CCopyBuffer::serializeCurrentSelection(CSer &ar,std::vector<int>* sel,C7Vec
         App::currentWorld->environment->modelThumbnail_notSerializedHere.serialize(ar,false);
         if (ar.setWritingMode())
             App::currentWorld->environment->modelThumbnail_notSerializedHere.serialize(ar,false);
+        ar.setThumbnailSection(thumbnailSectionStart,int(ar.getFileBuffer()->size()));
     }
     else
     {
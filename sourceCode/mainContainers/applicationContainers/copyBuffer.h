@@ -19,14 +19,14 @@ public:
     virtual ~CCopyBuffer();
 
     void clearBuffer();
-    int pasteBuffer(bool intoLockedScene,int selectionMode);
+    int pasteBuffer(bool intoLockedScene,int selectionMode,bool consumeBuffer=false); // with consumeBuffer, the buffered items go to the scene without being copied, and the buffer is empty afterwards
     bool isBufferEmpty();
     void copyCurrentSelection(std::vector<int>* sel,bool fromLockedScene);
     void serializeCurrentSelection(CSer& ar,std::vector<int>* sel,C7Vector& modelTr,C3Vector& modelBBSize,float modelNonDefaultTranslationStepSize);
     bool isCopyForPasting();
 
-    void memorizeBuffer();
-    void restoreBuffer();
+    void memorizeBuffer(); // moves the buffer content aside (the buffer is empty afterwards)
+    void restoreBuffer(); // moves the memorized content back
     void clearMemorizedBuffer();
 
     void _backupBuffers_temp();
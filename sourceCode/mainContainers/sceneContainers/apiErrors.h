@@ -158,6 +158,8 @@
 #define SIM_ERROR_CANNOT_BE_COMPOUND_SHAPE "Shape cannot be a compound shape."
 #define SIM_ERROR_ASSIMP_PLUGIN_NOT_FOUND "Assimp plugin was not found."
 #define SIM_ERROR_INVALID_MODULE_INFO_TYPE "Invalid module info type."
+#define SIM_ERROR_CANNOT_BE_CALLED_FROM_THIS_THREAD "Cannot be called from this thread."
+#define SIM_ERROR_ONLY_AVAILABLE_IN_HEADLESS_MODE "Only available in headless mode."
 #define SIM_ERROR_COULD_NOT_SET_PARAMETER "Could not set parameter."
 
 
@@ -71,6 +71,7 @@ CDynamicsContainer::CDynamicsContainer()
     _displayContactPoints=false;
     _tempDisabledWarnings=0;
     _currentlyInDynamicsCalculations=false;
+    _dynamicsStepCounter=0;
 
     _gravity=C3Vector(0.0f,0.0f,-9.81f);
     _resetWarningFlags();
@@ -142,9 +143,15 @@ bool CDynamicsContainer::getCurrentlyInDynamicsCalculations()
     return(_currentlyInDynamicsCalculations);
 }
 
+int CDynamicsContainer::getDynamicsStepCounter()
+{
+    return(_dynamicsStepCounter);
+}
+
 void CDynamicsContainer::handleDynamics(float dt)
 {
     App::worldContainer->calcInfo->dynamicsStart();
+    App::currentWorld->simulation->getRealTimeScheduler()->phaseStart(REAL_TIME_PHASE_DYNAMICS);
 
     for (size_t i=0;i<App::currentWorld->sceneObjects->getObjectCount();i++)
     {
@@ -153,6 +160,7 @@ void CDynamicsContainer::handleDynamics(float dt)
             it->setDynamicObjectFlag_forVisualization(0);
     }
     addWorldIfNotThere();
+    _dynamicsStepCounter++;
 
     if (getDynamicsEnabled())
     {
@@ -165,6 +173,7 @@ void CDynamicsContainer::handleDynamics(float dt)
         App::worldContainer->calcInfo->dynamicsEnd(CPluginContainer::dyn_getDynamicStepDivider(),true);
     else
         App::worldContainer->calcInfo->dynamicsEnd(0,false);
+    App::currentWorld->simulation->getRealTimeScheduler()->phaseEnd(REAL_TIME_PHASE_DYNAMICS);
 }
 
 bool CDynamicsContainer::getContactForce(int dynamicPass,int objectHandle,int index,int objectHandles[2],float contactInfo[6])
@@ -174,6 +183,15 @@ bool CDynamicsContainer::getContactForce(int dynamicPass,int objectHandle,int in
     return(false);
 }
 
+int CDynamicsContainer::getContactForces(int dynamicPass,int objectHandle,std::vector<int>& objectHandles,std::vector<float>& contactInfo)
+{
+    objectHandles.clear();
+    contactInfo.clear();
+    if (getDynamicsEnabled())
+        return(CPluginContainer::dyn_getContactForces(dynamicPass,objectHandle,objectHandles,contactInfo));
+    return(0);
+}
+
 void CDynamicsContainer::reportDynamicWorldConfiguration()
 {
     if (getDynamicsEnabled())
@@ -90,6 +90,7 @@ public:
 
     void handleDynamics(float dt);
     bool getContactForce(int dynamicPass,int objectHandle,int index,int objectHandles[2],float contactInfo[6]);
+    int getContactForces(int dynamicPass,int objectHandle,std::vector<int>& objectHandles,std::vector<float>& contactInfo);
 
     void reportDynamicWorldConfiguration();
 
@@ -142,6 +143,7 @@ public:
     int getTempDisabledWarnings();
 
     bool getCurrentlyInDynamicsCalculations();
+    int getDynamicsStepCounter();
 
     float getEngineFloatParam(int what,bool* ok);
     int getEngineIntParam(int what,bool* ok);
@@ -197,6 +199,7 @@ protected:
     int _tempDisabledWarnings; // bits in the same order as above messages
 
     bool _currentlyInDynamicsCalculations;
+    int _dynamicsStepCounter; // incremented with each call to handleDynamics. Not serialized
 
     // To serialize:
     bool _dynamicsEnabled;
@@ -7,9 +7,13 @@
 #include "simStrings.h"
 #include "app.h"
 #include "vDateTime.h"
+#include "jointObject.h"
+#include "shape.h"
+#include <algorithm>
 
 CEmbeddedScriptContainer::CEmbeddedScriptContainer()
 {
+    _contactCallbackBatchDynStep=-1;
     insertDefaultScript_mainAndChildScriptsOnly(sim_scripttype_mainscript,false,false);
 }
 
@@ -25,6 +29,9 @@ CEmbeddedScriptContainer::~CEmbeddedScriptContainer()
 
 void CEmbeddedScriptContainer::simulationAboutToStart()
 {
+    _jointCallbackBatches.clear();
+    _contactCallbackBatchResponses.clear();
+    _contactCallbackBatchDynStep=-1;
     broadcastDataContainer.simulationAboutToStart();
     for (size_t i=0;i<allScripts.size();i++)
         allScripts[i]->simulationAboutToStart();
@@ -36,6 +43,9 @@ void CEmbeddedScriptContainer::simulationEnded()
         allScripts[i]->simulationEnded();
 
     broadcastDataContainer.simulationEnded();
+    _jointCallbackBatches.clear();
+    _contactCallbackBatchResponses.clear();
+    _contactCallbackBatchDynStep=-1;
     removeDestroyedScripts(sim_scripttype_mainscript);
     removeDestroyedScripts(sim_scripttype_childscript);
     for (size_t i=0;i<_callbackStructureToDestroyAtEndOfSimulation_new.size();i++)
@@ -127,6 +137,167 @@ bool CEmbeddedScriptContainer::isContactCallbackFunctionAvailable()
     return(false);
 }
 
+bool CEmbeddedScriptContainer::isContactCallbackBatchFunctionAvailable()
+{
+    for (size_t i=0;i<allScripts.size();i++)
+    {
+        CLuaScriptObject* it=allScripts[i];
+        if (it->getContainsContactCallbackBatchFunction())
+            return(true);
+    }
+    return(false);
+}
+
+bool CEmbeddedScriptContainer::handleContactCallbackBatch(int objHandle1,int objHandle2,int engine,int& response)
+{ // Scripts defining sysCall_contactCallbackBatch receive all candidate pairs at once, as packed arrays
+    // (handles1, handles2), and return a 'response' array: -1=default handling, 0=no collision, 1=collision.
+    // The physics engine reports pairs one at a time, so at the first pair of a new dyn. step we gather the
+    // candidate pairs of the current step ourselves: all pairs of respondable shapes (not both static) whose
+    // world bounding boxes overlap. The decisions are then reused for the whole step (i.e. for all its passes).
+    // A pair that is not part of the batch gets the regular handling (i.e. no additional script call).
+    // Return value is false if no batched decision is available for that pair
+    int dynStep=App::currentWorld->dynamicsContainer->getDynamicsStepCounter();
+    if (dynStep!=_contactCallbackBatchDynStep)
+    {
+        _contactCallbackBatchDynStep=dynStep;
+        _contactCallbackBatchResponses.clear();
+        _buildContactCallbackBatch(engine);
+    }
+    std::map<std::pair<int,int>,int>::iterator it=_contactCallbackBatchResponses.find(std::make_pair(std::min<int>(objHandle1,objHandle2),std::max<int>(objHandle1,objHandle2)));
+    if (it==_contactCallbackBatchResponses.end())
+        return(false);
+    response=it->second;
+    return(response>=0);
+}
+
+void CEmbeddedScriptContainer::_buildContactCallbackBatch(int engine)
+{
+    // 1. Collect the world bounding boxes of the respondable shapes:
+    std::vector<CShape*> shapes;
+    std::vector<C3Vector> minV;
+    std::vector<C3Vector> maxV;
+    for (size_t i=0;i<App::currentWorld->sceneObjects->getShapeCount();i++)
+    {
+        CShape* shape=App::currentWorld->sceneObjects->getShapeFromIndex(i);
+        if (shape->getRespondable())
+        {
+            C7Vector tr(shape->getCumulativeTransformation());
+            C3Vector hs(shape->getBoundingBoxHalfSizes());
+            float margin=0.01f+0.1f*std::max<float>(hs(0),std::max<float>(hs(1),hs(2))); // shapes move during the step
+            C3Vector mi,ma;
+            for (int j=0;j<8;j++)
+            {
+                C3Vector c(tr*C3Vector(hs(0)*float((j&1)*2-1),hs(1)*float((j&2)-1),hs(2)*float((j&4)/2-1)));
+                if (j==0)
+                {
+                    mi=c;
+                    ma=c;
+                }
+                else
+                {
+                    mi.keepMin(c);
+                    ma.keepMax(c);
+                }
+            }
+            mi-=C3Vector(margin,margin,margin);
+            ma+=C3Vector(margin,margin,margin);
+            shapes.push_back(shape);
+            minV.push_back(mi);
+            maxV.push_back(ma);
+        }
+    }
+
+    // 2. Overlapping pairs, with a sweep along x. Static-static pairs never collide, and the respondable masks
+    // must match: the local masks for shapes in the same hierarchy tree, the global masks otherwise:
+    std::vector<int> order(shapes.size());
+    for (size_t i=0;i<order.size();i++)
+        order[i]=int(i);
+    std::sort(order.begin(),order.end(),[&](int a,int b){return(minV[a](0)<minV[b](0));});
+    std::vector<std::pair<int,int> > pairs;
+    for (size_t oi=0;oi<order.size();oi++)
+    {
+        int i=order[oi];
+        for (size_t oj=oi+1;(oj<order.size())&&(minV[order[oj]](0)<=maxV[i](0));oj++)
+        {
+            int j=order[oj];
+            if ( (!shapes[i]->getShapeIsDynamicallyStatic())||(!shapes[j]->getShapeIsDynamicallyStatic()) )
+            {
+                if ( (minV[i](1)<=maxV[j](1))&&(minV[j](1)<=maxV[i](1))&&(minV[i](2)<=maxV[j](2))&&(minV[j](2)<=maxV[i](2)) )
+                {
+                    unsigned short masks=shapes[i]->getDynamicCollisionMask()&shapes[j]->getDynamicCollisionMask();
+                    if (shapes[i]->getLastParentForLocalGlobalRespondable()==shapes[j]->getLastParentForLocalGlobalRespondable())
+                        masks&=0x00ff;
+                    else
+                        masks&=0xff00;
+                    if (masks!=0)
+                    {
+                        int h1=shapes[i]->getObjectHandle();
+                        int h2=shapes[j]->getObjectHandle();
+                        pairs.push_back(std::make_pair(std::min<int>(h1,h2),std::max<int>(h1,h2)));
+                    }
+                }
+            }
+        }
+    }
+    if (pairs.size()==0)
+        return;
+
+    size_t n=pairs.size();
+    std::vector<int> h1(n);
+    std::vector<int> h2(n);
+    for (size_t i=0;i<n;i++)
+    {
+        h1[i]=pairs[i].first;
+        h2[i]=pairs[i].second;
+    }
+    std::vector<int> responses(n,-1);
+    std::vector<int> scriptResponses(n);
+    for (int pass=0;pass<2;pass++)
+    { // child scripts first, then customization scripts (same order as for sysCall_contactCallback)
+        int scriptType=sim_scripttype_childscript;
+        if (pass==1)
+            scriptType=sim_scripttype_customizationscript;
+        for (size_t i=0;i<allScripts.size();i++)
+        {
+            CLuaScriptObject* script=allScripts[i];
+            if ( (script->getScriptType()==scriptType)&&script->getContainsContactCallbackBatchFunction() )
+            {
+                CInterfaceStack stack;
+                stack.pushTableOntoStack();
+                stack.pushStringOntoStack("handles1",0);
+                stack.pushInt32ArrayTableOntoStack(&h1[0],int(n));
+                stack.insertDataIntoStackTable();
+                stack.pushStringOntoStack("handles2",0);
+                stack.pushInt32ArrayTableOntoStack(&h2[0],int(n));
+                stack.insertDataIntoStackTable();
+                stack.pushStringOntoStack("engine",0);
+                stack.pushNumberOntoStack(double(engine));
+                stack.insertDataIntoStackTable();
+                if ( (script->callScriptFunction(CONTACT_CALLBACK_BATCH_FUNCTION_NAME,&stack)==0)&&(stack.getStackSize()>0) )
+                {
+                    if (stack.getStackSize()>1)
+                        stack.moveStackItemToTop(0);
+                    CInterfaceStackObject* obj=stack.getStackMapObject("response");
+                    if ( (obj!=nullptr)&&(obj->getObjectType()==STACK_OBJECT_TABLE)&&((CInterfaceStackTable*)obj)->isTableArray() )
+                    {
+                        CInterfaceStackTable* table=(CInterfaceStackTable*)obj;
+                        size_t cnt=std::min<size_t>(n,size_t(table->getArraySize())); // missing entries mean default handling
+                        if (cnt>0)
+                            table->getInt32Array(&scriptResponses[0],int(cnt));
+                        for (size_t j=0;j<cnt;j++)
+                        {
+                            if ( (responses[j]<0)&&(scriptResponses[j]>=0) )
+                                responses[j]=scriptResponses[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+    for (size_t i=0;i<n;i++)
+        _contactCallbackBatchResponses[pairs[i]]=responses[i];
+}
+
 bool CEmbeddedScriptContainer::isDynCallbackFunctionAvailable()
 {
     for (size_t i=0;i<allScripts.size();i++)
@@ -138,6 +309,209 @@ bool CEmbeddedScriptContainer::isDynCallbackFunctionAvailable()
     return(false);
 }
 
+CLuaScriptObject* CEmbeddedScriptContainer::getJointCallbackBatchScript(int jointHandle) const
+{ // the first child or customization script up the hierarchy that defines the batched joint callback
+    CSceneObject* it=App::currentWorld->sceneObjects->getObjectFromHandle(jointHandle);
+    while (it!=nullptr)
+    {
+        CLuaScriptObject* script=getScriptFromObjectAttachedTo_child(it->getObjectHandle());
+        if ( (script!=nullptr)&&script->getContainsJointCallbackBatchFunction() )
+            return(script);
+        script=getScriptFromObjectAttachedTo_customization(it->getObjectHandle());
+        if ( (script!=nullptr)&&script->getContainsJointCallbackBatchFunction() )
+            return(script);
+        it=it->getParent();
+    }
+    return(nullptr);
+}
+
+bool CEmbeddedScriptContainer::handleJointCallbackBatch(CJoint* joint,bool init,int loopCnt,int totalLoops,float currentPos,float effort,float dynStepSize,float errorV,float& velocity,float& forceTorque)
+{ // Joints in custom control mode that share a script defining sysCall_jointCallbackBatch are all handled with
+    // a single script call per dynamics pass. The first joint requesting control in a given pass triggers the call,
+    // the other joints of that pass are then served from the cached results. The engine only reports the position
+    // and effort of a joint when asking for its control values, so for joints other than the calling one we use the
+    // values the engine last reported for them (i.e. in the previous pass, or the last pass of the previous step):
+    // the batch input is thus built from last-pass values, except for the calling joint. Before a joint was reported
+    // once, its reflected position and last effort are used.
+    CLuaScriptObject* script=getJointCallbackBatchScript(joint->getObjectHandle());
+    if (script==nullptr)
+        return(false);
+    int dynStep=App::currentWorld->dynamicsContainer->getDynamicsStepCounter();
+    if (_jointCallbackBatches.find(script->getScriptHandle())==_jointCallbackBatches.end())
+    {
+        SJointCallbackBatch b;
+        b.dynStep=-1;
+        b.pass=-1;
+        b.velocityReturned=false;
+        b.forceReturned=false;
+        b.jointsDynStep=-1;
+        _jointCallbackBatches[script->getScriptHandle()]=b;
+    }
+    SJointCallbackBatch& batch=_jointCallbackBatches[script->getScriptHandle()];
+    batch.engineValues[joint->getObjectHandle()]=std::make_pair(currentPos,effort);
+    if ( (batch.dynStep==dynStep)&&(batch.pass==loopCnt) )
+    { // the script was already called in this pass
+        std::map<int,std::pair<float,float> >::iterator res=batch.results.find(joint->getObjectHandle());
+        if (res==batch.results.end())
+            return(false); // the call failed or didn't return anything. Don't call again in the same pass
+        if (batch.velocityReturned)
+            velocity=res->second.first;
+        if (batch.forceReturned)
+            forceTorque=res->second.second;
+        return(true);
+    }
+
+    // 1. Gather all the joints handled by this script. The list is built on the first pass of a dynamics step,
+    // the other passes reuse it. The calling joint always comes first:
+    if ( (batch.jointsDynStep!=dynStep)||(std::find(batch.jointHandles.begin(),batch.jointHandles.end(),joint->getObjectHandle())==batch.jointHandles.end()) )
+    {
+        batch.jointsDynStep=dynStep;
+        batch.jointHandles.clear();
+        batch.jointHandles.push_back(joint->getObjectHandle());
+        for (size_t i=0;i<App::currentWorld->sceneObjects->getJointCount();i++)
+        {
+            CJoint* it=App::currentWorld->sceneObjects->getJointFromIndex(i);
+            if ( (it!=joint)&&((it->getJointMode()==sim_jointmode_force)||it->getHybridFunctionality())&&it->getEnableDynamicMotor()&&it->getEnableDynamicMotorControlLoop() )
+            {
+                CLuaScriptObject* s=getScriptFromObjectAttachedTo_child(it->getObjectHandle());
+                if ( (s!=nullptr)&&s->getContainsJointCallbackFunction() )
+                    continue; // the per-joint callback has precedence
+                s=getScriptFromObjectAttachedTo_customization(it->getObjectHandle());
+                if ( (s!=nullptr)&&s->getContainsJointCallbackFunction() )
+                    continue;
+                if (getJointCallbackBatchScript(it->getObjectHandle())==script)
+                    batch.jointHandles.push_back(it->getObjectHandle());
+            }
+        }
+    }
+    std::vector<CJoint*> joints;
+    joints.push_back(joint);
+    for (size_t i=0;i<batch.jointHandles.size();i++)
+    {
+        CJoint* it=App::currentWorld->sceneObjects->getJointFromHandle(batch.jointHandles[i]);
+        if ( (it!=nullptr)&&(it!=joint) )
+            joints.push_back(it);
+    }
+
+    // 2. Prepare the packed input table:
+    size_t n=joints.size();
+    std::vector<int> handles(n);
+    std::vector<float> pos(n),targetPos(n),err(n),eff(n),lowL(n),highL(n),targetVel(n),maxForce(n),velUpperLimit(n);
+    for (size_t i=0;i<n;i++)
+    {
+        CJoint* it=joints[i];
+        handles[i]=it->getObjectHandle();
+        targetPos[i]=it->getDynamicMotorPositionControlTargetPosition();
+        lowL[i]=it->getPositionIntervalMin();
+        highL[i]=it->getPositionIntervalMin()+it->getPositionIntervalRange();
+        targetVel[i]=it->getDynamicMotorTargetVelocity();
+        maxForce[i]=it->getDynamicMotorMaximumForce();
+        velUpperLimit[i]=it->getDynamicMotorUpperLimitVelocity();
+        if (i==0)
+        {
+            pos[i]=currentPos;
+            eff[i]=effort;
+            err[i]=errorV;
+        }
+        else
+        {
+            std::map<int,std::pair<float,float> >::iterator ev=batch.engineValues.find(handles[i]);
+            if (ev!=batch.engineValues.end())
+            {
+                pos[i]=ev->second.first;
+                eff[i]=ev->second.second;
+            }
+            else
+            {
+                pos[i]=it->getPosition();
+                eff[i]=0.0f;
+                it->getDynamicForceOrTorque(eff[i],true);
+            }
+            if (it->getPositionIsCyclic())
+                err[i]=tt::getAngleMinusAlpha(targetPos[i],pos[i]);
+            else
+                err[i]=targetPos[i]-pos[i];
+        }
+    }
+    CInterfaceStack stack;
+    stack.pushTableOntoStack();
+    stack.pushStringOntoStack("first",0);
+    stack.pushBoolOntoStack(init);
+    stack.insertDataIntoStackTable();
+    stack.pushStringOntoStack("passCnt",0);
+    stack.pushNumberOntoStack(loopCnt);
+    stack.insertDataIntoStackTable();
+    stack.pushStringOntoStack("totalPasses",0);
+    stack.pushNumberOntoStack(totalLoops);
+    stack.insertDataIntoStackTable();
+    stack.pushStringOntoStack("dynStepSize",0);
+    stack.pushNumberOntoStack(dynStepSize);
+    stack.insertDataIntoStackTable();
+    stack.pushStringOntoStack("handles",0);
+    stack.pushInt32ArrayTableOntoStack(&handles[0],int(n));
+    stack.insertDataIntoStackTable();
+    stack.pushStringOntoStack("revolute",0);
+    stack.pushTableOntoStack();
+    for (size_t i=0;i<n;i++)
+    {
+        stack.pushInt32OntoStack(int(i+1));
+        stack.pushBoolOntoStack(joints[i]->getJointType()==sim_joint_revolute_subtype);
+        stack.insertDataIntoStackTable();
+    }
+    stack.insertDataIntoStackTable();
+    stack.pushStringOntoStack("cyclic",0);
+    stack.pushTableOntoStack();
+    for (size_t i=0;i<n;i++)
+    {
+        stack.pushInt32OntoStack(int(i+1));
+        stack.pushBoolOntoStack(joints[i]->getPositionIsCyclic());
+        stack.insertDataIntoStackTable();
+    }
+    stack.insertDataIntoStackTable();
+    const char* floatFields[9]={"currentPos","targetPos","errorValue","effort","lowLimit","highLimit","targetVel","maxForce","velUpperLimit"};
+    const std::vector<float>* floatValues[9]={&pos,&targetPos,&err,&eff,&lowL,&highL,&targetVel,&maxForce,&velUpperLimit};
+    for (size_t j=0;j<9;j++)
+    {
+        stack.pushStringOntoStack(floatFields[j],0);
+        stack.pushFloatArrayTableOntoStack(&floatValues[j]->at(0),int(n));
+        stack.insertDataIntoStackTable();
+    }
+
+    // 3. Call the script:
+    App::worldContainer->calcInfo->jointCallbackStart();
+    int res=script->callScriptFunction(JOINT_CALLBACK_BATCH_FUNCTION_NAME,&stack);
+    App::worldContainer->calcInfo->jointCallbackEnd(int(n));
+
+    // 4. Collect the return values:
+    batch.dynStep=dynStep;
+    batch.pass=loopCnt;
+    batch.results.clear();
+    batch.velocityReturned=false;
+    batch.forceReturned=false;
+    if ( (res==0)&&(stack.getStackSize()>0) )
+    {
+        if (stack.getStackSize()>1)
+            stack.moveStackItemToTop(0);
+        std::vector<float> forces(n,0.0f);
+        std::vector<float> velocities(n,0.0f);
+        batch.forceReturned=stack.getStackMapFloatArray("force",&forces[0],int(n));
+        batch.velocityReturned=stack.getStackMapFloatArray("velocity",&velocities[0],int(n));
+        if (batch.forceReturned||batch.velocityReturned)
+        { // a missing array leaves the corresponding values unchanged, as with sysCall_jointCallback
+            for (size_t i=0;i<n;i++)
+                batch.results[handles[i]]=std::make_pair(velocities[i],forces[i]);
+        }
+    }
+    std::map<int,std::pair<float,float> >::iterator r=batch.results.find(joint->getObjectHandle());
+    if (r==batch.results.end())
+        return(false); // error or nothing returned. We let the built-in controller handle the joint
+    if (batch.velocityReturned)
+        velocity=r->second.first;
+    if (batch.forceReturned)
+        forceTorque=r->second.second;
+    return(true);
+}
+
 void CEmbeddedScriptContainer::removeAllScripts()
 {
     TRACE_INTERNAL;
@@ -4,6 +4,20 @@
 #include "broadcastDataContainer.h"
 #include "simInternal.h"
 
+class CJoint;
+
+struct SJointCallbackBatch
+{
+    int dynStep;
+    int pass;
+    std::map<int,std::pair<float,float> > results; // joint handle --> velocity and force/torque
+    bool velocityReturned;
+    bool forceReturned;
+    std::map<int,std::pair<float,float> > engineValues; // joint handle --> last position and effort reported by the engine
+    int jointsDynStep;
+    std::vector<int> jointHandles; // joints handled by the script, gathered once per dynamics step and reused for all passes
+};
+
 class CEmbeddedScriptContainer
 {
 public:
@@ -39,7 +53,11 @@ public:
 
     int handleCascadedScriptExecution(int scriptType,int callTypeOrResumeLocation,CInterfaceStack* inStack,CInterfaceStack* outStack,int* retInfo);
     bool isContactCallbackFunctionAvailable();
+    bool isContactCallbackBatchFunctionAvailable();
+    bool handleContactCallbackBatch(int objHandle1,int objHandle2,int engine,int& response);
     bool isDynCallbackFunctionAvailable();
+    CLuaScriptObject* getJointCallbackBatchScript(int jointHandle) const;
+    bool handleJointCallbackBatch(CJoint* joint,bool init,int loopCnt,int totalLoops,float currentPos,float effort,float dynStepSize,float errorV,float& velocity,float& forceTorque);
 
     void callScripts(int callType,CInterfaceStack* inStack);
     void sceneOrModelAboutToBeSaved(int modelBase);
@@ -50,7 +68,11 @@ public:
 
 protected:
     int _getScriptsToExecute(int scriptType,std::vector<CLuaScriptObject*>& scripts,std::vector<int>& uniqueIds) const;
+    void _buildContactCallbackBatch(int engine);
 
     std::vector<SScriptCallBack*> _callbackStructureToDestroyAtEndOfSimulation_new;
     std::vector<SLuaCallBack*> _callbackStructureToDestroyAtEndOfSimulation_old;
+    std::map<int,SJointCallbackBatch> _jointCallbackBatches; // key is the script handle
+    std::map<std::pair<int,int>,int> _contactCallbackBatchResponses; // responses for the candidate pairs of the current dyn. step (key: smallest handle first)
+    int _contactCallbackBatchDynStep;
 };
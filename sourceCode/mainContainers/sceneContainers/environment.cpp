@@ -105,6 +105,7 @@ void CEnvironment::setUpDefaultValues()
 
     _sceneCanBeDiscardedWhenNewSceneOpened=false;
     autoSaveLastSaveTimeInSecondsSince1970=VDateTime::getSecondsSince1970();
+    autoSaveLastSceneDataHash=0;
 
     backGroundColor[0]=0.72f;
     backGroundColor[1]=0.81f;
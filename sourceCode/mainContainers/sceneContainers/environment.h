@@ -102,6 +102,7 @@ public:
     bool getShowPalletRepository();
 
     quint64 autoSaveLastSaveTimeInSecondsSince1970;
+    unsigned long long autoSaveLastSceneDataHash; // 0: scene not yet auto-saved
     float fogBackgroundColor[3];
     float backGroundColor[3];
     float backGroundColorDown[3];
@@ -2,9 +2,12 @@
 #include "ghostObjectContainer.h"
 #include "app.h"
 #include "sceneObjectOperations.h"
+#include "ghostRendering.h"
+#include <algorithm>
 
 CGhostObjectContainer::CGhostObjectContainer()
 {
+    _timeIndexValid=false;
 }
 
 CGhostObjectContainer::~CGhostObjectContainer()
@@ -60,6 +63,7 @@ int CGhostObjectContainer::addGhost(int theGroupId,int theObjectHandle,int theOp
             ghost->ghostId=nextGhostId;
             retVal=nextGhostId;
             _allObjects.push_back(ghost);
+            _timeIndexValid=false;
         }
     }
     return(retVal);
@@ -146,6 +150,8 @@ int CGhostObjectContainer::modifyGhost(int groupId,int ghostId,int operation,flo
             }
         }
     }
+    if ( (operation>=2)&&(operation<=10)&&(retVal>0) )
+        _timeIndexValid=false; // times or options changed
     return(retVal);
 }
 
@@ -174,6 +180,8 @@ int CGhostObjectContainer::removeGhost(int groupId,int ghostId)
                 i++;
         }
     }
+    if (retVal>0)
+        _timeIndexValid=false;
     return(retVal);
 }
 
@@ -186,6 +194,7 @@ void CGhostObjectContainer::announceObjectWillBeErased(int objID)
         {
             delete _allObjects[i];
             _allObjects.erase(_allObjects.begin()+i);
+            _timeIndexValid=false;
         }
         else
             i++;
@@ -255,6 +264,7 @@ void CGhostObjectContainer::serialize(CSer& ar)
                             ar >> go->tr.X(0) >> go->tr.X(1) >> go->tr.X(2);
                             ar >> go->tr.Q(0) >> go->tr.Q(1) >> go->tr.Q(2) >> go->tr.Q(3);
                             _allObjects.push_back(go);
+                            _timeIndexValid=false;
                         }
                     }
                     if (theName.compare("V02")==0)
@@ -278,6 +288,7 @@ void CGhostObjectContainer::serialize(CSer& ar)
                             ar >> go->tr.X(0) >> go->tr.X(1) >> go->tr.X(2);
                             ar >> go->tr.Q(0) >> go->tr.Q(1) >> go->tr.Q(2) >> go->tr.Q(3);
                             _allObjects.push_back(go);
+                            _timeIndexValid=false;
                         }
                     }
                     if (noHit)
@@ -353,6 +364,7 @@ void CGhostObjectContainer::serialize(CSer& ar)
                     }
 
                     _allObjects.push_back(go);
+                    _timeIndexValid=false;
 
                     if (!ar.xmlPushSiblingNode("ghost",false))
                         break;
@@ -369,13 +381,9 @@ void CGhostObjectContainer::renderYour3DStuff_nonTransparent(CViewableBase* rend
     {
         if (!App::currentWorld->simulation->isSimulationStopped())
         {
-            float simulationTime=float(App::currentWorld->simulation->getSimulationTime_us())/1000000.0f;
-            float realTime=float(App::currentWorld->simulation->getSimulationTime_real_us())/1000000.0f;
-            for (size_t i=0;i<_allObjects.size();i++)
-            {
-                if (_allObjects[i]->transparencyFactor==0)
-                    _allObjects[i]->render(displayAttrib,simulationTime,realTime);
-            }
+            std::vector<int> ghostIndices;
+            _getActiveGhosts(false,ghostIndices);
+            _renderGhosts(ghostIndices,displayAttrib);
         }
     }
 }
@@ -386,13 +394,9 @@ void CGhostObjectContainer::renderYour3DStuff_transparent(CViewableBase* renderi
     {
         if (!App::currentWorld->simulation->isSimulationStopped())
         {
-            float simulationTime=float(App::currentWorld->simulation->getSimulationTime_us())/1000000.0f;
-            float realTime=float(App::currentWorld->simulation->getSimulationTime_real_us())/1000000.0f;
-            for (size_t i=0;i<_allObjects.size();i++)
-            {
-                if (_allObjects[i]->transparencyFactor!=0)
-                    _allObjects[i]->render(displayAttrib,simulationTime,realTime);
-            }
+            std::vector<int> ghostIndices;
+            _getActiveGhosts(true,ghostIndices);
+            _renderGhosts(ghostIndices,displayAttrib);
         }
     }
 }
@@ -403,3 +407,79 @@ void CGhostObjectContainer::renderYour3DStuff_overlay(CViewableBase* renderingOb
 //  {
 //  }
 }
+
+void CGhostObjectContainer::_getActiveGhosts(bool transparent,std::vector<int>& ghostIndices)
+{ // returns the visible ghosts that are active at the current time, sorted by appearance
+    if (!_timeIndexValid)
+    {
+        _simulationTimeIndex.clear();
+        _realTimeIndex.clear();
+        for (size_t i=0;i<_allObjects.size();i++)
+        {
+            CGhostObject* ghost=_allObjects[i];
+            if ((ghost->options&2)!=0)
+                _realTimeIndex.addItem(int(i),ghost->startTime,ghost->endTime);
+            else
+                _simulationTimeIndex.addItem(int(i),ghost->startTime-0.00005f,ghost->endTime-0.00005f);
+        }
+        _simulationTimeIndex.rebuild();
+        _realTimeIndex.rebuild();
+        _timeIndexValid=true;
+    }
+    float simulationTime=float(App::currentWorld->simulation->getSimulationTime_us())/1000000.0f;
+    float realTime=float(App::currentWorld->simulation->getSimulationTime_real_us())/1000000.0f;
+    ghostIndices.clear();
+    for (size_t j=0;j<2;j++)
+    {
+        const std::vector<int>* active;
+        if (j==0)
+            active=&_simulationTimeIndex.getActiveItems(simulationTime);
+        else
+            active=&_realTimeIndex.getActiveItems(realTime);
+        for (size_t i=0;i<active->size();i++)
+        {
+            CGhostObject* ghost=_allObjects[active->at(i)];
+            if ( ((ghost->options&16)==0)&&((ghost->transparencyFactor!=0)==transparent) )
+                ghostIndices.push_back(active->at(i));
+        }
+    }
+    std::sort(ghostIndices.begin(),ghostIndices.end(),[this](int a,int b)
+    {
+        int c=_compareGhostAppearances(_allObjects[a],_allObjects[b]);
+        if (c!=0)
+            return(c<0);
+        return(a<b);
+    });
+}
+
+void CGhostObjectContainer::_renderGhosts(const std::vector<int>& ghostIndices,int displayAttrib)
+{ // ghosts of the same shape that look the same are drawn as one batch
+    std::vector<C7Vector> transformations;
+    size_t i=0;
+    while (i<ghostIndices.size())
+    {
+        CGhostObject* ghost=_allObjects[ghostIndices[i]];
+        transformations.clear();
+        while ( (i<ghostIndices.size())&&(_compareGhostAppearances(ghost,_allObjects[ghostIndices[i]])==0) )
+            transformations.push_back(_allObjects[ghostIndices[i++]]->tr);
+        CShape* shape=App::currentWorld->sceneObjects->getShapeFromHandle(ghost->objectHandle);
+        if (shape!=nullptr)
+            displayGhosts(shape,transformations,displayAttrib,ghost->options,float(ghost->transparencyFactor)/255.0f,ghost->color);
+    }
+}
+
+int CGhostObjectContainer::_compareGhostAppearances(const CGhostObject* ghost1,const CGhostObject* ghost2)
+{ // everything but the transformation
+    if (ghost1->objectHandle!=ghost2->objectHandle)
+        return((ghost1->objectHandle<ghost2->objectHandle)?-1:1);
+    if (ghost1->options!=ghost2->options)
+        return((ghost1->options<ghost2->options)?-1:1);
+    if (ghost1->transparencyFactor!=ghost2->transparencyFactor)
+        return((ghost1->transparencyFactor<ghost2->transparencyFactor)?-1:1);
+    for (size_t i=0;i<12;i++)
+    {
+        if (ghost1->color[i]!=ghost2->color[i])
+            return((ghost1->color[i]<ghost2->color[i])?-1:1);
+    }
+    return(0);
+}
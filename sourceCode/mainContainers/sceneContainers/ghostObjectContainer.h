@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ghostObject.h"
+#include "ghostTimeIndex.h"
 #include "ser.h"
 
 class CViewableBase;
@@ -22,5 +23,14 @@ public:
     void serialize(CSer& ar);
 
 protected:
+    void _getActiveGhosts(bool transparent,std::vector<int>& ghostIndices);
+    void _renderGhosts(const std::vector<int>& ghostIndices,int displayAttrib);
+    static int _compareGhostAppearances(const CGhostObject* ghost1,const CGhostObject* ghost2);
+
     std::vector<CGhostObject*> _allObjects;
+
+    // Ghosts by time, for rendering. Invalidated whenever ghosts are added, removed, or their times or options change:
+    CGhostTimeIndex _simulationTimeIndex;
+    CGhostTimeIndex _realTimeIndex; // for ghosts with real-time playback
+    bool _timeIndexValid;
 };
@@ -0,0 +1,95 @@
+#include "ghostTimeIndex.h"
+#include <algorithm>
+
+CGhostTimeIndex::CGhostTimeIndex()
+{
+    clear();
+}
+
+CGhostTimeIndex::~CGhostTimeIndex()
+{
+}
+
+void CGhostTimeIndex::clear()
+{
+    _items.clear();
+    _startTimes.clear();
+    _endTimes.clear();
+    rebuild();
+}
+
+void CGhostTimeIndex::addItem(int item,float startTime,float endTime)
+{
+    _items.push_back(item);
+    _startTimes.push_back(startTime);
+    _endTimes.push_back(endTime);
+}
+
+void CGhostTimeIndex::rebuild()
+{
+    _startOrder.resize(_items.size());
+    _endOrder.resize(_items.size());
+    for (size_t i=0;i<_items.size();i++)
+    {
+        _startOrder[i]=int(i);
+        _endOrder[i]=int(i);
+    }
+    std::sort(_startOrder.begin(),_startOrder.end(),[this](int a,int b){ return(_startTimes[a]<_startTimes[b]); });
+    std::sort(_endOrder.begin(),_endOrder.end(),[this](int a,int b){ return(_endTimes[a]<_endTimes[b]); });
+    _activePos.assign(_items.size(),-1);
+    _ended.assign(_items.size(),false);
+    _activeIndices.clear();
+    _activeItems.clear();
+    _startCursor=0;
+    _endCursor=0;
+    _time=0.0f;
+    _activeItemsValid=false;
+}
+
+const std::vector<int>& CGhostTimeIndex::getActiveItems(float time)
+{
+    if (_activeItemsValid&&(time==_time))
+        return(_activeItems);
+    if (time<_time)
+        rebuild();
+    while ( (_startCursor<int(_startOrder.size()))&&(_startTimes[_startOrder[_startCursor]]<=time) )
+    {
+        int i=_startOrder[_startCursor++];
+        if (!_ended[i])
+            _activate(i);
+    }
+    while ( (_endCursor<int(_endOrder.size()))&&(_endTimes[_endOrder[_endCursor]]<=time) )
+    {
+        int i=_endOrder[_endCursor++];
+        _ended[i]=true;
+        _deactivate(i);
+    }
+    _time=time;
+    _activeItems.resize(_activeIndices.size());
+    for (size_t i=0;i<_activeIndices.size();i++)
+        _activeItems[i]=_items[_activeIndices[i]];
+    _activeItemsValid=true;
+    return(_activeItems);
+}
+
+void CGhostTimeIndex::_activate(int i)
+{
+    if (_activePos[i]==-1)
+    {
+        _activePos[i]=int(_activeIndices.size());
+        _activeIndices.push_back(i);
+    }
+}
+
+void CGhostTimeIndex::_deactivate(int i)
+{ // the last active item takes the freed slot
+    int pos=_activePos[i];
+    if (pos!=-1)
+    {
+        int last=_activeIndices.back();
+        _activeIndices[pos]=last;
+        _activePos[last]=pos;
+        _activeIndices.pop_back();
+        _activePos[i]=-1;
+    }
+}
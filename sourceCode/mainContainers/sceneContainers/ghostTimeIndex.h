@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+// Finds the items that are active at a given time, i.e. with startTime<=time<endTime. Start and end times are
+// kept sorted, and the active items are updated by sweeping over the times that were passed since the previous
+// query: this is cheap when time advances little between queries (e.g. during playback). Going back in time
+// restarts the sweep from the beginning
+class CGhostTimeIndex
+{
+public:
+    CGhostTimeIndex();
+    virtual ~CGhostTimeIndex();
+
+    void clear();
+    void addItem(int item,float startTime,float endTime); // call rebuild after adding items
+    void rebuild();
+    const std::vector<int>& getActiveItems(float time);
+
+protected:
+    void _activate(int i);
+    void _deactivate(int i);
+
+    std::vector<int> _items;
+    std::vector<float> _startTimes;
+    std::vector<float> _endTimes;
+    std::vector<int> _startOrder; // indices, sorted by start time
+    std::vector<int> _endOrder; // indices, sorted by end time
+    std::vector<int> _activePos; // position in _activeIndices, or -1
+    std::vector<bool> _ended;
+    std::vector<int> _activeIndices;
+    std::vector<int> _activeItems;
+    int _startCursor;
+    int _endCursor;
+    float _time;
+    bool _activeItemsValid;
+};
@@ -0,0 +1,206 @@
+#include "realTimeScheduler.h"
+#include "vDateTime.h"
+#include "vThread.h"
+
+CRealTimeScheduler::CRealTimeScheduler()
+{
+    reset();
+}
+
+CRealTimeScheduler::~CRealTimeScheduler()
+{
+}
+
+void CRealTimeScheduler::reset()
+{
+    _started=false;
+    _inStep=false;
+    _deadlineMissAttributed=false;
+    _period_us=0;
+    _release_us=0;
+    _deadline_us=0;
+    _stepStart_us=0;
+    for (int i=0;i<REAL_TIME_PHASE_CNT;i++)
+    {
+        _phaseStart_us[i]=0;
+        _phaseTime_us[i]=0;
+        _phaseDepth[i]=0;
+        _phaseDeadlineMissCnt[i]=0;
+        _totalPhaseTime_us[i]=0;
+        _maxPhaseTime_us[i]=0;
+    }
+    _stepCnt=0;
+    _deadlineMissCnt=0;
+    _skippedReleaseCnt=0;
+    for (int i=0;i<REAL_TIME_HISTOGRAM_SIZE;i++)
+        _histogram[i]=0;
+    _totalStepTime_us=0;
+    _maxStepTime_us=0;
+    _totalJitter_us=0;
+    _maxJitter_us=0;
+    _maxLateness_us=0;
+}
+
+void CRealTimeScheduler::reanchor()
+{
+    _started=false;
+    _inStep=false;
+}
+
+bool CRealTimeScheduler::isStepDue() const
+{ // the next release is the current step's deadline
+    if (!_started)
+        return(true);
+    return(VDateTime::getTimeInUs()>=_deadline_us);
+}
+
+void CRealTimeScheduler::waitForNextStep(unsigned long long int maxWaitTimeInUs,unsigned long long int spinTimeInUs) const
+{ // returns at the next release, or after maxWaitTimeInUs, whatever comes first
+    if (!_started)
+        return;
+    unsigned long long int t=VDateTime::getTimeInUs()+maxWaitTimeInUs;
+    if (_deadline_us<t)
+        t=_deadline_us;
+    waitUntil(t,spinTimeInUs);
+}
+
+void CRealTimeScheduler::waitUntil(unsigned long long int timeInUs,unsigned long long int spinTimeInUs)
+{ // sleeping is only accurate to a few ms, depending on the OS: we sleep until spinTimeInUs before timeInUs, then spin
+    while (true)
+    {
+        unsigned long long int now=VDateTime::getTimeInUs();
+        if (now>=timeInUs)
+            break;
+        unsigned long long int remaining=timeInUs-now;
+        if (remaining>spinTimeInUs+1000)
+            VThread::sleep(int((remaining-spinTimeInUs)/1000));
+        else
+            VThread::switchThread();
+    }
+}
+
+void CRealTimeScheduler::stepStart(unsigned long long int periodInUs,bool catchUpIfLate)
+{
+    unsigned long long int now=VDateTime::getTimeInUs();
+    if (periodInUs==0)
+        periodInUs=1;
+    if (_started&&(periodInUs!=_period_us))
+        _started=false; // e.g. the simulation speed changed. Releases of the old period are meaningless now
+    if (_started)
+        _release_us=_deadline_us;
+    else
+    {
+        _started=true;
+        _release_us=now;
+    }
+    _period_us=periodInUs;
+    if (now<_release_us)
+        _release_us=now; // step triggered before its release (e.g. not via the scheduler)
+    if ( (!catchUpIfLate)&&(now>_release_us+_period_us) )
+    { // we are more than one period late. Drop the missed releases, otherwise following steps would run back-to-back:
+        _skippedReleaseCnt+=int((now-_release_us)/_period_us);
+        _release_us=now;
+    }
+    unsigned long long int jitter=0;
+    if (now>_release_us)
+        jitter=now-_release_us;
+    _totalJitter_us+=jitter;
+    if (jitter>_maxJitter_us)
+        _maxJitter_us=jitter;
+    _deadline_us=_release_us+_period_us;
+    _stepStart_us=now;
+    for (int i=0;i<REAL_TIME_PHASE_CNT;i++)
+    {
+        _phaseTime_us[i]=0;
+        _phaseDepth[i]=0;
+    }
+    _deadlineMissAttributed=false;
+    _inStep=true;
+}
+
+void CRealTimeScheduler::stepEnd()
+{
+    if (!_inStep)
+        return;
+    _inStep=false;
+    unsigned long long int now=VDateTime::getTimeInUs();
+    unsigned long long int stepTime=now-_stepStart_us;
+    unsigned long long int otherPhases=_phaseTime_us[REAL_TIME_PHASE_DYNAMICS]+_phaseTime_us[REAL_TIME_PHASE_SENSORS];
+    _phaseTime_us[REAL_TIME_PHASE_SCRIPTS]=0;
+    if (stepTime>otherPhases)
+        _phaseTime_us[REAL_TIME_PHASE_SCRIPTS]=stepTime-otherPhases;
+    for (int i=0;i<REAL_TIME_PHASE_CNT;i++)
+    {
+        _totalPhaseTime_us[i]+=_phaseTime_us[i];
+        if (_phaseTime_us[i]>_maxPhaseTime_us[i])
+            _maxPhaseTime_us[i]=_phaseTime_us[i];
+    }
+    _totalStepTime_us+=stepTime;
+    if (stepTime>_maxStepTime_us)
+        _maxStepTime_us=stepTime;
+    _stepCnt++;
+
+    unsigned long long int bucket=8*(now-_release_us)/_period_us;
+    if (bucket>=REAL_TIME_HISTOGRAM_SIZE)
+        bucket=REAL_TIME_HISTOGRAM_SIZE-1;
+    _histogram[bucket]++;
+
+    if (now>_deadline_us)
+    {
+        _deadlineMissCnt++;
+        if (!_deadlineMissAttributed)
+            _phaseDeadlineMissCnt[REAL_TIME_PHASE_SCRIPTS]++; // the deadline passed outside of dynamics and sensors
+        if (now-_deadline_us>_maxLateness_us)
+            _maxLateness_us=now-_deadline_us;
+    }
+}
+
+void CRealTimeScheduler::phaseStart(int phase)
+{ // phases can be nested calls (e.g. a sensor handled from within another sensor's callback): only the outermost counts
+    if ( (!_inStep)||(!VThread::isCurrentThreadTheMainSimulationThread()) )
+        return;
+    if (_phaseDepth[phase]==0)
+        _phaseStart_us[phase]=VDateTime::getTimeInUs();
+    _phaseDepth[phase]++;
+}
+
+void CRealTimeScheduler::phaseEnd(int phase)
+{
+    if ( (!_inStep)||(!VThread::isCurrentThreadTheMainSimulationThread())||(_phaseDepth[phase]==0) )
+        return;
+    _phaseDepth[phase]--;
+    if (_phaseDepth[phase]==0)
+    {
+        unsigned long long int now=VDateTime::getTimeInUs();
+        _phaseTime_us[phase]+=now-_phaseStart_us[phase];
+        if ( (!_deadlineMissAttributed)&&(_phaseStart_us[phase]<=_deadline_us)&&(now>_deadline_us) )
+        {
+            _phaseDeadlineMissCnt[phase]++;
+            _deadlineMissAttributed=true;
+        }
+    }
+}
+
+void CRealTimeScheduler::getStatistics(int counters[REAL_TIME_COUNTER_CNT],int histogram[REAL_TIME_HISTOGRAM_SIZE],float times[REAL_TIME_TIME_CNT]) const
+{
+    counters[0]=_stepCnt;
+    counters[1]=_deadlineMissCnt;
+    for (int i=0;i<REAL_TIME_PHASE_CNT;i++)
+        counters[2+i]=_phaseDeadlineMissCnt[i];
+    counters[5]=_skippedReleaseCnt;
+    for (int i=0;i<REAL_TIME_HISTOGRAM_SIZE;i++)
+        histogram[i]=_histogram[i];
+    float cnt=float(_stepCnt);
+    if (_stepCnt==0)
+        cnt=1.0f;
+    for (int i=0;i<REAL_TIME_PHASE_CNT;i++)
+    {
+        times[2*i+0]=float(_totalPhaseTime_us[i])*0.000001f/cnt;
+        times[2*i+1]=float(_maxPhaseTime_us[i])*0.000001f;
+    }
+    times[6]=float(_totalStepTime_us)*0.000001f/cnt;
+    times[7]=float(_maxStepTime_us)*0.000001f;
+    times[8]=float(_totalJitter_us)*0.000001f/cnt;
+    times[9]=float(_maxJitter_us)*0.000001f;
+    times[10]=float(_maxLateness_us)*0.000001f;
+}
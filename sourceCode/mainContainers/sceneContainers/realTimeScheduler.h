@@ -0,0 +1,62 @@
+#pragma once
+
+enum {
+    REAL_TIME_PHASE_SCRIPTS=0, // everything in a step that is not dynamics or sensors
+    REAL_TIME_PHASE_DYNAMICS,
+    REAL_TIME_PHASE_SENSORS,
+    REAL_TIME_PHASE_CNT
+};
+
+const int REAL_TIME_COUNTER_CNT=6; // steps, deadline misses, misses in scripts, in dynamics, in sensors, skipped releases
+const int REAL_TIME_HISTOGRAM_SIZE=16; // step completion time relative to the step's release, in 1/8 of a period. The last bucket also holds everything later
+const int REAL_TIME_TIME_CNT=11; // avg/max of scripts, dynamics, sensors and whole step, avg/max wake-up jitter, max lateness (in seconds)
+
+// Release and deadline bookkeeping for real-time simulation steps. Step k is released at start+k*period and
+// should be done before the next release. Time spent in each phase of a step is tracked, and a missed
+// deadline is attributed to the phase that was running when the deadline passed
+class CRealTimeScheduler
+{
+public:
+    CRealTimeScheduler();
+    virtual ~CRealTimeScheduler();
+
+    void reset();
+    void reanchor(); // the next step is released when it starts, e.g. after a pause. Statistics are kept
+
+    bool isStepDue() const;
+    void waitForNextStep(unsigned long long int maxWaitTimeInUs,unsigned long long int spinTimeInUs) const;
+
+    void stepStart(unsigned long long int periodInUs,bool catchUpIfLate);
+    void stepEnd();
+    void phaseStart(int phase);
+    void phaseEnd(int phase);
+
+    void getStatistics(int counters[REAL_TIME_COUNTER_CNT],int histogram[REAL_TIME_HISTOGRAM_SIZE],float times[REAL_TIME_TIME_CNT]) const;
+
+    static void waitUntil(unsigned long long int timeInUs,unsigned long long int spinTimeInUs);
+
+private:
+    bool _started;
+    bool _inStep;
+    bool _deadlineMissAttributed;
+    unsigned long long int _period_us;
+    unsigned long long int _release_us;
+    unsigned long long int _deadline_us;
+    unsigned long long int _stepStart_us;
+    unsigned long long int _phaseStart_us[REAL_TIME_PHASE_CNT];
+    unsigned long long int _phaseTime_us[REAL_TIME_PHASE_CNT];
+    int _phaseDepth[REAL_TIME_PHASE_CNT];
+
+    int _stepCnt;
+    int _deadlineMissCnt;
+    int _phaseDeadlineMissCnt[REAL_TIME_PHASE_CNT];
+    int _skippedReleaseCnt;
+    int _histogram[REAL_TIME_HISTOGRAM_SIZE];
+    unsigned long long int _totalPhaseTime_us[REAL_TIME_PHASE_CNT];
+    unsigned long long int _maxPhaseTime_us[REAL_TIME_PHASE_CNT];
+    unsigned long long int _totalStepTime_us;
+    unsigned long long int _maxStepTime_us;
+    unsigned long long int _totalJitter_us;
+    unsigned long long int _maxJitter_us;
+    unsigned long long int _maxLateness_us;
+};
@@ -98,12 +98,13 @@ bool CSceneObjectContainer::addObjectToSceneWithSuffixOffset(CSceneObject* newOb
             int initialSuffix=tt::getNameSuffixNumber(newObjName.c_str(),false);
             std::vector<int> suffixes;
             std::vector<int> dummyValues;
-            for (size_t i=0;i<getObjectCount();i++)
+            // Names with the same base name all start with it, i.e. are adjacent in the name map:
+            for (std::map<std::string,int>::iterator it=_objectNameMap.lower_bound(baseName);(it!=_objectNameMap.end())&&(it->first.compare(0,baseName.length(),baseName)==0);it++)
             {
-                std::string baseNameIt(tt::getNameWithoutSuffixNumber(getObjectFromIndex(i)->getObjectName().c_str(),false));
+                std::string baseNameIt(tt::getNameWithoutSuffixNumber(it->first.c_str(),false));
                 if (baseName.compare(baseNameIt)==0)
                 {
-                    suffixes.push_back(tt::getNameSuffixNumber(getObjectFromIndex(i)->getObjectName().c_str(),false));
+                    suffixes.push_back(tt::getNameSuffixNumber(it->first.c_str(),false));
                     dummyValues.push_back(0);
                 }
             }
@@ -133,12 +134,12 @@ bool CSceneObjectContainer::addObjectToSceneWithSuffixOffset(CSceneObject* newOb
         int initialSuffix=tt::getNameSuffixNumber(newObjAltName.c_str(),false);
         std::vector<int> suffixes;
         std::vector<int> dummyValues;
-        for (size_t i=0;i<getObjectCount();i++)
+        for (std::map<std::string,int>::iterator it=_objectAltNameMap.lower_bound(baseAltName);(it!=_objectAltNameMap.end())&&(it->first.compare(0,baseAltName.length(),baseAltName)==0);it++)
         {
-            std::string baseAltNameIt(tt::getNameWithoutSuffixNumber(getObjectFromIndex(i)->getObjectAltName().c_str(),false));
+            std::string baseAltNameIt(tt::getNameWithoutSuffixNumber(it->first.c_str(),false));
             if (baseAltName.compare(baseAltNameIt)==0)
             {
-                suffixes.push_back(tt::getNameSuffixNumber(getObjectFromIndex(i)->getObjectAltName().c_str(),false));
+                suffixes.push_back(tt::getNameSuffixNumber(it->first.c_str(),false));
                 dummyValues.push_back(0);
             }
         }
@@ -189,6 +190,7 @@ bool CSceneObjectContainer::addObjectToSceneWithSuffixOffset(CSceneObject* newOb
 
     // Actualize the object information
     actualizeObjectInformation();
+    App::setHierarchyObjectChangedFlag(handle);
     if (generateAfterCreateCallback)
     {
         CInterfaceStack stack;
@@ -238,10 +240,12 @@ bool CSceneObjectContainer::eraseObject(CSceneObject* it,bool generateBeforeAfte
     mapIt=_objectAltNameMap.find(it->getObjectAltName());
     _objectAltNameMap.erase(mapIt);
 
-    _removeObject(it->getObjectHandle());
+    int handle=it->getObjectHandle();
+    _removeObject(handle);
 
     CSceneObject::incrementModelPropertyValidityNumber();
     actualizeObjectInformation();
+    App::setHierarchyObjectChangedFlag(handle);
     App::worldContainer->setModificationFlag(1); // object erased
 
     if (generateBeforeAfterDeleteCallback)
@@ -346,8 +350,6 @@ void CSceneObjectContainer::actualizeObjectInformation()
 
     if (_objectActualizationEnabled)
     {
-        App::setRebuildHierarchyFlag();
-
         for (size_t i=0;i<getObjectCount();i++)
             getObjectFromIndex(i)->addChild(nullptr); // clear child list
         for (size_t i=0;i<getObjectCount();i++)
@@ -1195,6 +1197,7 @@ void CSceneObjectContainer::objectWasRenamed(int objectHandle,const char* oldNam
         std::map<std::string,int>::iterator mapIt=_objectNameMap.find(oldName);
         _objectNameMap.erase(mapIt);
         _objectNameMap[newName]=objectHandle;
+        App::setHierarchyObjectChangedFlag(objectHandle); // siblings are ordered by name
     }
 }
 
@@ -17,6 +17,8 @@ const int SIMULATION_DEFAULT_PASSES_PER_RENDERING[5]={1,1,1,1,1};
 const int SIMULATION_SPEED_MODIFIER_SEQUENCE[10]={1,2,5,10,20,40,80,160,320,640};
 const int SIMULATION_SPEED_MODIFIER_START_INDEX[6]={5,4,3,2,1,3};
 
+const quint64 REAL_TIME_MAX_WAIT_US=20000; // so that the simulation thread still handles messages and rendering
+
 CSimulation::CSimulation()
 {
     _stopRequestCounter=0;
@@ -139,6 +141,7 @@ void CSimulation::simulationAboutToStart()
     _dynamicContentVisualizationOnly=false;
     _desiredFasterOrSlowerSpeed=0;
     _stopRequestCounterAtSimulationStart=_stopRequestCounter;
+    _realTimeScheduler.reset();
     #ifdef SIM_WITH_GUI
         if ( (App::mainWindow!=nullptr) && App::userSettings->sceneHierarchyHiddenDuringSimulation )
         {
@@ -252,9 +255,12 @@ bool CSimulation::startOrResumeSimulation()
     TRACE_INTERNAL;
     if (isSimulationStopped())
     {
-        App::setFullScreen(_fullscreenAtSimulationStart);
-        CThreadPool::setSimulationEmergencyStop(false);
-        CThreadPool::setRequestSimulationStop(false);
+        if (CCurrentWorld::getThreadWorld()==nullptr)
+        { // i.e. not a batch world, which runs on a worker thread and doesn't use the thread pool
+            App::setFullScreen(_fullscreenAtSimulationStart);
+            CThreadPool::setSimulationEmergencyStop(false);
+            CThreadPool::setRequestSimulationStop(false);
+        }
 //        CLuaScriptObject::emergencyStopButtonPressed=false;
         App::worldContainer->simulationAboutToStart();
         _speedModifierIndexOffset=0;
@@ -276,6 +282,7 @@ bool CSimulation::startOrResumeSimulation()
         App::worldContainer->simulationAboutToResume();
 
         _realTimeCorrection_us=0;
+        _realTimeScheduler.reanchor(); // releases during the pause are not to be caught up
         simulationState=sim_simulation_advancing_firstafterpause;
         simulationTime_real_lastInMs=VDateTime::getTimeInMs();
         _requestToPause=false;
@@ -289,7 +296,7 @@ bool CSimulation::startOrResumeSimulation()
 bool CSimulation::stopSimulation()
 {
     TRACE_INTERNAL;
-    if (simulationState!=sim_simulation_stopped)
+    if ( (simulationState!=sim_simulation_stopped)&&(CCurrentWorld::getThreadWorld()==nullptr) )
         App::setFullScreen(false);
 
     if ((simulationState==sim_simulation_advancing_abouttostop)||
@@ -298,6 +305,7 @@ bool CSimulation::stopSimulation()
     if (simulationState==sim_simulation_paused)
     {
         App::worldContainer->simulationAboutToResume();
+        _realTimeScheduler.reanchor();
 
         // Special case here: we have to change the state directly here (and not automatically in "advanceSimulationByOneStep")
         simulationState=sim_simulation_advancing_firstafterpause;
@@ -386,7 +394,8 @@ void CSimulation::advanceSimulationByOneStep()
     {
         if (_requestToStop)
         {
-            CThreadPool::setRequestSimulationStop(true);
+            if (CCurrentWorld::getThreadWorld()==nullptr)
+                CThreadPool::setRequestSimulationStop(true);
             simulationState=sim_simulation_advancing_abouttostop;
             _requestToStop=false;
         }
@@ -410,15 +419,18 @@ void CSimulation::advanceSimulationByOneStep()
     }
     else if (simulationState==sim_simulation_advancing_abouttostop)
     {
-        // Check if all threads have stopped
-        if (CThreadPool::getThreadPoolThreadCount()==0)
+        // Check if all threads have stopped (batch worlds don't use the thread pool)
+        if ( (CCurrentWorld::getThreadWorld()!=nullptr)||(CThreadPool::getThreadPoolThreadCount()==0) )
             simulationState=sim_simulation_advancing_lastbeforestop;
     }
     else if (simulationState==sim_simulation_advancing_lastbeforestop)
     {
         App::worldContainer->simulationAboutToEnd();
-        CThreadPool::setSimulationEmergencyStop(false);
-        CThreadPool::setRequestSimulationStop(false);
+        if (CCurrentWorld::getThreadWorld()==nullptr)
+        {
+            CThreadPool::setSimulationEmergencyStop(false);
+            CThreadPool::setRequestSimulationStop(false);
+        }
  //       CLuaScriptObject::emergencyStopButtonPressed=false;
         simulationState=sim_simulation_stopped;
         App::worldContainer->simulationEnded(_removeNewObjectsAtSimulationEnd);
@@ -511,10 +523,53 @@ bool CSimulation::isRealTimeCalculationStepNeeded()
         return(false);
     if (!isSimulationRunning())
         return(false);
+    if (App::userSettings->deterministicRealTime)
+    { // steps are released on a fixed schedule, with microsecond resolution
+        if (_getRealTimeStepPeriod_us()==0)
+            return(false);
+        return(_realTimeScheduler.isStepDue());
+    }
     quint64 crt=simulationTime_real_noCatchUp_us+quint64(double(VDateTime::getTimeDiffInMs(simulationTime_real_lastInMs))*getRealTimeCoefficient_speedModified()*1000.0);
     return (_simulationTime_us+getSimulationTimeStep_speedModified_us()<crt);
 }
 
+void CSimulation::waitForRealTimeCalculationStep()
+{ // instead of polling isRealTimeCalculationStepNeeded, the simulation thread can wait for the next release
+    if ( _realTimeSimulation&&isSimulationRunning()&&App::userSettings->deterministicRealTime&&(_getRealTimeStepPeriod_us()!=0) )
+    {
+        quint64 spinTime=0;
+        if (App::userSettings->realTimeSpinTime>0)
+            spinTime=quint64(App::userSettings->realTimeSpinTime);
+        _realTimeScheduler.waitForNextStep(REAL_TIME_MAX_WAIT_US,spinTime);
+    }
+}
+
+void CSimulation::realTimeStepStart()
+{
+    if ( _realTimeSimulation&&isSimulationRunning()&&(_getRealTimeStepPeriod_us()!=0) )
+        _realTimeScheduler.stepStart(_getRealTimeStepPeriod_us(),_catchUpIfLate);
+    else
+        _realTimeScheduler.reanchor(); // this step is not on the real-time schedule. The next real-time step restarts it
+}
+
+void CSimulation::realTimeStepEnd()
+{
+    _realTimeScheduler.stepEnd();
+}
+
+CRealTimeScheduler* CSimulation::getRealTimeScheduler()
+{
+    return(&_realTimeScheduler);
+}
+
+quint64 CSimulation::_getRealTimeStepPeriod_us()
+{ // wall-clock duration of a simulation step. 0 if the simulation is frozen
+    double coeff=getRealTimeCoefficient_speedModified();
+    if (coeff<=0.0)
+        return(0);
+    return(quint64(double(getSimulationTimeStep_speedModified_us())/coeff+0.5));
+}
+
 bool CSimulation::getRealTimeSimulation()
 {
     return(_realTimeSimulation);
@@ -2,6 +2,7 @@
 
 #include "vThread.h"
 #include "ser.h"
+#include "realTimeScheduler.h"
 #ifdef SIM_WITH_GUI
 #include "vMenubar.h"
 #endif
@@ -74,6 +75,10 @@ public:
 
 
     bool isRealTimeCalculationStepNeeded();
+    void waitForRealTimeCalculationStep();
+    void realTimeStepStart();
+    void realTimeStepEnd();
+    CRealTimeScheduler* getRealTimeScheduler();
 
     void setSimulationStateDirect(int state);
 
@@ -107,6 +112,7 @@ public:
 private:
     double _getRealTimeCoefficient_raw();
     double _getSpeedModifier_forRealTimeCoefficient();
+    quint64 _getRealTimeStepPeriod_us();
 
     bool _resetSimulationAtEnd;
     bool _removeNewObjectsAtSimulationEnd;
@@ -121,6 +127,7 @@ private:
 
     int simulationTime_real_lastInMs;
     quint64 _realTimeCorrection_us;
+    CRealTimeScheduler _realTimeScheduler;
 
     int _simulationStepCount;
 
@@ -4,6 +4,8 @@
 #include "ttUtil.h"
 #include "tt.h"
 #include "app.h"
+#include "vDateTime.h"
+#include "workerPool.h"
 
 std::vector<SLoadOperationIssue> CWorld::_loadOperationIssues;
 
@@ -587,10 +589,16 @@ void CWorld::simulationAboutToStart()
     App::uiThread->executeCommandViaUiThread(&cmdIn,&cmdOut);
 #endif
 
+    // A batch world runs on a worker thread: app-wide scripts, plugins and the simulation thread are left alone
+    bool batchWorld=(CCurrentWorld::getThreadWorld()!=nullptr);
+
     embeddedScriptContainer->handleCascadedScriptExecution(sim_scripttype_customizationscript,sim_syscb_beforesimulation,nullptr,nullptr,nullptr);
-    App::worldContainer->addOnScriptContainer->callScripts(sim_syscb_beforesimulation,nullptr,nullptr);
-    if (App::worldContainer->sandboxScript!=nullptr)
-        App::worldContainer->sandboxScript->callSandboxScript(sim_syscb_beforesimulation,nullptr,nullptr);
+    if (!batchWorld)
+    {
+        App::worldContainer->addOnScriptContainer->callScripts(sim_syscb_beforesimulation,nullptr,nullptr);
+        if (App::worldContainer->sandboxScript!=nullptr)
+            App::worldContainer->sandboxScript->callSandboxScript(sim_syscb_beforesimulation,nullptr,nullptr);
+    }
 
     _initialObjectUniqueIdentifiersForRemovingNewObjects.clear();
     for (size_t i=0;i<sceneObjects->getObjectCount();i++)
@@ -618,14 +626,17 @@ void CWorld::simulationAboutToStart()
     _simulationAboutToStart();
     App::worldContainer->calcInfo->simulationAboutToStart();
 
-    void* retVal=CPluginContainer::sendEventCallbackMessageToAllPlugins(sim_message_eventcallback_simulationabouttostart,nullptr,nullptr,nullptr);
-    delete[] (char*)retVal;
+    if (!batchWorld)
+    {
+        void* retVal=CPluginContainer::sendEventCallbackMessageToAllPlugins(sim_message_eventcallback_simulationabouttostart,nullptr,nullptr,nullptr);
+        delete[] (char*)retVal;
 
-    App::worldContainer->setModificationFlag(2048); // simulation started
+        App::worldContainer->setModificationFlag(2048); // simulation started
 
-    SSimulationThreadCommand cmd;
-    cmd.cmdId=DISPLAY_VARIOUS_WARNING_MESSAGES_DURING_SIMULATION_CMD;
-    App::appendSimulationThreadCommand(cmd,1000);
+        SSimulationThreadCommand cmd;
+        cmd.cmdId=DISPLAY_VARIOUS_WARNING_MESSAGES_DURING_SIMULATION_CMD;
+        App::appendSimulationThreadCommand(cmd,1000);
+    }
 
     App::setToolbarRefreshFlag();
     App::setFullDialogRefreshFlag();
@@ -659,8 +670,11 @@ void CWorld::simulationAboutToEnd()
 {
     TRACE_INTERNAL;
 
-    void* retVal=CPluginContainer::sendEventCallbackMessageToAllPlugins(sim_message_eventcallback_simulationabouttoend,nullptr,nullptr,nullptr);
-    delete[] (char*)retVal;
+    if (CCurrentWorld::getThreadWorld()==nullptr)
+    { // not a batch world
+        void* retVal=CPluginContainer::sendEventCallbackMessageToAllPlugins(sim_message_eventcallback_simulationabouttoend,nullptr,nullptr,nullptr);
+        delete[] (char*)retVal;
+    }
 
     _simulationAboutToEnd();
 
@@ -675,15 +689,22 @@ void CWorld::simulationEnded(bool removeNewObjects)
     TRACE_INTERNAL;
     POST_SCENE_CHANGED_ANNOUNCEMENT(""); // keeps this (this has the objects in their last position, including additional objects)
 
-    void* retVal=CPluginContainer::sendEventCallbackMessageToAllPlugins(sim_message_eventcallback_simulationended,nullptr,nullptr,nullptr);
-    delete[] (char*)retVal;
-    App::worldContainer->setModificationFlag(4096); // simulation ended
+    // A batch world runs on a worker thread: app-wide scripts, plugins and the simulation thread are left alone
+    bool batchWorld=(CCurrentWorld::getThreadWorld()!=nullptr);
+
+    if (!batchWorld)
+    {
+        void* retVal=CPluginContainer::sendEventCallbackMessageToAllPlugins(sim_message_eventcallback_simulationended,nullptr,nullptr,nullptr);
+        delete[] (char*)retVal;
+        App::worldContainer->setModificationFlag(4096); // simulation ended
+    }
 
     _simulationEnded();
     App::worldContainer->calcInfo->simulationEnded();
 
 #ifdef SIM_WITH_SERIAL
-    App::worldContainer->serialPortContainer->simulationEnded();
+    if (!batchWorld)
+        App::worldContainer->serialPortContainer->simulationEnded();
 #endif
 
 #ifdef SIM_WITH_GUI
@@ -693,7 +714,8 @@ void CWorld::simulationEnded(bool removeNewObjects)
     App::uiThread->executeCommandViaUiThread(&cmdIn,&cmdOut);
 #endif
 
-    App::setMouseMode(_savedMouseMode);
+    if (!batchWorld)
+        App::setMouseMode(_savedMouseMode);
     App::setToolbarRefreshFlag();
     App::setFullDialogRefreshFlag();
 
@@ -724,9 +746,12 @@ void CWorld::simulationEnded(bool removeNewObjects)
     POST_SCENE_CHANGED_ANNOUNCEMENT(""); // keeps this (additional objects were removed, and object positions were reset)
 
     embeddedScriptContainer->handleCascadedScriptExecution(sim_scripttype_customizationscript,sim_syscb_aftersimulation,nullptr,nullptr,nullptr);
-    App::worldContainer->addOnScriptContainer->callScripts(sim_syscb_aftersimulation,nullptr,nullptr);
-    if (App::worldContainer->sandboxScript!=nullptr)
-        App::worldContainer->sandboxScript->callSandboxScript(sim_syscb_aftersimulation,nullptr,nullptr);
+    if (!batchWorld)
+    {
+        App::worldContainer->addOnScriptContainer->callScripts(sim_syscb_aftersimulation,nullptr,nullptr);
+        if (App::worldContainer->sandboxScript!=nullptr)
+            App::worldContainer->sandboxScript->callSandboxScript(sim_syscb_aftersimulation,nullptr,nullptr);
+    }
 }
 
 void CWorld::setEnableRemoteWorldsSync(bool enabled)
@@ -814,6 +839,7 @@ void CWorld::addGeneralObjectsToWorldAndPerformMappings(std::vector<CSceneObject
     _prepareFastLoadingMapping(objectMapping);
     sceneObjects->enableObjectActualization(true);
     sceneObjects->actualizeObjectInformation();
+    App::setRebuildHierarchyFlag(); // many objects at once
 
     // Remove any material that was loaded from a previous file version, where materials were still shared (until V3.3.2)
     for (size_t i=0;i<loadedDynMaterialObjectList.size();i++)
@@ -962,6 +988,7 @@ void CWorld::addGeneralObjectsToWorldAndPerformMappings(std::vector<CSceneObject
 
     sceneObjects->enableObjectActualization(true);
     sceneObjects->actualizeObjectInformation();
+    App::setRebuildHierarchyFlag(); // many objects at once
 
     if (!model)
         pageContainer->performObjectLoadingMapping(&objectMapping);
@@ -1210,6 +1237,8 @@ bool CWorld::_loadModelOrScene(CSer& ar,bool selectLoaded,bool isScene,bool just
 {
     appendLoadOperationIssue(-1,nullptr,-1); // clear
 
+    int loadStartTime=VDateTime::getTimeInMs();
+    int meshBufferDuration=0;
     CMesh::clearTempVerticesIndicesNormalsAndEdges();
     sceneObjects->deselectObjects();
 
@@ -1265,9 +1294,11 @@ bool CWorld::_loadModelOrScene(CSer& ar,bool selectLoaded,bool isScene,bool just
                 //------------------------------------------------------------
                 if (theName.compare(SER_VERTICESINDICESNORMALSEDGES)==0)
                 {
+                    int meshBufferStartTime=VDateTime::getTimeInMs();
                     CMesh::clearTempVerticesIndicesNormalsAndEdges();
                     ar >> byteQuantity; // never use that info, unless loading unknown data!!!! (undo/redo stores dummy info in there)
                     CMesh::serializeTempVerticesIndicesNormalsAndEdges(ar);
+                    meshBufferDuration+=VDateTime::getTimeDiffInMs(meshBufferStartTime);
                     noHit=false;
                 }
                 //------------------------------------------------------------
@@ -1572,9 +1603,23 @@ bool CWorld::_loadModelOrScene(CSer& ar,bool selectLoaded,bool isScene,bool just
         }
     }
 
+    // Decode the calculation structures and textures in parallel. Objects are not yet part of the scene:
+    int decodeStartTime=VDateTime::getTimeInMs();
+    CWorkerPool::parallelFor(int(loadedObjectList.size()+loadedTextureList.size()),[&](int i)
+    {
+        if (i<int(loadedObjectList.size()))
+            loadedObjectList[i]->decodeLoadedData();
+        else
+            loadedTextureList[i-loadedObjectList.size()]->decodeLoadedData();
+    });
+    for (size_t i=0;i<loadedObjectList.size();i++)
+        loadedObjectList[i]->finalizeLoadedData();
+    int decodeDuration=VDateTime::getTimeDiffInMs(decodeStartTime);
+
     CMesh::clearTempVerticesIndicesNormalsAndEdges();
 
     int fileSimVersion=ar.getCoppeliaSimVersionThatWroteThisFile();
+    int commitStartTime=VDateTime::getTimeInMs();
 
     // All object have been loaded and are in:
     // loadedObjectList
@@ -1595,6 +1640,14 @@ bool CWorld::_loadModelOrScene(CSer& ar,bool selectLoaded,bool isScene,bool just
 
     CMesh::clearTempVerticesIndicesNormalsAndEdges();
 
+    int commitDuration=VDateTime::getTimeDiffInMs(commitStartTime);
+    std::string msg("loading times (ms): mesh data ");
+    msg+=std::to_string(meshBufferDuration)+", other data ";
+    msg+=std::to_string(VDateTime::getTimeDiffInMs(loadStartTime,decodeStartTime)-meshBufferDuration)+", calculation structures and textures ";
+    msg+=std::to_string(decodeDuration)+", adding to scene ";
+    msg+=std::to_string(commitDuration);
+    App::logMsg(sim_verbosity_debug,msg.c_str());
+
     appendLoadOperationIssue(-1,nullptr,-1); // clear
 
     if (!isScene)
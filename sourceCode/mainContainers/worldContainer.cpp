@@ -3,6 +3,13 @@
 #include "pluginContainer.h"
 #include "rendering.h"
 #include "tt.h"
+#include "fileOperations.h"
+#include "workerPool.h"
+#include "proxSensorRoutine.h"
+#include <mutex>
+
+static std::mutex _batchGlobalMutex; // scene loading touches app-wide state
+static std::mutex _batchDynamicsMutex; // the physics engine plugins handle a single world at a time
 
 CWorldContainer::CWorldContainer()
 {
@@ -23,6 +30,7 @@ CWorldContainer::CWorldContainer()
     serialPortContainer=nullptr;
 #endif
     _currentWorldIndex=-1;
+    _nextWorldHandle=0;
     App::currentWorld=nullptr;
 }
 
@@ -118,8 +126,7 @@ int CWorldContainer::createNewWorld()
     // Create new world and switch to it:
     CWorld* w=new CWorld();
     _currentWorldIndex=int(_worlds.size());
-    static int nextWorldHandle=0;
-    w->setWorldHandle(nextWorldHandle++);
+    w->setWorldHandle(_nextWorldHandle++);
     _worlds.push_back(w);
     currentWorld=w;
     App::currentWorld=w;
@@ -249,6 +256,16 @@ int CWorldContainer::getWorldCount() const
     return(int(_worlds.size()));
 }
 
+CWorld* CWorldContainer::getWorldFromHandle(int worldHandle) const
+{ // nullptr if the world was destroyed in the meantime
+    for (size_t i=0;i<_worlds.size();i++)
+    {
+        if (_worlds[i]->getWorldHandle()==worldHandle)
+            return(_worlds[i]);
+    }
+    return(nullptr);
+}
+
 void CWorldContainer::initialize()
 {
     TRACE_INTERNAL;
@@ -398,9 +415,9 @@ void CWorldContainer::getAllSceneNames(std::vector<std::string>& l) const
 
 CLuaScriptObject* CWorldContainer::getScriptFromHandle(int scriptHandle) const
 {
-    CLuaScriptObject* retVal=currentWorld->embeddedScriptContainer->getScriptFromHandle(scriptHandle);
-    if (retVal==nullptr)
-    {
+    CLuaScriptObject* retVal=App::currentWorld->embeddedScriptContainer->getScriptFromHandle(scriptHandle);
+    if ( (retVal==nullptr)&&(CCurrentWorld::getThreadWorld()==nullptr) )
+    { // add-on and sandbox scripts are not accessible from the worker threads of a simulation batch
         retVal=addOnScriptContainer->getAddOnScriptFromID(scriptHandle);
         if ( (retVal==nullptr)&&(sandboxScript!=nullptr)&&(sandboxScript->getScriptHandle()==scriptHandle) )
             retVal=sandboxScript;
@@ -411,10 +428,107 @@ CLuaScriptObject* CWorldContainer::getScriptFromHandle(int scriptHandle) const
 void CWorldContainer::callScripts(int callType,CInterfaceStack* inStack)
 {
     TRACE_INTERNAL;
-    currentWorld->embeddedScriptContainer->callScripts(callType,inStack);
-    addOnScriptContainer->callScripts(callType,inStack,nullptr);
-    if (sandboxScript!=nullptr)
-        sandboxScript->callSandboxScript(callType,inStack,nullptr);
+    App::currentWorld->embeddedScriptContainer->callScripts(callType,inStack);
+    if (CCurrentWorld::getThreadWorld()==nullptr)
+    { // add-on and sandbox scripts are not called from the worker threads of a simulation batch
+        addOnScriptContainer->callScripts(callType,inStack,nullptr);
+        if (sandboxScript!=nullptr)
+            sandboxScript->callSandboxScript(callType,inStack,nullptr);
+    }
+}
+
+int CWorldContainer::runSimulationBatch(const std::vector<std::string>& sceneFiles,float simulationDuration,int threadCount,std::vector<int>& stepCounts)
+{ // SIM THREAD only, headless, with the current scene not running. Returns the number of scenes that could be run.
+    // Scenes with dynamics enabled are run one at a time, since the physics engine is shared.
+    // Scenes containing child or customization scripts are refused: the Lua side (API error state, interface
+    // stacks, custom functions and the SIM/UI thread locks) is app-wide and not meant for worker threads
+    TRACE_INTERNAL;
+    stepCounts.assign(sceneFiles.size(),-1);
+    std::vector<char> success(sceneFiles.size(),0);
+    CWorkerPool::parallelFor(int(sceneFiles.size()),[&](int i)
+    {
+        int steps=0;
+        if (_runSimulationBatchJob(sceneFiles[i].c_str(),simulationDuration,steps))
+        {
+            stepCounts[i]=steps;
+            success[i]=1;
+        }
+    },threadCount);
+    int retVal=0;
+    for (size_t i=0;i<success.size();i++)
+        retVal+=success[i];
+    return(retVal);
+}
+
+bool CWorldContainer::_runSimulationBatchJob(const char* sceneFile,float simulationDuration,int& stepCount)
+{ // runs on any thread. App::currentWorld refers to the job's world, for the duration of the job
+    stepCount=0;
+    CWorld* w=new CWorld();
+    {
+        std::lock_guard<std::mutex> lock(_batchGlobalMutex);
+        w->setWorldHandle(_nextWorldHandle++);
+    }
+    CCurrentWorld::setThreadWorld(w);
+    CCalculationInfo calculationInfo;
+    CCurrentCalcInfo::setThreadCalcInfo(&calculationInfo);
+    w->initializeWorld();
+    bool retVal;
+    {
+        std::lock_guard<std::mutex> lock(_batchGlobalMutex);
+        retVal=CFileOperations::loadScene(sceneFile,false,false,false);
+    }
+    if (retVal)
+    {
+        for (size_t i=0;i<w->embeddedScriptContainer->allScripts.size();i++)
+        {
+            int t=w->embeddedScriptContainer->allScripts[i]->getScriptType();
+            if ( (t==sim_scripttype_childscript)||(t==sim_scripttype_customizationscript) )
+                retVal=false;
+        }
+        if (!retVal)
+            App::logMsg(sim_verbosity_errors,"simulation batch: scene '%s' contains scripts and was not run.",sceneFile);
+    }
+    if (retVal)
+    {
+        std::unique_lock<std::mutex> dynLock(_batchDynamicsMutex,std::defer_lock);
+        if (w->dynamicsContainer->getDynamicsEnabled())
+            dynLock.lock();
+        w->simulation->startOrResumeSimulation();
+        quint64 duration_us=quint64(simulationDuration*1000000.0f);
+        while (!w->simulation->isSimulationStopped())
+        {
+            if (w->simulation->isSimulationPaused())
+                w->simulation->startOrResumeSimulation(); // e.g. pause at specific time, or pause on script error
+            if (w->simulation->getSimulationTime_us()>=duration_us)
+                w->simulation->stopSimulation();
+            // The main script is not run: we do what the default main script does, without going through Lua.
+            // Plugins are not informed either: they expect a single scene on the simulation thread
+            _stepBatchWorld(w);
+            w->simulation->advanceSimulationByOneStep();
+            stepCount++;
+        }
+    }
+    w->clearScene(true);
+    w->deleteWorld();
+    delete w;
+    CCurrentCalcInfo::setThreadCalcInfo(nullptr);
+    CCurrentWorld::setThreadWorld(nullptr);
+    return(retVal);
+}
+
+void CWorldContainer::_stepBatchWorld(CWorld* w)
+{ // runs on the worker thread of a batch job: actuation, then sensing, as in the default main script
+    w->dynamicsContainer->handleDynamics(float(w->simulation->getSimulationTimeStep_speedModified_us())/1000000.0f);
+    w->collisions->handleAllCollisions(true);
+    w->distances->handleAllDistances(true);
+    std::vector<CProxSensor*> sensors;
+    for (size_t i=0;i<w->sceneObjects->getProximitySensorCount();i++)
+        sensors.push_back(w->sceneObjects->getProximitySensorFromIndex(i));
+    std::vector<bool> detected;
+    std::vector<C3Vector> detectedPts;
+    std::vector<int> detectedObjs;
+    std::vector<C3Vector> detectedSurfs;
+    CProxSensorRoutine::handleSensors(sensors,true,detected,detectedPts,detectedObjs,detectedSurfs);
 }
 
 #ifdef SIM_WITH_GUI
@@ -486,44 +600,44 @@ bool CWorldContainer::processGuiCommand(int commandID)
 void CWorldContainer::simulationAboutToStart()
 {
     calcInfo->simulationAboutToStart();
-    currentWorld->simulationAboutToStart();
+    App::currentWorld->simulationAboutToStart();
 }
 
 void CWorldContainer::simulationPaused()
 {
-    currentWorld->simulationPaused();
+    App::currentWorld->simulationPaused();
 }
 
 void CWorldContainer::simulationAboutToResume()
 {
-    currentWorld->simulationAboutToResume();
+    App::currentWorld->simulationAboutToResume();
 }
 
 void CWorldContainer::simulationAboutToStep()
 {
     calcInfo->simulationAboutToStep();
-    currentWorld->simulationAboutToStep();
+    App::currentWorld->simulationAboutToStep();
 }
 
 void CWorldContainer::simulationAboutToEnd()
 {
-    currentWorld->simulationAboutToEnd();
+    App::currentWorld->simulationAboutToEnd();
 }
 
 void CWorldContainer::simulationEnded(bool removeNewObjects)
 {
-    currentWorld->simulationEnded(removeNewObjects);
+    App::currentWorld->simulationEnded(removeNewObjects);
     calcInfo->simulationEnded();
 }
 
 void CWorldContainer::announceScriptWillBeErased(int scriptHandle,bool simulationScript,bool sceneSwitchPersistentScript)
 {
-    currentWorld->announceScriptWillBeErased(scriptHandle,simulationScript,sceneSwitchPersistentScript);
+    App::currentWorld->announceScriptWillBeErased(scriptHandle,simulationScript,sceneSwitchPersistentScript);
 }
 
 void CWorldContainer::announceScriptStateWillBeErased(int scriptHandle,bool simulationScript,bool sceneSwitchPersistentScript)
 {
-    currentWorld->announceScriptStateWillBeErased(scriptHandle,simulationScript,sceneSwitchPersistentScript);
+    App::currentWorld->announceScriptStateWillBeErased(scriptHandle,simulationScript,sceneSwitchPersistentScript);
 }
 
 
@@ -33,6 +33,7 @@ public:
     int createNewWorld();
     int destroyCurrentWorld();
     int getWorldCount() const;
+    CWorld* getWorldFromHandle(int worldHandle) const;
     int getCurrentWorldIndex() const;
     bool switchToWorld(int worldIndex);
     bool isWorldSwitchingLocked() const;
@@ -40,6 +41,10 @@ public:
     CLuaScriptObject* getScriptFromHandle(int scriptHandle) const;
     void callScripts(int callType,CInterfaceStack* inStack);
 
+    // Headless batch mode: runs independent scenes concurrently, each in its own (not displayed) world.
+    // Scenes must not contain child or customization scripts (the main script is replaced by its default behaviour):
+    int runSimulationBatch(const std::vector<std::string>& sceneFiles,float simulationDuration,int threadCount,std::vector<int>& stepCounts);
+
     void simulationAboutToStart();
     void simulationPaused();
     void simulationAboutToResume();
@@ -53,7 +58,7 @@ public:
     CCopyBuffer* copyBuffer;
     CPersistentDataContainer* persistentDataContainer;
     CSimulatorMessageQueue* simulatorMessageQueue;
-    CCalculationInfo* calcInfo;
+    CCurrentCalcInfo calcInfo;
     CInterfaceStackContainer* interfaceStackContainer;
     CLuaCustomFuncAndVarContainer* luaCustomFuncAndVarContainer;
     CCustomData* customAppData;
@@ -68,9 +73,12 @@ public:
 
 private:
     bool _switchToWorld(int newWorldIndex);
+    bool _runSimulationBatchJob(const char* sceneFile,float simulationDuration,int& stepCount);
+    void _stepBatchWorld(CWorld* w);
 
     std::vector<CWorld*> _worlds;
     int _currentWorldIndex;
+    int _nextWorldHandle;
 
     std::vector<int> _uniqueIdsOfSelectionSinceLastTimeGetAndClearModificationFlagsWasCalled;
     int _modificationFlags;
@@ -16,6 +16,7 @@
 #include "vDateTime.h"
 #include "ttUtil.h"
 #include "simFlavor.h"
+#include "sceneFileWriter.h"
 #include <boost/algorithm/string/predicate.hpp>
 #ifdef SIM_WITH_GUI
     #include "vFileDialog.h"
@@ -1214,6 +1215,44 @@ bool CFileOperations::saveScene(const char* pathAndFilename,bool displayMessages
     return(retVal);
 }
 
+bool CFileOperations::saveSceneInBackground(const char* pathAndFilename,int& snapshotTimeInMs,unsigned long long* dataHash/*=nullptr*/)
+{ // binary scene files only. The scene is serialized right away, compression and writing happen in CSceneFileWriter's thread.
+  // Unlike saveScene, the scene keeps its current path and name. Returns false if a previous write is still in progress.
+  // If dataHash is provided, nothing is written if the serialized scene has the same hash, and dataHash is updated
+    if ( (!CSimFlavor::getBoolVal(16))||CSceneFileWriter::isBusy() )
+        return(false);
+    int stTime=VDateTime::getTimeInMs();
+#ifdef SIM_WITH_GUI
+    if (App::mainWindow!=nullptr)
+        App::mainWindow->codeEditorContainer->saveOrCopyOperationAboutToHappen();
+#endif
+
+    void* returnVal=CPluginContainer::sendEventCallbackMessageToAllPlugins(sim_message_eventcallback_scenesave,nullptr,nullptr,nullptr);
+    delete[] (char*)returnVal;
+    App::currentWorld->embeddedScriptContainer->sceneOrModelAboutToBeSaved(-1);
+
+    std::vector<char> header;
+    std::vector<unsigned char> data;
+    CSer serObj(header,CSer::filetype_csim_bin_scene_file);
+    serObj.writeOpenBinary(App::userSettings->compressFiles);
+    App::currentWorld->saveScene(serObj);
+    serObj.writeCloseWithoutCompressing(data);
+    snapshotTimeInMs=VDateTime::getTimeDiffInMs(stTime);
+    if (dataHash!=nullptr)
+    { // detects all changes, also the ones that didn't generate an undo point
+        unsigned long long h=14695981039346656037ULL;
+        for (size_t i=0;i<data.size();i++)
+        {
+            h^=data[i];
+            h*=1099511628211ULL;
+        }
+        if (h==dataHash[0])
+            return(true);
+        dataHash[0]=h;
+    }
+    return(CSceneFileWriter::startWrite(pathAndFilename,header,data,App::userSettings->compressFiles));
+}
+
 bool CFileOperations::saveModel(int modelBaseDummyID,const char* pathAndFilename,bool displayMessages,bool displayDialogs,bool setCurrentDir,std::vector<char>* saveBuffer/*=nullptr*/)
 {
     if ( CSimFlavor::getBoolVal(16)||(saveBuffer!=nullptr) )
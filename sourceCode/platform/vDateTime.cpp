@@ -4,6 +4,7 @@
 #include <QElapsedTimer>
 #endif
 #include <ctime>
+#include <chrono>
 #ifdef WIN_SIM
 #include <Windows.h>
 #else
@@ -41,6 +42,12 @@ int VDateTime::getTimeInMs()
     return(retVal);
 }
 
+unsigned long long int VDateTime::getTimeInUs()
+{
+    static std::chrono::steady_clock::time_point startT=std::chrono::steady_clock::now();
+    return((unsigned long long int)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()-startT).count());
+}
+
 int VDateTime::getTimeDiffInMs(int lastTime)
 {
     return(getTimeDiffInMs(lastTime,getTimeInMs()));
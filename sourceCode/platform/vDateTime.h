@@ -5,6 +5,7 @@ class VDateTime
 {
 public:
     static int getTimeInMs();
+    static unsigned long long int getTimeInUs(); // monotonic, for profiling only
     static unsigned int getOSTimeInMs();
     static int getTimeDiffInMs(int lastTime);
     static int getTimeDiffInMs(int oldTime,int newTime);
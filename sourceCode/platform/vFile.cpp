@@ -13,6 +13,13 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #endif
+#ifdef WIN_SIM
+#include <Windows.h>
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+#include <cstdio>
 
 unsigned short VFile::CREATE_WRITE      =1;
 unsigned short VFile::SHARE_EXCLUSIVE   =2;
@@ -205,6 +212,20 @@ quint64 VFile::getLength()
 #endif
 }
 
+bool VFile::readBytes(quint64 pos,char* buffer,quint64 size)
+{
+#ifndef SIM_WITH_QT
+    _theFile->clear();
+    _theFile->seekg(std::streamoff(pos),std::ios::beg);
+    _theFile->read(buffer,std::streamsize(size));
+    return(quint64(_theFile->gcount())==size);
+#else
+    if (!_theFile->seek(qint64(pos)))
+        return(false);
+    return(_theFile->read(buffer,qint64(size))==qint64(size));
+#endif
+}
+
 void VFile::close()
 {
     _theFile->close();
@@ -232,6 +253,25 @@ bool VFile::flush()
 }
 
 
+bool VFile::replaceFile(const char* sourceFilenameAndPath,const char* destFilenameAndPath)
+{ // renames the source file, overwriting the destination file if present. Where the OS allows it, the
+  // destination is replaced atomically: at any time it is either the old or the new file
+#ifdef WIN_SIM
+    return(MoveFileExA(sourceFilenameAndPath,destFilenameAndPath,MOVEFILE_REPLACE_EXISTING|MOVEFILE_WRITE_THROUGH)!=0);
+#else
+    return(std::rename(sourceFilenameAndPath,destFilenameAndPath)==0);
+#endif
+}
+
+bool VFile::touchFile(const char* filenameAndPath)
+{
+#ifdef WIN_SIM
+    return(_utime(filenameAndPath,nullptr)==0);
+#else
+    return(utime(filenameAndPath,nullptr)==0);
+#endif
+}
+
 int VFile::eraseFilesWithPrefix(const char* pathWithoutTerminalSlash,const char* prefix)
 {
     int cnt=0;
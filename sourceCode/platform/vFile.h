@@ -23,9 +23,12 @@ public:
     static bool doesFileExist(const char* filenameAndPath);
     static bool doesFolderExist(const char* foldernameAndPath); // no final slash!
     static void eraseFile(const char* filenameAndPath);
+    static bool replaceFile(const char* sourceFilenameAndPath,const char* destFilenameAndPath);
+    static bool touchFile(const char* filenameAndPath); // sets the last modification time to now
     static int eraseFilesWithPrefix(const char* pathWithoutTerminalSlash,const char* prefix);
 
     quint64 getLength();
+    bool readBytes(quint64 pos,char* buffer,quint64 size); // reads at a given position, e.g. only the end of a file
     void close();
     WFile* getFile();
     bool flush();
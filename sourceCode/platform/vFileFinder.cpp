@@ -69,10 +69,14 @@ int VFileFinder::_searchFilesOrFolders(const char* pathWithoutTerminalSlash,cons
                     fileAndPath+=ent->d_name;
 #ifdef WIN_SIM
                     f.lastWriteTime=0;
+                    f.size=0;
 #else // WIN_SIM
                     struct stat attrib;
                     stat(fileAndPath.c_str(),&attrib);
                     f.lastWriteTime=attrib.st_ctime;
+                    f.size=0;
+                    if (f.isFile)
+                        f.size=(unsigned long long int)attrib.st_size;
 #endif // WIN_SIM
                     _searchResult.push_back(f);
                 }
@@ -118,6 +122,9 @@ int VFileFinder::_searchFilesOrFolders(const char* pathWithoutTerminalSlash,cons
         f.path=fileInfo.filePath().toLocal8Bit().data();
         QDateTime lastWriteTime(fileInfo.lastModified());
         f.lastWriteTime=lastWriteTime.toTime_t();
+        f.size=0;
+        if (f.isFile)
+            f.size=(unsigned long long int)fileInfo.size();
         _searchResult.push_back(f);
     }
     return(int(_searchResult.size()));
@@ -9,6 +9,7 @@ struct SFileOrFolder
     std::string path;
     bool isFile;
     unsigned long long int lastWriteTime;
+    unsigned long long int size; // 0 for folders, or when not known
 };
 
 class VFileFinder  
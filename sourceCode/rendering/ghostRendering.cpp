@@ -19,6 +19,23 @@ void displayGhost(CShape* shape,const C7Vector& tr,int displayAttributes,int opt
     glDisable(GL_CULL_FACE);
 }
 
+void displayGhosts(CShape* shape,const std::vector<C7Vector>& trs,int displayAttributes,int options,float transparencyFactor,const float* color)
+{ // same shape and appearance, different poses: the state is set up and restored only once for all
+    glPushAttrib(GL_POLYGON_BIT);
+    for (size_t i=0;i<trs.size();i++)
+    {
+        glPushMatrix();
+        glTranslatef(trs[i].X(0),trs[i].X(1),trs[i].X(2));
+        C4Vector axis=trs[i].Q.getAngleAndAxisNoChecking();
+        glRotatef(axis(0)*radToDeg_f,axis(1),axis(2),axis(3));
+        shape->getMeshWrapper()->displayGhost(shape,displayAttributes,(options&4)!=0,(options&32)!=0,transparencyFactor,color);
+        glPopMatrix();
+    }
+    glPopAttrib();
+    ogl::setBlending(false);
+    glDisable(GL_CULL_FACE);
+}
+
 #else
 
 void displayGhost(CShape* shape,const C7Vector& tr,int displayAttributes,int options,float transparencyFactor,const float* color)
@@ -26,6 +43,11 @@ void displayGhost(CShape* shape,const C7Vector& tr,int displayAttributes,int opt
 
 }
 
+void displayGhosts(CShape* shape,const std::vector<C7Vector>& trs,int displayAttributes,int options,float transparencyFactor,const float* color)
+{
+
+}
+
 #endif
 
 
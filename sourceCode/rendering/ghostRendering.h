@@ -3,3 +3,4 @@
 #include "rendering.h"
 
 void displayGhost(CShape* shape,const C7Vector& tr,int displayAttributes,int options,float transparencyFactor,const float* color);
+void displayGhosts(CShape* shape,const std::vector<C7Vector>& trs,int displayAttributes,int options,float transparencyFactor,const float* color);
@@ -1341,10 +1341,12 @@ void CJoint::handleDynJointControl(bool init,int loopCnt,int totalLoops,float cu
             CInterfaceStack outStack;
 
             // 2. Call the script(s):
+            App::worldContainer->calcInfo->jointCallbackStart();
             if (script!=nullptr)
                 script->callChildScript(sim_syscb_jointcallback,&inStack,&outStack);
             if ( (cScript!=nullptr)&&(outStack.getStackSize()==0) )
                 cScript->callCustomizationScript(sim_syscb_jointcallback,&inStack,&outStack);
+            App::worldContainer->calcInfo->jointCallbackEnd(1);
             // 3. Collect the return values:
             if (outStack.getStackSize()>0)
             {
@@ -1355,8 +1357,8 @@ void CJoint::handleDynJointControl(bool init,int loopCnt,int totalLoops,float cu
                 outStack.getStackMapFloatValue("velocity",velocity);
             }
         }
-        else
-        { // there doesn't seem to be any appropriate function for joint handling in the attached child or customization scripts
+        else if (!App::currentWorld->embeddedScriptContainer->handleJointCallbackBatch(this,init,loopCnt,totalLoops,currentPos,effort,dynStepSize,errorV,velocity,forceTorque))
+        { // there doesn't seem to be any appropriate function for joint handling in the attached child or customization scripts, nor up the hierarchy (batched mode)
             // we have the built-in control (position PID or spring-damper KC)
             // Following 9 new since 7/5/2014:
             float P=_dynamicMotorPositionControl_P;
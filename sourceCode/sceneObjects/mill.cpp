@@ -7,6 +7,7 @@
 #include "app.h"
 #include "pluginContainer.h"
 #include "millRendering.h"
+#include "octree.h"
 
 CMill::CMill(int theType)
 {
@@ -469,11 +470,27 @@ int CMill::handleMill(bool exceptExplicitHandling,float& milledSurface,float& mi
 
     int stTime=VDateTime::getTimeInMs();
 
-    // For now:
-    int cutObjectHandle=-1;
     milledSurface=0.0f;
     milledVolume=0.0f;
-    _milledObjectCount=0; //CCuttingRoutine::cutEntity(getObjectHandle(),_millableObject,cutObjectHandle,milledSurface,milledVolume,justForInitialization,false);
+    _milledObjectCount=0;
+    if (!justForInitialization)
+    { // the mill volume is removed from the octree workpieces. The surface is the one the cut exposed on the workpieces
+        C7Vector millTr(getFullCumulativeTransformation());
+        std::vector<COctree*> octrees;
+        _getMillableOctrees(octrees);
+        for (size_t i=0;i<octrees.size();i++)
+        {
+            float surf;
+            int cnt=octrees[i]->subtractConvexVolume(convexVolume,millTr,&surf);
+            if (cnt>0)
+            {
+                float cellSize=octrees[i]->getCellSize();
+                milledVolume+=float(cnt)*cellSize*cellSize*cellSize;
+                milledSurface+=surf;
+                _milledObjectCount++;
+            }
+        }
+    }
     _milledSurface=milledSurface;
     _milledVolume=milledVolume;
     _calcTimeInMs=VDateTime::getTimeDiffInMs(stTime);
@@ -481,6 +498,35 @@ int CMill::handleMill(bool exceptExplicitHandling,float& milledSurface,float& mi
     return(_milledObjectCount);
 }
 
+void CMill::_getMillableOctrees(std::vector<COctree*>& octrees) const
+{
+    octrees.clear();
+    if (_millableObject==-1)
+    {
+        for (size_t i=0;i<App::currentWorld->sceneObjects->getOctreeCount();i++)
+            octrees.push_back(App::currentWorld->sceneObjects->getOctreeFromIndex(i));
+    }
+    else if (_millableObject>=SIM_IDSTART_COLLECTION)
+    {
+        CCollection* coll=App::currentWorld->collections->getObjectFromHandle(_millableObject);
+        if (coll!=nullptr)
+        {
+            for (size_t i=0;i<coll->getSceneObjectCountInCollection();i++)
+            {
+                COctree* it=App::currentWorld->sceneObjects->getOctreeFromHandle(coll->getSceneObjectHandleFromIndex(i));
+                if (it!=nullptr)
+                    octrees.push_back(it);
+            }
+        }
+    }
+    else
+    {
+        COctree* it=App::currentWorld->sceneObjects->getOctreeFromHandle(_millableObject);
+        if (it!=nullptr)
+            octrees.push_back(it);
+    }
+}
+
 float CMill::getCalculationTime() const
 {
     return(float(_calcTimeInMs)*0.001f);
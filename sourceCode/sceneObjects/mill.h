@@ -4,6 +4,8 @@
 #include "sceneObject.h"
 #include "convexVolume.h"
 
+class COctree;
+
 class CMill : public CSceneObject  
 {
 public:
@@ -78,6 +80,7 @@ public:
     CConvexVolume* convexVolume;
 
 protected:
+    void _getMillableOctrees(std::vector<COctree*>& octrees) const;
 
     // Variables which need to be serialized & copied
     CColorObject activeVolumeColor;
@@ -85,7 +88,7 @@ protected:
     float _size;
     bool _explicitHandling;
     int _millType;
-    int _millableObject; // scene object handle or collection handle
+    int _millableObject; // scene object handle or collection handle. -1: all octrees in the scene
     bool _millDataValid;
     float _milledSurface;
     float _milledVolume;
@@ -9,6 +9,12 @@
 #include "global.h"
 #include "app.h"
 #include "octreeRendering.h"
+#include "convexVolume.h"
+#include "workerPool.h"
+#include <unordered_set>
+#include <algorithm>
+
+bool COctree::_incrementalUpdates=true;
 
 COctree::COctree()
 {
@@ -33,6 +39,7 @@ COctree::COctree()
     _cellSizeForDisplay=0;
     _vertexBufferId=-1;
     _normalBufferId=-1;
+    _voxelIndicesValid=false;
 
     clear(); // also sets the _minDim and _maxDim values
 }
@@ -93,49 +100,239 @@ float* COctree::getColors()
     return(&_colors[0]);
 }
 
-void COctree::_readPositionsAndColorsAndSetDimensions()
-{
+void COctree::_readPositionsAndColorsAndSetDimensions(bool randomColors/*=true*/)
+{ // randomColors is false when called from a worker thread (SIM_RAND_FLOAT is not thread-safe)
     _voxelPositions.clear();
     _colors.clear();
+    _voxelIndicesValid=false;
     if (_octreeInfo!=nullptr)
     {
         CPluginContainer::geomPlugin_getOctreeVoxelPositions(_octreeInfo,_voxelPositions);
         CPluginContainer::geomPlugin_getOctreeVoxelColors(_octreeInfo,_colors);
-        if (_useRandomColors)
+        if (_useRandomColors&&randomColors)
+            _setRandomColors();
+        _computeDimensionsFromVoxels();
+    }
+    else
+        clear();
+}
+
+void COctree::_setRandomColors()
+{
+    _colors.clear();
+    for (size_t i=0;i<_voxelPositions.size()/3;i++)
+    {
+        _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+        _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+        _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+        _colors.push_back(0.0);
+    }
+}
+
+void COctree::_computeDimensionsFromVoxels()
+{
+    for (size_t i=0;i<_voxelPositions.size()/3;i++)
+    {
+        C3Vector p(&_voxelPositions[3*i]);
+        if (i==0)
         {
-            _colors.clear();
-            for (size_t i=0;i<_voxelPositions.size()/3;i++)
+            _minDim=p;
+            _maxDim=p;
+        }
+        else
+        {
+            _minDim.keepMin(p);
+            _maxDim.keepMax(p);
+        }
+    }
+    _minDim(0)-=_cellSize*0.5;
+    _minDim(1)-=_cellSize*0.5;
+    _minDim(2)-=_cellSize*0.5;
+    _maxDim(0)+=_cellSize*0.5;
+    _maxDim(1)+=_cellSize*0.5;
+    _maxDim(2)+=_cellSize*0.5;
+}
+
+void COctree::_buildVoxelIndices()
+{ // maps integer voxel coordinates (relative to the first voxel) to indices in _voxelPositions
+    _voxelIndices.clear();
+    _voxelIndices.reserve(_voxelPositions.size()/3);
+    if (_voxelPositions.size()>0)
+        _voxelGridOrigin=C3Vector(&_voxelPositions[0]);
+    _voxelIndicesValid=true;
+    for (size_t i=0;i<_voxelPositions.size()/3;i++)
+    {
+        unsigned long long key;
+        if (_getVoxelKey(C3Vector(&_voxelPositions[3*i]),key))
+            _voxelIndices[key]=int(i);
+        else
+        {
+            _voxelIndicesValid=false;
+            break;
+        }
+    }
+}
+
+bool COctree::_getVoxelKey(const C3Vector& p,unsigned long long& key,C3Vector* voxelCenter/*=nullptr*/) const
+{ // 21 bits per axis. Returns false if the point is too far away from the grid origin
+    key=0;
+    for (size_t i=0;i<3;i++)
+    {
+        float c=floor((p(i)-_voxelGridOrigin(i))/_cellSize+0.5f);
+        if ((c<-1048575.0f)||(c>1048575.0f))
+            return(false);
+        key=(key<<21)|((unsigned long long)(int(c)+1048576)&0x1fffff);
+        if (voxelCenter!=nullptr)
+            (*voxelCenter)(i)=_voxelGridOrigin(i)+c*_cellSize;
+    }
+    return(true);
+}
+
+bool COctree::_insertPointsIncrementally(const float* pts,int ptsCnt,const unsigned char* optionalColors3,bool colorsAreIndividual)
+{ // Called after the points were inserted into the octree structure. Returns false if the local copy could not be updated
+    if (_voxelPositions.size()==0)
+        return(false);
+    if (!_voxelIndicesValid)
+        _buildVoxelIndices();
+    if (!_voxelIndicesValid)
+        return(false);
+    bool grew=false;
+    std::vector<float> newPositions;
+    std::vector<std::pair<int,int> > recolored; // voxel index, point index
+    std::vector<int> newFromPoint;
+    std::unordered_map<unsigned long long,int> newIndices;
+    for (int i=0;i<ptsCnt;i++)
+    {
+        C3Vector p(pts+3*i);
+        unsigned long long key;
+        C3Vector center;
+        if (!_getVoxelKey(p,key,&center))
+            return(false);
+        std::unordered_map<unsigned long long,int>::iterator it=_voxelIndices.find(key);
+        if (it!=_voxelIndices.end())
+            recolored.push_back(std::make_pair(it->second,i));
+        else
+        {
+            std::unordered_map<unsigned long long,int>::iterator it2=newIndices.find(key);
+            if (it2==newIndices.end())
             {
-                _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
-                _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
-                _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
-                _colors.push_back(0.0);
+                // Make sure the octree really holds a voxel there, i.e. that our grid matches:
+                if (!CPluginContainer::geomPlugin_getOctreePointCollision(_octreeInfo,C7Vector::identityTransformation,center))
+                    return(false);
+                newIndices[key]=int(newFromPoint.size());
+                newFromPoint.push_back(i);
+                newPositions.push_back(center(0));
+                newPositions.push_back(center(1));
+                newPositions.push_back(center(2));
+                for (size_t j=0;j<3;j++)
+                    grew|=((center(j)-_cellSize*0.5f<_minDim(j))||(center(j)+_cellSize*0.5f>_maxDim(j)));
             }
+            else
+                newFromPoint[it2->second]=i; // last inserted point wins, as in the octree structure
+        }
+    }
+    if (grew)
+    { // the octree structure might have been extended. Check that its voxels still lie on our grid. A point
+      // collision test is not enough here, since it also succeeds when the grid moved by less than half a cell:
+        std::vector<float> positions;
+        CPluginContainer::geomPlugin_getOctreeVoxelPositions(_octreeInfo,positions);
+        if (positions.size()<3)
+            return(false);
+        for (size_t j=0;j<3;j++)
+        {
+            float d=(positions[j]-_voxelGridOrigin(j))/_cellSize;
+            if (fabs(d-floor(d+0.5f))>0.01f)
+                return(false);
         }
+    }
 
-        for (size_t i=0;i<_voxelPositions.size()/3;i++)
+    float defCol[3]={color.getColorsPtr()[0],color.getColorsPtr()[1],color.getColorsPtr()[2]};
+    if (!_useRandomColors)
+    {
+        for (size_t i=0;i<recolored.size();i++)
         {
-            C3Vector p(&_voxelPositions[3*i]);
-            if (i==0)
+            float* c=&_colors[4*recolored[i].first];
+            for (size_t j=0;j<3;j++)
             {
-                _minDim=p;
-                _maxDim=p;
+                if (optionalColors3==nullptr)
+                    c[j]=defCol[j];
+                else if (colorsAreIndividual)
+                    c[j]=float(optionalColors3[3*recolored[i].second+j])/255.1f;
+                else
+                    c[j]=float(optionalColors3[j])/255.1f;
             }
+        }
+    }
+    _voxelPositions.reserve(_voxelPositions.size()+newPositions.size());
+    _colors.reserve(_colors.size()+newFromPoint.size()*4);
+    for (size_t i=0;i<newFromPoint.size();i++)
+    {
+        C3Vector center(&newPositions[3*i]);
+        unsigned long long key;
+        _getVoxelKey(center,key);
+        _voxelIndices[key]=int(_voxelPositions.size()/3);
+        _voxelPositions.push_back(center(0));
+        _voxelPositions.push_back(center(1));
+        _voxelPositions.push_back(center(2));
+        for (size_t j=0;j<3;j++)
+        {
+            if (_useRandomColors)
+                _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+            else if (optionalColors3==nullptr)
+                _colors.push_back(defCol[j]);
+            else if (colorsAreIndividual)
+                _colors.push_back(float(optionalColors3[3*newFromPoint[i]+j])/255.1f);
             else
+                _colors.push_back(float(optionalColors3[j])/255.1f);
+        }
+        _colors.push_back(0.0);
+        C3Vector h(_cellSize*0.5f,_cellSize*0.5f,_cellSize*0.5f);
+        _minDim.keepMin(center-h);
+        _maxDim.keepMax(center+h);
+    }
+    return(true);
+}
+
+bool COctree::_subtractPointsIncrementally(const float* pts,int ptsCnt)
+{ // Called after the points were removed from the octree structure. Returns false if the local copy could not be updated
+    if (!_voxelIndicesValid)
+        _buildVoxelIndices();
+    if (!_voxelIndicesValid)
+        return(false);
+    bool shrunk=false;
+    for (int i=0;i<ptsCnt;i++)
+    {
+        unsigned long long key;
+        if (!_getVoxelKey(C3Vector(pts+3*i),key))
+            continue; // outside of the octree anyways
+        std::unordered_map<unsigned long long,int>::iterator it=_voxelIndices.find(key);
+        if (it!=_voxelIndices.end())
+        { // move the last voxel into the freed slot:
+            int index=it->second;
+            _voxelIndices.erase(it);
+            for (size_t j=0;j<3;j++)
             {
-                _minDim.keepMin(p);
-                _maxDim.keepMax(p);
+                float v=_voxelPositions[3*index+j];
+                shrunk|=((v-_cellSize*0.5f<=_minDim(j)+_cellSize*0.01f)||(v+_cellSize*0.5f>=_maxDim(j)-_cellSize*0.01f));
             }
+            int last=int(_voxelPositions.size()/3)-1;
+            if (index!=last)
+            {
+                for (size_t j=0;j<3;j++)
+                    _voxelPositions[3*index+j]=_voxelPositions[3*last+j];
+                for (size_t j=0;j<4;j++)
+                    _colors[4*index+j]=_colors[4*last+j];
+                unsigned long long lastKey;
+                _getVoxelKey(C3Vector(&_voxelPositions[3*index]),lastKey);
+                _voxelIndices[lastKey]=index;
+            }
+            _voxelPositions.resize(3*last);
+            _colors.resize(4*last);
         }
-        _minDim(0)-=_cellSize*0.5;
-        _minDim(1)-=_cellSize*0.5;
-        _minDim(2)-=_cellSize*0.5;
-        _maxDim(0)+=_cellSize*0.5;
-        _maxDim(1)+=_cellSize*0.5;
-        _maxDim(2)+=_cellSize*0.5;
     }
-    else
-        clear();
+    if (shrunk&&(_voxelPositions.size()>0))
+        _computeDimensionsFromVoxels();
+    return(_voxelPositions.size()>0);
 }
 
 void COctree::insertPoints(const float* pts,int ptsCnt,bool ptsAreRelativeToOctree,const unsigned char* optionalColors3,bool colorsAreIndividual,const unsigned int* optionalTags,unsigned int theTagWhenOptionalTagsIsNull)
@@ -156,6 +353,7 @@ void COctree::insertPoints(const float* pts,int ptsCnt,bool ptsAreRelativeToOctr
         }
         _pts=&__pts[0];
     }
+    bool incremental=false;
     if (_octreeInfo==nullptr)
     {
         if (optionalColors3==nullptr)
@@ -185,8 +383,10 @@ void COctree::insertPoints(const float* pts,int ptsCnt,bool ptsAreRelativeToOctr
             else
                 CPluginContainer::geomPlugin_insertPointsIntoOctree(_octreeInfo,C7Vector::identityTransformation,_pts,ptsCnt,optionalColors3,optionalTags[0]);
         }
+        incremental=_incrementalUpdates&&_insertPointsIncrementally(_pts,ptsCnt,optionalColors3,colorsAreIndividual);
     }
-    _readPositionsAndColorsAndSetDimensions();
+    if (!incremental)
+        _readPositionsAndColorsAndSetDimensions();
 }
 
 void COctree::insertShape(CShape* shape,unsigned int theTag)
@@ -300,6 +500,8 @@ void COctree::subtractPoints(const float* pts,int ptsCnt,bool ptsAreRelativeToOc
             CPluginContainer::geomPlugin_destroyOctree(_octreeInfo);
             _octreeInfo=nullptr;
         }
+        else if (_incrementalUpdates&&_subtractPointsIncrementally(_pts,ptsCnt))
+            return;
     }
     _readPositionsAndColorsAndSetDimensions();
 }
@@ -392,6 +594,148 @@ void COctree::subtractObject(const CSceneObject* obj)
         subtractPointCloud((CPointCloud*)obj);
 }
 
+int COctree::subtractConvexVolume(const CConvexVolume* volume,const C7Vector& volumeTr,float* exposedSurface/*=nullptr*/)
+{ // Removes the voxels whose center lies inside the volume, and returns their count. exposedSurface receives
+    // the surface of the voxel faces that the removal uncovered. volumeTr is the absolute transformation of the volume
+    TRACE_INTERNAL;
+    if (exposedSurface!=nullptr)
+        exposedSurface[0]=0.0f;
+    C3Vector volMin,volMax;
+    if ( (_octreeInfo==nullptr)||(_voxelPositions.size()==0)||(!volume->getVolumeBoundingBox(volMin,volMax)) )
+        return(0);
+    C7Vector octreeToVolume(volumeTr.getInverse()*getFullCumulativeTransformation());
+    C7Vector volumeToOctree(octreeToVolume.getInverse());
+
+    // Bounding box of the volume, relative to the octree and clipped to the octree:
+    C3Vector boxMin,boxMax;
+    for (size_t i=0;i<8;i++)
+    {
+        C3Vector corner(volMin);
+        for (size_t j=0;j<3;j++)
+        {
+            if (i&(1<<j))
+                corner(j)=volMax(j);
+        }
+        corner=volumeToOctree*corner;
+        if (i==0)
+        {
+            boxMin=corner;
+            boxMax=corner;
+        }
+        else
+        {
+            boxMin.keepMin(corner);
+            boxMax.keepMax(corner);
+        }
+    }
+    boxMin.keepMax(_minDim);
+    boxMax.keepMin(_maxDim);
+    if ( (boxMin(0)>boxMax(0))||(boxMin(1)>boxMax(1))||(boxMin(2)>boxMax(2)) )
+        return(0);
+
+    if (!_voxelIndicesValid)
+        _buildVoxelIndices();
+    int voxelCnt=int(_voxelPositions.size()/3);
+    std::vector<float> removed; // voxel centers, relative to the octree
+    int cellMin[3];
+    int cellMax[3];
+    float cellCnt=1.0f;
+    if (_voxelIndicesValid)
+    {
+        for (size_t j=0;j<3;j++)
+        {
+            cellMin[j]=int(floor((boxMin(j)-_voxelGridOrigin(j))/_cellSize+0.5f));
+            cellMax[j]=int(floor((boxMax(j)-_voxelGridOrigin(j))/_cellSize+0.5f));
+            cellCnt*=float(cellMax[j]-cellMin[j]+1);
+        }
+    }
+    if ( _voxelIndicesValid&&(cellCnt<float(voxelCnt)) )
+    { // the volume is small compared to the octree (the usual case with a mill): we visit the grid cells it overlaps
+        for (int x=cellMin[0];x<=cellMax[0];x++)
+        {
+            for (int y=cellMin[1];y<=cellMax[1];y++)
+            {
+                for (int z=cellMin[2];z<=cellMax[2];z++)
+                {
+                    C3Vector center(_voxelGridOrigin+C3Vector(float(x),float(y),float(z))*_cellSize);
+                    unsigned long long key;
+                    if ( _getVoxelKey(center,key)&&(_voxelIndices.find(key)!=_voxelIndices.end())&&volume->isPointInsideVolume(octreeToVolume*center) )
+                    {
+                        removed.push_back(center(0));
+                        removed.push_back(center(1));
+                        removed.push_back(center(2));
+                    }
+                }
+            }
+        }
+    }
+    else
+    { // we visit all voxels, in parallel:
+        const int chunkSize=4096;
+        int chunkCnt=(voxelCnt+chunkSize-1)/chunkSize;
+        std::vector<std::vector<int> > inside(chunkCnt);
+        CWorkerPool::parallelFor(chunkCnt,[&](int chunk)
+        {
+            int to=std::min<int>(voxelCnt,(chunk+1)*chunkSize);
+            for (int i=chunk*chunkSize;i<to;i++)
+            {
+                C3Vector p(&_voxelPositions[3*i]);
+                if ( (p(0)>=boxMin(0))&&(p(0)<=boxMax(0))&&(p(1)>=boxMin(1))&&(p(1)<=boxMax(1))&&(p(2)>=boxMin(2))&&(p(2)<=boxMax(2)) )
+                {
+                    if (volume->isPointInsideVolume(octreeToVolume*p))
+                        inside[chunk].push_back(i);
+                }
+            }
+        });
+        for (size_t chunk=0;chunk<inside.size();chunk++)
+        {
+            for (size_t i=0;i<inside[chunk].size();i++)
+                removed.insert(removed.end(),_voxelPositions.begin()+3*inside[chunk][i],_voxelPositions.begin()+3*inside[chunk][i]+3);
+        }
+    }
+    int removedCnt=int(removed.size()/3);
+    if (removedCnt==0)
+        return(0);
+
+    if ( (exposedSurface!=nullptr)&&_voxelIndicesValid )
+    { // faces shared between a removed voxel and a remaining voxel:
+        std::unordered_set<unsigned long long> removedKeys;
+        removedKeys.reserve(removedCnt);
+        for (int i=0;i<removedCnt;i++)
+        {
+            unsigned long long key;
+            if (_getVoxelKey(C3Vector(&removed[3*i]),key))
+                removedKeys.insert(key);
+        }
+        int faceCnt=0;
+        for (int i=0;i<removedCnt;i++)
+        {
+            for (size_t j=0;j<6;j++)
+            {
+                C3Vector neighbour(&removed[3*i]);
+                neighbour(j/2)+=_cellSize*float(2*int(j%2)-1);
+                unsigned long long key;
+                if ( _getVoxelKey(neighbour,key)&&(_voxelIndices.find(key)!=_voxelIndices.end())&&(removedKeys.find(key)==removedKeys.end()) )
+                    faceCnt++;
+            }
+        }
+        exposedSurface[0]=float(faceCnt)*_cellSize*_cellSize;
+    }
+
+    subtractPoints(&removed[0],removedCnt,true);
+    return(removedCnt);
+}
+
+void COctree::setIncrementalUpdates(bool e)
+{ // when false, the whole structure is re-read after each modification (for comparison)
+    _incrementalUpdates=e;
+}
+
+bool COctree::getIncrementalUpdates()
+{
+    return(_incrementalUpdates);
+}
+
 void COctree::clear()
 {
     TRACE_INTERNAL;
@@ -402,6 +746,8 @@ void COctree::clear()
     }
     _voxelPositions.clear();
     _colors.clear();
+    _voxelIndices.clear();
+    _voxelIndicesValid=false;
     _minDim.set(-0.1f,-0.1f,-0.1f);
     _maxDim.set(+0.1f,+0.1f,+0.1f);
 }
@@ -545,6 +891,7 @@ void COctree::scaleObject(float scalingFactor)
     _maxDim*=scalingFactor;
     for (size_t i=0;i<_voxelPositions.size();i++)
         _voxelPositions[i]*=scalingFactor;
+    _voxelIndicesValid=false;
     if (_octreeInfo!=nullptr)
         CPluginContainer::geomPlugin_scaleOctree(_octreeInfo,scalingFactor);
 }
@@ -702,6 +1049,22 @@ void COctree::simulationEnded()
     CSceneObject::simulationEnded();
 }
 
+void COctree::decodeLoadedData()
+{
+    if (_octreeInfoLoadingData.size()>0)
+    {
+        _octreeInfo=CPluginContainer::geomPlugin_getOctreeFromSerializationData(&_octreeInfoLoadingData[0]);
+        std::vector<unsigned char>().swap(_octreeInfoLoadingData);
+        _readPositionsAndColorsAndSetDimensions(false);
+    }
+}
+
+void COctree::finalizeLoadedData()
+{
+    if ( (_octreeInfo!=nullptr)&&_useRandomColors )
+        _setRandomColors();
+}
+
 void COctree::serialize(CSer& ar)
 {
     CSceneObject::serialize(ar);
@@ -843,17 +1206,8 @@ void COctree::serialize(CSer& ar)
                     {
                         noHit=false;
                         ar >> byteQuantity; // never use that info, unless loading unknown data!!!! (undo/redo never stores calc structures)
-
-                        std::vector<unsigned char> data;
-                        data.reserve(byteQuantity);
-                        unsigned char dummy;
-                        for (int i=0;i<byteQuantity;i++)
-                        {
-                            ar >> dummy;
-                            data.push_back(dummy);
-                        }
-                        _octreeInfo=CPluginContainer::geomPlugin_getOctreeFromSerializationData(&data[0]);
-                        _readPositionsAndColorsAndSetDimensions();
+                        // decoded in decodeLoadedData:
+                        ar.readFileBufferBytes(_octreeInfoLoadingData,byteQuantity);
                     }
                     if (noHit)
                         ar.loadUnknownData();
@@ -4,9 +4,11 @@
 #include "sceneObject.h"
 #include "3Vector.h"
 #include "7Vector.h"
+#include <unordered_map>
 
 class CDummy;
 class CPointCloud;
+class CConvexVolume;
 
 class COctree : public CSceneObject
 {
@@ -23,6 +25,8 @@ public:
     void scaleObjectNonIsometrically(float x,float y,float z);
     void serialize(CSer& ar);
     void serializeWExtIk(CExtIkSer& ar);
+    void decodeLoadedData();
+    void finalizeLoadedData();
     void announceCollectionWillBeErased(int groupID,bool copyBuffer);
     void announceCollisionWillBeErased(int collisionID,bool copyBuffer);
     void announceDistanceWillBeErased(int distanceID,bool copyBuffer);
@@ -72,8 +76,11 @@ public:
     void subtractOctree(const void* octree2Info,const C7Vector& octree2Tr);
     void subtractObjects(const std::vector<int>& sel);
     void subtractObject(const CSceneObject* obj);
+    int subtractConvexVolume(const CConvexVolume* volume,const C7Vector& volumeTr,float* exposedSurface=nullptr);
 
     void clear();
+    static void setIncrementalUpdates(bool e);
+    static bool getIncrementalUpdates();
     bool getShowOctree() const;
     void setShowOctree(bool show);
     bool getUseRandomColors() const;
@@ -102,13 +109,20 @@ public:
     float* getColors();
 
 protected:
-    void _readPositionsAndColorsAndSetDimensions();
+    void _readPositionsAndColorsAndSetDimensions(bool randomColors=true);
+    void _setRandomColors();
+    void _buildVoxelIndices();
+    bool _getVoxelKey(const C3Vector& p,unsigned long long& key,C3Vector* voxelCenter=nullptr) const;
+    bool _insertPointsIncrementally(const float* pts,int ptsCnt,const unsigned char* optionalColors3,bool colorsAreIndividual);
+    bool _subtractPointsIncrementally(const float* pts,int ptsCnt);
+    void _computeDimensionsFromVoxels();
 
     // Variables which need to be serialized & copied
     CColorObject color;
     float _cellSize;
     int _pointSize;
     void* _octreeInfo;
+    std::vector<unsigned char> _octreeInfoLoadingData; // serialization data, until decodeLoadedData is called
     C3Vector _minDim;
     C3Vector _maxDim;
     std::vector<float> _voxelPositions;
@@ -124,4 +138,11 @@ protected:
     float _cellSizeForDisplay;
     int _vertexBufferId;
     int _normalBufferId;
+
+    // following to keep _voxelPositions in sync without re-reading the whole octree:
+    std::unordered_map<unsigned long long,int> _voxelIndices;
+    C3Vector _voxelGridOrigin;
+    bool _voxelIndicesValid;
+
+    static bool _incrementalUpdates;
 };
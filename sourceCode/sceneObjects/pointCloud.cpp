@@ -10,6 +10,11 @@
 #include "vDateTime.h"
 #include "app.h"
 #include "pointCloudRendering.h"
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+
+bool CPointCloud::_incrementalUpdates=true;
 
 CPointCloud::CPointCloud()
 {
@@ -36,6 +41,9 @@ CPointCloud::CPointCloud()
     _insertionDistanceTolerance=0.0;
     _nonEmptyCells=0;
     _pointDisplayRatio=1.0;
+    _displayRatioAccumulator=0.0f;
+    _displayPointsDirty=false;
+    _pointGridValid=false;
 
     clear(); // also sets the _minDim and _maxDim values
 }
@@ -73,18 +81,26 @@ std::vector<float>* CPointCloud::getColors()
 
 std::vector<float>* CPointCloud::getDisplayPoints()
 {
+    if (_displayPointsDirty)
+        _resampleDisplayPoints();
     return(&_displayPoints);
 }
 
 std::vector<float>* CPointCloud::getDisplayColors()
 {
+    if (_displayPointsDirty)
+        _resampleDisplayPoints();
     return(&_displayColors);
 }
 
-void CPointCloud::_readPositionsAndColorsAndSetDimensions()
-{
+void CPointCloud::_readPositionsAndColorsAndSetDimensions(bool randomColors/*=true*/)
+{ // randomColors is false when called from a worker thread (SIM_RAND_FLOAT is not thread-safe)
     _displayPoints.clear();
     _displayColors.clear();
+    _displayRatioAccumulator=0.0f;
+    _displayPointsDirty=false;
+    _pointGridValid=false;
+    _pointGrid.clear();
     if (_doNotUseOctreeStructure)
     {
         _nonEmptyCells=0;
@@ -134,25 +150,8 @@ void CPointCloud::_readPositionsAndColorsAndSetDimensions()
             CPluginContainer::geomPlugin_getPtcloudPoints(_pointCloudInfo,_points,&_colors);
             if (_pointDisplayRatio<0.99f)
                 CPluginContainer::geomPlugin_getPtcloudPoints(_pointCloudInfo,_displayPoints,&_displayColors,_pointDisplayRatio);
-            if (_useRandomColors)
-            {
-                _colors.clear();
-                for (size_t i=0;i<_points.size()/3;i++)
-                {
-                    _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
-                    _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
-                    _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
-                    _colors.push_back(0.0);
-                }
-                _displayColors.clear();
-                for (size_t i=0;i<_displayPoints.size()/3;i++)
-                {
-                    _displayColors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
-                    _displayColors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
-                    _displayColors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
-                    _displayColors.push_back(0.0);
-                }
-            }
+            if (_useRandomColors&&randomColors)
+                _setRandomColors();
 
             for (size_t i=0;i<_points.size()/3;i++)
             {
@@ -182,6 +181,298 @@ void CPointCloud::_readPositionsAndColorsAndSetDimensions()
     }
 }
 
+void CPointCloud::_setRandomColors()
+{
+    _colors.clear();
+    for (size_t i=0;i<_points.size()/3;i++)
+    {
+        _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+        _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+        _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+        _colors.push_back(0.0);
+    }
+    _displayColors.clear();
+    for (size_t i=0;i<_displayPoints.size()/3;i++)
+    {
+        _displayColors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+        _displayColors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+        _displayColors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+        _displayColors.push_back(0.0);
+    }
+}
+
+void CPointCloud::_appendPointsAndColors(const float* pts,int ptsCnt,const unsigned char* optionalColors3,bool colorsAreIndividual)
+{ // appends to _points, _colors and the display subset, without going through the calculation structure
+    size_t firstPoint=_points.size()/3;
+    _points.insert(_points.end(),pts,pts+ptsCnt*3);
+    _colors.reserve(_colors.size()+ptsCnt*4);
+    for (int i=0;i<ptsCnt;i++)
+    {
+        for (size_t j=0;j<3;j++)
+        {
+            if (_useRandomColors)
+                _colors.push_back(0.2f+SIM_RAND_FLOAT*0.8f);
+            else if (optionalColors3==nullptr)
+                _colors.push_back(color.getColorsPtr()[j]);
+            else if (colorsAreIndividual)
+                _colors.push_back(float(optionalColors3[3*i+j])/255.1f);
+            else
+                _colors.push_back(float(optionalColors3[j])/255.1f);
+        }
+        _colors.push_back(0.0);
+    }
+    if ( (!_doNotUseOctreeStructure)&&(_pointDisplayRatio<0.99f) )
+    {
+        for (int i=0;i<ptsCnt;i++)
+        {
+            _displayRatioAccumulator+=_pointDisplayRatio;
+            if (_displayRatioAccumulator>=1.0f)
+            {
+                _displayRatioAccumulator-=1.0f;
+                _displayPoints.insert(_displayPoints.end(),pts+3*i,pts+3*i+3);
+                _displayColors.insert(_displayColors.end(),_colors.begin()+4*(firstPoint+i),_colors.begin()+4*(firstPoint+i)+4);
+            }
+        }
+    }
+    if (_pointGridValid)
+    {
+        for (int i=0;i<ptsCnt;i++)
+        {
+            long long c[3];
+            _getPointGridCell(pts+3*i,c);
+            _pointGrid[_getPointGridKey(c[0],c[1],c[2])].push_back(int(firstPoint)+i);
+        }
+    }
+    _extendDimensions(firstPoint);
+}
+
+void CPointCloud::_extendDimensions(size_t firstPoint)
+{
+    for (size_t i=firstPoint;i<_points.size()/3;i++)
+    {
+        C3Vector p(&_points[3*i]);
+        if (i==0)
+        {
+            _minDim=p;
+            _maxDim=p;
+        }
+        else
+        {
+            _minDim.keepMin(p);
+            _maxDim.keepMax(p);
+        }
+    }
+}
+
+void CPointCloud::_resampleDisplayPoints()
+{ // rebuilds the display subset from _points, instead of asking the calculation structure
+    _displayPoints.clear();
+    _displayColors.clear();
+    _displayRatioAccumulator=0.0f;
+    _displayPointsDirty=false;
+    if ( (!_doNotUseOctreeStructure)&&(_pointDisplayRatio<0.99f) )
+    {
+        for (size_t i=0;i<_points.size()/3;i++)
+        {
+            _displayRatioAccumulator+=_pointDisplayRatio;
+            if (_displayRatioAccumulator>=1.0f)
+            {
+                _displayRatioAccumulator-=1.0f;
+                _displayPoints.insert(_displayPoints.end(),_points.begin()+3*i,_points.begin()+3*i+3);
+                _displayColors.insert(_displayColors.end(),_colors.begin()+4*i,_colors.begin()+4*i+4);
+            }
+        }
+    }
+}
+
+void CPointCloud::_getPointGridCell(const float* p,long long cell[3]) const
+{
+    for (size_t j=0;j<3;j++)
+        cell[j]=(long long)floor(p[j]/_cellSize);
+}
+
+unsigned long long CPointCloud::_getPointGridKey(long long x,long long y,long long z)
+{ // 21 bits per axis
+    unsigned long long key=((unsigned long long)(x+1048576)&0x1fffff);
+    key=(key<<21)|((unsigned long long)(y+1048576)&0x1fffff);
+    key=(key<<21)|((unsigned long long)(z+1048576)&0x1fffff);
+    return(key);
+}
+
+void CPointCloud::_buildPointGrid()
+{ // O(N), only needed again after the points were re-read from the calculation structure
+    _pointGrid.clear();
+    _pointGrid.reserve(_points.size()/3);
+    for (size_t i=0;i<_points.size()/3;i++)
+    {
+        long long c[3];
+        _getPointGridCell(&_points[3*i],c);
+        _pointGrid[_getPointGridKey(c[0],c[1],c[2])].push_back(int(i));
+    }
+    _pointGridValid=true;
+}
+
+bool CPointCloud::_insertPointsIncrementally(const float* pts,int ptsCnt,const unsigned char* optionalColors3,bool colorsAreIndividual)
+{ // Called after the points were inserted into the calculation structure. The structure silently drops points that
+  // are within the insertion tolerance of another point, or that fall into a full cell. We append the new points
+  // locally (in O(ptsCnt)) only if none of them can have been dropped, assuming the structure's cells are not larger
+  // than _cellSize. Returns false if a full re-read is needed
+    if ( (_points.size()==0)||_useRandomColors||(_insertionDistanceTolerance>_cellSize) )
+        return(false);
+    if (!_pointGridValid)
+        _buildPointGrid();
+    float tol2=_insertionDistanceTolerance*_insertionDistanceTolerance*1.01f; // borderline distances also lead to a re-read
+    std::unordered_map<unsigned long long,std::vector<int> > added; // new points per cell, indices into pts
+    for (int i=0;i<ptsCnt;i++)
+    {
+        const float* p=pts+3*i;
+        long long c[3];
+        _getPointGridCell(p,c);
+        int cnt[3][3][3];
+        for (int dx=-1;dx<=1;dx++)
+        {
+            for (int dy=-1;dy<=1;dy++)
+            {
+                for (int dz=-1;dz<=1;dz++)
+                {
+                    unsigned long long key=_getPointGridKey(c[0]+dx,c[1]+dy,c[2]+dz);
+                    int& n=cnt[dx+1][dy+1][dz+1];
+                    n=0;
+                    std::unordered_map<unsigned long long,std::vector<int> >::const_iterator it=_pointGrid.find(key);
+                    if (it!=_pointGrid.end())
+                    {
+                        for (size_t k=0;k<it->second.size();k++)
+                        {
+                            const float* q=&_points[3*it->second[k]];
+                            if ((p[0]-q[0])*(p[0]-q[0])+(p[1]-q[1])*(p[1]-q[1])+(p[2]-q[2])*(p[2]-q[2])<=tol2)
+                                return(false);
+                        }
+                        n+=int(it->second.size());
+                    }
+                    it=added.find(key);
+                    if (it!=added.end())
+                    {
+                        for (size_t k=0;k<it->second.size();k++)
+                        {
+                            const float* q=pts+3*it->second[k];
+                            if ((p[0]-q[0])*(p[0]-q[0])+(p[1]-q[1])*(p[1]-q[1])+(p[2]-q[2])*(p[2]-q[2])<=tol2)
+                                return(false);
+                        }
+                        n+=int(it->second.size());
+                    }
+                }
+            }
+        }
+        // A structure cell containing p overlaps 2x2x2 of our cells, one of which is p's cell:
+        for (int sx=0;sx<=2;sx+=2)
+        {
+            for (int sy=0;sy<=2;sy+=2)
+            {
+                for (int sz=0;sz<=2;sz+=2)
+                {
+                    int n=0;
+                    for (int x=std::min(1,sx);x<=std::max(1,sx);x++)
+                    {
+                        for (int y=std::min(1,sy);y<=std::max(1,sy);y++)
+                        {
+                            for (int z=std::min(1,sz);z<=std::max(1,sz);z++)
+                                n+=cnt[x][y][z];
+                        }
+                    }
+                    if (n>=_maxPointCountPerCell)
+                        return(false);
+                }
+            }
+        }
+        added[_getPointGridKey(c[0],c[1],c[2])].push_back(i);
+    }
+    _appendPointsAndColors(pts,ptsCnt,optionalColors3,colorsAreIndividual); // also updates the grid
+    _nonEmptyCells=CPluginContainer::geomPlugin_getPtcloudNonEmptyCellCount(_pointCloudInfo);
+    return(true);
+}
+
+bool CPointCloud::_removePointsIncrementally(const float* pts,int ptsCnt,float distanceTolerance,int removedCnt)
+{ // Called after the points were removed from the calculation structure. We find the same points locally via the
+  // point grid, and remove them by moving the last points into their slots, i.e. in O(ptsCnt+removedCnt). Returns
+  // false if the result doesn't match, and a full re-read is needed
+    if ( (distanceTolerance<=0.0f)||(removedCnt<=0)||(_points.size()==0) )
+        return(removedCnt==0);
+    if ( (size_t(removedCnt)>=_points.size()/3)||(distanceTolerance>_cellSize*2.0f) )
+        return(false);
+    if (!_pointGridValid)
+        _buildPointGrid();
+    int r=(distanceTolerance>_cellSize)?2:1;
+    float tol2=distanceTolerance*distanceTolerance;
+    std::vector<int> removed;
+    std::unordered_set<int> isRemoved;
+    for (int i=0;i<ptsCnt;i++)
+    {
+        const float* q=pts+3*i;
+        long long c[3];
+        _getPointGridCell(q,c);
+        for (int dx=-r;dx<=r;dx++)
+        {
+            for (int dy=-r;dy<=r;dy++)
+            {
+                for (int dz=-r;dz<=r;dz++)
+                {
+                    std::unordered_map<unsigned long long,std::vector<int> >::const_iterator it=_pointGrid.find(_getPointGridKey(c[0]+dx,c[1]+dy,c[2]+dz));
+                    if (it!=_pointGrid.end())
+                    {
+                        for (size_t k=0;k<it->second.size();k++)
+                        {
+                            int ind=it->second[k];
+                            const float* p=&_points[3*ind];
+                            float d2=(p[0]-q[0])*(p[0]-q[0])+(p[1]-q[1])*(p[1]-q[1])+(p[2]-q[2])*(p[2]-q[2]);
+                            if ( (d2>tol2*0.99f)&&(d2<tol2*1.01f) )
+                                return(false); // borderline, the structure might have decided otherwise
+                            if ( (d2<=tol2)&&(isRemoved.find(ind)==isRemoved.end()) )
+                            {
+                                isRemoved.insert(ind);
+                                removed.push_back(ind);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    if (int(removed.size())!=removedCnt)
+        return(false);
+
+    // Removed points are handled in descending order, so that the last point is never one still to be removed:
+    std::sort(removed.begin(),removed.end(),std::greater<int>());
+    bool boundaryPointRemoved=false;
+    for (size_t i=0;i<removed.size();i++)
+    {
+        int ind=removed[i];
+        int last=int(_points.size()/3)-1;
+        long long c[3];
+        _getPointGridCell(&_points[3*ind],c);
+        std::vector<int>& cell=_pointGrid[_getPointGridKey(c[0],c[1],c[2])];
+        cell.erase(std::find(cell.begin(),cell.end(),ind));
+        for (size_t j=0;j<3;j++)
+            boundaryPointRemoved|=((_points[3*ind+j]<=_minDim(j))||(_points[3*ind+j]>=_maxDim(j)));
+        if (ind!=last)
+        {
+            _getPointGridCell(&_points[3*last],c);
+            std::vector<int>& lastCell=_pointGrid[_getPointGridKey(c[0],c[1],c[2])];
+            *std::find(lastCell.begin(),lastCell.end(),last)=ind;
+            for (size_t j=0;j<3;j++)
+                _points[3*ind+j]=_points[3*last+j];
+            for (size_t j=0;j<4;j++)
+                _colors[4*ind+j]=_colors[4*last+j];
+        }
+        _points.resize(3*last);
+        _colors.resize(4*last);
+    }
+    if (boundaryPointRemoved)
+        _extendDimensions(0); // the bounding box can only shrink if a point on its boundary was removed
+    _displayPointsDirty=(_pointDisplayRatio<0.99f);
+    _nonEmptyCells=CPluginContainer::geomPlugin_getPtcloudNonEmptyCellCount(_pointCloudInfo);
+    return(true);
+}
+
 void CPointCloud::_getCharRGB3Colors(const std::vector<float>& floatRGBA,std::vector<unsigned char>& charRGB)
 {
     charRGB.resize(floatRGBA.size()*3/4);
@@ -219,7 +510,8 @@ int CPointCloud::removePoints(const float* pts,int ptsCnt,bool ptsAreRelativeToP
             CPluginContainer::geomPlugin_destroyPtcloud(_pointCloudInfo);
             _pointCloudInfo=nullptr;
         }
-        _readPositionsAndColorsAndSetDimensions();
+        if ( (_pointCloudInfo==nullptr)||(!_incrementalUpdates)||(!_removePointsIncrementally(_pts,ptsCnt,distanceTolerance,pointCntRemoved)) )
+            _readPositionsAndColorsAndSetDimensions();
     }
     return(pointCntRemoved);
 }
@@ -345,42 +637,7 @@ void CPointCloud::insertPoints(const float* pts,int ptsCnt,bool ptsAreRelativeTo
         _pts=&__pts[0];
     }
     if (_doNotUseOctreeStructure)
-    {
-        _points.insert(_points.end(),_pts,_pts+ptsCnt*3);
-        if (optionalColors3==nullptr)
-        {
-            for (int i=0;i<ptsCnt;i++)
-            {
-                _colors.push_back(color.getColorsPtr()[0]);
-                _colors.push_back(color.getColorsPtr()[1]);
-                _colors.push_back(color.getColorsPtr()[2]);
-                _colors.push_back(0.0);
-            }
-        }
-        else
-        {
-            if (colorsAreIndividual)
-            {
-                for (int i=0;i<ptsCnt;i++)
-                {
-                    _colors.push_back(float(optionalColors3[3*i+0])/255.1f);
-                    _colors.push_back(float(optionalColors3[3*i+1])/255.1f);
-                    _colors.push_back(float(optionalColors3[3*i+2])/255.1f);
-                    _colors.push_back(0.0);
-                }
-            }
-            else
-            {
-                for (int i=0;i<ptsCnt;i++)
-                {
-                    _colors.push_back(float(optionalColors3[0])/255.1f);
-                    _colors.push_back(float(optionalColors3[1])/255.1f);
-                    _colors.push_back(float(optionalColors3[2])/255.1f);
-                    _colors.push_back(0.0);
-                }
-            }
-        }
-    }
+        _appendPointsAndColors(_pts,ptsCnt,optionalColors3,colorsAreIndividual);
     else
     {
         if (_pointCloudInfo==nullptr)
@@ -412,9 +669,11 @@ void CPointCloud::insertPoints(const float* pts,int ptsCnt,bool ptsAreRelativeTo
                 else
                     CPluginContainer::geomPlugin_insertPointsIntoPtcloud(_pointCloudInfo,C7Vector::identityTransformation,_pts,ptsCnt,optionalColors3,_insertionDistanceTolerance);
             }
+            if ( _incrementalUpdates&&_insertPointsIncrementally(_pts,ptsCnt,optionalColors3,colorsAreIndividual) )
+                return;
         }
+        _readPositionsAndColorsAndSetDimensions();
     }
-    _readPositionsAndColorsAndSetDimensions();
 }
 
 void CPointCloud::insertShape(CShape* shape)
@@ -503,6 +762,16 @@ void CPointCloud::insertObject(const CSceneObject* obj)
         insertPointCloud((CPointCloud*)obj);
 }
 
+void CPointCloud::setIncrementalUpdates(bool e)
+{ // when false, the whole structure is re-read after each modification (for comparison)
+    _incrementalUpdates=e;
+}
+
+bool CPointCloud::getIncrementalUpdates()
+{
+    return(_incrementalUpdates);
+}
+
 void CPointCloud::clear()
 {
     TRACE_INTERNAL;
@@ -510,6 +779,9 @@ void CPointCloud::clear()
     _colors.clear();
     _displayPoints.clear();
     _displayColors.clear();
+    _displayPointsDirty=false;
+    _pointGrid.clear();
+    _pointGridValid=false;
     if (_pointCloudInfo!=nullptr)
     {
         CPluginContainer::geomPlugin_destroyPtcloud(_pointCloudInfo);
@@ -600,6 +872,8 @@ void CPointCloud::scaleObject(float scalingFactor)
         _points[i]*=scalingFactor;
     for (size_t i=0;i<_displayPoints.size();i++)
         _displayPoints[i]*=scalingFactor;
+    _pointGrid.clear();
+    _pointGridValid=false;
     if (_pointCloudInfo!=nullptr)
         CPluginContainer::geomPlugin_scalePtcloud(_pointCloudInfo,scalingFactor);
 }
@@ -642,6 +916,7 @@ CSceneObject* CPointCloud::copyYourself()
     newPointcloud->_pointDisplayRatio=_pointDisplayRatio;
     newPointcloud->_displayPoints.assign(_displayPoints.begin(),_displayPoints.end());
     newPointcloud->_displayColors.assign(_displayColors.begin(),_displayColors.end());
+    newPointcloud->_displayPointsDirty=_displayPointsDirty;
 
     return(newPointcloud);
 }
@@ -894,6 +1169,22 @@ void CPointCloud::simulationEnded()
     CSceneObject::simulationEnded();
 }
 
+void CPointCloud::decodeLoadedData()
+{
+    if (_pointCloudInfoLoadingData.size()>0)
+    {
+        _pointCloudInfo=CPluginContainer::geomPlugin_getPtcloudFromSerializationData(&_pointCloudInfoLoadingData[0]);
+        std::vector<unsigned char>().swap(_pointCloudInfoLoadingData);
+        _readPositionsAndColorsAndSetDimensions(false);
+    }
+}
+
+void CPointCloud::finalizeLoadedData()
+{
+    if ( (_pointCloudInfo!=nullptr)&&_useRandomColors )
+        _setRandomColors();
+}
+
 void CPointCloud::serialize(CSer& ar)
 {
     CSceneObject::serialize(ar);
@@ -1083,17 +1374,8 @@ void CPointCloud::serialize(CSer& ar)
                     {
                         noHit=false;
                         ar >> byteQuantity; // never use that info, unless loading unknown data!!!! (undo/redo never stores calc structures)
-
-                        std::vector<unsigned char> data;
-                        data.reserve(byteQuantity);
-                        unsigned char dummy;
-                        for (int i=0;i<byteQuantity;i++)
-                        {
-                            ar >> dummy;
-                            data.push_back(dummy);
-                        }
-                        _pointCloudInfo=CPluginContainer::geomPlugin_getPtcloudFromSerializationData(&data[0]);
-                        _readPositionsAndColorsAndSetDimensions();
+                        // decoded in decodeLoadedData:
+                        ar.readFileBufferBytes(_pointCloudInfoLoadingData,byteQuantity);
                     }
                     if (noHit)
                         ar.loadUnknownData();
@@ -4,6 +4,7 @@
 #include "sceneObject.h"
 #include "3Vector.h"
 #include "7Vector.h"
+#include <unordered_map>
 
 class CDummy;
 class COctree;
@@ -23,6 +24,8 @@ public:
     void scaleObjectNonIsometrically(float x,float y,float z);
     void serialize(CSer& ar);
     void serializeWExtIk(CExtIkSer& ar);
+    void decodeLoadedData();
+    void finalizeLoadedData();
     void announceCollectionWillBeErased(int groupID,bool copyBuffer);
     void announceCollisionWillBeErased(int collisionID,bool copyBuffer);
     void announceDistanceWillBeErased(int distanceID,bool copyBuffer);
@@ -73,6 +76,8 @@ public:
     int intersectPoints(const float* pts,int ptsCnt,bool ptsAreRelativeToPointCloud,float distanceTolerance);
 
     void clear();
+    static void setIncrementalUpdates(bool e);
+    static bool getIncrementalUpdates();
     bool getShowOctree() const;
     void setShowOctree(bool show);
     float getAveragePointCountInCell();
@@ -107,7 +112,16 @@ public:
     std::vector<float>* getDisplayColors();
 
 protected:
-    void _readPositionsAndColorsAndSetDimensions();
+    void _readPositionsAndColorsAndSetDimensions(bool randomColors=true);
+    void _setRandomColors();
+    void _appendPointsAndColors(const float* pts,int ptsCnt,const unsigned char* optionalColors3,bool colorsAreIndividual);
+    bool _insertPointsIncrementally(const float* pts,int ptsCnt,const unsigned char* optionalColors3,bool colorsAreIndividual);
+    bool _removePointsIncrementally(const float* pts,int ptsCnt,float distanceTolerance,int removedCnt);
+    void _buildPointGrid();
+    void _getPointGridCell(const float* p,long long cell[3]) const;
+    static unsigned long long _getPointGridKey(long long x,long long y,long long z);
+    void _extendDimensions(size_t firstPoint);
+    void _resampleDisplayPoints();
     void _getCharRGB3Colors(const std::vector<float>& floatRGBA,std::vector<unsigned char>& charRGB);
 
     // Variables which need to be serialized & copied
@@ -115,6 +129,7 @@ protected:
     float _cellSize;
     int _maxPointCountPerCell;
     void* _pointCloudInfo;
+    std::vector<unsigned char> _pointCloudInfoLoadingData; // serialization data, until decodeLoadedData is called
     C3Vector _minDim;
     C3Vector _maxDim;
     std::vector<float> _points;
@@ -132,4 +147,13 @@ protected:
     float _pointDisplayRatio;
     bool _doNotUseOctreeStructure;
     bool _colorIsEmissive;
+
+    float _displayRatioAccumulator;
+    bool _displayPointsDirty; // the display subset is resampled when next needed
+
+    // Point indices in _points, per cell of size _cellSize. Used for incremental updates, not serialized:
+    std::unordered_map<unsigned long long,std::vector<int> > _pointGrid;
+    bool _pointGridValid;
+
+    static bool _incrementalUpdates;
 };
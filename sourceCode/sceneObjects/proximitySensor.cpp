@@ -166,6 +166,7 @@ void CProxSensor::commonInit()
     _randomizedDetection=false;
     _randomizedDetectionSampleCount=20;
     _randomizedDetectionCountForDetection=5;
+    _randGen.seed(123456);
 
     size=0.01f;
     _showVolumeWhenNotDetecting=true;
@@ -175,7 +176,7 @@ void CProxSensor::commonInit()
     _sensableObject=-1;
     _sensableType=sim_objectspecialproperty_detectable_ultrasonic;
     _detectedPointValid=false;
-    _calcTimeInMs=0;
+    _calcTimeInUs=0;
 
     passiveVolumeColor.setColorsAllBlack();
     passiveVolumeColor.setColor(0.9f,0.0f,0.5f,sim_colorcomponent_ambient_diffuse);
@@ -362,6 +363,7 @@ void CProxSensor::initializeInitialValues(bool simulationAlreadyRunning)
 { // is called at simulation start, but also after object(s) have been copied into a scene!
     CSceneObject::initializeInitialValues(simulationAlreadyRunning);
     _initialExplicitHandling=explicitHandling;
+    _randGen.seed(123456+_objectHandle); // each simulation run produces the same rays
 }
 
 void CProxSensor::simulationAboutToStart()
@@ -815,34 +817,29 @@ bool CProxSensor::getMarkingBoundingBox(C3Vector& minV,C3Vector& maxV) const
 }
 
 void CProxSensor::calculateFreshRandomizedRays()
-{
-    _randomizedVectors.clear();
-    _randomizedVectorDetectionStates.clear();
-    // Build the random rays (only direction)
+{ // Uses the sensor's own random generator, and can run in a worker thread
+    size_t cnt=size_t(_randomizedDetectionSampleCount);
+    // First draw all random values, then build the rays (only direction) in one tight loop:
+    std::vector<float> rnd(cnt*3);
+    for (size_t i=0;i<rnd.size();i++)
+        rnd[i]=float(_randGen())/float(_randGen.max());
+    _randomizedVectors.resize(cnt);
+    _randomizedVectorDetectionStates.assign(cnt,0.0f);
     float angle=convexVolume->getAngle();
-    for (int i=0;i<_randomizedDetectionSampleCount;i++)
+    // if angle>90, we have 360x180 degrees. We compute it as 2 half-spheres, in order to have a perfect direction distribution. Otherwise we have 360xA degrees, where A<=90:
+    bool twoHalfSpheres=(angle>1.1f*piValD2_f);
+    float zScaling=1.0f;
+    if (!twoHalfSpheres)
+        zScaling=angle/piValue_f;
+    for (size_t i=0;i<cnt;i++)
     {
-        float rZ,sZ,cZ;
-        if (angle>1.1f*piValD2_f)
-        { // this means we have 360x180 degrees. We compute it as 2 half-spheres, in order to have a perfect direction distribution:
-            rZ=acos(1.0f-SIM_RAND_FLOAT);
-            sZ=sin(rZ);
-            cZ=cos(rZ);
-            if (SIM_RAND_FLOAT>0.5f)
-                cZ=-cZ;
-        }
-        else
-        { // this means we have 360xA degrees, where A<=90.
-            rZ=angle*acos(1.0f-SIM_RAND_FLOAT)/piValue_f;
-            sZ=sin(rZ);
-            cZ=cos(rZ);
-        }
-        float rXY=SIM_RAND_FLOAT*piValTimes2_f;
-        float sXY=sin(rXY);
-        float cXY=cos(rXY);
-        C3Vector v(sZ*cXY,sZ*sXY,cZ);
-        _randomizedVectors.push_back(v);
-        _randomizedVectorDetectionStates.push_back(0.0f);
+        float rZ=zScaling*acos(1.0f-rnd[3*i+0]);
+        float sZ=sin(rZ);
+        float cZ=cos(rZ);
+        if ( twoHalfSpheres&&(rnd[3*i+1]>0.5f) )
+            cZ=-cZ;
+        float rXY=rnd[3*i+2]*piValTimes2_f;
+        _randomizedVectors[i]=C3Vector(sZ*cos(rXY),sZ*sin(rXY),cZ);
     }
 }
 
@@ -862,25 +859,37 @@ void CProxSensor::resetSensor(bool exceptExplicitHandling)
     {
         _detectedPointValid=false;
         _sensorResultValid=false;
-        _calcTimeInMs=0;
+        _calcTimeInUs=0;
     }
 }
 
 bool CProxSensor::handleSensor(bool exceptExplicitHandling,int& detectedObjectHandle,C3Vector& detectedNormalVector)
 {
+    if (!prepareSensorHandling(exceptExplicitHandling))
+        return(false);
+    computeDetection(true);
+    return(finalizeSensorHandling(detectedObjectHandle,detectedNormalVector));
+}
+
+bool CProxSensor::prepareSensorHandling(bool exceptExplicitHandling)
+{ // returns true if computeDetection should follow
     if (exceptExplicitHandling&&getExplicitHandling())
         return(false); // We don't want to handle those
     _sensorResultValid=false;
     _detectedPointValid=false;
-    _calcTimeInMs=0;
+    _calcTimeInUs=0;
     if (!App::currentWorld->mainSettings->proximitySensorsEnabled)
         return(false);
     if (!CPluginContainer::isGeomPluginAvailable())
         return(false);
 
     _sensorResultValid=true;
+    return(true);
+}
 
-    int stTime=VDateTime::getTimeInMs();
+void CProxSensor::computeDetection(bool updateCalcInfo,const CProxSensorBroadphase* broadphase/*=nullptr*/)
+{ // only modifies the sensor itself, and can run in a worker thread
+    unsigned long long int stTime=VDateTime::getTimeInUs();
 
     float treshhold=SIM_MAX_FLOAT;
     float minThreshold=-1.0f;
@@ -889,10 +898,27 @@ bool CProxSensor::handleSensor(bool exceptExplicitHandling,int& detectedObjectHa
 
     _randomizedVectors.clear();
     _randomizedVectorDetectionStates.clear();
-    _detectedPointValid=CProxSensorRoutine::detectEntity(_objectHandle,_sensableObject,closestObjectMode,normalCheck,allowedNormal,_detectedPoint,treshhold,frontFaceDetection,backFaceDetection,detectedObjectHandle,minThreshold,detectedNormalVector,false);
+    int detectedObjectHandle;
+    C3Vector detectedNormalVector;
+    _detectedPointValid=CProxSensorRoutine::detectEntity(_objectHandle,_sensableObject,closestObjectMode,normalCheck,allowedNormal,_detectedPoint,treshhold,frontFaceDetection,backFaceDetection,detectedObjectHandle,minThreshold,detectedNormalVector,false,updateCalcInfo,broadphase);
     _detectedObjectHandle=detectedObjectHandle;
     _detectedNormalVector=detectedNormalVector;
-    _calcTimeInMs=VDateTime::getTimeDiffInMs(stTime);
+    _calcTimeInUs=VDateTime::getTimeInUs()-stTime;
+}
+
+bool CProxSensor::getHasTriggerCallback() const
+{ // i.e. handling this sensor can run a script, which could modify the scene or read other sensors
+    CLuaScriptObject* script=App::currentWorld->embeddedScriptContainer->getScriptFromObjectAttachedTo_child(_objectHandle);
+    if ( (script!=nullptr)&&script->getContainsTriggerCallbackFunction() )
+        return(true);
+    script=App::currentWorld->embeddedScriptContainer->getScriptFromObjectAttachedTo_customization(_objectHandle);
+    return( (script!=nullptr)&&script->getContainsTriggerCallbackFunction() );
+}
+
+bool CProxSensor::finalizeSensorHandling(int& detectedObjectHandle,C3Vector& detectedNormalVector)
+{ // calls the trigger callbacks. Must run in the simulation thread, in sensor order
+    detectedObjectHandle=_detectedObjectHandle;
+    detectedNormalVector=_detectedNormalVector;
     if (_sensorResultValid&&_detectedPointValid)
     {
         CLuaScriptObject* script=App::currentWorld->embeddedScriptContainer->getScriptFromObjectAttachedTo_child(_objectHandle);
@@ -994,7 +1020,12 @@ int CProxSensor::readSensor(C3Vector& detectPt,int& detectedObjectHandle,C3Vecto
 
 float CProxSensor::getCalculationTime() const
 {
-    return(float(_calcTimeInMs)*0.001f);
+    return(float(_calcTimeInUs)*0.000001f);
+}
+
+unsigned long long int CProxSensor::getCalculationTimeInUs() const
+{
+    return(_calcTimeInUs);
 }
 
 bool CProxSensor::getFrontFaceDetection() const
@@ -1039,7 +1070,7 @@ void CProxSensor::setClosestObjectMode(bool closestObjMode)
 {
     closestObjectMode=closestObjMode;
     _detectedPointValid=false;
-    _calcTimeInMs=0;
+    _calcTimeInUs=0;
 }
 bool CProxSensor::getClosestObjectMode()
 {
@@ -3,6 +3,9 @@
 
 #include "sceneObject.h"
 #include "convexVolume.h"
+#include <random>
+
+class CProxSensorBroadphase;
 
 class CProxSensor : public CSceneObject  
 {
@@ -52,6 +55,10 @@ public:
     int getSensableObject();
 
     bool handleSensor(bool exceptExplicitHandling,int& detectedObjectHandle,C3Vector& detectedNormalVector);
+    bool prepareSensorHandling(bool exceptExplicitHandling);
+    void computeDetection(bool updateCalcInfo,const CProxSensorBroadphase* broadphase=nullptr);
+    bool finalizeSensorHandling(int& detectedObjectHandle,C3Vector& detectedNormalVector);
+    bool getHasTriggerCallback() const;
     void resetSensor(bool exceptExplicitHandling);
     int readSensor(C3Vector& detectPt,int& detectedObjectHandle,C3Vector& detectedNormalVector);
 
@@ -104,6 +111,7 @@ public:
     std::vector<float>* getPointerToRandomizedRayDetectionStates();
 
     float getCalculationTime() const;
+    unsigned long long int getCalculationTimeInUs() const;
     C3Vector getDetectedPoint() const;
     bool getIsDetectedPointValid() const;
     std::string getSensableObjectLoadName() const;
@@ -140,7 +148,7 @@ protected:
     bool _sensorResultValid;
     int _detectedObjectHandle;
     C3Vector _detectedNormalVector;
-    int _calcTimeInMs;
+    unsigned long long int _calcTimeInUs;
 
     bool _randomizedDetection;
     int _randomizedDetectionSampleCount;
@@ -148,6 +156,7 @@ protected:
 
     std::vector<C3Vector> _randomizedVectors;
     std::vector<float> _randomizedVectorDetectionStates;
+    std::mt19937 _randGen; // own generator: reproducible rays, and sensors can be handled concurrently
 
     bool _initialExplicitHandling;
 
@@ -0,0 +1,196 @@
+#include "proxSensorBroadphase.h"
+#include "shape.h"
+#include "octree.h"
+#include "pointCloud.h"
+#include <algorithm>
+
+const int LEAF_ENTRY_COUNT=4;
+
+CProxSensorBroadphase::CProxSensorBroadphase()
+{
+}
+
+CProxSensorBroadphase::~CProxSensorBroadphase()
+{
+}
+
+void CProxSensorBroadphase::build(const std::vector<CSceneObject*>& objects)
+{
+    _entries.clear();
+    _nodes.clear();
+    for (size_t i=0;i<objects.size();i++)
+    {
+        SBroadphaseEntry entry;
+        if (getObjectBoundingBox(objects[i],entry.minV,entry.maxV))
+        {
+            entry.object=objects[i];
+            entry.order=int(i);
+            entry.specialProperty=objects[i]->getCumulativeObjectSpecialProperty();
+            entry.center=(entry.minV+entry.maxV)*0.5f;
+            _entries.push_back(entry);
+        }
+    }
+    if (_entries.size()>0)
+    {
+        _nodes.reserve(2*_entries.size()/LEAF_ENTRY_COUNT+1);
+        _buildNode(0,int(_entries.size()));
+    }
+}
+
+int CProxSensorBroadphase::_buildNode(int first,int count)
+{
+    int nodeIndex=int(_nodes.size());
+    _nodes.push_back(SBroadphaseNode());
+    C3Vector minV(_entries[first].minV);
+    C3Vector maxV(_entries[first].maxV);
+    C3Vector minC(_entries[first].center);
+    C3Vector maxC(_entries[first].center);
+    for (int i=first+1;i<first+count;i++)
+    {
+        minV.keepMin(_entries[i].minV);
+        maxV.keepMax(_entries[i].maxV);
+        minC.keepMin(_entries[i].center);
+        maxC.keepMax(_entries[i].center);
+    }
+    _nodes[nodeIndex].minV=minV;
+    _nodes[nodeIndex].maxV=maxV;
+    _nodes[nodeIndex].first=first;
+    _nodes[nodeIndex].count=count;
+    _nodes[nodeIndex].right=-1;
+    C3Vector centerSpread(maxC-minC);
+    if ( (count>LEAF_ENTRY_COUNT)&&((centerSpread(0)>0.0f)||(centerSpread(1)>0.0f)||(centerSpread(2)>0.0f)) )
+    { // split at the median center, along the axis with the largest center spread:
+        int axis=0;
+        if (centerSpread(1)>centerSpread(axis))
+            axis=1;
+        if (centerSpread(2)>centerSpread(axis))
+            axis=2;
+        int half=count/2;
+        std::nth_element(_entries.begin()+first,_entries.begin()+first+half,_entries.begin()+first+count,[axis](const SBroadphaseEntry& a,const SBroadphaseEntry& b){return(a.center(axis)<b.center(axis));});
+        _nodes[nodeIndex].count=0;
+        _buildNode(first,half);
+        int right=_buildNode(first+half,count-half);
+        _nodes[nodeIndex].right=right;
+    }
+    return(nodeIndex);
+}
+
+void CProxSensorBroadphase::getCandidates(CProxSensor* sensor,int detectableMask,std::vector<CSceneObject*>& candidates) const
+{ // candidates are the detectable objects whose bounding box overlaps the sensing volume. They are returned in the order they were provided in build
+    candidates.clear();
+    if (_nodes.size()==0)
+        return;
+    C3Vector minV,maxV;
+    getSensorBoundingBox(sensor,minV,maxV);
+    std::vector<size_t> found;
+    std::vector<int> stack;
+    stack.push_back(0);
+    while (stack.size()>0)
+    {
+        int nodeIndex=stack[stack.size()-1];
+        stack.pop_back();
+        const SBroadphaseNode& node=_nodes[nodeIndex];
+        if (_boxesOverlap(node.minV,node.maxV,minV,maxV))
+        {
+            if (node.count>0)
+            {
+                for (int i=node.first;i<node.first+node.count;i++)
+                {
+                    const SBroadphaseEntry& entry=_entries[i];
+                    if ( ((entry.specialProperty&detectableMask)!=0)||(detectableMask==-1) )
+                    {
+                        if (_boxesOverlap(entry.minV,entry.maxV,minV,maxV))
+                            found.push_back(size_t(i));
+                    }
+                }
+            }
+            else
+            {
+                stack.push_back(node.right);
+                stack.push_back(nodeIndex+1);
+            }
+        }
+    }
+    // Restore the original object order (entries were reordered while building), so that results don't depend on the hierarchy:
+    std::vector<std::pair<int,CSceneObject*> > ordered;
+    for (size_t i=0;i<found.size();i++)
+        ordered.push_back(std::make_pair(_entries[found[i]].order,_entries[found[i]].object));
+    std::sort(ordered.begin(),ordered.end());
+    for (size_t i=0;i<ordered.size();i++)
+        candidates.push_back(ordered[i].second);
+}
+
+size_t CProxSensorBroadphase::getObjectCount() const
+{
+    return(_entries.size());
+}
+
+bool CProxSensorBroadphase::getObjectBoundingBox(CSceneObject* obj,C3Vector& minV,C3Vector& maxV)
+{ // world-space box enclosing the object's bounding box, as used by CProxSensorRoutine
+    C3Vector halfSize;
+    C7Vector tr;
+    if (obj->getObjectType()==sim_object_shape_type)
+    {
+        halfSize=((CShape*)obj)->getBoundingBoxHalfSizes();
+        tr=obj->getFullCumulativeTransformation();
+    }
+    else if (obj->getObjectType()==sim_object_dummy_type)
+    {
+        halfSize.clear();
+        tr=obj->getFullCumulativeTransformation();
+    }
+    else if (obj->getObjectType()==sim_object_octree_type)
+        ((COctree*)obj)->getTransfAndHalfSizeOfBoundingBox(tr,halfSize);
+    else if (obj->getObjectType()==sim_object_pointcloud_type)
+        ((CPointCloud*)obj)->getTransfAndHalfSizeOfBoundingBox(tr,halfSize);
+    else
+        return(false);
+    _getWorldBox(tr,halfSize,minV,maxV);
+    return(true);
+}
+
+void CProxSensorBroadphase::getSensorBoundingBox(CProxSensor* sensor,C3Vector& minV,C3Vector& maxV)
+{ // world-space box enclosing the sensing volume's bounding box
+    C7Vector tr;
+    C3Vector halfSize;
+    sensor->getSensingVolumeOBB(tr,halfSize);
+    _getWorldBox(tr,halfSize,minV,maxV);
+}
+
+void CProxSensorBroadphase::removeNonOverlappingObjects(CProxSensor* sensor,std::vector<CSceneObject*>& objects)
+{ // linear version of getCandidates, for one-off queries where building the hierarchy would not pay off
+    C3Vector minV,maxV;
+    getSensorBoundingBox(sensor,minV,maxV);
+    size_t j=0;
+    for (size_t i=0;i<objects.size();i++)
+    {
+        C3Vector objMinV,objMaxV;
+        if (getObjectBoundingBox(objects[i],objMinV,objMaxV))
+        {
+            if (_boxesOverlap(objMinV,objMaxV,minV,maxV))
+                objects[j++]=objects[i];
+        }
+    }
+    objects.resize(j);
+}
+
+void CProxSensorBroadphase::_getWorldBox(const C7Vector& tr,const C3Vector& halfSize,C3Vector& minV,C3Vector& maxV)
+{ // axis-aligned box enclosing an oriented box. Slightly enlarged, to never miss touching boxes
+    C4X4Matrix m(tr.getMatrix());
+    float tolerance=0.0001f+(halfSize(0)+halfSize(1)+halfSize(2))*0.0001f;
+    C3Vector extent;
+    for (size_t k=0;k<3;k++)
+        extent(k)=fabs(m.M.axis[0](k))*halfSize(0)+fabs(m.M.axis[1](k))*halfSize(1)+fabs(m.M.axis[2](k))*halfSize(2)+tolerance;
+    minV=m.X-extent;
+    maxV=m.X+extent;
+}
+
+bool CProxSensorBroadphase::_boxesOverlap(const C3Vector& minA,const C3Vector& maxA,const C3Vector& minB,const C3Vector& maxB)
+{
+    for (size_t k=0;k<3;k++)
+    {
+        if ( (maxA(k)<minB(k))||(maxB(k)<minA(k)) )
+            return(false);
+    }
+    return(true);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "sceneObject.h"
+#include "proximitySensor.h"
+
+struct SBroadphaseEntry
+{
+    CSceneObject* object;
+    int order; // index in the list provided to build
+    int specialProperty;
+    C3Vector minV;
+    C3Vector maxV;
+    C3Vector center;
+};
+
+struct SBroadphaseNode
+{
+    C3Vector minV;
+    C3Vector maxV;
+    int first; // first entry index (leaves only)
+    int count; // entry count (leaves only), 0 for inner nodes
+    int right; // index of the right child (the left child directly follows the node)
+};
+
+// World-space bounding box hierarchy over scene objects, used to quickly find the objects that
+// might overlap a proximity sensor's sensing volume. Once built it is only read, possibly from several threads
+class CProxSensorBroadphase
+{
+public:
+    CProxSensorBroadphase();
+    virtual ~CProxSensorBroadphase();
+
+    void build(const std::vector<CSceneObject*>& objects);
+    void getCandidates(CProxSensor* sensor,int detectableMask,std::vector<CSceneObject*>& candidates) const;
+    size_t getObjectCount() const;
+
+    static bool getObjectBoundingBox(CSceneObject* obj,C3Vector& minV,C3Vector& maxV);
+    static void getSensorBoundingBox(CProxSensor* sensor,C3Vector& minV,C3Vector& maxV);
+    static void removeNonOverlappingObjects(CProxSensor* sensor,std::vector<CSceneObject*>& objects);
+
+private:
+    int _buildNode(int first,int count);
+    static void _getWorldBox(const C7Vector& tr,const C3Vector& halfSize,C3Vector& minV,C3Vector& maxV);
+    static bool _boxesOverlap(const C3Vector& minA,const C3Vector& maxA,const C3Vector& minB,const C3Vector& maxB);
+
+    std::vector<SBroadphaseEntry> _entries;
+    std::vector<SBroadphaseNode> _nodes;
+};
@@ -2,17 +2,20 @@
 #include "pluginContainer.h"
 #include "app.h"
 #include "tt.h"
+#include "workerPool.h"
+#include <algorithm>
 
 
-bool CProxSensorRoutine::detectEntity(int sensorID,int entityID,bool closestFeatureMode,bool angleLimitation,float maxAngle,C3Vector& detectedPt,float& dist,bool frontFace,bool backFace,int& detectedObject,float minThreshold,C3Vector& triNormal,bool overrideDetectableFlagIfNonCollection)
-{ // entityID==-1 --> checks all objects in the scene
+bool CProxSensorRoutine::detectEntity(int sensorID,int entityID,bool closestFeatureMode,bool angleLimitation,float maxAngle,C3Vector& detectedPt,float& dist,bool frontFace,bool backFace,int& detectedObject,float minThreshold,C3Vector& triNormal,bool overrideDetectableFlagIfNonCollection,bool updateCalcInfo/*=true*/,const CProxSensorBroadphase* broadphase/*=nullptr*/)
+{ // entityID==-1 --> checks all objects in the scene. broadphase, if provided, must have been built with the current scene state
     bool returnValue=false;
     detectedObject=-1;
     CProxSensor* sensor=App::currentWorld->sceneObjects->getProximitySensorFromHandle(sensorID);
     CSceneObject* object=App::currentWorld->sceneObjects->getObjectFromHandle(entityID);
     if (sensor==nullptr)
         return(false); // should never happen!
-    App::worldContainer->calcInfo->proximitySensorSimulationStart();
+    if (updateCalcInfo)
+        App::worldContainer->calcInfo->proximitySensorSimulationStart();
     if (sensor->getRandomizedDetection())
     {
         if (sensor->getSensorType()!=sim_proximitysensor_ray_subtype)
@@ -33,20 +36,29 @@ bool CProxSensorRoutine::detectEntity(int sensorID,int entityID,bool closestFeat
     else
     {
         std::vector<CSceneObject*> group;
-        if (entityID==-1)
-        { // Special group here (all detectable objects):
-            std::vector<CSceneObject*> exception;
-            App::currentWorld->sceneObjects->getAllDetectableObjectsFromSceneExcept(&exception,group,sensor->getSensableType());
-        }
+        if ( (entityID==-1)&&(broadphase!=nullptr) )
+            broadphase->getCandidates(sensor,sensor->getSensableType(),group); // only objects overlapping the sensing volume
         else
-        { // Regular group here:
-            App::currentWorld->collections->getDetectableObjectsFromCollection(entityID,group,sensor->getSensableType());
+        {
+            if (entityID==-1)
+            { // Special group here (all detectable objects):
+                std::vector<CSceneObject*> exception;
+                App::currentWorld->sceneObjects->getAllDetectableObjectsFromSceneExcept(&exception,group,sensor->getSensableType());
+            }
+            else
+            { // Regular group here:
+                App::currentWorld->collections->getDetectableObjectsFromCollection(entityID,group,sensor->getSensableType());
+            }
+            CProxSensorBroadphase::removeNonOverlappingObjects(sensor,group);
         }
         if (group.size()!=0)
         {
-            _orderGroupAccordingToApproxDistanceToSensingPoint(sensor,group);
+            std::vector<float> approxDistances;
+            _orderGroupAccordingToApproxDistanceToSensingPoint(sensor,group,&approxDistances);
             for (size_t i=0;i<group.size();i++)
             {
+                if (approxDistances[i]>dist)
+                    break; // this and all following objects are further away than the current detection
                 int detectObjId=_detectObject(sensor,group[i],detectedPt,dist,triNormal,closestFeatureMode,angleLimitation,maxAngle,frontFace,backFace,minThreshold);
                 returnValue=returnValue||(detectObjId>=0);
                 if (detectObjId>=0)
@@ -62,10 +74,85 @@ bool CProxSensorRoutine::detectEntity(int sensorID,int entityID,bool closestFeat
 
     if (returnValue)
         triNormal.normalize();
-    App::worldContainer->calcInfo->proximitySensorSimulationEnd(returnValue);
+    if (updateCalcInfo)
+        App::worldContainer->calcInfo->proximitySensorSimulationEnd(returnValue);
     return(returnValue);
 }
 
+void CProxSensorRoutine::handleSensors(const std::vector<CProxSensor*>& sensors,bool exceptExplicitHandling,std::vector<bool>& detected,std::vector<C3Vector>& detectedPoints,std::vector<int>& detectedObjects,std::vector<C3Vector>& detectedNormals)
+{ // Handles several sensors, with the same results as calling handleSensor on each, in order.
+  // If any sensor has a trigger callback, the sensors are handled one after the other, since a callback could modify
+  // the scene or read other sensors. Otherwise detections are computed in parallel, then committed in sensor order
+    detected.assign(sensors.size(),false);
+    detectedPoints.assign(sensors.size(),C3Vector::zeroVector);
+    detectedObjects.assign(sensors.size(),-1);
+    detectedNormals.assign(sensors.size(),C3Vector::zeroVector);
+    bool sequential=(sensors.size()<2);
+    for (size_t i=0;(i<sensors.size())&&(!sequential);i++)
+        sequential=sensors[i]->getHasTriggerCallback();
+    if (sequential)
+    {
+        std::vector<int> handles;
+        for (size_t i=0;i<sensors.size();i++)
+            handles.push_back(sensors[i]->getObjectHandle());
+        for (size_t i=0;i<sensors.size();i++)
+        {
+            CProxSensor* sensor=sensors[i];
+            if (App::currentWorld->sceneObjects->getProximitySensorFromHandle(handles[i])!=sensor)
+                continue; // the sensor was removed by a callback
+            int detectedObj;
+            C3Vector detectedNormal;
+            detected[i]=sensor->handleSensor(exceptExplicitHandling,detectedObj,detectedNormal);
+            detectedPoints[i]=sensor->getDetectedPoint();
+            detectedObjects[i]=detectedObj;
+            detectedNormals[i]=detectedNormal;
+        }
+        return;
+    }
+
+    std::vector<CProxSensor*> toHandle;
+    std::vector<size_t> toHandleIndices;
+    for (size_t i=0;i<sensors.size();i++)
+    {
+        if (sensors[i]->prepareSensorHandling(exceptExplicitHandling))
+        {
+            toHandle.push_back(sensors[i]);
+            toHandleIndices.push_back(i);
+        }
+    }
+    // Sensors that check all scene objects share one spatial index:
+    CProxSensorBroadphase broadphase;
+    bool useBroadphase=false;
+    for (size_t i=0;i<toHandle.size();i++)
+        useBroadphase=useBroadphase||(toHandle[i]->getSensableObject()==-1);
+    if (useBroadphase)
+    {
+        std::vector<CSceneObject*> objects;
+        App::currentWorld->sceneObjects->getAllDetectableObjectsFromSceneExcept(nullptr,objects,-1);
+        broadphase.build(objects);
+    }
+    CWorld* world=App::currentWorld;
+    CWorkerPool::parallelFor(int(toHandle.size()),[&](int i)
+    {
+        CWorld* previousWorld=CCurrentWorld::getThreadWorld();
+        CCurrentWorld::setThreadWorld(world);
+        toHandle[i]->computeDetection(false,&broadphase);
+        CCurrentWorld::setThreadWorld(previousWorld);
+    });
+    for (size_t i=0;i<toHandle.size();i++)
+    {
+        CProxSensor* sensor=toHandle[i];
+        App::worldContainer->calcInfo->proximitySensorSimulationAdd(sensor->getIsDetectedPointValid(),sensor->getCalculationTimeInUs());
+        size_t ind=toHandleIndices[i];
+        int detectedObj;
+        C3Vector detectedNormal;
+        detected[ind]=sensor->finalizeSensorHandling(detectedObj,detectedNormal);
+        detectedPoints[ind]=sensor->getDetectedPoint();
+        detectedObjects[ind]=detectedObj;
+        detectedNormals[ind]=detectedNormal;
+    }
+}
+
 bool CProxSensorRoutine::detectPrimitive(int sensorID,float* vertexPointer,int itemType,int itemCount,
         bool closestFeatureMode,bool angleLimitation,float maxAngle,C3Vector& detectedPt,
         float& dist,bool frontFace,bool backFace,float minThreshold,C3Vector& triNormal)
@@ -288,53 +375,22 @@ int CProxSensorRoutine::_detectShape(CProxSensor* sensor,CShape* shape,C3Vector&
 
     if (sensor->getRandomizedDetection())
     {
-        bool* closeDetectionTriggered=nullptr;
-        bool dummyVal=0;
-        if (sensor->convexVolume->getSmallestDistanceEnabled())
-            closeDetectionTriggered=&dummyVal;
-        int normalDetectionCnt=0;
-        C3Vector averageDetectionVector;
-        C3Vector averageNormalVector;
-        averageDetectionVector.clear();
-        averageNormalVector.clear();
-        float averageDetectionDist=0.0f;
-        const std::vector<C3Vector> normalizedRays=sensor->getPointerToRandomizedRays()[0];
-        std::vector<float> individualRayDetectionState=sensor->getPointerToRandomizedRayDetectionStates()[0];
-        int requiredDetectionCount=sensor->getRandomizedDetectionCountForDetection();
-        for (size_t i=0;i<normalizedRays.size();i++)
-        {
-            C3Vector lp(normalizedRays[i]*sensor->convexVolume->getRadius()); // Here we have radius instead of offset! Special with randomized detection!!
-            C3Vector lvFar(normalizedRays[i]*sensor->convexVolume->getRange());
-            float distTmp=dist;
-            C3Vector detectedPtTmp;
-            C3Vector triNormalNotNormalizedTmp;
-            float _maxAngle=0.0f;
-            if (angleLimitation)
-                _maxAngle=maxAngle;
-            bool result=CPluginContainer::geomPlugin_raySensorDetectMeshIfSmaller(lp,lvFar,shape->_meshCalculationStructure,shapeITr,distTmp,sensor->convexVolume->getSmallestDistanceAllowed(),!closestFeatureMode,frontFace,backFace,_maxAngle,&detectedPtTmp,&triNormalNotNormalizedTmp,closeDetectionTriggered);
-            if ((closeDetectionTriggered!=nullptr)&&closeDetectionTriggered[0])
-            { // We triggered the sensor in the forbiden zone
-                normalDetectionCnt=0;
-                retVal=-2;
-                break;
-            }
-            if (result)
-            { // We triggered the sensor normally
-                normalDetectionCnt++;
-                individualRayDetectionState[i]=distTmp;
-                averageDetectionVector+=detectedPtTmp;
-                averageDetectionDist+=distTmp;
-                averageNormalVector+=triNormalNotNormalizedTmp.getNormalized();
-            }
-        }
-
-        if (normalDetectionCnt>=requiredDetectionCount)
+        float _maxAngle=0.0f;
+        if (angleLimitation)
+            _maxAngle=maxAngle;
+        bool checkCloseDetection=sensor->convexVolume->getSmallestDistanceEnabled();
+        float startDist=dist;
+        std::vector<SRandomizedRayResult> results;
+        _detectRandomizedRays(sensor,results,[&](const C3Vector& normalizedRay,SRandomizedRayResult& res)
         {
-            retVal=shape->getObjectHandle();
-            dist=averageDetectionDist/float(normalDetectionCnt);
-            detectedPt=averageDetectionVector/float(normalDetectionCnt);
-            triNormalNotNormalized=averageNormalVector/float(normalDetectionCnt);
-        }
+            C3Vector lp(normalizedRay*sensor->convexVolume->getRadius()); // Here we have radius instead of offset! Special with randomized detection!!
+            C3Vector lvFar(normalizedRay*sensor->convexVolume->getRange());
+            bool closeDetectionTriggered=false;
+            res.dist=startDist;
+            res.detected=CPluginContainer::geomPlugin_raySensorDetectMeshIfSmaller(lp,lvFar,shape->_meshCalculationStructure,shapeITr,res.dist,sensor->convexVolume->getSmallestDistanceAllowed(),!closestFeatureMode,frontFace,backFace,_maxAngle,&res.detectedPt,&res.normal,checkCloseDetection?&closeDetectionTriggered:nullptr);
+            res.forbidden=closeDetectionTriggered;
+        });
+        retVal=_averageRandomizedRays(sensor,results,shape->getObjectHandle(),detectedPt,dist,triNormalNotNormalized);
     }
     else
     {
@@ -405,52 +461,20 @@ int CProxSensorRoutine::_detectOctree(CProxSensor* sensor,COctree* octree,C3Vect
 
     if (sensor->getRandomizedDetection())
     {
-        int normalDetectionCnt=0;
-        C3Vector averageDetectionVector;
-        C3Vector averageNormalVector;
-        averageDetectionVector.clear();
-        averageNormalVector.clear();
-        float averageDetectionDist=0.0f;
-        const std::vector<C3Vector> normalizedRays=sensor->getPointerToRandomizedRays()[0];
-        std::vector<float> individualRayDetectionState=sensor->getPointerToRandomizedRayDetectionStates()[0];
-        int requiredDetectionCount=sensor->getRandomizedDetectionCountForDetection();
-        for (size_t i=0;i<normalizedRays.size();i++)
+        float _maxAngle=0.0f;
+        if (angleLimitation)
+            _maxAngle=maxAngle;
+        float startDist=dist;
+        std::vector<SRandomizedRayResult> results;
+        _detectRandomizedRays(sensor,results,[&](const C3Vector& normalizedRay,SRandomizedRayResult& res)
         {
-            C3Vector lp(normalizedRays[i]*sensor->convexVolume->getRadius()); // Here we have radius instead of offset! Special with randomized detection!!
-            C3Vector lvFar(normalizedRays[i]*sensor->convexVolume->getRange());
-            float distTmp=dist;
-            C3Vector detectedPtTmp;
-            C3Vector triNormalNotNormalizedTmp;
-            float _maxAngle=0.0f;
-            if (angleLimitation)
-                _maxAngle=maxAngle;
-            bool result=CPluginContainer::geomPlugin_raySensorDetectOctreeIfSmaller(lp,lvFar,octree->getOctreeInfo(),octreeITr,distTmp,0.0f,!closestFeatureMode,frontFace,backFace,_maxAngle,&detectedPtTmp,&triNormalNotNormalizedTmp,nullptr);
-            if (result)
-            { // We triggered the sensor
-                if (sensor->convexVolume->getSmallestDistanceEnabled())
-                {
-                    if (distTmp<sensor->convexVolume->getSmallestDistanceAllowed())
-                    {
-                        normalDetectionCnt=0;
-                        retVal=-2;
-                        break;
-                    }
-                }
-                normalDetectionCnt++;
-                individualRayDetectionState[i]=distTmp;
-                averageDetectionVector+=detectedPtTmp;
-                averageDetectionDist+=distTmp;
-                averageNormalVector+=triNormalNotNormalizedTmp.getNormalized();
-            }
-        }
-
-        if (normalDetectionCnt>=requiredDetectionCount)
-        {
-            retVal=octree->getObjectHandle();
-            dist=averageDetectionDist/float(normalDetectionCnt);
-            detectedPt=averageDetectionVector/float(normalDetectionCnt);
-            triNormalNotNormalized=averageNormalVector/float(normalDetectionCnt);
-        }
+            C3Vector lp(normalizedRay*sensor->convexVolume->getRadius()); // Here we have radius instead of offset! Special with randomized detection!!
+            C3Vector lvFar(normalizedRay*sensor->convexVolume->getRange());
+            res.dist=startDist;
+            res.detected=CPluginContainer::geomPlugin_raySensorDetectOctreeIfSmaller(lp,lvFar,octree->getOctreeInfo(),octreeITr,res.dist,0.0f,!closestFeatureMode,frontFace,backFace,_maxAngle,&res.detectedPt,&res.normal,nullptr);
+            res.forbidden=res.detected&&sensor->convexVolume->getSmallestDistanceEnabled()&&(res.dist<sensor->convexVolume->getSmallestDistanceAllowed());
+        });
+        retVal=_averageRandomizedRays(sensor,results,octree->getObjectHandle(),detectedPt,dist,triNormalNotNormalized);
     }
     else
     {
@@ -541,8 +565,60 @@ int CProxSensorRoutine::_detectPointCloud(CProxSensor* sensor,CPointCloud* point
     return(retVal);
 }
 
-void CProxSensorRoutine::_orderGroupAccordingToApproxDistanceToSensingPoint(const CProxSensor* sensor,std::vector<CSceneObject*>& group)
-{
+void CProxSensorRoutine::_detectRandomizedRays(CProxSensor* sensor,std::vector<SRandomizedRayResult>& results,const std::function<void(const C3Vector&,SRandomizedRayResult&)>& rayDetection)
+{ // Rays are independent: they are checked in parallel, in batches (nested calls, e.g. when sensors are already handled in parallel, run inline)
+    const std::vector<C3Vector>& normalizedRays=sensor->getPointerToRandomizedRays()[0];
+    results.resize(normalizedRays.size());
+    const int batchSize=16;
+    int batchCnt=(int(normalizedRays.size())+batchSize-1)/batchSize;
+    CWorkerPool::parallelFor(batchCnt,[&](int batch)
+    {
+        size_t last=std::min<size_t>(size_t(batch+1)*batchSize,normalizedRays.size());
+        for (size_t i=size_t(batch)*batchSize;i<last;i++)
+            rayDetection(normalizedRays[i],results[i]);
+    });
+}
+
+int CProxSensorRoutine::_averageRandomizedRays(CProxSensor* sensor,const std::vector<SRandomizedRayResult>& results,int objectHandle,C3Vector& detectedPt,float& dist,C3Vector& triNormalNotNormalized)
+{ // combines the ray results in ray order. -2: forbidden zone triggered, -1: not enough rays detected, otherwise objectHandle
+    int retVal=-1;
+    int normalDetectionCnt=0;
+    C3Vector averageDetectionVector;
+    C3Vector averageNormalVector;
+    averageDetectionVector.clear();
+    averageNormalVector.clear();
+    float averageDetectionDist=0.0f;
+    std::vector<float>& individualRayDetectionState=sensor->getPointerToRandomizedRayDetectionStates()[0];
+    int requiredDetectionCount=sensor->getRandomizedDetectionCountForDetection();
+    for (size_t i=0;i<results.size();i++)
+    {
+        if (results[i].forbidden)
+        { // We triggered the sensor in the forbiden zone
+            normalDetectionCnt=0;
+            retVal=-2;
+            break;
+        }
+        if (results[i].detected)
+        { // We triggered the sensor normally
+            normalDetectionCnt++;
+            individualRayDetectionState[i]=results[i].dist;
+            averageDetectionVector+=results[i].detectedPt;
+            averageDetectionDist+=results[i].dist;
+            averageNormalVector+=results[i].normal.getNormalized();
+        }
+    }
+    if (normalDetectionCnt>=requiredDetectionCount)
+    {
+        retVal=objectHandle;
+        dist=averageDetectionDist/float(normalDetectionCnt);
+        detectedPt=averageDetectionVector/float(normalDetectionCnt);
+        triNormalNotNormalized=averageNormalVector/float(normalDetectionCnt);
+    }
+    return(retVal);
+}
+
+void CProxSensorRoutine::_orderGroupAccordingToApproxDistanceToSensingPoint(const CProxSensor* sensor,std::vector<CSceneObject*>& group,std::vector<float>* approxDistances/*=nullptr*/)
+{ // approxDistances, if not nullptr, receives the ordered approximate distances
     std::vector<float> distances;
     std::vector<int> indexes;
     std::vector<CSceneObject*> _group(group);
@@ -557,6 +633,8 @@ void CProxSensorRoutine::_orderGroupAccordingToApproxDistanceToSensingPoint(cons
     tt::orderAscending(distances,indexes);
     for (size_t i=0;i<indexes.size();i++)
         group.push_back(_group[indexes[i]]);
+    if (approxDistances!=nullptr)
+        approxDistances[0].swap(distances);
 }
 
 float CProxSensorRoutine::_getApproxPointObjectBoundingBoxDistance(const C3Vector& point,CSceneObject* obj)
@@ -4,6 +4,17 @@
 #include "proximitySensor.h"
 #include "octree.h"
 #include "pointCloud.h"
+#include "proxSensorBroadphase.h"
+#include <functional>
+
+struct SRandomizedRayResult
+{
+    bool detected;
+    bool forbidden; // detected in the forbidden zone
+    float dist;
+    C3Vector detectedPt;
+    C3Vector normal;
+};
 
 
 //FULLY STATIC CLASS
@@ -11,7 +22,8 @@ class CProxSensorRoutine
 {
 public:
     // The main general routine:
-    static bool detectEntity(int sensorID,int entityID,bool closestFeatureMode,bool angleLimitation,float maxAngle,C3Vector& detectedPt,float& dist,bool frontFace,bool backFace,int& detectedObject,float minThreshold,C3Vector& triNormal,bool overrideDetectableFlagIfNonCollection);
+    static bool detectEntity(int sensorID,int entityID,bool closestFeatureMode,bool angleLimitation,float maxAngle,C3Vector& detectedPt,float& dist,bool frontFace,bool backFace,int& detectedObject,float minThreshold,C3Vector& triNormal,bool overrideDetectableFlagIfNonCollection,bool updateCalcInfo=true,const CProxSensorBroadphase* broadphase=nullptr);
+    static void handleSensors(const std::vector<CProxSensor*>& sensors,bool exceptExplicitHandling,std::vector<bool>& detected,std::vector<C3Vector>& detectedPoints,std::vector<int>& detectedObjects,std::vector<C3Vector>& detectedNormals);
 
     static bool detectPrimitive(int sensorID,float* vertexPointer,int itemType,int itemCount,bool closestFeatureMode,bool angleLimitation,float maxAngle,C3Vector& detectedPt,float& dist,bool frontFace,bool backFace,float minThreshold,C3Vector& triNormal);
 
@@ -24,7 +36,10 @@ private:
     static int _detectPointCloud(CProxSensor* sensor,CPointCloud* pointCloud,C3Vector& detectedPt,float& dist,C3Vector& triNormalNotNormalized,bool closestFeatureMode,bool angleLimitation,float maxAngle,bool frontFace,bool backFace,float minThreshold);
     static int _detectObject(CProxSensor* sensor,CSceneObject* object,C3Vector& detectedPt,float& dist,C3Vector& triNormalNotNormalized,bool closestFeatureMode,bool angleLimitation,float maxAngle,bool frontFace,bool backFace,float minThreshold);
 
-    static void _orderGroupAccordingToApproxDistanceToSensingPoint(const CProxSensor* sensor,std::vector<CSceneObject*>& group);
+    static void _detectRandomizedRays(CProxSensor* sensor,std::vector<SRandomizedRayResult>& results,const std::function<void(const C3Vector&,SRandomizedRayResult&)>& rayDetection);
+    static int _averageRandomizedRays(CProxSensor* sensor,const std::vector<SRandomizedRayResult>& results,int objectHandle,C3Vector& detectedPt,float& dist,C3Vector& triNormalNotNormalized);
+
+    static void _orderGroupAccordingToApproxDistanceToSensingPoint(const CProxSensor* sensor,std::vector<CSceneObject*>& group,std::vector<float>* approxDistances=nullptr);
     static float _getApproxPointObjectBoundingBoxDistance(const C3Vector& point,CSceneObject* obj);
     static bool _doesSensorVolumeOverlapWithObjectBoundingBox(CProxSensor* sensor,CSceneObject* obj);
 };
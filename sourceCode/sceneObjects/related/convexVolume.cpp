@@ -402,6 +402,25 @@ void CConvexVolume::serialize(CSer& ar)
     }
 }
 
+bool CConvexVolume::isPointInsideVolume(const C3Vector& pt) const
+{ // pt is relative to the volume. The volume is formed by the inside volume minus the outside volume
+    if (planesInside.size()==0)
+        return(false);
+    for (size_t i=0;i<planesInside.size()/4;i++)
+    {
+        if (planesInside[4*i+0]*pt(0)+planesInside[4*i+1]*pt(1)+planesInside[4*i+2]*pt(2)+planesInside[4*i+3]>0.0f)
+            return(false);
+    }
+    if (planesOutside.size()==0)
+        return(true);
+    for (size_t i=0;i<planesOutside.size()/4;i++)
+    {
+        if (planesOutside[4*i+0]*pt(0)+planesOutside[4*i+1]*pt(1)+planesOutside[4*i+2]*pt(2)+planesOutside[4*i+3]>0.0f)
+            return(true);
+    }
+    return(false);
+}
+
 bool CConvexVolume::getVolumeBoundingBox(C3Vector& minV,C3Vector& maxV) const
 { 
     if (_volumeType==RAY_TYPE_CONVEX_VOLUME)
@@ -26,6 +26,7 @@ public:
     void scaleVolumeNonIsometrically(float x,float y,float z,float& xRet,float& yRet,float& zRet);
     void serialize(CSer& ar);
     bool getVolumeBoundingBox(C3Vector& minV,C3Vector& maxV) const;
+    bool isPointInsideVolume(const C3Vector& pt) const;
     void disableVolumeComputation(bool disableIt);
 
     void commonInit();
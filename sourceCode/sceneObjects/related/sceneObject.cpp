@@ -408,6 +408,8 @@ bool CSceneObject::isPotentiallyRenderable() const
 
 void CSceneObject::setModelBase(bool m)
 { // is also called from the ungroup/divide shape routines!!
+    if (m!=_modelBase)
+        App::setRebuildHierarchyFlag(); // children flagged as hidden model children appear or disappear
     _modelBase=m;
     _localModelProperty=0; // Nothing is overridden!
     _modelAcknowledgement="";
@@ -416,6 +418,8 @@ void CSceneObject::setModelBase(bool m)
 
 void CSceneObject::setLocalObjectProperty(int p)
 {
+    if ((p^_localObjectProperty)&sim_objectproperty_hierarchyhiddenmodelchild)
+        App::setHierarchyObjectChangedFlag(_objectHandle);
     _localObjectProperty=p;
 }
 
@@ -1662,6 +1666,14 @@ void CSceneObject::_setParent_send(int parentHandle,bool keepObjectInPlace) cons
     }
 }
 
+void CSceneObject::decodeLoadedData()
+{
+}
+
+void CSceneObject::finalizeLoadedData()
+{
+}
+
 void CSceneObject::serialize(CSer& ar)
 {
     if (ar.isBinary())
@@ -3109,7 +3121,7 @@ bool CSceneObject::setParent(CSceneObject* newParent,bool keepObjectInPlace)
                     h2=newParent->getObjectHandle();
                 App::currentWorld->sceneObjects->objectGotNewParent(_objectHandle,h1,h2);
                 CSceneObject::incrementModelPropertyValidityNumber();
-                App::setRebuildHierarchyFlag();
+                App::setHierarchyObjectChangedFlag(_objectHandle);
                 if (keepObjectInPlace)
                     setLocalTransformation(getFullParentCumulativeTransformation().getInverse()*oldCumulTransf);
             }
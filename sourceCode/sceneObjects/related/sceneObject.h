@@ -48,6 +48,8 @@ public:
     virtual void scaleObjectNonIsometrically(float x,float y,float z);
     virtual void serialize(CSer& ar);
     virtual void serializeWExtIk(CExtIkSer& ar);
+    virtual void decodeLoadedData(); // CPU-heavy part of loading, done after serialize. Can run in a worker thread
+    virtual void finalizeLoadedData(); // done after decodeLoadedData, in the loading thread
 
     virtual bool announceObjectWillBeErased(int objHandle,bool copyBuffer);
     virtual void announceScriptWillBeErased(int scriptHandle,bool simulationScript,bool sceneSwitchPersistentScript,bool copyBuffer);
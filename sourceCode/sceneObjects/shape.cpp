@@ -10,6 +10,9 @@
 #include "shapeRendering.h"
 #include "meshManip.h"
 #include "base64.h"
+#include "meshCalcStructures.h"
+#include "meshCalcStructureCache.h"
+#include <mutex>
 
 bool CShape::_visualizeObbStructures=false;
 
@@ -691,7 +694,10 @@ void CShape::scaleMesh(float x,float y,float z,float& xp,float& yp,float& zp)
 
     // Scale collision info if we have an isometric scaling:
     if ( (x==y)&&(x==z)&&(_meshCalculationStructure!=nullptr) )
+    {
+        _meshCalculationStructure=CMeshCalcStructures::makeUnique(_meshCalculationStructure);
         CPluginContainer::geomPlugin_scaleMesh(_meshCalculationStructure,x);
+    }
     else
         removeMeshCalculationStructure(); // we have to recompute it!
 
@@ -1219,6 +1225,29 @@ void CShape::simulationEnded()
     CSceneObject::simulationEnded();
 }
 
+void CShape::decodeLoadedData()
+{ // shapes loaded with the same mesh share their calculation structure
+    if ( (_meshCalculationStructureLoadingData.size()>0)&&(_meshCalculationStructure==nullptr) )
+    {
+        if (_mesh->isMesh())
+        {
+            SMeshCalcStructureKey key=CMeshCalcStructures::getKey(getSingleMesh()->getGeometryUniqueId(),getSingleMesh()->getVerticeLocalFrame(),-1.0f,-1);
+            _meshCalculationStructure=CMeshCalcStructures::find(key);
+            if (_meshCalculationStructure==nullptr)
+            {
+                void* calcStruct=CPluginContainer::geomPlugin_getMeshFromSerializationData(&_meshCalculationStructureLoadingData[0]);
+                _meshCalculationStructure=CMeshCalcStructures::add(calcStruct,&key);
+            }
+        }
+        else
+        {
+            void* calcStruct=CPluginContainer::geomPlugin_getMeshFromSerializationData(&_meshCalculationStructureLoadingData[0]);
+            _meshCalculationStructure=CMeshCalcStructures::add(calcStruct,nullptr);
+        }
+    }
+    std::vector<unsigned char>().swap(_meshCalculationStructureLoadingData);
+}
+
 void CShape::serialize(CSer& ar)
 {
     CSceneObject::serialize(ar);
@@ -1349,19 +1378,8 @@ void CShape::serialize(CSer& ar)
                     { // (not yet used, but so that old versions will be able to read this)
                         noHit=false;
                         ar >> byteQuantity; // never use that info, unless loading unknown data!!!! (undo/redo never stores calc structures)
-
-                        std::vector<unsigned char> data;
-                        data.reserve(byteQuantity);
-                        unsigned char dummy;
-                        for (int i=0;i<byteQuantity;i++)
-                        {
-                            ar >> dummy;
-                            data.push_back(dummy);
-                        }
-                        std::vector<float> wvert;
-                        std::vector<int> wind;
-                        _mesh->getCumulativeMeshes(wvert,&wind,nullptr);
-                        _meshCalculationStructure=CPluginContainer::geomPlugin_getMeshFromSerializationData(&data[0]);
+                        // decoded in decodeLoadedData:
+                        ar.readFileBufferBytes(_meshCalculationStructureLoadingData,byteQuantity);
                     }
                     if (theName.compare("Mat")==0)
                     {
@@ -1495,11 +1513,7 @@ void CShape::serialize(CSer& ar)
                         str=base64_decode(str);
                     else
                         ar.xmlGetNode_binFile("file",str);
-
-                    std::vector<float> wvert;
-                    std::vector<int> wind;
-                    _mesh->getCumulativeMeshes(wvert,&wind,nullptr);
-                    _meshCalculationStructure=CPluginContainer::geomPlugin_getMeshFromSerializationData((unsigned char*)str.c_str());
+                    _meshCalculationStructureLoadingData.assign(str.begin(),str.end()); // decoded in decodeLoadedData
                     ar.xmlPopNode();
                 }
                 if (ar.xmlPushChildNode("mesh",false))
@@ -1621,19 +1635,8 @@ void CShape::_serializeBackCompatibility(CSer& ar)
                     {
                         noHit=false;
                         ar >> byteQuantity; // never use that info, unless loading unknown data!!!! (undo/redo never stores calc structures)
-
-                        std::vector<unsigned char> data;
-                        data.reserve(byteQuantity);
-                        unsigned char dummy;
-                        for (int i=0;i<byteQuantity;i++)
-                        {
-                            ar >> dummy;
-                            data.push_back(dummy);
-                        }
-                        std::vector<float> wvert;
-                        std::vector<int> wind;
-                        _mesh->getCumulativeMeshes(wvert,&wind,nullptr);
-                        _meshCalculationStructure=CPluginContainer::geomPlugin_getMeshFromSerializationData(&data[0]);
+                        // decoded in decodeLoadedData:
+                        ar.readFileBufferBytes(_meshCalculationStructureLoadingData,byteQuantity);
                     }
                     if (noHit)
                         ar.loadUnknownData();
@@ -1678,11 +1681,7 @@ void CShape::_serializeBackCompatibility(CSer& ar)
                     str=base64_decode(str);
                 else
                     ar.xmlGetNode_binFile("file",str);
-
-                std::vector<float> wvert;
-                std::vector<int> wind;
-                _mesh->getCumulativeMeshes(wvert,&wind,nullptr);
-                _meshCalculationStructure=CPluginContainer::geomPlugin_getMeshFromSerializationData((unsigned char*)str.c_str());
+                _meshCalculationStructureLoadingData.assign(str.begin(),str.end()); // decoded in decodeLoadedData
                 ar.xmlPopNode();
             }
             if (ar.xmlPushChildNode("mesh",false))
@@ -1770,7 +1769,7 @@ void CShape::removeMeshCalculationStructure()
     TRACE_INTERNAL;
     if (_meshCalculationStructure!=nullptr)
     {
-        CPluginContainer::geomPlugin_destroyMesh(_meshCalculationStructure);
+        CMeshCalcStructures::release(_meshCalculationStructure);
         _meshCalculationStructure=nullptr;
     }
 }
@@ -1781,17 +1780,50 @@ bool CShape::isMeshCalculationStructureInitialized()
 }
 
 void CShape::initializeMeshCalculationStructureIfNeeded()
-{
-    if ((_meshCalculationStructure==nullptr)&&(_mesh!=nullptr))
+{ // can be called concurrently from worker threads (e.g. parallel proximity sensor handling). Other shapes are not blocked
+    if ((_meshCalculationStructure.load(std::memory_order_acquire)==nullptr)&&(_mesh!=nullptr))
     {
+        std::lock_guard<std::mutex> lock(_meshCalculationStructureMutex);
+        if (_meshCalculationStructure.load(std::memory_order_relaxed)!=nullptr)
+            return;
         std::vector<float> wvert;
         std::vector<int> wind;
-        _mesh->getCumulativeMeshes(wvert,&wind,nullptr);
         float maxTriSize=App::currentWorld->environment->getCalculationMaxTriangleSize();
         float minTriSize=(std::max<float>(std::max<float>(_meshBoundingBoxHalfSizes(0),_meshBoundingBoxHalfSizes(1)),_meshBoundingBoxHalfSizes(2)))*2.0f*App::currentWorld->environment->getCalculationMinRelTriangleSize();
         if (maxTriSize<minTriSize)
             maxTriSize=minTriSize;
-        _meshCalculationStructure=CPluginContainer::geomPlugin_createMesh(&wvert[0],(int)wvert.size(),&wind[0],(int)wind.size(),nullptr,maxTriSize,App::userSettings->triCountInOBB);
+        // Our world is App::currentWorld, unless we are in a worker thread with its own world (e.g. a batch world, or
+        // sensors handled in parallel). We then don't write to the disk cache, as we don't while simulating:
+        bool mayWriteToDiskCache=(CCurrentWorld::getThreadWorld()==nullptr)&&App::currentWorld->simulation->isSimulationStopped();
+        if (_mesh->isMesh())
+        { // shapes with the same mesh share the structure, which is then only built once
+            CMesh* mesh=getSingleMesh();
+            SMeshCalcStructureKey key=CMeshCalcStructures::getKey(mesh->getGeometryUniqueId(),mesh->getVerticeLocalFrame(),maxTriSize,App::userSettings->triCountInOBB);
+            void* calcStruct=CMeshCalcStructures::find(key);
+            if (calcStruct==nullptr)
+            { // not in memory. Try the disk cache before building it
+                mesh->getCumulativeMeshes(wvert,&wind,nullptr);
+                calcStruct=CMeshCalcStructureCache::load(wvert,wind,maxTriSize,App::userSettings->triCountInOBB);
+                if (calcStruct==nullptr)
+                {
+                    calcStruct=CPluginContainer::geomPlugin_createMesh(&wvert[0],(int)wvert.size(),&wind[0],(int)wind.size(),nullptr,maxTriSize,App::userSettings->triCountInOBB);
+                    CMeshCalcStructureCache::store(calcStruct,wvert,wind,maxTriSize,App::userSettings->triCountInOBB,mayWriteToDiskCache);
+                }
+                calcStruct=CMeshCalcStructures::add(calcStruct,&key);
+            }
+            _meshCalculationStructure.store(calcStruct,std::memory_order_release);
+        }
+        else
+        {
+            _mesh->getCumulativeMeshes(wvert,&wind,nullptr);
+            void* calcStruct=CMeshCalcStructureCache::load(wvert,wind,maxTriSize,App::userSettings->triCountInOBB);
+            if (calcStruct==nullptr)
+            {
+                calcStruct=CPluginContainer::geomPlugin_createMesh(&wvert[0],(int)wvert.size(),&wind[0],(int)wind.size(),nullptr,maxTriSize,App::userSettings->triCountInOBB);
+                CMeshCalcStructureCache::store(calcStruct,wvert,wind,maxTriSize,App::userSettings->triCountInOBB,mayWriteToDiskCache);
+            }
+            _meshCalculationStructure.store(CMeshCalcStructures::add(calcStruct,nullptr),std::memory_order_release);
+        }
     }
 }
 
@@ -1929,7 +1961,7 @@ CSceneObject* CShape::copyYourself()
     newShape->_meshBoundingBoxHalfSizes=_meshBoundingBoxHalfSizes;
 
     if (_meshCalculationStructure!=nullptr)
-        newShape->_meshCalculationStructure=CPluginContainer::geomPlugin_copyMesh(_meshCalculationStructure);
+        newShape->_meshCalculationStructure=CMeshCalcStructures::share(_meshCalculationStructure);
 
     delete newShape->_dynMaterial;
     newShape->_dynMaterial=_dynMaterial->copyYourself();
@@ -3,6 +3,8 @@
 #include "sceneObject.h"
 #include "mesh.h"
 #include "dummy.h"
+#include <atomic>
+#include <mutex>
 
 class CShape : public CSceneObject  
 {
@@ -29,11 +31,13 @@ public:
     CMesh* getSingleMesh() const;
     void disconnectMesh();
 
-    void* _meshCalculationStructure;
+    std::atomic<void*> _meshCalculationStructure; // set concurrently by initializeMeshCalculationStructureIfNeeded
+    std::vector<unsigned char> _meshCalculationStructureLoadingData; // serialization data, until decodeLoadedData is called
     C3Vector _meshBoundingBoxHalfSizes;
     bool _meshDynamicsFullRefreshFlag;
     int _meshModificationCounter;
     CMeshWrapper* _mesh;
+    std::mutex _meshCalculationStructureMutex;
 
 
     // Following functions are inherited from CSceneObject
@@ -44,6 +48,7 @@ public:
     void scaleObjectNonIsometrically(float x,float y,float z);
     void serialize(CSer& ar);
     void serializeWExtIk(CExtIkSer& ar);
+    void decodeLoadedData();
     bool announceObjectWillBeErased(int objectHandle,bool copyBuffer);
     void announceCollectionWillBeErased(int groupID,bool copyBuffer);
     void announceCollisionWillBeErased(int collisionID,bool copyBuffer);
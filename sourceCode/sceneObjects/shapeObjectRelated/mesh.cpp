@@ -9,6 +9,8 @@
 #include "shapeRendering.h"
 #include "tt.h"
 #include "base64.h"
+#include "workerPool.h"
+#include <cstring>
 
 int CMesh::_nextUniqueID=0;
 unsigned int CMesh::_extRendererUniqueObjectID=0;
@@ -19,6 +21,9 @@ std::vector<std::vector<float>*> CMesh::_tempVertices;
 std::vector<std::vector<int>*> CMesh::_tempIndices;
 std::vector<std::vector<float>*> CMesh::_tempNormals;
 std::vector<std::vector<unsigned char>*> CMesh::_tempEdges;
+std::map<std::vector<int>,SMeshGeometry*> CMesh::_tempLoadedGeometries;
+std::map<SMeshGeometry*,std::vector<int>> CMesh::_tempSavedGeometries;
+std::atomic<int> CMesh::_nextGeometryUniqueId(0);
 
 CMesh::CMesh()
 {
@@ -53,6 +58,7 @@ CMesh::CMesh()
     _gouraudShadingAngle=0.5f*degToRad_f;
     _edgeThresholdAngle=_gouraudShadingAngle;
     _uniqueID=_nextUniqueID++;
+    _geometry=_newGeometry();
 
     _extRendererObjectId=0;
     _extRendererMeshId=0;
@@ -64,6 +70,7 @@ CMesh::~CMesh()
     decreaseVertexBufferRefCnt(_vertexBufferId);
     decreaseNormalBufferRefCnt(_normalBufferId);
     decreaseEdgeBufferRefCnt(_edgeBufferId);
+    _releaseGeometry(_geometry);
     delete _textureProperty;
 }
 
@@ -136,14 +143,14 @@ void CMesh::display_extRenderer(CShape* geomData,int displayAttrib,const C7Vecto
         static int a=0;
         a++;
         void* data[40];
-        data[0]=&_vertices[0];
-        int vs=(int)_vertices.size()/3;
+        data[0]=&_geometry->vertices[0];
+        int vs=(int)_geometry->vertices.size()/3;
         data[1]=&vs;
-        data[2]=&_indices[0];
-        int is=(int)_indices.size()/3;
+        data[2]=&_geometry->indices[0];
+        int is=(int)_geometry->indices.size()/3;
         data[3]=&is;
-        data[4]=&_normals[0];
-        int ns=(int)_normals.size()/3;
+        data[4]=&_geometry->normals[0];
+        int ns=(int)_geometry->normals.size()/3;
         data[5]=&ns;
         data[6]=tr2.X.data;
 
@@ -161,7 +168,7 @@ void CMesh::display_extRenderer(CShape* geomData,int displayAttrib,const C7Vecto
         data[23]=&_culling;
         data[24]=&_extRendererMeshId;
         data[25]=&_extRendererTextureId;
-        data[26]=&_edges[0];
+        data[26]=&_geometry->edges[0];
         bool visibleEdges=_visibleEdges;
         if (displayAttrib&sim_displayattribute_forbidedges)
             visibleEdges=false;
@@ -185,7 +192,7 @@ void CMesh::display_extRenderer(CShape* geomData,int displayAttrib,const C7Vecto
         if (tp!=nullptr)
         {
             textured=true;
-            textureCoords=tp->getTextureCoordinates(geomData->getMeshModificationCounter(),_verticeLocalFrame,_vertices,_indices);
+            textureCoords=tp->getTextureCoordinates(geomData->getMeshModificationCounter(),_verticeLocalFrame,_geometry->vertices,_geometry->indices);
             if (textureCoords==nullptr)
                 return; // Should normally never happen
             data[9]=&(textureCoords[0])[0];
@@ -298,10 +305,10 @@ CMesh* CMesh::copyYourself()
     newIt->_edgeThresholdAngle=_edgeThresholdAngle;
     newIt->_edgeWidth_DEPRERCATED=_edgeWidth_DEPRERCATED;
 
-    newIt->_vertices.assign(_vertices.begin(),_vertices.end());
-    newIt->_indices.assign(_indices.begin(),_indices.end());
-    newIt->_normals.assign(_normals.begin(),_normals.end());
-    newIt->_edges.assign(_edges.begin(),_edges.end());
+    // The geometry is shared until one of the two meshes modifies it:
+    _releaseGeometry(newIt->_geometry);
+    newIt->_geometry=_geometry;
+    _geometry->refCnt++;
 
     newIt->_vertexBufferId=_vertexBufferId;
     newIt->_normalBufferId=_normalBufferId;
@@ -342,17 +349,18 @@ void CMesh::scale(float xVal,float yVal,float zVal)
     _verticeLocalFrame.X(2)*=zVal;
 
     C7Vector inverse(_verticeLocalFrame.getInverse());
-    for (int i=0;i<int(_vertices.size())/3;i++)
+    _makeGeometryUnique(true);
+    for (int i=0;i<int(_geometry->vertices.size())/3;i++)
     {
-        C3Vector v(&_vertices[3*i+0]);
+        C3Vector v(&_geometry->vertices[3*i+0]);
         v=_verticeLocalFrame.Q*v;
         v(0)*=xVal;
         v(1)*=yVal;
         v(2)*=zVal;
         v=inverse.Q*v;
-        _vertices[3*i+0]=v(0);
-        _vertices[3*i+1]=v(1);
-        _vertices[3*i+2]=v(2);
+        _geometry->vertices[3*i+0]=v(0);
+        _geometry->vertices[3*i+1]=v(1);
+        _geometry->vertices[3*i+2]=v(2);
     }
     
     if (_purePrimitive==sim_pure_primitive_heightfield)
@@ -364,7 +372,7 @@ void CMesh::scale(float xVal,float yVal,float zVal)
     if (_textureProperty!=nullptr)
     {
         //if ( (fabs(xVal-yVal)>fabs(xVal*0.01f))||(fabs(xVal-zVal)>fabs(xVal*0.01f)) ) // if we do not have iso scaling, we transform the texture from text. coord. calculated into fixed text. coords:
-        //    _textureProperty->transformToFixedTextureCoordinates(_verticeLocalFrame,_vertices,_indices);
+        //    _textureProperty->transformToFixedTextureCoordinates(_verticeLocalFrame,_geometry->vertices,_geometry->indices);
         _textureProperty->scaleObject(xVal);
     }
     if ((xVal!=yVal)||(xVal!=zVal))
@@ -383,10 +391,11 @@ void CMesh::scale(float xVal,float yVal,float zVal)
 
 void CMesh::setMeshDataDirect(const std::vector<float>& vertices,const std::vector<int>& indices,const std::vector<float>& normals,const std::vector<unsigned char>& edges)
 {
-    _vertices.assign(vertices.begin(),vertices.end());
-    _indices.assign(indices.begin(),indices.end());
-    _normals.assign(normals.begin(),normals.end());
-    _edges.assign(edges.begin(),edges.end());
+    _makeGeometryUnique(false);
+    _geometry->vertices.assign(vertices.begin(),vertices.end());
+    _geometry->indices.assign(indices.begin(),indices.end());
+    _geometry->normals.assign(normals.begin(),normals.end());
+    _geometry->edges.assign(edges.begin(),edges.end());
     checkIfConvex();
 
     decreaseVertexBufferRefCnt(_vertexBufferId);
@@ -400,15 +409,16 @@ void CMesh::setMeshDataDirect(const std::vector<float>& vertices,const std::vect
 
 void CMesh::setMesh(const std::vector<float>& vertices,const std::vector<int>& indices,const std::vector<float>* normals,const C7Vector& transformation)
 {
-    _vertices.assign(vertices.begin(),vertices.end());
-    _indices.assign(indices.begin(),indices.end());
+    _makeGeometryUnique(false);
+    _geometry->vertices.assign(vertices.begin(),vertices.end());
+    _geometry->indices.assign(indices.begin(),indices.end());
     if (normals==nullptr)
     {
-        CMeshManip::getNormals(&_vertices,&_indices,&_normals);
+        CMeshManip::getNormals(&_geometry->vertices,&_geometry->indices,&_geometry->normals);
         _recomputeNormals();
     }
     else
-        _normals.assign(normals->begin(),normals->end());
+        _geometry->normals.assign(normals->begin(),normals->end());
     _verticeLocalFrame=transformation;
     _computeVisibleEdges();
     checkIfConvex();
@@ -491,9 +501,9 @@ void CMesh::setConvex(bool convex)
 void CMesh::getCumulativeMeshes(std::vector<float>& vertices,std::vector<int>* indices,std::vector<float>* normals)
 { // function has virtual/non-virtual counterpart!
     size_t offset=vertices.size()/3;
-    for (size_t i=0;i<_vertices.size()/3;i++)
+    for (size_t i=0;i<_geometry->vertices.size()/3;i++)
     {
-        C3Vector v(&_vertices[3*i]);
+        C3Vector v(&_geometry->vertices[3*i]);
         v*=_verticeLocalFrame;
         vertices.push_back(v(0));
         vertices.push_back(v(1));
@@ -501,15 +511,15 @@ void CMesh::getCumulativeMeshes(std::vector<float>& vertices,std::vector<int>* i
     }
     if (indices!=nullptr)
     {
-        for (size_t i=0;i<_indices.size();i++)
-            indices->push_back(_indices[i]+int(offset));
+        for (size_t i=0;i<_geometry->indices.size();i++)
+            indices->push_back(_geometry->indices[i]+int(offset));
     }
     if (normals!=nullptr)
     {
         C4Vector rot(_verticeLocalFrame.Q);
-        for (size_t i=0;i<_normals.size()/3;i++)
+        for (size_t i=0;i<_geometry->normals.size()/3;i++)
         {
-            C3Vector v(&_normals[3*i]);
+            C3Vector v(&_geometry->normals[3*i]);
             v=rot*v;
             normals->push_back(v(0));
             normals->push_back(v(1));
@@ -780,17 +790,18 @@ void CMesh::setHeightfieldDiamonds(int d)
 { 
     if (_purePrimitive==sim_pure_primitive_heightfield)
     {
-        for (size_t i=0;i<_indices.size()/6;i++)
+        _makeGeometryUnique(true);
+        for (size_t i=0;i<_geometry->indices.size()/6;i++)
         {
             if (d==0)
             {
-                _indices[6*i+1]=_indices[6*i+3];
-                _indices[6*i+5]=_indices[6*i+2];
+                _geometry->indices[6*i+1]=_geometry->indices[6*i+3];
+                _geometry->indices[6*i+5]=_geometry->indices[6*i+2];
             }
             if (d==1)
             {
-                _indices[6*i+1]=_indices[6*i+4];
-                _indices[6*i+5]=_indices[6*i+0];
+                _geometry->indices[6*i+1]=_geometry->indices[6*i+4];
+                _geometry->indices[6*i+5]=_geometry->indices[6*i+0];
             }
         }
     }
@@ -966,24 +977,24 @@ void CMesh::setVerticeLocalFrame(const C7Vector& tr)
     _verticeLocalFrame=tr;
 }
 
-std::vector<float>* CMesh::getVertices()
+const std::vector<float>* CMesh::getVertices() const
 {
-    return(&_vertices);
+    return(&_geometry->vertices);
 }
 
-std::vector<int>* CMesh::getIndices()
+const std::vector<int>* CMesh::getIndices() const
 {
-    return(&_indices);
+    return(&_geometry->indices);
 }
 
-std::vector<float>* CMesh::getNormals()
+const std::vector<float>* CMesh::getNormals() const
 {
-    return(&_normals);
+    return(&_geometry->normals);
 }
 
-std::vector<unsigned char>* CMesh::getEdges()
+const std::vector<unsigned char>* CMesh::getEdges() const
 {
-    return(&_edges);
+    return(&_geometry->edges);
 }
 
 int* CMesh::getVertexBufferIdPtr()
@@ -1001,6 +1012,76 @@ int* CMesh::getEdgeBufferIdPtr()
     return(&_edgeBufferId);
 }
 
+int CMesh::getGeometryUniqueId() const
+{
+    return(_geometry->uniqueId);
+}
+
+int CMesh::getGeometryRefCount() const
+{
+    return(_geometry->refCnt);
+}
+
+SMeshGeometry* CMesh::_newGeometry()
+{
+    SMeshGeometry* geometry=new SMeshGeometry();
+    geometry->refCnt=1;
+    geometry->uniqueId=_nextGeometryUniqueId++;
+    return(geometry);
+}
+
+void CMesh::_releaseGeometry(SMeshGeometry* geometry)
+{
+    if (--geometry->refCnt==0)
+        delete geometry;
+}
+
+void CMesh::_makeGeometryUnique(bool keepContent)
+{ // call before modifying the geometry. If it is shared, this mesh gets its own copy (or an empty one). In any case,
+    // the geometry gets a new unique id, since structures built from the old content (e.g. in the shape) are not valid anymore
+    if (_geometry->refCnt>1)
+    {
+        SMeshGeometry* geometry=_newGeometry();
+        if (keepContent)
+        {
+            geometry->vertices.assign(_geometry->vertices.begin(),_geometry->vertices.end());
+            geometry->indices.assign(_geometry->indices.begin(),_geometry->indices.end());
+            geometry->normals.assign(_geometry->normals.begin(),_geometry->normals.end());
+            geometry->edges.assign(_geometry->edges.begin(),_geometry->edges.end());
+        }
+        _releaseGeometry(_geometry);
+        _geometry=geometry;
+    }
+    else
+        _geometry->uniqueId=_nextGeometryUniqueId++;
+}
+
+void CMesh::_setGeometryFromTempBuffers(const int bufferIndices[4])
+{ // meshes loaded from the same vertices, indices, normals and edges share their geometry
+    if ( (bufferIndices[0]>=0)&&(bufferIndices[1]>=0)&&(bufferIndices[2]>=0)&&(bufferIndices[3]>=0) )
+    {
+        std::vector<int> key(bufferIndices,bufferIndices+4);
+        std::map<std::vector<int>,SMeshGeometry*>::iterator it=_tempLoadedGeometries.find(key);
+        if (it!=_tempLoadedGeometries.end())
+        {
+            _releaseGeometry(_geometry);
+            _geometry=it->second;
+            _geometry->refCnt++;
+            return;
+        }
+        _tempLoadedGeometries[key]=_geometry;
+        _geometry->refCnt++;
+    }
+    if (bufferIndices[0]>=0)
+        getVerticesFromBufferBasedOnIndex(bufferIndices[0],_geometry->vertices);
+    if (bufferIndices[1]>=0)
+        getIndicesFromBufferBasedOnIndex(bufferIndices[1],_geometry->indices);
+    if (bufferIndices[2]>=0)
+        getNormalsFromBufferBasedOnIndex(bufferIndices[2],_geometry->normals);
+    if (bufferIndices[3]>=0)
+        getEdgesFromBufferBasedOnIndex(bufferIndices[3],_geometry->edges);
+}
+
 
 void CMesh::preMultiplyAllVerticeLocalFrames(const C7Vector& preTr)
 { // function has virtual/non-virtual counterpart!
@@ -1046,26 +1127,27 @@ void CMesh::flipFaces()
 { // function has virtual/non-virtual counterpart!
     int save;
     float normSave;
-    for (int i=0;i<int(_indices.size())/3;i++)
+    _makeGeometryUnique(true);
+    for (int i=0;i<int(_geometry->indices.size())/3;i++)
     {
-        save=_indices[3*i+0];
-        _indices[3*i+0]=_indices[3*i+2];
-        _indices[3*i+2]=save;
-
-        normSave=-_normals[3*(3*i+0)+0];
-        _normals[3*(3*i+0)+0]=-_normals[3*(3*i+2)+0];
-        _normals[3*(3*i+1)+0]*=-1.0f;
-        _normals[3*(3*i+2)+0]=normSave;
-
-        normSave=-_normals[3*(3*i+0)+1];
-        _normals[3*(3*i+0)+1]=-_normals[3*(3*i+2)+1];
-        _normals[3*(3*i+1)+1]*=-1.0f;
-        _normals[3*(3*i+2)+1]=normSave;
-
-        normSave=-_normals[3*(3*i+0)+2];
-        _normals[3*(3*i+0)+2]=-_normals[3*(3*i+2)+2];
-        _normals[3*(3*i+1)+2]*=-1.0f;
-        _normals[3*(3*i+2)+2]=normSave;  
+        save=_geometry->indices[3*i+0];
+        _geometry->indices[3*i+0]=_geometry->indices[3*i+2];
+        _geometry->indices[3*i+2]=save;
+
+        normSave=-_geometry->normals[3*(3*i+0)+0];
+        _geometry->normals[3*(3*i+0)+0]=-_geometry->normals[3*(3*i+2)+0];
+        _geometry->normals[3*(3*i+1)+0]*=-1.0f;
+        _geometry->normals[3*(3*i+2)+0]=normSave;
+
+        normSave=-_geometry->normals[3*(3*i+0)+1];
+        _geometry->normals[3*(3*i+0)+1]=-_geometry->normals[3*(3*i+2)+1];
+        _geometry->normals[3*(3*i+1)+1]*=-1.0f;
+        _geometry->normals[3*(3*i+2)+1]=normSave;
+
+        normSave=-_geometry->normals[3*(3*i+0)+2];
+        _geometry->normals[3*(3*i+0)+2]=-_geometry->normals[3*(3*i+2)+2];
+        _geometry->normals[3*(3*i+1)+2]*=-1.0f;
+        _geometry->normals[3*(3*i+2)+2]=normSave;  
     }
     _computeVisibleEdges();
     checkIfConvex();
@@ -1085,43 +1167,44 @@ void CMesh::actualizeGouraudShadingAndVisibleEdges()
 
 void CMesh::_recomputeNormals()
 {
-    _normals.resize(3*_indices.size());
+    _makeGeometryUnique(true);
+    _geometry->normals.resize(3*_geometry->indices.size());
     float maxAngle=_gouraudShadingAngle;
     C3Vector v[3];
-    for (int i=0;i<int(_indices.size())/3;i++)
+    for (int i=0;i<int(_geometry->indices.size())/3;i++)
     {   // Here we restore first all the normal vectors
-        v[0]=C3Vector(&_vertices[3*(_indices[3*i+0])]);
-        v[1]=C3Vector(&_vertices[3*(_indices[3*i+1])]);
-        v[2]=C3Vector(&_vertices[3*(_indices[3*i+2])]);
+        v[0]=C3Vector(&_geometry->vertices[3*(_geometry->indices[3*i+0])]);
+        v[1]=C3Vector(&_geometry->vertices[3*(_geometry->indices[3*i+1])]);
+        v[2]=C3Vector(&_geometry->vertices[3*(_geometry->indices[3*i+2])]);
 
         C3Vector v1(v[1]-v[0]);
         C3Vector v2(v[2]-v[0]);
         C3Vector n((v1^v2).getNormalized());
 
-        _normals[9*i+0]=n(0);
-        _normals[9*i+1]=n(1);
-        _normals[9*i+2]=n(2);
-        _normals[9*i+3]=n(0);
-        _normals[9*i+4]=n(1);
-        _normals[9*i+5]=n(2);
-        _normals[9*i+6]=n(0);
-        _normals[9*i+7]=n(1);
-        _normals[9*i+8]=n(2);
+        _geometry->normals[9*i+0]=n(0);
+        _geometry->normals[9*i+1]=n(1);
+        _geometry->normals[9*i+2]=n(2);
+        _geometry->normals[9*i+3]=n(0);
+        _geometry->normals[9*i+4]=n(1);
+        _geometry->normals[9*i+5]=n(2);
+        _geometry->normals[9*i+6]=n(0);
+        _geometry->normals[9*i+7]=n(1);
+        _geometry->normals[9*i+8]=n(2);
     }
 
     std::vector<std::vector<int>*> indexToNormals;
-    for (int i=0;i<int(_vertices.size())/3;i++)
+    for (int i=0;i<int(_geometry->vertices.size())/3;i++)
     {
         std::vector<int>* sharingNormals=new std::vector<int>;
         indexToNormals.push_back(sharingNormals);
     }
-    for (int i=0;i<int(_indices.size())/3;i++)
+    for (int i=0;i<int(_geometry->indices.size())/3;i++)
     {
-        indexToNormals[_indices[3*i+0]]->push_back(3*i+0);
-        indexToNormals[_indices[3*i+1]]->push_back(3*i+1);
-        indexToNormals[_indices[3*i+2]]->push_back(3*i+2);
+        indexToNormals[_geometry->indices[3*i+0]]->push_back(3*i+0);
+        indexToNormals[_geometry->indices[3*i+1]]->push_back(3*i+1);
+        indexToNormals[_geometry->indices[3*i+2]]->push_back(3*i+2);
     }
-    std::vector<float> changedNorm(_normals.size());
+    std::vector<float> changedNorm(_geometry->normals.size());
 
     for (int i=0;i<int(indexToNormals.size());i++)
     {
@@ -1130,13 +1213,13 @@ void CMesh::_recomputeNormals()
             C3Vector totN;
             float nb=1.0f;
             C3Vector nActual;
-            nActual.set(&_normals[3*(indexToNormals[i]->at(j))]);
+            nActual.set(&_geometry->normals[3*(indexToNormals[i]->at(j))]);
             totN=nActual;
             for (int k=0;k<int(indexToNormals[i]->size());k++)
             {
                 if (j!=k)
                 {
-                    C3Vector nToCompare(&_normals[3*(indexToNormals[i]->at(k))]);
+                    C3Vector nToCompare(&_geometry->normals[3*(indexToNormals[i]->at(k))]);
                     if (nActual.getAngle(nToCompare)<maxAngle)
                     {
                         totN+=nToCompare;
@@ -1152,10 +1235,10 @@ void CMesh::_recomputeNormals()
         delete indexToNormals[i];
     }
     // Now we have to replace the modified normals:
-    for (int i=0;i<int(_indices.size())/3;i++)
+    for (int i=0;i<int(_geometry->indices.size())/3;i++)
     {
         for (int j=0;j<9;j++)
-            _normals[9*i+j]=changedNorm[9*i+j];
+            _geometry->normals[9*i+j]=changedNorm[9*i+j];
     }
 
     decreaseNormalBufferRefCnt(_normalBufferId);
@@ -1165,19 +1248,20 @@ void CMesh::_recomputeNormals()
 
 void CMesh::_computeVisibleEdges()
 {
-    if (_indices.size()==0)
+    if (_geometry->indices.size()==0)
         return;
+    _makeGeometryUnique(true);
     float softAngle=_edgeThresholdAngle;
-    _edges.clear();
+    _geometry->edges.clear();
     std::vector<int> eIDs;
-    CMeshRoutines::getEdgeFeatures(&_vertices[0],(int)_vertices.size(),&_indices[0],(int)_indices.size(),nullptr,&eIDs,nullptr,softAngle,true,_hideEdgeBorders);
-    _edges.assign((_indices.size()/8)+1,0);
-    std::vector<bool> usedEdges(_indices.size(),false);
+    CMeshRoutines::getEdgeFeatures(&_geometry->vertices[0],(int)_geometry->vertices.size(),&_geometry->indices[0],(int)_geometry->indices.size(),nullptr,&eIDs,nullptr,softAngle,true,_hideEdgeBorders);
+    _geometry->edges.assign((_geometry->indices.size()/8)+1,0);
+    std::vector<bool> usedEdges(_geometry->indices.size(),false);
     for (int i=0;i<int(eIDs.size());i++)
     {
         if (eIDs[i]!=-1)
         {
-            _edges[i>>3]|=(1<<(i&7));
+            _geometry->edges[i>>3]|=(1<<(i&7));
             usedEdges[eIDs[i]]=true;
         }
     }
@@ -1187,7 +1271,7 @@ void CMesh::_computeVisibleEdges()
 
 bool CMesh::checkIfConvex()
 { // function has virtual/non-virtual counterpart!
-    _convex=CMeshRoutines::checkIfConvex(_vertices,_indices,0.015f); // 1.5% tolerance of the average bounding box side length
+    _convex=CMeshRoutines::checkIfConvex(_geometry->vertices,_geometry->indices,0.015f); // 1.5% tolerance of the average bounding box side length
     setConvex(_convex);
     return(_convex);
 }
@@ -1272,6 +1356,53 @@ void CMesh::_loadPackedIntegers(CSer& ar,std::vector<int>& data)
     }
 }
 
+void CMesh::_decodePackedIntegers(const unsigned char* bytes,int byteQuantity,std::vector<int>& data)
+{ // same as _loadPackedIntegers, but from a buffer of byteQuantity bytes
+    data.clear();
+    if (byteQuantity<int(sizeof(int)))
+        return;
+    const unsigned char* end=bytes+byteQuantity;
+    int dataLength;
+    memcpy(&dataLength,bytes,sizeof(dataLength));
+    bytes+=sizeof(dataLength);
+    if ( (dataLength<0)||(dataLength>int(end-bytes)) )
+        return; // each index takes at least one byte
+    data.reserve(dataLength);
+    unsigned char b0,b1,b2,b3,storageB;
+    int prevInd=0;
+    for (int i=0;i<dataLength;i++)
+    {
+        b1=0;
+        b2=0;
+        b3=0;
+        if (bytes>=end)
+            break;
+        b0=*(bytes++);
+        storageB=((b0&0xc0)>>6);
+        if (bytes+storageB>end)
+            break;
+        b0&=0x3f; // we remove the storage byte info
+        if (storageB>=1)
+            b1=*(bytes++); // this index takes 2 or more storage bytes
+        if (storageB>=2)
+            b2=*(bytes++); // this index takes 3 or more storage bytes
+        if (storageB>=3)
+            b3=*(bytes++); // this index takes 4 storage bytes
+        int diff=b0+(b1<<6)+(b2<<14)+(b3<<22);
+        if (storageB==0)
+            diff-=31;
+        if (storageB==1)
+            diff-=8191;
+        if (storageB==2)
+            diff-=2097151;
+        if (storageB==3)
+            diff-=536870911;
+        int currInd=prevInd+diff;
+        data.push_back(currInd);
+        prevInd=currInd;
+    }
+}
+
 void CMesh::clearTempVerticesIndicesNormalsAndEdges()
 {
     for (int i=0;i<int(_tempVertices.size());i++)
@@ -1289,25 +1420,51 @@ void CMesh::clearTempVerticesIndicesNormalsAndEdges()
     for (int i=0;i<int(_tempEdges.size());i++)
         delete _tempEdges[i];
     _tempEdges.clear();
+
+    for (std::map<std::vector<int>,SMeshGeometry*>::iterator it=_tempLoadedGeometries.begin();it!=_tempLoadedGeometries.end();it++)
+        _releaseGeometry(it->second);
+    _tempLoadedGeometries.clear();
+
+    for (std::map<SMeshGeometry*,std::vector<int>>::iterator it=_tempSavedGeometries.begin();it!=_tempSavedGeometries.end();it++)
+        _releaseGeometry(it->first);
+    _tempSavedGeometries.clear();
 }
 
 void CMesh::prepareVerticesIndicesNormalsAndEdgesForSerialization()
 { // function has virtual/non-virtual counterpart!
-    _tempVerticesIndexForSerialization=getBufferIndexOfVertices(_vertices);
+    std::map<SMeshGeometry*,std::vector<int>>::iterator it=_tempSavedGeometries.find(_geometry);
+    if (it!=_tempSavedGeometries.end())
+    { // the geometry is shared with a mesh that was already prepared. No need to compare the data again
+        _tempVerticesIndexForSerialization=it->second[0];
+        _tempIndicesIndexForSerialization=it->second[1];
+        _tempNormalsIndexForSerialization=it->second[2];
+        _tempEdgesIndexForSerialization=it->second[3];
+        return;
+    }
+
+    _tempVerticesIndexForSerialization=getBufferIndexOfVertices(_geometry->vertices);
     if (_tempVerticesIndexForSerialization==-1)
-        _tempVerticesIndexForSerialization=addVerticesToBufferAndReturnIndex(_vertices);
+        _tempVerticesIndexForSerialization=addVerticesToBufferAndReturnIndex(_geometry->vertices);
 
-    _tempIndicesIndexForSerialization=getBufferIndexOfIndices(_indices);
+    _tempIndicesIndexForSerialization=getBufferIndexOfIndices(_geometry->indices);
     if (_tempIndicesIndexForSerialization==-1)
-        _tempIndicesIndexForSerialization=addIndicesToBufferAndReturnIndex(_indices);
+        _tempIndicesIndexForSerialization=addIndicesToBufferAndReturnIndex(_geometry->indices);
 
-    _tempNormalsIndexForSerialization=getBufferIndexOfNormals(_normals);
+    _tempNormalsIndexForSerialization=getBufferIndexOfNormals(_geometry->normals);
     if (_tempNormalsIndexForSerialization==-1)
-        _tempNormalsIndexForSerialization=addNormalsToBufferAndReturnIndex(_normals);
+        _tempNormalsIndexForSerialization=addNormalsToBufferAndReturnIndex(_geometry->normals);
 
-    _tempEdgesIndexForSerialization=getBufferIndexOfEdges(_edges);
+    _tempEdgesIndexForSerialization=getBufferIndexOfEdges(_geometry->edges);
     if (_tempEdgesIndexForSerialization==-1)
-        _tempEdgesIndexForSerialization=addEdgesToBufferAndReturnIndex(_edges);
+        _tempEdgesIndexForSerialization=addEdgesToBufferAndReturnIndex(_geometry->edges);
+
+    std::vector<int> bufferIndices;
+    bufferIndices.push_back(_tempVerticesIndexForSerialization);
+    bufferIndices.push_back(_tempIndicesIndexForSerialization);
+    bufferIndices.push_back(_tempNormalsIndexForSerialization);
+    bufferIndices.push_back(_tempEdgesIndexForSerialization);
+    _tempSavedGeometries[_geometry]=bufferIndices;
+    _geometry->refCnt++;
 }
 
 void CMesh::serializeTempVerticesIndicesNormalsAndEdges(CSer& ar)
@@ -1387,7 +1544,8 @@ void CMesh::serializeTempVerticesIndicesNormalsAndEdges(CSer& ar)
         ar.storeDataName(SER_END_OF_OBJECT);
     }
     else
-    { // loading
+    { // loading. Only the positions of the data in the file buffer are read here, the data is then decoded in parallel
+        std::vector<STempBufferLoadingData> toDecode;
         int byteQuantity;
         std::string theName="";
         while (theName.compare(SER_END_OF_OBJECT)!=0)
@@ -1396,77 +1554,100 @@ void CMesh::serializeTempVerticesIndicesNormalsAndEdges(CSer& ar)
             if (theName.compare(SER_END_OF_OBJECT)!=0)
             {
                 bool noHit=true;
-                if (theName.compare("Ver")==0)
-                {
-                    noHit=false;
-                    ar >> byteQuantity;
-                    std::vector<float>* arr=new std::vector<float>;
-                    _tempVertices.push_back(arr);
-                    arr->resize(byteQuantity/sizeof(float),0.0f);
-                    for (int i=0;i<int(arr->size());i++)
-                        ar >> arr->at(i);
-                }
-                if (theName.compare("Ind")==0)
-                {
-                    noHit=false;
-                    ar >> byteQuantity;
-                    std::vector<int>* arr=new std::vector<int>;
-                    _tempIndices.push_back(arr);
-                    arr->resize(byteQuantity/sizeof(int),0);
-                    for (int i=0;i<int(arr->size());i++)
-                        ar >> arr->at(i);
-                }
-                if (theName.compare("In2")==0)
-                {
-                    noHit=false;
-                    ar >> byteQuantity;
-                    std::vector<int>* arr=new std::vector<int>;
-                    _tempIndices.push_back(arr);
-                    _loadPackedIntegers(ar,*arr);
-                }
-                if (theName.compare("Nor")==0)
+                if ( (theName.compare("Ver")==0)||(theName.compare("Ind")==0)||(theName.compare("In2")==0)||(theName.compare("Nor")==0)||(theName.compare("No2")==0)||(theName.compare("Ved")==0) )
                 {
                     noHit=false;
                     ar >> byteQuantity;
-                    std::vector<float>* arr=new std::vector<float>;
-                    _tempNormals.push_back(arr);
-                    arr->resize(byteQuantity/sizeof(float),0.0f);
-                    for (int i=0;i<int(arr->size());i++)
-                        ar >> arr->at(i);
-                }
-                if (theName.compare("No2")==0)
-                {
-                    noHit=false;
-                    ar >> byteQuantity;
-                    std::vector<float>* arr=new std::vector<float>;
-                    _tempNormals.push_back(arr);
-                    arr->resize(byteQuantity*6/sizeof(float),0.0f);
-                    for (int i=0;i<byteQuantity/2;i++)
+                    STempBufferLoadingData data;
+                    data.dataName=theName;
+                    data.buffer=nullptr;
+                    data.fileBufferPos=ar.getFileBufferReadPointer();
+                    data.byteQuantity=byteQuantity;
+                    if (theName[0]=='V')
                     {
-                        unsigned short w;
-                        ar >> w;
-                        char x=(w&0x001f)-15;
-                        char y=((w>>5)&0x001f)-15;
-                        char z=((w>>10)&0x001f)-15;
-                        C3Vector n((float)x,(float)y,(float)z);
-                        n.normalize();
-                        arr->at(3*i+0)=n(0);
-                        arr->at(3*i+1)=n(1);
-                        arr->at(3*i+2)=n(2);
+                        if (theName[1]=='e')
+                        {
+                            _tempVertices.push_back(new std::vector<float>);
+                            data.buffer=_tempVertices.back();
+                        }
+                        else
+                        {
+                            _tempEdges.push_back(new std::vector<unsigned char>);
+                            data.buffer=_tempEdges.back();
+                        }
                     }
+                    if (theName[0]=='I')
+                    {
+                        _tempIndices.push_back(new std::vector<int>);
+                        data.buffer=_tempIndices.back();
+                    }
+                    if (theName[0]=='N')
+                    {
+                        _tempNormals.push_back(new std::vector<float>);
+                        data.buffer=_tempNormals.back();
+                    }
+                    if (ar.skipFileBufferBytes(byteQuantity))
+                        toDecode.push_back(data); // otherwise corrupt data: the buffer stays empty
                 }
-                if (theName.compare("Ved")==0)
-                {
-                    noHit=false;
-                    ar >> byteQuantity;
-                    std::vector<unsigned char>* arr=new std::vector<unsigned char>;
-                    _tempEdges.push_back(arr);
-                    arr->resize(byteQuantity,0);
-                    for (int i=0;i<byteQuantity;i++)
-                        ar >> arr->at(i);
-                }
+                if (noHit)
+                    ar.loadUnknownData();
             }
         }
+        const unsigned char* fileBuffer=ar.getFileBuffer()->data();
+        CWorkerPool::parallelFor(int(toDecode.size()),[&](int i)
+        {
+            _decodeTempBuffer(toDecode[i],fileBuffer+toDecode[i].fileBufferPos);
+        });
+    }
+}
+
+void CMesh::_decodeTempBuffer(const STempBufferLoadingData& data,const unsigned char* bytes)
+{ // can run in a worker thread
+    if (data.dataName.compare("Ver")==0)
+    {
+        std::vector<float>* arr=(std::vector<float>*)data.buffer;
+        arr->resize(data.byteQuantity/sizeof(float),0.0f);
+        if (arr->size()>0)
+            memcpy(&arr->at(0),bytes,arr->size()*sizeof(float));
+    }
+    if (data.dataName.compare("Ind")==0)
+    {
+        std::vector<int>* arr=(std::vector<int>*)data.buffer;
+        arr->resize(data.byteQuantity/sizeof(int),0);
+        if (arr->size()>0)
+            memcpy(&arr->at(0),bytes,arr->size()*sizeof(int));
+    }
+    if (data.dataName.compare("In2")==0)
+        _decodePackedIntegers(bytes,data.byteQuantity,((std::vector<int>*)data.buffer)[0]);
+    if (data.dataName.compare("Nor")==0)
+    {
+        std::vector<float>* arr=(std::vector<float>*)data.buffer;
+        arr->resize(data.byteQuantity/sizeof(float),0.0f);
+        if (arr->size()>0)
+            memcpy(&arr->at(0),bytes,arr->size()*sizeof(float));
+    }
+    if (data.dataName.compare("No2")==0)
+    {
+        std::vector<float>* arr=(std::vector<float>*)data.buffer;
+        arr->resize(data.byteQuantity*6/sizeof(float),0.0f);
+        for (int i=0;i<data.byteQuantity/2;i++)
+        {
+            unsigned short w;
+            memcpy(&w,bytes+2*i,sizeof(w));
+            char x=(w&0x001f)-15;
+            char y=((w>>5)&0x001f)-15;
+            char z=((w>>10)&0x001f)-15;
+            C3Vector n((float)x,(float)y,(float)z);
+            n.normalize();
+            arr->at(3*i+0)=n(0);
+            arr->at(3*i+1)=n(1);
+            arr->at(3*i+2)=n(2);
+        }
+    }
+    if (data.dataName.compare("Ved")==0)
+    {
+        std::vector<unsigned char>* arr=(std::vector<unsigned char>*)data.buffer;
+        arr->assign(bytes,bytes+data.byteQuantity);
     }
 }
 
@@ -1648,15 +1829,15 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
             if (App::currentWorld->undoBufferContainer->isUndoSavingOrRestoringUnderWay())
             { // undo/redo serialization:
                 ar.storeDataName("Ver");
-                ar << App::currentWorld->undoBufferContainer->undoBufferArrays.addVertexBuffer(_vertices,App::currentWorld->undoBufferContainer->getNextBufferId());
+                ar << App::currentWorld->undoBufferContainer->undoBufferArrays.addVertexBuffer(_geometry->vertices,App::currentWorld->undoBufferContainer->getNextBufferId());
                 ar.flush();
 
                 ar.storeDataName("Ind");
-                ar << App::currentWorld->undoBufferContainer->undoBufferArrays.addIndexBuffer(_indices,App::currentWorld->undoBufferContainer->getNextBufferId());
+                ar << App::currentWorld->undoBufferContainer->undoBufferArrays.addIndexBuffer(_geometry->indices,App::currentWorld->undoBufferContainer->getNextBufferId());
                 ar.flush();
 
                 ar.storeDataName("Nor");
-                ar << App::currentWorld->undoBufferContainer->undoBufferArrays.addNormalsBuffer(_normals,App::currentWorld->undoBufferContainer->getNextBufferId());
+                ar << App::currentWorld->undoBufferContainer->undoBufferArrays.addNormalsBuffer(_geometry->normals,App::currentWorld->undoBufferContainer->getNextBufferId());
                 ar.flush();
             }
             else
@@ -1731,6 +1912,8 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
         }
         else
         {       // Loading
+            _makeGeometryUnique(false);
+            int bufferIndices[4]={-1,-1,-1,-1}; // vertices, indices, normals and edges in the temp buffers
             int byteQuantity;
             std::string theName="";
             while (theName.compare(SER_END_OF_OBJECT)!=0)
@@ -1765,7 +1948,7 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
                             ar >> byteQuantity;
                             int id;
                             ar >> id;
-                            App::currentWorld->undoBufferContainer->undoBufferArrays.getVertexBuffer(id,_vertices);
+                            App::currentWorld->undoBufferContainer->undoBufferArrays.getVertexBuffer(id,_geometry->vertices);
                         }
                         if (theName.compare("Ind")==0)
                         {
@@ -1773,7 +1956,7 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
                             ar >> byteQuantity;
                             int id;
                             ar >> id;
-                            App::currentWorld->undoBufferContainer->undoBufferArrays.getIndexBuffer(id,_indices);
+                            App::currentWorld->undoBufferContainer->undoBufferArrays.getIndexBuffer(id,_geometry->indices);
                         }
                         if (theName.compare("Nor")==0)
                         {
@@ -1781,7 +1964,7 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
                             ar >> byteQuantity;
                             int id;
                             ar >> id;
-                            App::currentWorld->undoBufferContainer->undoBufferArrays.getNormalsBuffer(id,_normals);
+                            App::currentWorld->undoBufferContainer->undoBufferArrays.getNormalsBuffer(id,_geometry->normals);
                         }
                     }
                     else
@@ -1790,50 +1973,44 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
                         { // for backward compatibility (1/7/2014)
                             noHit=false;
                             ar >> byteQuantity;
-                            _vertices.resize(byteQuantity/sizeof(float),0.0f);
-                            for (int i=0;i<int(_vertices.size());i++)
-                                ar >> _vertices[i];
+                            _geometry->vertices.resize(byteQuantity/sizeof(float),0.0f);
+                            for (int i=0;i<int(_geometry->vertices.size());i++)
+                                ar >> _geometry->vertices[i];
                         }
                         if (theName.compare("Ind")==0)
                         { // for backward compatibility (1/7/2014)
                             noHit=false;
                             ar >> byteQuantity;
-                            _indices.resize(byteQuantity/sizeof(int),0);
-                            for (int i=0;i<int(_indices.size());i++)
-                                ar >> _indices[i];
+                            _geometry->indices.resize(byteQuantity/sizeof(int),0);
+                            for (int i=0;i<int(_geometry->indices.size());i++)
+                                ar >> _geometry->indices[i];
                         }
                         if (theName.compare("Nor")==0)
                         { // for backward compatibility (1/7/2014)
                             noHit=false;
                             ar >> byteQuantity;
-                            _normals.resize(byteQuantity/sizeof(float),0.0f);
-                            for (int i=0;i<int(_normals.size());i++)
-                                ar >> _normals[i];
+                            _geometry->normals.resize(byteQuantity/sizeof(float),0.0f);
+                            for (int i=0;i<int(_geometry->normals.size());i++)
+                                ar >> _geometry->normals[i];
                         }
 
                         if (theName.compare("Vev")==0)
                         {
                             noHit=false;
                             ar >> byteQuantity;
-                            int index;
-                            ar >> index;
-                            getVerticesFromBufferBasedOnIndex(index,_vertices);
+                            ar >> bufferIndices[0];
                         }
                         if (theName.compare("Inv")==0)
                         {
                             noHit=false;
                             ar >> byteQuantity;
-                            int index;
-                            ar >> index;
-                            getIndicesFromBufferBasedOnIndex(index,_indices);
+                            ar >> bufferIndices[1];
                         }
                         if (theName.compare("Nov")==0)
                         {
                             noHit=false;
                             ar >> byteQuantity;
-                            int index;
-                            ar >> index;
-                            getNormalsFromBufferBasedOnIndex(index,_normals);
+                            ar >> bufferIndices[2];
                         }
                     }
 
@@ -1841,13 +2018,13 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
                     { // for backward compatibility (1/7/2014)
                         noHit=false;
                         ar >> byteQuantity;
-                        _loadPackedIntegers(ar,_indices);
+                        _loadPackedIntegers(ar,_geometry->indices);
                     }
                     if (theName.compare("No2")==0)
                     { // for backward compatibility (1/7/2014)
                         noHit=false;
                         ar >> byteQuantity;
-                        _normals.resize(byteQuantity*6/sizeof(float),0.0f);
+                        _geometry->normals.resize(byteQuantity*6/sizeof(float),0.0f);
                         for (int i=0;i<byteQuantity/2;i++)
                         {
                             unsigned short w;
@@ -1857,26 +2034,24 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
                             char z=((w>>10)&0x001f)-15;
                             C3Vector n((float)x,(float)y,(float)z);
                             n.normalize();
-                            _normals[3*i+0]=n(0);
-                            _normals[3*i+1]=n(1);
-                            _normals[3*i+2]=n(2);
+                            _geometry->normals[3*i+0]=n(0);
+                            _geometry->normals[3*i+1]=n(1);
+                            _geometry->normals[3*i+2]=n(2);
                         }
                     }
                     if (theName.compare("Ved")==0)
                     { // for backward compatibility (1/7/2014)
                         noHit=false;
                         ar >> byteQuantity;
-                        _edges.resize(byteQuantity,0);
+                        _geometry->edges.resize(byteQuantity,0);
                         for (int i=0;i<byteQuantity;i++)
-                            ar >> _edges[i];
+                            ar >> _geometry->edges[i];
                     }
                     if (theName.compare("Vvd")==0)
                     {
                         noHit=false;
                         ar >> byteQuantity;
-                        int index;
-                        ar >> index;
-                        getEdgesFromBufferBasedOnIndex(index,_edges);
+                        ar >> bufferIndices[3];
                     }
                     if (theName.compare("Ppr")==0)
                     {
@@ -1948,6 +2123,7 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
                         ar.loadUnknownData();
                 }
             }
+            _setGeometryFromTempBuffers(bufferIndices);
         }
     }
     else
@@ -1992,15 +2168,15 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
             ar.xmlPopNode();
 
             ar.xmlPushNewNode("meshData");
-            if (ar.xmlSaveDataInline(_vertices.size()*4+_indices.size()*4+_normals.size()*4+_edges.size()))
+            if (ar.xmlSaveDataInline(_geometry->vertices.size()*4+_geometry->indices.size()*4+_geometry->normals.size()*4+_geometry->edges.size()))
             {
-                ar.xmlAddNode_floats("vertices",_vertices);
-                ar.xmlAddNode_ints("indices",_indices);
-                ar.xmlAddNode_floats("normals",_normals);
-                ar.xmlAddNode_uchars("edges",_edges);
+                ar.xmlAddNode_floats("vertices",_geometry->vertices);
+                ar.xmlAddNode_ints("indices",_geometry->indices);
+                ar.xmlAddNode_floats("normals",_geometry->normals);
+                ar.xmlAddNode_uchars("edges",_geometry->edges);
             }
             else
-                ar.xmlAddNode_meshFile("file",(std::string("mesh_")+std::string(shapeName)+"_"+tt::FNb(ar.getIncrementCounter())).c_str(),&_vertices[0],(int)_vertices.size(),&_indices[0],(int)_indices.size(),&_normals[0],(int)_normals.size(),&_edges[0],(int)_edges.size());
+                ar.xmlAddNode_meshFile("file",(std::string("mesh_")+std::string(shapeName)+"_"+tt::FNb(ar.getIncrementCounter())).c_str(),&_geometry->vertices[0],(int)_geometry->vertices.size(),&_geometry->indices[0],(int)_geometry->indices.size(),&_geometry->normals[0],(int)_geometry->normals.size(),&_geometry->edges[0],(int)_geometry->edges.size());
             ar.xmlPopNode();
         }
         else
@@ -2057,15 +2233,16 @@ void CMesh::serialize(CSer& ar,const char* shapeName)
 
             if (ar.xmlPushChildNode("meshData"))
             {
-                if (ar.xmlGetNode_floats("vertices",_vertices,false))
+                _makeGeometryUnique(false);
+                if (ar.xmlGetNode_floats("vertices",_geometry->vertices,false))
                 {
-                    ar.xmlGetNode_ints("indices",_indices);
-                    ar.xmlGetNode_floats("normals",_normals);
-                    ar.xmlGetNode_uchars("edges",_edges);
+                    ar.xmlGetNode_ints("indices",_geometry->indices);
+                    ar.xmlGetNode_floats("normals",_geometry->normals);
+                    ar.xmlGetNode_uchars("edges",_geometry->edges);
                 }
                 else
                 {
-                    ar.xmlGetNode_meshFile("file",_vertices,_indices,_normals,_edges);
+                    ar.xmlGetNode_meshFile("file",_geometry->vertices,_geometry->indices,_geometry->normals,_geometry->edges);
                     actualizeGouraudShadingAndVisibleEdges();
                 }
                 ar.xmlPopNode();
@@ -2101,7 +2278,7 @@ bool CMesh::getNonCalculatedTextureCoordinates(std::vector<float>& texCoords)
         return(false);
     C7Vector dummyTr;
     dummyTr.setIdentity();
-    std::vector<float>* tc=_textureProperty->getTextureCoordinates(-1,dummyTr,_vertices,_indices);
+    std::vector<float>* tc=_textureProperty->getTextureCoordinates(-1,dummyTr,_geometry->vertices,_geometry->indices);
     if (tc==nullptr)
         return(false);
     if (!_textureProperty->getFixedCoordinates())
@@ -3,6 +3,26 @@
 
 #include "meshWrapper.h"
 #include "textureProperty.h"
+#include <atomic>
+#include <map>
+
+struct SMeshGeometry
+{ // shared by copies of a mesh, and by meshes loaded from the same data. Copied before being modified if shared
+    std::vector<float> vertices;
+    std::vector<int> indices;
+    std::vector<float> normals;
+    std::vector<unsigned char> edges;
+    std::atomic<int> refCnt;
+    int uniqueId; // changes when the content changes
+};
+
+struct STempBufferLoadingData
+{
+    std::string dataName;
+    void* buffer; // one of the temp buffers
+    int fileBufferPos;
+    int byteQuantity;
+};
 
 class CMesh : public CMeshWrapper
 {
@@ -88,10 +108,13 @@ public:
     void setWireframe(bool w);
     bool getWireframe();
 
-    std::vector<float>* getVertices();
-    std::vector<int>* getIndices();
-    std::vector<float>* getNormals();
-    std::vector<unsigned char>* getEdges();
+    // Following 4 can be shared with other meshes: read only!
+    const std::vector<float>* getVertices() const; // geometry can be shared: not for modifications
+    const std::vector<int>* getIndices() const;
+    const std::vector<float>* getNormals() const;
+    const std::vector<unsigned char>* getEdges() const;
+    int getGeometryUniqueId() const;
+    int getGeometryRefCount() const;
     int* getVertexBufferIdPtr();
     int* getNormalBufferIdPtr();
     int* getEdgeBufferIdPtr();
@@ -130,15 +153,19 @@ public:
 protected:
     void _recomputeNormals();
     void _computeVisibleEdges();
+    void _makeGeometryUnique(bool keepContent);
+    void _setGeometryFromTempBuffers(const int bufferIndices[4]);
+
+    static SMeshGeometry* _newGeometry();
+    static void _releaseGeometry(SMeshGeometry* geometry);
 
     static void _savePackedIntegers(CSer& ar,const std::vector<int>& data);
     static void _loadPackedIntegers(CSer& ar,std::vector<int>& data);
+    static void _decodePackedIntegers(const unsigned char* bytes,int byteQuantity,std::vector<int>& data);
+    static void _decodeTempBuffer(const STempBufferLoadingData& data,const unsigned char* bytes);
+
+    SMeshGeometry* _geometry;
 
-    std::vector<float> _vertices;
-    std::vector<int> _indices;
-    std::vector<float> _normals;
-    std::vector<unsigned char> _edges;
-    
     bool _visibleEdges;
     bool _hideEdgeBorders;
     bool _culling;
@@ -189,6 +216,9 @@ protected:
     static std::vector<std::vector<int>*> _tempIndices;
     static std::vector<std::vector<float>*> _tempNormals;
     static std::vector<std::vector<unsigned char>*> _tempEdges;
+    static std::map<std::vector<int>,SMeshGeometry*> _tempLoadedGeometries; // key: indices in above buffers
+    static std::map<SMeshGeometry*,std::vector<int>> _tempSavedGeometries;
+    static std::atomic<int> _nextGeometryUniqueId;
 
 #ifdef SIM_WITH_GUI
 public:
@@ -0,0 +1,270 @@
+#include "meshCalcStructureCache.h"
+#include "pluginContainer.h"
+#include "app.h"
+#include "vFile.h"
+#include "vFileFinder.h"
+#include "vDateTime.h"
+#include <algorithm>
+#include <cstring>
+
+int CMeshCalcStructureCache::_hits=0;
+int CMeshCalcStructureCache::_misses=0;
+int CMeshCalcStructureCache::_stores=0;
+int CMeshCalcStructureCache::_evictions=0;
+long long CMeshCalcStructureCache::_cacheSize=-1;
+std::mutex CMeshCalcStructureCache::_mutex;
+std::atomic<unsigned int> CMeshCalcStructureCache::_tmpFileCounter(0);
+
+struct SMeshCalcStructureCacheHeader
+{
+    int version;
+    int verticesSize;
+    int indicesSize;
+    int dataSize;
+    unsigned long long checkHash; // 2nd hash with a different seed, against file name collisions
+};
+
+static unsigned long long _fnv1a(unsigned long long hash,const void* data,size_t size)
+{
+    const unsigned char* d=(const unsigned char*)data;
+    for (size_t i=0;i<size;i++)
+    {
+        hash^=d[i];
+        hash*=1099511628211ULL;
+    }
+    return(hash);
+}
+
+std::string CMeshCalcStructureCache::getCacheFolder()
+{
+    return(App::folders->getSystemPath()+"/calcStructureCache");
+}
+
+bool CMeshCalcStructureCache::_isEnabled()
+{
+    return( (App::userSettings->calcStructureCacheSize>0)&&CPluginContainer::isGeomPluginAvailable() );
+}
+
+unsigned long long CMeshCalcStructureCache::_getHash(unsigned long long seed,const std::vector<float>& vertices,const std::vector<int>& indices,float maxTriSize,int triCountInObb)
+{ // the geometry plugin version is part of the key, since the serialization format is the plugin's
+    unsigned long long h=seed;
+    int version=MESH_CALC_STRUCTURE_CACHE_VERSION;
+    h=_fnv1a(h,&version,sizeof(version));
+    std::string pluginName(CPluginContainer::currentGeomPlugin->getName());
+    h=_fnv1a(h,pluginName.c_str(),pluginName.size());
+    h=_fnv1a(h,&CPluginContainer::currentGeomPlugin->pluginVersion,sizeof(unsigned char));
+    h=_fnv1a(h,&CPluginContainer::currentGeomPlugin->extendedVersionInt,sizeof(int));
+    h=_fnv1a(h,&maxTriSize,sizeof(maxTriSize));
+    h=_fnv1a(h,&triCountInObb,sizeof(triCountInObb));
+    int s[2]={int(vertices.size()),int(indices.size())};
+    h=_fnv1a(h,s,sizeof(s));
+    if (vertices.size()>0)
+        h=_fnv1a(h,&vertices[0],vertices.size()*sizeof(float));
+    if (indices.size()>0)
+        h=_fnv1a(h,&indices[0],indices.size()*sizeof(int));
+    return(h);
+}
+
+std::string CMeshCalcStructureCache::_getFilename(unsigned long long hash)
+{
+    static const char hex[]="0123456789abcdef";
+    std::string name;
+    for (int i=15;i>=0;i--)
+        name+=hex[(hash>>(i*4))&15];
+    return(getCacheFolder()+"/"+name+"."+MESH_CALC_STRUCTURE_CACHE_EXTENSION);
+}
+
+void* CMeshCalcStructureCache::load(const std::vector<float>& vertices,const std::vector<int>& indices,float maxTriSize,int triCountInObb)
+{
+    if ( (!_isEnabled())||(indices.size()/3<MESH_CALC_STRUCTURE_CACHE_MIN_TRIANGLES) )
+        return(nullptr);
+    void* retVal=nullptr;
+    std::string filename(_getFilename(_getHash(14695981039346656037ULL,vertices,indices,maxTriSize,triCountInObb)));
+    if (VFile::doesFileExist(filename.c_str()))
+    {
+        try
+        {
+            VFile file(filename.c_str(),VFile::READ|VFile::SHARE_DENY_NONE);
+            std::vector<unsigned char> buffer(size_t(file.getLength()));
+            if ( (buffer.size()>sizeof(SMeshCalcStructureCacheHeader))&&file.readBytes(0,(char*)&buffer[0],buffer.size()) )
+            {
+                SMeshCalcStructureCacheHeader header;
+                std::memcpy(&header,&buffer[0],sizeof(header));
+                bool valid=(header.version==MESH_CALC_STRUCTURE_CACHE_VERSION);
+                valid=valid&&(header.verticesSize==int(vertices.size()))&&(header.indicesSize==int(indices.size()));
+                valid=valid&&(size_t(header.dataSize)==buffer.size()-sizeof(header));
+                valid=valid&&(header.checkHash==_getHash(1469598103934665603ULL,vertices,indices,maxTriSize,triCountInObb));
+                if (valid)
+                    retVal=CPluginContainer::geomPlugin_getMeshFromSerializationData(&buffer[sizeof(header)]);
+            }
+            file.close();
+            if (retVal!=nullptr)
+                VFile::touchFile(filename.c_str()); // eviction is least recently used first
+        }
+        catch(VFILE_EXCEPTION_TYPE e)
+        { // silent: the structure will simply be built
+        }
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (retVal!=nullptr)
+        _hits++;
+    else
+        _misses++;
+    return(retVal);
+}
+
+void CMeshCalcStructureCache::store(const void* calcStruct,const std::vector<float>& vertices,const std::vector<int>& indices,float maxTriSize,int triCountInObb,bool mayWrite)
+{
+    if ( (calcStruct==nullptr)||(!mayWrite)||(!_isEnabled())||(indices.size()/3<MESH_CALC_STRUCTURE_CACHE_MIN_TRIANGLES) )
+        return;
+    std::vector<unsigned char> data;
+    CPluginContainer::geomPlugin_getMeshSerializationData(calcStruct,data);
+    if (data.size()==0)
+        return;
+    SMeshCalcStructureCacheHeader header;
+    header.version=MESH_CALC_STRUCTURE_CACHE_VERSION;
+    header.verticesSize=int(vertices.size());
+    header.indicesSize=int(indices.size());
+    header.dataSize=int(data.size());
+    header.checkHash=_getHash(1469598103934665603ULL,vertices,indices,maxTriSize,triCountInObb);
+    std::vector<unsigned char> buffer(sizeof(header)+data.size());
+    std::memcpy(&buffer[0],&header,sizeof(header));
+    std::memcpy(&buffer[sizeof(header)],&data[0],data.size());
+
+    std::string folder(getCacheFolder());
+    if (!VFile::doesFolderExist(folder.c_str()))
+        VFile::createFolder(folder.c_str());
+    std::string filename(_getFilename(_getHash(14695981039346656037ULL,vertices,indices,maxTriSize,triCountInObb)));
+    std::string tmpFilename(filename+"."+std::to_string(VDateTime::getTimeInUs())+"-"+std::to_string(_tmpFileCounter++)+".tmp"); // unique, several shapes or instances could store the same entry at the same time
+    try
+    { // write to a temp file first: another instance could be reading the same entry
+        VFile file(tmpFilename.c_str(),VFile::CREATE_WRITE|VFile::SHARE_EXCLUSIVE);
+        file.getFile()->write((const char*)&buffer[0],(long long)buffer.size());
+        file.close();
+    }
+    catch(VFILE_EXCEPTION_TYPE e)
+    { // silent, e.g. when the system folder is not writable
+        return;
+    }
+    if (!VFile::replaceFile(tmpFilename.c_str(),filename.c_str()))
+    {
+        VFile::eraseFile(tmpFilename.c_str());
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stores++;
+    unsigned long long maxSize=(unsigned long long)App::userSettings->calcStructureCacheSize*1024*1024;
+    if (_cacheSize>=0)
+        _cacheSize+=(long long)buffer.size();
+    if ( (_cacheSize<0)||((unsigned long long)_cacheSize>maxSize) )
+        _limitCacheSize(maxSize,(unsigned long long)(double(maxSize)*MESH_CALC_STRUCTURE_CACHE_LOW_WATER_MARK));
+}
+
+void CMeshCalcStructureCache::erase(const std::vector<float>& vertices,const std::vector<int>& indices,float maxTriSize,int triCountInObb)
+{
+    if (!CPluginContainer::isGeomPluginAvailable())
+        return;
+    std::string filename(_getFilename(_getHash(14695981039346656037ULL,vertices,indices,maxTriSize,triCountInObb)));
+    if (!VFile::doesFileExist(filename.c_str()))
+        return;
+    long long size=0;
+    try
+    {
+        VFile file(filename.c_str(),VFile::READ|VFile::SHARE_DENY_NONE);
+        size=(long long)file.getLength();
+        file.close();
+    }
+    catch(VFILE_EXCEPTION_TYPE e)
+    {
+    }
+    VFile::eraseFile(filename.c_str());
+    if (!VFile::doesFileExist(filename.c_str()))
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_cacheSize>=0)
+            _cacheSize=std::max<long long>(0,_cacheSize-size);
+    }
+}
+
+void CMeshCalcStructureCache::_limitCacheSize(unsigned long long maxSize,unsigned long long targetSize)
+{ // scans the cache folder and, if the cache is larger than maxSize, erases the least recently used entries until
+  // it fits into targetSize. Stale temp files are erased, the other ones are counted
+    struct SEntry
+    {
+        std::string filename;
+        unsigned long long time;
+        unsigned long long size;
+    };
+    std::string folder(getCacheFolder());
+    std::vector<SEntry> entries;
+    unsigned long long totalSize=0;
+    VFileFinder finder;
+    int cnt=finder.searchFilesWithExtension(folder.c_str(),MESH_CALC_STRUCTURE_CACHE_EXTENSION);
+    for (int i=0;i<cnt;i++)
+    {
+        SFileOrFolder* f=finder.getFoundItem(i);
+        SEntry entry;
+        entry.filename=folder+"/"+f->name;
+        entry.time=f->lastWriteTime;
+        entry.size=f->size;
+        if (entry.size==0)
+        { // size not provided by the file finder
+            try
+            {
+                VFile file(entry.filename.c_str(),VFile::READ|VFile::SHARE_DENY_NONE);
+                entry.size=file.getLength();
+                file.close();
+            }
+            catch(VFILE_EXCEPTION_TYPE e)
+            {
+            }
+        }
+        totalSize+=entry.size;
+        entries.push_back(entry);
+    }
+    unsigned long long now=VDateTime::getSecondsSince1970();
+    std::string tmpSuffix(std::string(".")+MESH_CALC_STRUCTURE_CACHE_EXTENSION+".");
+    cnt=finder.searchFilesWithExtension(folder.c_str(),"tmp");
+    for (int i=0;i<cnt;i++)
+    {
+        SFileOrFolder* f=finder.getFoundItem(i);
+        if (f->name.find(tmpSuffix)!=std::string::npos)
+        {
+            if ( (targetSize==0)||(f->lastWriteTime+MESH_CALC_STRUCTURE_CACHE_STALE_TMP_TIME<now) )
+                VFile::eraseFile((folder+"/"+f->name).c_str());
+            else
+                totalSize+=f->size; // probably being written
+        }
+    }
+    if (totalSize>maxSize)
+    {
+        std::sort(entries.begin(),entries.end(),[](const SEntry& a,const SEntry& b){ return(a.time<b.time); });
+        for (size_t i=0;(i<entries.size())&&(totalSize>targetSize);i++)
+        {
+            VFile::eraseFile(entries[i].filename.c_str());
+            totalSize-=std::min<unsigned long long>(totalSize,entries[i].size);
+            _evictions++;
+        }
+    }
+    _cacheSize=(long long)totalSize;
+}
+
+void CMeshCalcStructureCache::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _limitCacheSize(0,0);
+    _hits=0;
+    _misses=0;
+    _stores=0;
+    _evictions=0;
+}
+
+void CMeshCalcStructureCache::getStatistics(int& hits,int& misses,int& stores,int& evictions)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    hits=_hits;
+    misses=_misses;
+    stores=_stores;
+    evictions=_evictions;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+
+#define MESH_CALC_STRUCTURE_CACHE_VERSION 1 // increment when the cache file layout changes
+#define MESH_CALC_STRUCTURE_CACHE_EXTENSION "obb"
+#define MESH_CALC_STRUCTURE_CACHE_MIN_TRIANGLES 5000 // smaller meshes are built faster than they are read from disk
+#define MESH_CALC_STRUCTURE_CACHE_LOW_WATER_MARK 0.75 // when full, the cache is trimmed to this fraction of its max. size
+#define MESH_CALC_STRUCTURE_CACHE_STALE_TMP_TIME 600 // in s. Older temp files are leftovers of interrupted writes
+
+// FULLY STATIC CLASS
+// On-disk cache of mesh calculation structures (OBB trees built by the geometry plugin), so that repeated loads or
+// imports of the same geometry skip the OBB construction. Entries are keyed by a content hash of the vertices and
+// indices, the build parameters, and the geometry plugin name and version. The total cache size is limited by
+// App::userSettings->calcStructureCacheSize (in MB, 0 disables the cache): least recently used entries are erased first.
+// Small meshes are not cached. The caller decides whether an entry may be written (e.g. not while simulating)
+class CMeshCalcStructureCache
+{
+public:
+    static void* load(const std::vector<float>& vertices,const std::vector<int>& indices,float maxTriSize,int triCountInObb); // returns nullptr if not cached
+    static void store(const void* calcStruct,const std::vector<float>& vertices,const std::vector<int>& indices,float maxTriSize,int triCountInObb,bool mayWrite);
+    static void erase(const std::vector<float>& vertices,const std::vector<int>& indices,float maxTriSize,int triCountInObb);
+    static void clear();
+    static void getStatistics(int& hits,int& misses,int& stores,int& evictions);
+    static std::string getCacheFolder();
+
+private:
+    static bool _isEnabled();
+    static unsigned long long _getHash(unsigned long long seed,const std::vector<float>& vertices,const std::vector<int>& indices,float maxTriSize,int triCountInObb);
+    static std::string _getFilename(unsigned long long hash);
+    static void _limitCacheSize(unsigned long long maxSize,unsigned long long targetSize);
+
+    static int _hits;
+    static int _misses;
+    static int _stores;
+    static int _evictions;
+    static long long _cacheSize; // -1 if not yet known
+    static std::mutex _mutex;
+    static std::atomic<unsigned int> _tmpFileCounter;
+};
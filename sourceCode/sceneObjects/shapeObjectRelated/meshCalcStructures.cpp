@@ -0,0 +1,136 @@
+#include "meshCalcStructures.h"
+#include "pluginContainer.h"
+
+std::map<void*,CMeshCalcStructures::SCalcStructure> CMeshCalcStructures::_structures;
+std::map<SMeshCalcStructureKey,void*> CMeshCalcStructures::_structuresByKey;
+std::mutex CMeshCalcStructures::_mutex;
+
+bool SMeshCalcStructureKey::operator<(const SMeshCalcStructureKey& other) const
+{
+    if (geometryUniqueId!=other.geometryUniqueId)
+        return(geometryUniqueId<other.geometryUniqueId);
+    if (triCountInObb!=other.triCountInObb)
+        return(triCountInObb<other.triCountInObb);
+    if (maxTriSize!=other.maxTriSize)
+        return(maxTriSize<other.maxTriSize);
+    for (size_t i=0;i<7;i++)
+    {
+        if (verticeLocalFrame[i]!=other.verticeLocalFrame[i])
+            return(verticeLocalFrame[i]<other.verticeLocalFrame[i]);
+    }
+    return(false);
+}
+
+SMeshCalcStructureKey CMeshCalcStructures::getKey(int geometryUniqueId,const C7Vector& verticeLocalFrame,float maxTriSize,int triCountInObb)
+{
+    SMeshCalcStructureKey key;
+    key.geometryUniqueId=geometryUniqueId;
+    for (size_t i=0;i<3;i++)
+        key.verticeLocalFrame[i]=verticeLocalFrame.X.data[i];
+    for (size_t i=0;i<4;i++)
+        key.verticeLocalFrame[3+i]=verticeLocalFrame.Q.data[i];
+    key.maxTriSize=maxTriSize;
+    key.triCountInObb=triCountInObb;
+    return(key);
+}
+
+void* CMeshCalcStructures::find(const SMeshCalcStructureKey& key)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::map<SMeshCalcStructureKey,void*>::iterator it=_structuresByKey.find(key);
+    if (it==_structuresByKey.end())
+        return(nullptr);
+    _structures[it->second].refCnt++;
+    return(it->second);
+}
+
+void* CMeshCalcStructures::add(void* calcStruct,const SMeshCalcStructureKey* key)
+{
+    if (calcStruct==nullptr)
+        return(nullptr);
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_structures.find(calcStruct)!=_structures.end())
+        return(calcStruct); // already added
+    if (key!=nullptr)
+    {
+        std::map<SMeshCalcStructureKey,void*>::iterator it=_structuresByKey.find(key[0]);
+        if (it!=_structuresByKey.end())
+        {
+            CPluginContainer::geomPlugin_destroyMesh(calcStruct);
+            _structures[it->second].refCnt++;
+            return(it->second);
+        }
+        _structuresByKey[key[0]]=calcStruct;
+    }
+    SCalcStructure s;
+    s.refCnt=1;
+    s.hasKey=(key!=nullptr);
+    if (key!=nullptr)
+        s.key=key[0];
+    _structures[calcStruct]=s;
+    return(calcStruct);
+}
+
+void* CMeshCalcStructures::share(void* calcStruct)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::map<void*,SCalcStructure>::iterator it=_structures.find(calcStruct);
+    if (it!=_structures.end())
+    {
+        it->second.refCnt++;
+        return(calcStruct);
+    }
+    // not registered here. Give the caller its own copy:
+    void* copy=CPluginContainer::geomPlugin_copyMesh(calcStruct);
+    SCalcStructure s;
+    s.refCnt=1;
+    s.hasKey=false;
+    _structures[copy]=s;
+    return(copy);
+}
+
+void CMeshCalcStructures::release(void* calcStruct)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::map<void*,SCalcStructure>::iterator it=_structures.find(calcStruct);
+    if (it!=_structures.end())
+    {
+        if (--it->second.refCnt>0)
+            return;
+        if (it->second.hasKey)
+            _structuresByKey.erase(it->second.key);
+        _structures.erase(it);
+    }
+    CPluginContainer::geomPlugin_destroyMesh(calcStruct);
+}
+
+void* CMeshCalcStructures::makeUnique(void* calcStruct)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::map<void*,SCalcStructure>::iterator it=_structures.find(calcStruct);
+    if (it==_structures.end())
+        return(calcStruct);
+    if (it->second.refCnt>1)
+    {
+        it->second.refCnt--;
+        void* copy=CPluginContainer::geomPlugin_copyMesh(calcStruct);
+        SCalcStructure s;
+        s.refCnt=1;
+        s.hasKey=false;
+        _structures[copy]=s;
+        return(copy);
+    }
+    // not shared, but will be modified. Others must not find it anymore:
+    if (it->second.hasKey)
+    {
+        _structuresByKey.erase(it->second.key);
+        it->second.hasKey=false;
+    }
+    return(calcStruct);
+}
+
+int CMeshCalcStructures::getStructureCount()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return(int(_structures.size()));
+}
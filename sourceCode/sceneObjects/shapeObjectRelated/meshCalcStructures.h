@@ -0,0 +1,43 @@
+#pragma once
+
+#include "7Vector.h"
+#include <map>
+#include <mutex>
+
+struct SMeshCalcStructureKey
+{
+    int geometryUniqueId;
+    float verticeLocalFrame[7];
+    float maxTriSize; // -1 if unknown (e.g. structure was loaded)
+    int triCountInObb; // -1 if unknown (e.g. structure was loaded)
+
+    bool operator<(const SMeshCalcStructureKey& other) const;
+};
+
+// FULLY STATIC CLASS
+// Reference counts the mesh calculation structures (OBB trees built by the geometry plugin), so that they can be
+// shared between shapes with identical meshes. Structures are read-only while shared: call makeUnique before
+// modifying one. Can be called from any thread
+class CMeshCalcStructures
+{
+public:
+    static SMeshCalcStructureKey getKey(int geometryUniqueId,const C7Vector& verticeLocalFrame,float maxTriSize,int triCountInObb);
+    static void* find(const SMeshCalcStructureKey& key); // increases the ref count if found
+    static void* add(void* calcStruct,const SMeshCalcStructureKey* key); // if a structure with same key exists, calcStruct is destroyed and the existing one returned
+    static void* share(void* calcStruct);
+    static void release(void* calcStruct); // destroys the structure when not used anymore
+    static void* makeUnique(void* calcStruct); // returns a copy if calcStruct is shared
+    static int getStructureCount();
+
+private:
+    struct SCalcStructure
+    {
+        int refCnt;
+        bool hasKey;
+        SMeshCalcStructureKey key;
+    };
+
+    static std::map<void*,SCalcStructure> _structures;
+    static std::map<SMeshCalcStructureKey,void*> _structuresByKey;
+    static std::mutex _mutex;
+};
@@ -6,6 +6,8 @@
 #include "sceneObjectOperations.h"
 #include "simStrings.h"
 #include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstring>
 #include "vDateTime.h"
 #include "vVarious.h"
 #include "ttUtil.h"
@@ -15,6 +17,9 @@
 #include "pluginContainer.h"
 #include "visionSensorRendering.h"
 #include "interfaceStackString.h"
+#include "visionSensorRayCaster.h"
+#include "imageKernels.h"
+#include "workerPool.h"
 #ifdef SIM_WITH_OPENGL
 #include "rendering.h"
 #include "oGL.h"
@@ -77,32 +82,19 @@ float* CVisionSensor::readPortionOfImage(int posX,int posY,int sizeX,int sizeY,i
         buff=new float[sizeX*sizeY*3];
     else
         buff=new float[sizeX*sizeY];
-    int p=0;
-    for (int j=posY;j<posY+sizeY;j++)
+    if ( (rgbGreyOrDepth==0)||(rgbGreyOrDepth==1) )
     {
-        for (int i=posX;i<posX+sizeX;i++)
+        for (int j=0;j<sizeY;j++)
         {
+            const unsigned char* row=_rgbBuffer+3*((posY+j)*_resolutionX+posX);
             if (rgbGreyOrDepth==0)
-            { // RGB
-                buff[3*p+0]=float(_rgbBuffer[3*(j*_resolutionX+i)+0])/255.0f;
-                buff[3*p+1]=float(_rgbBuffer[3*(j*_resolutionX+i)+1])/255.0f;
-                buff[3*p+2]=float(_rgbBuffer[3*(j*_resolutionX+i)+2])/255.0f;
-            }
+                CImageKernels::charToFloat(row,buff+3*j*sizeX,3*sizeX); // RGB
             else
-            {
-                if (rgbGreyOrDepth==1)
-                { // Greyscale
-                    buff[p]=float(_rgbBuffer[3*(j*_resolutionX+i)+0])/255.0f;
-                    buff[p]+=float(_rgbBuffer[3*(j*_resolutionX+i)+1])/255.0f;
-                    buff[p]+=float(_rgbBuffer[3*(j*_resolutionX+i)+2])/255.0f;
-                    buff[p]/=3.0f;
-                }
-                else
-                    buff[p]=_depthBuffer[j*_resolutionX+i];
-            }
-            p++;
+                CImageKernels::rgbToGreyFloat(row,buff+j*sizeX,sizeX); // Greyscale
         }
     }
+    else
+        CImageKernels::copyRegion(_depthBuffer,_resolutionX,posX,posY,sizeX,sizeY,1,buff);
     return(buff);
 }
 
@@ -114,65 +106,32 @@ unsigned char* CVisionSensor::readPortionOfCharImage(int posX,int posY,int sizeX
     if (cutoffRgba==0.0f)
     {
         if (imgIsGreyScale)
+        {
             buff=new unsigned char[sizeX*sizeY];
+            for (int j=0;j<sizeY;j++)
+                CImageKernels::rgbToGreyChar(_rgbBuffer+3*((posY+j)*_resolutionX+posX),buff+j*sizeX,1,sizeX);
+        }
         else
-            buff=new unsigned char[sizeX*sizeY*3];
-        int p=0;
-        for (int j=posY;j<posY+sizeY;j++)
         {
-            for (int i=posX;i<posX+sizeX;i++)
-            {
-                if (imgIsGreyScale)
-                {
-                    unsigned int v=_rgbBuffer[3*(j*_resolutionX+i)+0];
-                    v+=_rgbBuffer[3*(j*_resolutionX+i)+1];
-                    v+=_rgbBuffer[3*(j*_resolutionX+i)+2];
-                    buff[p]=(unsigned char)(v/3);
-                }
-                else
-                {
-                    buff[3*p+0]=_rgbBuffer[3*(j*_resolutionX+i)+0];
-                    buff[3*p+1]=_rgbBuffer[3*(j*_resolutionX+i)+1];
-                    buff[3*p+2]=_rgbBuffer[3*(j*_resolutionX+i)+2];
-                }
-                p++;
-            }
+            buff=new unsigned char[sizeX*sizeY*3];
+            CImageKernels::copyRegion(_rgbBuffer,_resolutionX,posX,posY,sizeX,sizeY,3,buff);
         }
     }
     else
-    {
+    { // with an alpha channel, set from the depth
+        int valPerPixel=4;
         if (imgIsGreyScale)
-            buff=new unsigned char[sizeX*sizeY*2];
-        else
-            buff=new unsigned char[sizeX*sizeY*4];
-        int p=0;
-        for (int j=posY;j<posY+sizeY;j++)
+            valPerPixel=2;
+        buff=new unsigned char[sizeX*sizeY*valPerPixel];
+        for (int j=0;j<sizeY;j++)
         {
-            for (int i=posX;i<posX+sizeX;i++)
-            {
-                if (imgIsGreyScale)
-                {
-                    unsigned int v=_rgbBuffer[3*(j*_resolutionX+i)+0];
-                    v+=_rgbBuffer[3*(j*_resolutionX+i)+1];
-                    v+=_rgbBuffer[3*(j*_resolutionX+i)+2];
-                    buff[2*p+0]=(unsigned char)(v/3);
-                    if (_depthBuffer[j*_resolutionX+i]>cutoffRgba)
-                        buff[2*p+1]=0;
-                    else
-                        buff[2*p+1]=255;
-                }
-                else
-                {
-                    buff[4*p+0]=_rgbBuffer[3*(j*_resolutionX+i)+0];
-                    buff[4*p+1]=_rgbBuffer[3*(j*_resolutionX+i)+1];
-                    buff[4*p+2]=_rgbBuffer[3*(j*_resolutionX+i)+2];
-                    if (_depthBuffer[j*_resolutionX+i]>cutoffRgba)
-                        buff[4*p+3]=0;
-                    else
-                        buff[4*p+3]=255;
-                }
-                p++;
-            }
+            int srcPix=(posY+j)*_resolutionX+posX;
+            unsigned char* dst=buff+j*sizeX*valPerPixel;
+            if (imgIsGreyScale)
+                CImageKernels::rgbToGreyChar(_rgbBuffer+3*srcPix,dst,2,sizeX);
+            else
+                CImageKernels::rgbToRgbaChar(_rgbBuffer+3*srcPix,dst,sizeX);
+            CImageKernels::depthThreshold(_depthBuffer+srcPix,cutoffRgba,dst+valPerPixel-1,valPerPixel,sizeX);
         }
     }
     return(buff);
@@ -279,6 +238,9 @@ void CVisionSensor::commonInit()
 #ifdef SIM_WITH_OPENGL
     _contextFboAndTexture=nullptr;
 #endif
+    _readbackStallTimeInUs=0;
+    _renderTimeInUs=0;
+    _discardPendingReadback=false;
 
     _rgbBuffer=nullptr;
     _depthBuffer=nullptr;
@@ -310,6 +272,16 @@ bool CVisionSensor::getApplyExternalRenderedImage()
     return( (_renderMode==sim_rendermode_povray)||(_renderMode==sim_rendermode_extrenderer)||(_renderMode==sim_rendermode_opengl3) );
 }
 
+bool CVisionSensor::getUseDepthRayCasting()
+{ // depth-only sensors can be rendered by ray casting, without OpenGL. Only shapes and octrees are then seen (no mirrors, point clouds, drawing objects, etc.)
+    return( App::userSettings->visionSensorsDepthRayCasting&&_ignoreRGBInfo&&(!_ignoreDepthInfo)&&(!_useExternalImage)&&getInternalRendering()&&CPluginContainer::isGeomPluginAvailable() );
+}
+
+unsigned long long int CVisionSensor::getReadbackStallTimeInUs() const
+{
+    return(_readbackStallTimeInUs);
+}
+
 CComposedFilter* CVisionSensor::getComposedFilter()
 {
     return(_composedFilter);
@@ -636,22 +608,9 @@ void CVisionSensor::resetSensor()
 bool CVisionSensor::setExternalImage(const float* img,bool imgIsGreyScale,bool noProcessing)
 {
     if (imgIsGreyScale)
-    {
-        int n=_resolutionX*_resolutionY;
-        for (int i=0;i<n;i++)
-        {
-            unsigned char v=(unsigned char)(img[i]*255.1f);
-            _rgbBuffer[3*i+0]=v;
-            _rgbBuffer[3*i+1]=v;
-            _rgbBuffer[3*i+2]=v;
-        }
-    }
+        CImageKernels::greyFloatToRgb(img,_rgbBuffer,_resolutionX*_resolutionY);
     else
-    {
-        int n=_resolutionX*_resolutionY*3;
-        for (int i=0;i<n;i++)
-            _rgbBuffer[i]=(unsigned char)(img[i]*255.1f);
-    }
+        CImageKernels::floatToChar(img,_rgbBuffer,_resolutionX*_resolutionY*3);
     bool returnValue=false;
     if (!noProcessing)
         returnValue=_computeDefaultReturnValuesAndApplyFilters(); // this might overwrite the default return values
@@ -669,21 +628,9 @@ bool CVisionSensor::setExternalImage(const float* img,bool imgIsGreyScale,bool n
 bool CVisionSensor::setExternalCharImage(const unsigned char* img,bool imgIsGreyScale,bool noProcessing)
 {
     if (imgIsGreyScale)
-    {
-        int n=_resolutionX*_resolutionY;
-        for (int i=0;i<n;i++)
-        {
-            _rgbBuffer[3*i+0]=img[i];
-            _rgbBuffer[3*i+1]=img[i];
-            _rgbBuffer[3*i+2]=img[i];
-        }
-    }
+        CImageKernels::greyCharToRgb(img,_rgbBuffer,_resolutionX*_resolutionY);
     else
-    {
-        int n=_resolutionX*_resolutionY*3;
-        for (int i=0;i<n;i++)
-            _rgbBuffer[i]=img[i];
-    }
+        std::memcpy(_rgbBuffer,img,_resolutionX*_resolutionY*3);
     bool returnValue=false;
     if (!noProcessing)
         returnValue=_computeDefaultReturnValuesAndApplyFilters(); // this might overwrite the default return values
@@ -700,14 +647,106 @@ bool CVisionSensor::setExternalCharImage(const unsigned char* img,bool imgIsGrey
 
 void CVisionSensor::setDepthBuffer(const float* img)
 {
-    int n=_resolutionX*_resolutionY;
-    for (int i=0;i<n;i++)
-        _depthBuffer[i]=img[i];
+    std::memcpy(_depthBuffer,img,_resolutionX*_resolutionY*sizeof(float));
 }
 
 bool CVisionSensor::handleSensor()
 {
     TRACE_INTERNAL;
+    _clearSensorResult();
+    if (!App::currentWorld->mainSettings->visionSensorsEnabled)
+        return(false);
+    if (_useExternalImage) // those 2 lines added on 2010/12/12
+        return(false);
+    int stTime=VDateTime::getTimeInMs();
+    detectEntity(_detectableEntityHandle,_detectableEntityHandle==-1,false,false,false);
+    _updateTexture();
+    sensorResult.calcTimeInMs=VDateTime::getTimeDiffInMs(stTime);
+    return(sensorResult.sensorWasTriggered);
+}
+
+int CVisionSensor::handleSensors(const std::vector<CVisionSensor*>& sensors)
+{ // Same as calling handleSensor for each sensor. Without vision callbacks, all sensors are first rendered, then filtered:
+  // sensors that have to be rendered in the UI thread are then all rendered there in a single round trip. A vision callback
+  // can modify the scene, or remove sensors, so sensors are then rendered and filtered one after the other, as before
+    TRACE_INTERNAL;
+    std::vector<CVisionSensor*> toHandle;
+    std::vector<int> handles;
+    bool visionCallbacks=false;
+    for (size_t i=0;i<sensors.size();i++)
+    {
+        sensors[i]->_clearSensorResult();
+        if ( App::currentWorld->mainSettings->visionSensorsEnabled&&(!sensors[i]->_useExternalImage) )
+        {
+            toHandle.push_back(sensors[i]);
+            handles.push_back(sensors[i]->getObjectHandle());
+            visionCallbacks=visionCallbacks||sensors[i]->_hasVisionCallback();
+        }
+    }
+    if (toHandle.size()==0)
+        return(0);
+
+    int retVal=0;
+    if (visionCallbacks)
+    {
+        for (size_t i=0;i<handles.size();i++)
+        { // a previous callback might have removed the sensor
+            CVisionSensor* it=App::currentWorld->sceneObjects->getVisionSensorFromHandle(handles[i]);
+            if ( (it!=nullptr)&&it->handleSensor() )
+                retVal++;
+        }
+        return(retVal);
+    }
+
+    App::worldContainer->calcInfo->visionSensorSimulationStart();
+
+    // 1. Render all sensors. Rendering doesn't modify the scene:
+    std::vector<CVisionSensor*> viaUiThread;
+    for (size_t i=0;i<toHandle.size();i++)
+    {
+        CVisionSensor* it=toHandle[i];
+        it->_readbackStallTimeInUs=0;
+        it->_renderTimeInUs=0;
+        if ( it->getUseDepthRayCasting()||it->_canRenderInCurrentThread() )
+            it->_renderForHandling();
+        else
+            viaUiThread.push_back(it);
+    }
+    if (viaUiThread.size()>0)
+    { // each sensor has its own context and FBO. We still group sensors of same resolution, drivers switch faster between same-sized surfaces:
+        std::stable_sort(viaUiThread.begin(),viaUiThread.end(),[](CVisionSensor* a,CVisionSensor* b){return(a->_resolutionX*a->_resolutionY<b->_resolutionX*b->_resolutionY);});
+        renderSensors_executedViaUiThread(viaUiThread);
+    }
+
+    // 2. Compute the return values, in the original order. No script is called here:
+    for (size_t i=0;i<toHandle.size();i++)
+    {
+        CVisionSensor* it=toHandle[i];
+        unsigned long long int stTime=VDateTime::getTimeInUs();
+        App::worldContainer->calcInfo->visionSensorReadbackAdd(it->_readbackStallTimeInUs);
+        bool detected=it->_computeDefaultReturnValuesAndApplyFilters();
+        it->sensorResult.sensorWasTriggered=detected;
+        it->_updateTexture();
+        it->sensorResult.calcTimeInMs=int((it->_renderTimeInUs+VDateTime::getTimeInUs()-stTime)/1000);
+        App::worldContainer->calcInfo->visionSensorSimulationAdd(detected);
+        if (detected)
+            retVal++;
+    }
+    App::worldContainer->calcInfo->visionSensorSimulationBatchEnd();
+    return(retVal);
+}
+
+bool CVisionSensor::_hasVisionCallback()
+{ // i.e. an attached child or customization script with a vision callback function
+    CLuaScriptObject* script=App::currentWorld->embeddedScriptContainer->getScriptFromObjectAttachedTo_child(_objectHandle);
+    if ( (script!=nullptr)&&script->getContainsVisionCallbackFunction() )
+        return(true);
+    script=App::currentWorld->embeddedScriptContainer->getScriptFromObjectAttachedTo_customization(_objectHandle);
+    return( (script!=nullptr)&&script->getContainsVisionCallbackFunction() );
+}
+
+void CVisionSensor::_clearSensorResult()
+{
     sensorAuxiliaryResult.clear();
     sensorResult.sensorWasTriggered=false;
     sensorResult.sensorResultIsValid=false;
@@ -720,18 +759,24 @@ bool CVisionSensor::handleSensor()
         sensorResult.sensorDataIntensity[i]=0;
         sensorResult.sensorDataDepth[i]=0.0f;
     }
-    if (!App::currentWorld->mainSettings->visionSensorsEnabled)
-        return(false);
-    if (_useExternalImage) // those 2 lines added on 2010/12/12
-        return(false);
-    int stTime=VDateTime::getTimeInMs();
-    detectEntity(_detectableEntityHandle,_detectableEntityHandle==-1,false,false,false);
+}
+
+void CVisionSensor::_updateTexture()
+{
 #ifdef SIM_WITH_OPENGL
     if (_contextFboAndTexture!=nullptr)
         _contextFboAndTexture->textureObject->setImage(false,false,true,_rgbBuffer); // Update the texture
 #endif
-    sensorResult.calcTimeInMs=VDateTime::getTimeDiffInMs(stTime);
-    return(sensorResult.sensorWasTriggered);
+}
+
+void CVisionSensor::_renderForHandling()
+{ // renders the detectable entity in the current thread, as handleSensor does
+    unsigned long long int stTime=VDateTime::getTimeInUs();
+    if (getUseDepthRayCasting())
+        _rayCastDepth(_detectableEntityHandle,_detectableEntityHandle==-1,false,false);
+    else
+        detectEntity2(_detectableEntityHandle,_detectableEntityHandle==-1,false,false,false);
+    _renderTimeInUs=VDateTime::getTimeInUs()-stTime;
 }
 
 bool CVisionSensor::checkSensor(int entityID,bool overrideRenderableFlagsForNonCollections)
@@ -873,7 +918,25 @@ bool CVisionSensor::detectEntity(int entityID,bool detectAll,bool entityIsModelA
     TRACE_INTERNAL;
     bool retVal=false;
     App::worldContainer->calcInfo->visionSensorSimulationStart();
+    _readbackStallTimeInUs=0;
+
+    if (getUseDepthRayCasting())
+        _rayCastDepth(entityID,detectAll,entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,overrideRenderableFlagsForNonCollections); // no OpenGL involved: runs in the current thread
+    else if (_canRenderInCurrentThread())
+        detectEntity2(entityID,detectAll,entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,hideEdgesIfModel,overrideRenderableFlagsForNonCollections);
+    else
+        detectVisionSensorEntity_executedViaUiThread(entityID,detectAll,entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,hideEdgesIfModel,overrideRenderableFlagsForNonCollections);
+    App::worldContainer->calcInfo->visionSensorReadbackAdd(_readbackStallTimeInUs);
 
+    retVal=_computeDefaultReturnValuesAndApplyFilters(); // this might overwrite the default return values
+    sensorResult.sensorWasTriggered=retVal;
+
+    App::worldContainer->calcInfo->visionSensorSimulationEnd(retVal);
+    return(retVal);
+}
+
+bool CVisionSensor::_canRenderInCurrentThread()
+{
     // Following strange construction needed so that we can
     // do all the initialization/rendering in the UI thread:
     // - if not using an offscreen type (otherwise big problems and crashes)
@@ -901,17 +964,7 @@ bool CVisionSensor::detectEntity(int entityID,bool detectAll,bool entityIsModelA
     bool ui=VThread::isCurrentThreadTheUiThread();
     bool noAuxThread=VThread::isCurrentThreadTheUiThread()||VThread::isCurrentThreadTheMainSimulationThread();
     bool offscreen=(App::userSettings->offscreenContextType<1);
-
-    if ( ui || ((noAuxThread&&offscreen)&&(!onlyGuiThread)) )
-        detectEntity2(entityID,detectAll,entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,hideEdgesIfModel,overrideRenderableFlagsForNonCollections);
-    else
-        detectVisionSensorEntity_executedViaUiThread(entityID,detectAll,entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,hideEdgesIfModel,overrideRenderableFlagsForNonCollections);
-
-    retVal=_computeDefaultReturnValuesAndApplyFilters(); // this might overwrite the default return values
-    sensorResult.sensorWasTriggered=retVal;
-
-    App::worldContainer->calcInfo->visionSensorSimulationEnd(retVal);
-    return(retVal);
+    return( ui || ((noAuxThread&&offscreen)&&(!onlyGuiThread)) );
 }
 
 void CVisionSensor::detectEntity2(int entityID,bool detectAll,bool entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,bool hideEdgesIfModel,bool overrideRenderableFlagsForNonCollections)
@@ -942,28 +995,34 @@ void CVisionSensor::detectEntity2(int entityID,bool detectAll,bool entityIsModel
     if (getInternalRendering())
     {
 #ifdef SIM_WITH_OPENGL
-        if (!_useExternalImage)
+        if ( (!_useExternalImage)&&((!_ignoreRGBInfo)||(!_ignoreDepthInfo)) )
         {
-            if (!_ignoreRGBInfo)
+            int asyncReadback=App::userSettings->visionSensorsAsyncReadback; // 0=direct, 1=pixel buffer objects, 2=pixel buffer objects with one frame latency
+            if ( (asyncReadback!=0)&&(_contextFboAndTexture->readback==nullptr) )
+                _contextFboAndTexture->readback=new CVisionSensorReadback(_resolutionX,_resolutionY);
+            if ( (asyncReadback!=0)&&_contextFboAndTexture->readback->isValid() )
             {
-                glPixelStorei(GL_PACK_ALIGNMENT,1);
-                glReadPixels(0,0,_resolutionX,_resolutionY,GL_RGB,GL_UNSIGNED_BYTE,_rgbBuffer);
-                glPixelStorei(GL_PACK_ALIGNMENT,4); // important to restore! Really?
+                if (_discardPendingReadback)
+                    _contextFboAndTexture->readback->discardPendingImages();
+                _contextFboAndTexture->readback->read(!_ignoreRGBInfo,!_ignoreDepthInfo,asyncReadback==2,_rgbBuffer,_depthBuffer);
+                _readbackStallTimeInUs=_contextFboAndTexture->readback->getLastStallTimeInUs();
             }
-            if (!_ignoreDepthInfo)
+            else
             {
-                glReadPixels(0,0,_resolutionX,_resolutionY,GL_DEPTH_COMPONENT,GL_FLOAT,_depthBuffer);
-                // Convert this depth info into values corresponding to linear depths (if perspective mode):
-                if (_perspectiveOperation)
+                unsigned long long int stTime=VDateTime::getTimeInUs();
+                if (!_ignoreRGBInfo)
                 {
-                    float farMinusNear= _farClippingPlane-_nearClippingPlane;
-                    float farDivFarMinusNear=_farClippingPlane/farMinusNear;
-                    float nearTimesFar=_nearClippingPlane*_farClippingPlane;
-                    int v=_resolutionX*_resolutionY;
-                    for (int i=0;i<v;i++)
-                        _depthBuffer[i]=((nearTimesFar/(farMinusNear*(farDivFarMinusNear-_depthBuffer[i])))-_nearClippingPlane)/farMinusNear;
+                    glPixelStorei(GL_PACK_ALIGNMENT,1);
+                    glReadPixels(0,0,_resolutionX,_resolutionY,GL_RGB,GL_UNSIGNED_BYTE,_rgbBuffer);
+                    glPixelStorei(GL_PACK_ALIGNMENT,4); // important to restore! Really?
                 }
+                if (!_ignoreDepthInfo)
+                    glReadPixels(0,0,_resolutionX,_resolutionY,GL_DEPTH_COMPONENT,GL_FLOAT,_depthBuffer);
+                _readbackStallTimeInUs=VDateTime::getTimeInUs()-stTime;
             }
+            _discardPendingReadback=false;
+            if ( (!_ignoreDepthInfo)&&_perspectiveOperation )
+                _linearizeDepthBuffer();
         }
 
         if (App::userSettings->useGlFinish_visionSensors) // false by default!
@@ -980,6 +1039,39 @@ void CVisionSensor::detectEntity2(int entityID,bool detectAll,bool entityIsModel
         _extRenderer_retrieveImage();
 }
 
+void CVisionSensor::_linearizeDepthBuffer()
+{ // Converts the OpenGL depth values into values corresponding to linear depths (perspective mode).
+  // Same formula as always, but with loop-invariant values and no aliasing, so that the compiler can vectorize it
+    const float nearPlane=_nearClippingPlane;
+    const float farMinusNear=_farClippingPlane-_nearClippingPlane;
+    const float farDivFarMinusNear=_farClippingPlane/farMinusNear;
+    const float nearTimesFar=_nearClippingPlane*_farClippingPlane;
+    const int pixelCount=_resolutionX*_resolutionY;
+    const int chunkSize=65536;
+    float* depth=_depthBuffer;
+    CWorkerPool::parallelFor((pixelCount+chunkSize-1)/chunkSize,[=](int chunk)
+    {
+        int end=std::min<int>(pixelCount,(chunk+1)*chunkSize);
+        for (int i=chunk*chunkSize;i<end;i++)
+            depth[i]=((nearTimesFar/(farMinusNear*(farDivFarMinusNear-depth[i])))-nearPlane)/farMinusNear;
+    });
+}
+
+void CVisionSensor::_rayCastDepth(int entityID,bool detectAll,bool entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,bool overrideRenderableFlagsForNonCollections)
+{ // if entityID is -1, all detectable objects are ray cast. Only the depth buffer is updated
+    TRACE_INTERNAL;
+    _currentPerspective=_perspectiveOperation;
+    std::vector<CSceneObject*> toRender;
+    CSceneObject* viewBoxObject=_getInfoOfWhatNeedsToBeRendered(entityID,detectAll,_attributesForRendering,entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,overrideRenderableFlagsForNonCollections,toRender);
+    std::vector<CSceneObject*> objects;
+    for (size_t i=0;i<toRender.size();i++)
+    { // the skybox follows the camera with OpenGL. We ignore it here
+        if ( (viewBoxObject==nullptr)||(toRender[i]->getParent()!=viewBoxObject) )
+            objects.push_back(toRender[i]);
+    }
+    CVisionSensorRayCaster::renderDepth(this,objects,_depthBuffer);
+}
+
 bool CVisionSensor::_extRenderer_prepareView(int extRendererIndex)
 {   // Set-up the resolution, clear color, camera properties and camera pose:
     bool retVal=CPluginContainer::selectExtRenderer(extRendererIndex);
@@ -1928,6 +2020,7 @@ void CVisionSensor::performDynMaterialObjectLoadingMapping(const std::vector<int
 void CVisionSensor::initializeInitialValues(bool simulationAlreadyRunning)
 { // is called at simulation start, but also after object(s) have been copied into a scene!
     CSceneObject::initializeInitialValues(simulationAlreadyRunning);
+    _discardPendingReadback=true; // an image from before would be returned otherwise, with one frame latency readback
     for (int i=0;i<3;i++)
     {
         sensorResult.sensorDataRed[i]=0;
@@ -1988,70 +2081,16 @@ bool CVisionSensor::_computeDefaultReturnValuesAndApplyFilters()
 
     if (_computeImageBasicStats&&(_renderMode!=sim_rendermode_colorcoded))
     {
-        unsigned int cumulRed=0;
-        unsigned int cumulGreen=0;
-        unsigned int cumulBlue=0;
-        unsigned int cumulIntensity=0;
-        float cumulDepth=0.0f;
-
-        // Initialize the min/max values with first element:
-        for (int i=0;i<2;i++)
-        {
-            sensorResult.sensorDataRed[i]=_rgbBuffer[0];
-            sensorResult.sensorDataGreen[i]=_rgbBuffer[1];
-            sensorResult.sensorDataBlue[i]=_rgbBuffer[2];
-            sensorResult.sensorDataIntensity[i]=(_rgbBuffer[0]+_rgbBuffer[1]+_rgbBuffer[2])/3;
-            sensorResult.sensorDataDepth[i]=_depthBuffer[0];
-        }
-
-        int v=_resolutionX*_resolutionY;
-        for (int i=0;i<v;i++)
+        SImageStats stats;
+        CImageKernels::getStats(_rgbBuffer,_depthBuffer,_resolutionX*_resolutionY,stats);
+        for (int i=0;i<3;i++)
         {
-            unsigned int intens=(_rgbBuffer[3*i+0]+_rgbBuffer[3*i+1]+_rgbBuffer[3*i+2])/3;
-            cumulRed+=_rgbBuffer[3*i+0];
-            cumulGreen+=_rgbBuffer[3*i+1];
-            cumulBlue+=_rgbBuffer[3*i+2];
-            cumulDepth+=_depthBuffer[i];
-            cumulIntensity+=intens;
-            // we actualize min/max values:
-            //r = (x < y) ? x : y
-            // Red
-            if (_rgbBuffer[3*i+0]<sensorResult.sensorDataRed[0])
-                sensorResult.sensorDataRed[0]=_rgbBuffer[3*i+0];
-            if (_rgbBuffer[3*i+0]>sensorResult.sensorDataRed[1])
-                sensorResult.sensorDataRed[1]=_rgbBuffer[3*i+0];
-            // Green
-            if (_rgbBuffer[3*i+1]<sensorResult.sensorDataGreen[0])
-                sensorResult.sensorDataGreen[0]=_rgbBuffer[3*i+1];
-            if (_rgbBuffer[3*i+1]>sensorResult.sensorDataGreen[1])
-                sensorResult.sensorDataGreen[1]=_rgbBuffer[3*i+1];
-            // Blue
-            if (_rgbBuffer[3*i+2]<sensorResult.sensorDataBlue[0])
-                sensorResult.sensorDataBlue[0]=_rgbBuffer[3*i+2];
-            if (_rgbBuffer[3*i+2]>sensorResult.sensorDataBlue[1])
-                sensorResult.sensorDataBlue[1]=_rgbBuffer[3*i+2];
-            // Intensity
-            if (intens<sensorResult.sensorDataIntensity[0])
-                sensorResult.sensorDataIntensity[0]=intens;
-            if (intens>sensorResult.sensorDataIntensity[1])
-                sensorResult.sensorDataIntensity[1]=intens;
-            // Depth
-            if (_depthBuffer[i]<sensorResult.sensorDataDepth[0])
-                sensorResult.sensorDataDepth[0]=_depthBuffer[i];
-            if (_depthBuffer[i]>sensorResult.sensorDataDepth[1])
-                sensorResult.sensorDataDepth[1]=_depthBuffer[i];
+            sensorResult.sensorDataRed[i]=stats.red[i];
+            sensorResult.sensorDataGreen[i]=stats.green[i];
+            sensorResult.sensorDataBlue[i]=stats.blue[i];
+            sensorResult.sensorDataIntensity[i]=stats.intensity[i];
+            sensorResult.sensorDataDepth[i]=stats.depth[i];
         }
-        unsigned char averageRed=cumulRed/v;
-        unsigned char averageGreen=cumulGreen/v;
-        unsigned char averageBlue=cumulBlue/v;
-        unsigned char averageIntensity=cumulIntensity/v;
-        float averageDepth=cumulDepth/float(v);
-        // We set-up average values:
-        sensorResult.sensorDataRed[2]=averageRed;
-        sensorResult.sensorDataGreen[2]=averageGreen;
-        sensorResult.sensorDataBlue[2]=averageBlue;
-        sensorResult.sensorDataIntensity[2]=averageIntensity;
-        sensorResult.sensorDataDepth[2]=averageDepth;
 
         // We prepare the auxiliary values:
         std::vector<float> defaultResults;
@@ -2711,10 +2750,51 @@ void CVisionSensor::detectVisionSensorEntity_executedViaUiThread(int entityID,bo
         cmdIn.boolParams.push_back(entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects);
         cmdIn.boolParams.push_back(hideEdgesIfModel);
         cmdIn.boolParams.push_back(overrideRenderableFlagsForNonCollections);
+        unsigned long long int stTime=VDateTime::getTimeInUs();
         App::uiThread->executeCommandViaUiThread(&cmdIn,&cmdOut);
+        if (cmdOut.uintParams.size()>0)
+            _addUiThreadHandoffTime(VDateTime::getTimeInUs()-stTime,cmdOut.uintParams[0]);
     }
 }
 
+unsigned long long int CVisionSensor::renderSensors_executedViaUiThread(const std::vector<CVisionSensor*>& sensors)
+{ // renders several sensors as in handleSensor, in one go. Returns the time spent rendering, in microseconds
+    TRACE_INTERNAL;
+    unsigned long long int retVal=0;
+    if (VThread::isCurrentThreadTheUiThread())
+    { // we are in the UI thread. We execute the command now:
+        for (size_t i=0;i<sensors.size();i++)
+        {
+            sensors[i]->_renderForHandling();
+            retVal+=sensors[i]->_renderTimeInUs;
+        }
+    }
+    else
+    { // We are NOT in the UI thread. We execute the command via the UI thread:
+        SUIThreadCommand cmdIn;
+        SUIThreadCommand cmdOut;
+        cmdIn.cmdId=RENDER_VISION_SENSORS_UITHREADCMD;
+        for (size_t i=0;i<sensors.size();i++)
+            cmdIn.objectParams.push_back(sensors[i]);
+        unsigned long long int stTime=VDateTime::getTimeInUs();
+        App::uiThread->executeCommandViaUiThread(&cmdIn,&cmdOut);
+        if (cmdOut.uintParams.size()>0)
+        {
+            retVal=cmdOut.uintParams[0];
+            _addUiThreadHandoffTime(VDateTime::getTimeInUs()-stTime,retVal);
+        }
+    }
+    return(retVal);
+}
+
+void CVisionSensor::_addUiThreadHandoffTime(unsigned long long int roundTripTimeInUs,unsigned long long int renderTimeInUs)
+{ // the part of a UI thread round trip not spent rendering
+    unsigned long long int handoffTime=0;
+    if (roundTripTimeInUs>renderTimeInUs)
+        handoffTime=roundTripTimeInUs-renderTimeInUs;
+    App::worldContainer->calcInfo->visionSensorUiThreadHandoffAdd(handoffTime);
+}
+
 void CVisionSensor::display(CViewableBase* renderingObject,int displayAttrib)
 {
     EASYLOCK(_objectMutex);
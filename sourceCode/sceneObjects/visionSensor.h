@@ -105,6 +105,8 @@ public:
     int getDetectableEntityHandle();
 
     void detectVisionSensorEntity_executedViaUiThread(int entityID,bool detectAll,bool entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,bool hideEdgesIfModel,bool overrideRenderableFlagsForNonCollections);
+    static unsigned long long int renderSensors_executedViaUiThread(const std::vector<CVisionSensor*>& sensors);
+    static int handleSensors(const std::vector<CVisionSensor*>& sensors);
     bool detectEntity(int entityID,bool detectAll,bool entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,bool hideEdgesIfModel,bool overrideRenderableFlagsForNonCollections);
     void detectEntity2(int entityID,bool detectAll,bool entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,bool hideEdgesIfModel,bool overrideRenderableFlagsForNonCollections);
     void renderForDetection(int entityID,bool detectAll,bool entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,bool hideEdgesIfModel,bool overrideRenderableFlagsForNonCollections,const std::vector<int>& activeMirrors);
@@ -115,6 +117,8 @@ public:
     bool getUseExternalImage();
     bool getInternalRendering();
     bool getApplyExternalRenderedImage();
+    bool getUseDepthRayCasting();
+    unsigned long long int getReadbackStallTimeInUs() const;
 
     void setExtWindowSizeAndPos(int sizeX,int sizeY,int posX,int posY);
     void getExtWindowSizeAndPos(int& sizeX,int& sizeY,int& posX,int& posY);
@@ -142,6 +146,14 @@ protected:
     void _clearBuffers();
 
     bool _computeDefaultReturnValuesAndApplyFilters();
+    void _linearizeDepthBuffer();
+    bool _canRenderInCurrentThread();
+    bool _hasVisionCallback();
+    void _renderForHandling();
+    void _clearSensorResult();
+    void _updateTexture();
+    static void _addUiThreadHandoffTime(unsigned long long int roundTripTimeInUs,unsigned long long int renderTimeInUs);
+    void _rayCastDepth(int entityID,bool detectAll,bool entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,bool overrideRenderableFlagsForNonCollections);
 
     CSceneObject* _getInfoOfWhatNeedsToBeRendered(int entityID,bool detectAll,int rendAttrib,bool entityIsModelAndRenderAllVisibleModelAlsoNonRenderableObjects,bool overrideRenderableFlagsForNonCollections,std::vector<CSceneObject*>& toRender);
 
@@ -154,6 +166,9 @@ protected:
     float* _depthBuffer;
 
     unsigned int _rayTracingTextureName;
+    unsigned long long int _readbackStallTimeInUs; // time waited for the GPU in the last detection
+    unsigned long long int _renderTimeInUs; // rendering time in the last handleSensors
+    bool _discardPendingReadback;
 
     int _extWindowedViewSize[2];
     int _extWindowedViewPos[2];
@@ -0,0 +1,240 @@
+#include "imageKernels.h"
+#include <cstring>
+
+#if defined(__GNUC__)&&!defined(__clang__)&&defined(__x86_64__)&&defined(__linux__)
+    #define IMAGE_KERNEL_DISPATCH
+    #define IMAGE_KERNEL __attribute__((target_clones("avx2","default"),optimize("tree-vectorize","vect-cost-model=dynamic")))
+#else
+    #define IMAGE_KERNEL
+#endif
+
+// The kernels keep the arithmetic of the loops they replace (same operations, same order), so that results are identical
+
+IMAGE_KERNEL static void _charToFloat(const unsigned char* __restrict src,float* __restrict dst,int cnt)
+{
+    for (int i=0;i<cnt;i++)
+        dst[i]=float(src[i])/255.0f;
+}
+
+IMAGE_KERNEL static void _floatToChar(const float* __restrict src,unsigned char* __restrict dst,int cnt)
+{
+    for (int i=0;i<cnt;i++)
+        dst[i]=(unsigned char)(src[i]*255.1f);
+}
+
+IMAGE_KERNEL static void _rgbToGreyFloat(const unsigned char* __restrict rgb,float* __restrict dst,int pixelCnt)
+{
+    for (int i=0;i<pixelCnt;i++)
+    {
+        float v=float(rgb[3*i+0])/255.0f;
+        v+=float(rgb[3*i+1])/255.0f;
+        v+=float(rgb[3*i+2])/255.0f;
+        dst[i]=v/3.0f;
+    }
+}
+
+IMAGE_KERNEL static void _rgbToGreyChar(const unsigned char* __restrict rgb,unsigned char* __restrict dst,int dstStride,int pixelCnt)
+{
+    if (dstStride==1)
+    {
+        for (int i=0;i<pixelCnt;i++)
+        {
+            unsigned int v=rgb[3*i+0];
+            v+=rgb[3*i+1];
+            v+=rgb[3*i+2];
+            dst[i]=(unsigned char)(v/3);
+        }
+    }
+    else
+    {
+        for (int i=0;i<pixelCnt;i++)
+        {
+            unsigned int v=rgb[3*i+0];
+            v+=rgb[3*i+1];
+            v+=rgb[3*i+2];
+            dst[i*dstStride]=(unsigned char)(v/3);
+        }
+    }
+}
+
+IMAGE_KERNEL static void _rgbToRgbaChar(const unsigned char* __restrict rgb,unsigned char* __restrict rgba,int pixelCnt)
+{
+    for (int i=0;i<pixelCnt;i++)
+    {
+        rgba[4*i+0]=rgb[3*i+0];
+        rgba[4*i+1]=rgb[3*i+1];
+        rgba[4*i+2]=rgb[3*i+2];
+    }
+}
+
+IMAGE_KERNEL static void _greyFloatToRgb(const float* __restrict src,unsigned char* __restrict rgb,int pixelCnt)
+{
+    for (int i=0;i<pixelCnt;i++)
+    {
+        unsigned char v=(unsigned char)(src[i]*255.1f);
+        rgb[3*i+0]=v;
+        rgb[3*i+1]=v;
+        rgb[3*i+2]=v;
+    }
+}
+
+IMAGE_KERNEL static void _greyCharToRgb(const unsigned char* __restrict src,unsigned char* __restrict rgb,int pixelCnt)
+{
+    for (int i=0;i<pixelCnt;i++)
+    {
+        rgb[3*i+0]=src[i];
+        rgb[3*i+1]=src[i];
+        rgb[3*i+2]=src[i];
+    }
+}
+
+IMAGE_KERNEL static void _depthThreshold(const float* __restrict depth,float threshold,unsigned char* __restrict dst,int dstStride,int pixelCnt)
+{
+    for (int i=0;i<pixelCnt;i++)
+        dst[i*dstStride]=(depth[i]>threshold)?0:255;
+}
+
+IMAGE_KERNEL static void _getRgbStats(const unsigned char* __restrict rgb,int pixelCnt,unsigned char mins[4],unsigned char maxs[4],unsigned int sums[4])
+{ // red, green, blue and intensity
+    unsigned char minR=rgb[0],minG=rgb[1],minB=rgb[2];
+    unsigned char maxR=minR,maxG=minG,maxB=minB;
+    unsigned char minI=(unsigned char)((rgb[0]+rgb[1]+rgb[2])/3);
+    unsigned char maxI=minI;
+    unsigned int sumR=0,sumG=0,sumB=0,sumI=0;
+    for (int i=0;i<pixelCnt;i++)
+    {
+        unsigned char r=rgb[3*i+0];
+        unsigned char g=rgb[3*i+1];
+        unsigned char b=rgb[3*i+2];
+        unsigned char intens=(unsigned char)((r+g+b)/3);
+        sumR+=r;
+        sumG+=g;
+        sumB+=b;
+        sumI+=intens;
+        minR=(r<minR)?r:minR;
+        maxR=(r>maxR)?r:maxR;
+        minG=(g<minG)?g:minG;
+        maxG=(g>maxG)?g:maxG;
+        minB=(b<minB)?b:minB;
+        maxB=(b>maxB)?b:maxB;
+        minI=(intens<minI)?intens:minI;
+        maxI=(intens>maxI)?intens:maxI;
+    }
+    mins[0]=minR;
+    mins[1]=minG;
+    mins[2]=minB;
+    mins[3]=minI;
+    maxs[0]=maxR;
+    maxs[1]=maxG;
+    maxs[2]=maxB;
+    maxs[3]=maxI;
+    sums[0]=sumR;
+    sums[1]=sumG;
+    sums[2]=sumB;
+    sums[3]=sumI;
+}
+
+IMAGE_KERNEL static void _getDepthMinMax(const float* __restrict depth,int pixelCnt,float minMax[2])
+{
+    float minD=depth[0];
+    float maxD=minD;
+    for (int i=0;i<pixelCnt;i++)
+    {
+        float d=depth[i];
+        minD=(d<minD)?d:minD;
+        maxD=(d>maxD)?d:maxD;
+    }
+    minMax[0]=minD;
+    minMax[1]=maxD;
+}
+
+const char* CImageKernels::getInstructionSet()
+{
+#ifdef IMAGE_KERNEL_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return("avx2");
+#endif
+    return("default");
+}
+
+void CImageKernels::charToFloat(const unsigned char* src,float* dst,int cnt)
+{ // 0-255 --> 0.0-1.0
+    _charToFloat(src,dst,cnt);
+}
+
+void CImageKernels::floatToChar(const float* src,unsigned char* dst,int cnt)
+{ // 0.0-1.0 --> 0-255
+    _floatToChar(src,dst,cnt);
+}
+
+void CImageKernels::rgbToGreyFloat(const unsigned char* rgb,float* dst,int pixelCnt)
+{
+    _rgbToGreyFloat(rgb,dst,pixelCnt);
+}
+
+void CImageKernels::rgbToGreyChar(const unsigned char* rgb,unsigned char* dst,int dstStride,int pixelCnt)
+{ // dstStride allows writing into an interleaved image (e.g. grey + alpha)
+    _rgbToGreyChar(rgb,dst,dstStride,pixelCnt);
+}
+
+void CImageKernels::rgbToRgbaChar(const unsigned char* rgb,unsigned char* rgba,int pixelCnt)
+{ // the alpha channel is not touched
+    _rgbToRgbaChar(rgb,rgba,pixelCnt);
+}
+
+void CImageKernels::greyFloatToRgb(const float* src,unsigned char* rgb,int pixelCnt)
+{
+    _greyFloatToRgb(src,rgb,pixelCnt);
+}
+
+void CImageKernels::greyCharToRgb(const unsigned char* src,unsigned char* rgb,int pixelCnt)
+{
+    _greyCharToRgb(src,rgb,pixelCnt);
+}
+
+void CImageKernels::depthThreshold(const float* depth,float threshold,unsigned char* dst,int dstStride,int pixelCnt)
+{ // dst is 0 where the depth is above the threshold, otherwise 255. dstStride allows writing into an interleaved image (e.g. an alpha channel)
+    _depthThreshold(depth,threshold,dst,dstStride,pixelCnt);
+}
+
+void CImageKernels::copyRegion(const unsigned char* src,int srcResX,int posX,int posY,int sizeX,int sizeY,int valPerPixel,unsigned char* dst)
+{ // copies a rectangular region row by row into a contiguous buffer
+    for (int j=0;j<sizeY;j++)
+        std::memcpy(dst+j*sizeX*valPerPixel,src+((posY+j)*srcResX+posX)*valPerPixel,sizeX*valPerPixel);
+}
+
+void CImageKernels::copyRegion(const float* src,int srcResX,int posX,int posY,int sizeX,int sizeY,int valPerPixel,float* dst)
+{
+    for (int j=0;j<sizeY;j++)
+        std::memcpy(dst+j*sizeX*valPerPixel,src+((posY+j)*srcResX+posX)*valPerPixel,sizeX*valPerPixel*sizeof(float));
+}
+
+void CImageKernels::getStats(const unsigned char* rgb,const float* depth,int pixelCnt,SImageStats& stats)
+{
+    unsigned char mins[4];
+    unsigned char maxs[4];
+    unsigned int sums[4];
+    float depthMinMax[2];
+    _getRgbStats(rgb,pixelCnt,mins,maxs,sums);
+    _getDepthMinMax(depth,pixelCnt,depthMinMax);
+    // A float sum can't be vectorized without changing its result. We keep it in a separate loop:
+    float depthSum=0.0f;
+    for (int i=0;i<pixelCnt;i++)
+        depthSum+=depth[i];
+    stats.red[0]=mins[0];
+    stats.red[1]=maxs[0];
+    stats.red[2]=sums[0]/pixelCnt;
+    stats.green[0]=mins[1];
+    stats.green[1]=maxs[1];
+    stats.green[2]=sums[1]/pixelCnt;
+    stats.blue[0]=mins[2];
+    stats.blue[1]=maxs[2];
+    stats.blue[2]=sums[2]/pixelCnt;
+    stats.intensity[0]=mins[3];
+    stats.intensity[1]=maxs[3];
+    stats.intensity[2]=sums[3]/pixelCnt;
+    stats.depth[0]=depthMinMax[0];
+    stats.depth[1]=depthMinMax[1];
+    stats.depth[2]=depthSum/float(pixelCnt);
+}
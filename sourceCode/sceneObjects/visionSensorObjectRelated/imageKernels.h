@@ -0,0 +1,32 @@
+#pragma once
+
+struct SImageStats
+{ // min, max and average values, as in SHandlingResult
+    unsigned char red[3];
+    unsigned char green[3];
+    unsigned char blue[3];
+    unsigned char intensity[3];
+    float depth[3];
+};
+
+// FULLY STATIC CLASS
+// Pixel loops used by vision sensors for image conversion, readout and statistics. Each kernel works on
+// contiguous runs of pixels, without per-pixel index math, so that the compiler can vectorize it. Where
+// supported (GCC on Linux x86_64), the kernels are also compiled for AVX2 and the best version is selected at run time
+class CImageKernels
+{
+public:
+    static const char* getInstructionSet();
+
+    static void charToFloat(const unsigned char* src,float* dst,int cnt);
+    static void floatToChar(const float* src,unsigned char* dst,int cnt);
+    static void rgbToGreyFloat(const unsigned char* rgb,float* dst,int pixelCnt);
+    static void rgbToGreyChar(const unsigned char* rgb,unsigned char* dst,int dstStride,int pixelCnt);
+    static void rgbToRgbaChar(const unsigned char* rgb,unsigned char* rgba,int pixelCnt);
+    static void greyFloatToRgb(const float* src,unsigned char* rgb,int pixelCnt);
+    static void greyCharToRgb(const unsigned char* src,unsigned char* rgb,int pixelCnt);
+    static void depthThreshold(const float* depth,float threshold,unsigned char* dst,int dstStride,int pixelCnt);
+    static void copyRegion(const unsigned char* src,int srcResX,int posX,int posY,int sizeX,int sizeY,int valPerPixel,unsigned char* dst);
+    static void copyRegion(const float* src,int srcResX,int posX,int posY,int sizeX,int sizeY,int valPerPixel,float* dst);
+    static void getStats(const unsigned char* rgb,const float* depth,int pixelCnt,SImageStats& stats);
+};
@@ -19,6 +19,8 @@ CVisionSensorGlStuff::CVisionSensorGlStuff(int resX,int resY,int offscreenType,b
     // 3. We need a texture object:
     textureObject=new CTextureObject(resX,resY);
 
+    readback=nullptr;
+
 //  CGlShader* a=new CGlShader();
 
     offscreenContext->doneCurrent();
@@ -28,6 +30,7 @@ CVisionSensorGlStuff::~CVisionSensorGlStuff()
 {
     TRACE_INTERNAL;
     offscreenContext->makeCurrent();
+    delete readback;
     delete textureObject;
     delete frameBufferObject;
     offscreenContext->doneCurrent();
@@ -3,6 +3,7 @@
 #include "offscreenGlContext.h"
 #include "frameBufferObject.h"
 #include "textureObject.h"
+#include "visionSensorReadback.h"
 
 class CVisionSensorGlStuff : public QObject
 {
@@ -21,6 +22,7 @@ public:
     COffscreenGlContext* offscreenContext;
     CFrameBufferObject* frameBufferObject;
     CTextureObject* textureObject;
+    CVisionSensorReadback* readback; // created when asynchronous readback is first used
 protected:
     bool _destroyOffscreenContext;
 };
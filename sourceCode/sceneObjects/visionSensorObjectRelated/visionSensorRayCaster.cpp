@@ -0,0 +1,181 @@
+#include "visionSensorRayCaster.h"
+#include "visionSensor.h"
+#include "shape.h"
+#include "octree.h"
+#include "pluginContainer.h"
+#include "workerPool.h"
+#include <algorithm>
+
+const int RAY_CAST_TILE_SIZE=16;
+
+void CVisionSensorRayCaster::renderDepth(CVisionSensor* sensor,const std::vector<CSceneObject*>& objects,float* depthBuffer)
+{ // Produces the same linearized depth values as the OpenGL path (0.0 at the near, 1.0 at the far clipping plane).
+  // Only shapes and octrees are seen
+    int res[2];
+    sensor->getRealResolution(res);
+    float nearPlane=sensor->getNearClippingPlane();
+    float farPlane=sensor->getFarClippingPlane();
+    bool perspective=sensor->getPerspectiveOperation();
+
+    // Same frustum as in CVisionSensor::renderForDetection. halfX/halfY are tangents of the half view angles in perspective mode, otherwise half view sizes:
+    float ratio=float(res[0])/float(res[1]);
+    float h=sensor->getOrthoViewSize()*0.5f;
+    if (perspective)
+        h=tan(sensor->getViewAngle()*0.5f);
+    float halfX=h;
+    float halfY=h;
+    if (ratio>1.0f)
+        halfY=h/ratio;
+    else
+        halfX=h*ratio;
+
+    // Prepare the targets, with the pixel rectangle they cover:
+    C7Vector sensorTrInv(sensor->getFullCumulativeTransformation().getInverse());
+    std::vector<SRayCastTarget> targets;
+    for (size_t i=0;i<objects.size();i++)
+    {
+        SRayCastTarget target;
+        C7Vector boxTr;
+        C3Vector halfSize;
+        if (objects[i]->getObjectType()==sim_object_shape_type)
+        {
+            CShape* shape=(CShape*)objects[i];
+            shape->initializeMeshCalculationStructureIfNeeded();
+            target.calcStruct=shape->_meshCalculationStructure;
+            target.isOctree=false;
+            target.tr=sensorTrInv*shape->getFullCumulativeTransformation();
+            boxTr=target.tr;
+            halfSize=shape->getBoundingBoxHalfSizes();
+        }
+        else if (objects[i]->getObjectType()==sim_object_octree_type)
+        {
+            COctree* octree=(COctree*)objects[i];
+            target.calcStruct=octree->getOctreeInfo();
+            target.isOctree=true;
+            target.tr=sensorTrInv*octree->getFullCumulativeTransformation();
+            octree->getTransfAndHalfSizeOfBoundingBox(boxTr,halfSize);
+            boxTr=sensorTrInv*boxTr;
+        }
+        else
+            continue;
+        if ( (target.calcStruct!=nullptr)&&_getScreenRect(boxTr,halfSize,perspective,halfX,halfY,nearPlane,farPlane,res,target.rect) )
+            targets.push_back(target);
+    }
+
+    int tilesX=(res[0]+RAY_CAST_TILE_SIZE-1)/RAY_CAST_TILE_SIZE;
+    int tilesY=(res[1]+RAY_CAST_TILE_SIZE-1)/RAY_CAST_TILE_SIZE;
+    CWorkerPool::parallelFor(tilesX*tilesY,[&](int tile)
+    {
+        int x0=(tile%tilesX)*RAY_CAST_TILE_SIZE;
+        int y0=(tile/tilesX)*RAY_CAST_TILE_SIZE;
+        int x1=std::min<int>(x0+RAY_CAST_TILE_SIZE,res[0])-1;
+        int y1=std::min<int>(y0+RAY_CAST_TILE_SIZE,res[1])-1;
+        std::vector<const SRayCastTarget*> candidates;
+        for (size_t i=0;i<targets.size();i++)
+        {
+            const int* r=targets[i].rect;
+            if ( (r[0]<=x1)&&(r[2]>=x0)&&(r[1]<=y1)&&(r[3]>=y0) )
+                candidates.push_back(&targets[i]);
+        }
+        for (int y=y0;y<=y1;y++)
+        {
+            for (int x=x0;x<=x1;x++)
+            {
+                float depth=1.0f;
+                if (candidates.size()>0)
+                {
+                    // Pixel centers. Row 0 is the bottom row, and the sensor's x axis points to the image's left:
+                    float u=2.0f*(float(x)+0.5f)/float(res[0])-1.0f;
+                    float v=2.0f*(float(y)+0.5f)/float(res[1])-1.0f;
+                    C3Vector rayStart,rayVect;
+                    if (perspective)
+                    {
+                        C3Vector dir(-u*halfX,v*halfY,1.0f);
+                        rayStart=dir*nearPlane;
+                        rayVect=dir*(farPlane-nearPlane);
+                    }
+                    else
+                    {
+                        rayStart=C3Vector(-u*halfX,v*halfY,nearPlane);
+                        rayVect=C3Vector(0.0f,0.0f,farPlane-nearPlane);
+                    }
+                    float dist=SIM_MAX_FLOAT;
+                    bool hit=false;
+                    C3Vector pt;
+                    for (size_t i=0;i<candidates.size();i++)
+                    {
+                        const SRayCastTarget* t=candidates[i];
+                        const int* r=t->rect;
+                        if ( (x<r[0])||(x>r[2])||(y<r[1])||(y>r[3]) )
+                            continue;
+                        if (t->isOctree)
+                            hit=CPluginContainer::geomPlugin_raySensorDetectOctreeIfSmaller(rayStart,rayVect,t->calcStruct,t->tr,dist,0.0f,false,true,true,0.0f,&pt)||hit;
+                        else
+                            hit=CPluginContainer::geomPlugin_raySensorDetectMeshIfSmaller(rayStart,rayVect,t->calcStruct,t->tr,dist,0.0f,false,true,true,0.0f,&pt)||hit;
+                    }
+                    if (hit)
+                        depth=std::min<float>(1.0f,std::max<float>(0.0f,(pt(2)-nearPlane)/(farPlane-nearPlane)));
+                }
+                depthBuffer[y*res[0]+x]=depth;
+            }
+        }
+    });
+}
+
+bool CVisionSensorRayCaster::_getScreenRect(const C7Vector& boxTr,const C3Vector& halfSize,bool perspective,float halfX,float halfY,float nearPlane,float farPlane,const int res[2],int rect[4])
+{ // conservative pixel rectangle covered by a box (relative to the sensor). Returns false if the box can't be seen
+    float minU=SIM_MAX_FLOAT;
+    float maxU=-SIM_MAX_FLOAT;
+    float minV=SIM_MAX_FLOAT;
+    float maxV=-SIM_MAX_FLOAT;
+    bool allBeforeNear=true;
+    bool allBehindFar=true;
+    bool behindEye=false;
+    for (int i=0;i<8;i++)
+    {
+        C3Vector corner(halfSize(0)*((i&1)?1.0f:-1.0f),halfSize(1)*((i&2)?1.0f:-1.0f),halfSize(2)*((i&4)?1.0f:-1.0f));
+        corner=boxTr*corner;
+        if (corner(2)>=nearPlane)
+            allBeforeNear=false;
+        if (corner(2)<=farPlane)
+            allBehindFar=false;
+        float s=1.0f;
+        if (perspective)
+        {
+            if (corner(2)<=0.0f)
+            {
+                behindEye=true;
+                continue;
+            }
+            s=1.0f/corner(2);
+        }
+        float u=-corner(0)*s/halfX;
+        float v=corner(1)*s/halfY;
+        minU=std::min<float>(minU,u);
+        maxU=std::max<float>(maxU,u);
+        minV=std::min<float>(minV,v);
+        maxV=std::max<float>(maxV,v);
+    }
+    if (allBeforeNear||allBehindFar)
+        return(false);
+    if (behindEye)
+    { // the projection is not bounded: take the whole image
+        rect[0]=0;
+        rect[1]=0;
+        rect[2]=res[0]-1;
+        rect[3]=res[1]-1;
+        return(true);
+    }
+    minU=std::max<float>(minU,-1.0f);
+    maxU=std::min<float>(maxU,1.0f);
+    minV=std::max<float>(minV,-1.0f);
+    maxV=std::min<float>(maxV,1.0f);
+    if ( (minU>maxU)||(minV>maxV) )
+        return(false); // outside of the view
+    // to pixels, with a one pixel margin:
+    rect[0]=std::max<int>(0,int(floor((minU+1.0f)*0.5f*float(res[0])))-1);
+    rect[2]=std::min<int>(res[0]-1,int(ceil((maxU+1.0f)*0.5f*float(res[0])))+1);
+    rect[1]=std::max<int>(0,int(floor((minV+1.0f)*0.5f*float(res[1])))-1);
+    rect[3]=std::min<int>(res[1]-1,int(ceil((maxV+1.0f)*0.5f*float(res[1])))+1);
+    return( (rect[0]<=rect[2])&&(rect[1]<=rect[3]) );
+}
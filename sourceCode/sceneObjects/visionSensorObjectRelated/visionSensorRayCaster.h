@@ -0,0 +1,25 @@
+#pragma once
+
+#include "sceneObject.h"
+
+class CVisionSensor;
+
+struct SRayCastTarget
+{
+    const void* calcStruct; // mesh or octree calculation structure
+    bool isOctree;
+    C7Vector tr; // relative to the sensor
+    int rect[4]; // covered pixels: minX, minY, maxX, maxY
+};
+
+// FULLY STATIC CLASS
+// Depth-only rendering of a vision sensor without OpenGL: one ray per pixel, cast through the geometry
+// plugin's mesh and octree calculation structures. Tiles of pixels are handled by the worker pool
+class CVisionSensorRayCaster
+{
+public:
+    static void renderDepth(CVisionSensor* sensor,const std::vector<CSceneObject*>& objects,float* depthBuffer);
+
+private:
+    static bool _getScreenRect(const C7Vector& boxTr,const C3Vector& halfSize,bool perspective,float halfX,float halfY,float nearPlane,float farPlane,const int res[2],int rect[4]);
+};
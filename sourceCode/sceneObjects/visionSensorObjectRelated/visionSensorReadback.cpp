@@ -0,0 +1,132 @@
+#include "visionSensorReadback.h"
+#include "oGL.h"
+#include "vDateTime.h"
+#include <cstring>
+
+CVisionSensorReadback::CVisionSensorReadback(int resX,int resY)
+{ // the sensor's GL context must be current
+    _resX=resX;
+    _resY=resY;
+    _valid=true;
+    _nextSlot=0;
+    _lastStallTimeInUs=0;
+    for (size_t i=0;i<2;i++)
+    {
+        _pendingRgb[i]=false;
+        _pendingDepth[i]=false;
+        _rgbBuffers[i]=new QGLBuffer(QGLBuffer::PixelPackBuffer);
+        _depthBuffers[i]=new QGLBuffer(QGLBuffer::PixelPackBuffer);
+        QGLBuffer* buffers[2]={_rgbBuffers[i],_depthBuffers[i]};
+        int sizes[2]={3*resX*resY,int(sizeof(float))*resX*resY};
+        for (size_t j=0;j<2;j++)
+        {
+            if (buffers[j]->create()&&buffers[j]->bind())
+            {
+                buffers[j]->setUsagePattern(QGLBuffer::StreamRead);
+                buffers[j]->allocate(sizes[j]);
+                buffers[j]->release();
+            }
+            else
+                _valid=false; // pixel buffer objects not supported
+        }
+    }
+}
+
+CVisionSensorReadback::~CVisionSensorReadback()
+{ // the sensor's GL context must be current
+    for (size_t i=0;i<2;i++)
+    {
+        _rgbBuffers[i]->destroy();
+        delete _rgbBuffers[i];
+        _depthBuffers[i]->destroy();
+        delete _depthBuffers[i];
+    }
+}
+
+bool CVisionSensorReadback::isValid() const
+{
+    return(_valid);
+}
+
+void CVisionSensorReadback::read(bool rgb,bool depth,bool withLatency,unsigned char* rgbBuffer,float* depthBuffer)
+{ // the sensor's FBO must be bound, with the new image rendered
+    _lastStallTimeInUs=0;
+    if (withLatency)
+    {
+        int slot=_nextSlot;
+        int previousSlot=1-slot;
+        _startRead(slot,rgb,depth);
+        _nextSlot=previousSlot;
+        if ( (_pendingRgb[previousSlot]==rgb)&&(_pendingDepth[previousSlot]==depth) )
+            _finishRead(previousSlot,rgbBuffer,depthBuffer);
+        else
+        { // first image, or other buffers requested than last time: we have to wait for the current image
+            _pendingRgb[previousSlot]=false;
+            _pendingDepth[previousSlot]=false;
+            _finishRead(slot,rgbBuffer,depthBuffer);
+        }
+    }
+    else
+    {
+        _startRead(0,rgb,depth);
+        _finishRead(0,rgbBuffer,depthBuffer);
+        _pendingRgb[0]=false;
+        _pendingDepth[0]=false;
+    }
+}
+
+void CVisionSensorReadback::discardPendingImages()
+{ // e.g. when a new simulation starts, the image of the previous call is not relevant anymore
+    for (size_t i=0;i<2;i++)
+    {
+        _pendingRgb[i]=false;
+        _pendingDepth[i]=false;
+    }
+}
+
+unsigned long long int CVisionSensorReadback::getLastStallTimeInUs() const
+{
+    return(_lastStallTimeInUs);
+}
+
+void CVisionSensorReadback::_startRead(int slot,bool rgb,bool depth)
+{ // queues the transfers, without waiting
+    if (rgb)
+    {
+        _rgbBuffers[slot]->bind();
+        glPixelStorei(GL_PACK_ALIGNMENT,1);
+        glReadPixels(0,0,_resX,_resY,GL_RGB,GL_UNSIGNED_BYTE,nullptr);
+        glPixelStorei(GL_PACK_ALIGNMENT,4);
+        _rgbBuffers[slot]->release();
+    }
+    if (depth)
+    {
+        _depthBuffers[slot]->bind();
+        glReadPixels(0,0,_resX,_resY,GL_DEPTH_COMPONENT,GL_FLOAT,nullptr);
+        _depthBuffers[slot]->release();
+    }
+    _pendingRgb[slot]=rgb;
+    _pendingDepth[slot]=depth;
+}
+
+void CVisionSensorReadback::_finishRead(int slot,unsigned char* rgbBuffer,float* depthBuffer)
+{ // waits for the transfers of a slot. The slot stays readable until it is reused
+    unsigned long long int stTime=VDateTime::getTimeInUs();
+    if (_pendingRgb[slot])
+        _copyFromBuffer(_rgbBuffers[slot],rgbBuffer,3*_resX*_resY);
+    if (_pendingDepth[slot])
+        _copyFromBuffer(_depthBuffers[slot],depthBuffer,int(sizeof(float))*_resX*_resY);
+    _lastStallTimeInUs+=VDateTime::getTimeInUs()-stTime;
+}
+
+void CVisionSensorReadback::_copyFromBuffer(QGLBuffer* buffer,void* dest,int size)
+{
+    buffer->bind();
+    void* data=buffer->map(QGLBuffer::ReadOnly);
+    if (data!=nullptr)
+    {
+        std::memcpy(dest,data,size);
+        buffer->unmap();
+    }
+    buffer->release();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <QGLBuffer>
+
+// Reads a vision sensor's RGB and depth images back through two sets of pixel buffer objects.
+// glReadPixels into a pixel buffer object returns immediately: we only wait when mapping the buffer.
+// With latency, the image of the previous call is returned while the current one is being transferred
+class CVisionSensorReadback
+{
+public:
+    CVisionSensorReadback(int resX,int resY);
+    virtual ~CVisionSensorReadback();
+
+    bool isValid() const;
+    void read(bool rgb,bool depth,bool withLatency,unsigned char* rgbBuffer,float* depthBuffer);
+    void discardPendingImages();
+    unsigned long long int getLastStallTimeInUs() const;
+
+private:
+    void _startRead(int slot,bool rgb,bool depth);
+    void _finishRead(int slot,unsigned char* rgbBuffer,float* depthBuffer);
+    static void _copyFromBuffer(QGLBuffer* buffer,void* dest,int size);
+
+    int _resX;
+    int _resY;
+    bool _valid;
+    QGLBuffer* _rgbBuffers[2];
+    QGLBuffer* _depthBuffers[2];
+    bool _pendingRgb[2];
+    bool _pendingDepth[2];
+    int _nextSlot;
+    unsigned long long int _lastStallTimeInUs;
+};
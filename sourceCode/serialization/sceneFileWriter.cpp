@@ -0,0 +1,115 @@
+#include "sceneFileWriter.h"
+#include "ser.h"
+#include "vFile.h"
+#include "vDateTime.h"
+#include <thread>
+#include <mutex>
+
+static std::mutex _mutex;
+static std::thread _thread;
+static bool _busy=false;
+static bool _finished=false;
+static std::string _pathAndFilename;
+static std::vector<char> _header;
+static std::vector<unsigned char> _data;
+static bool _compress=false;
+static bool _success=false;
+static int _compressionTimeInMs=0;
+static int _writeTimeInMs=0;
+
+struct SSceneFileWriterGuard
+{ // in case waitUntilDone was not called, e.g. when the library is unloaded without clean-up
+    ~SSceneFileWriterGuard()
+    {
+        if (_thread.joinable())
+            _thread.detach();
+    }
+};
+static SSceneFileWriterGuard _guard;
+
+bool CSceneFileWriter::startWrite(const char* pathAndFilename,std::vector<char>& header,std::vector<unsigned char>& data,bool compress)
+{
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (_busy)
+            return(false);
+        _busy=true;
+        _finished=false;
+    }
+    if (_thread.joinable())
+        _thread.join(); // previous write, already done
+    _pathAndFilename=pathAndFilename;
+    _header.clear();
+    _header.swap(header);
+    _data.clear();
+    _data.swap(data);
+    _compress=compress;
+    _thread=std::thread(_writeThread);
+    return(true);
+}
+
+bool CSceneFileWriter::isBusy()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return(_busy);
+}
+
+bool CSceneFileWriter::getFinishedWrite(std::string& pathAndFilename,bool& success,int& compressionTimeInMs,int& writeTimeInMs)
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    if (!_finished)
+        return(false);
+    _finished=false;
+    pathAndFilename=_pathAndFilename;
+    success=_success;
+    compressionTimeInMs=_compressionTimeInMs;
+    writeTimeInMs=_writeTimeInMs;
+    return(true);
+}
+
+void CSceneFileWriter::waitUntilDone()
+{
+    if (_thread.joinable())
+        _thread.join();
+}
+
+void CSceneFileWriter::_writeThread()
+{ // the target file is never left half-written: we write to a temporary file first
+    unsigned long long int stTime=VDateTime::getTimeInUs();
+    std::vector<unsigned char> compressed;
+    std::vector<unsigned char>* data=&_data;
+    if (_compress)
+    {
+        CSer::compressData(_data,compressed);
+        data=&compressed;
+    }
+    unsigned long long int compressionTime=VDateTime::getTimeInUs()-stTime;
+
+    stTime=VDateTime::getTimeInUs();
+    std::string tmpFile(_pathAndFilename+".tmp");
+    bool success=false;
+    {
+        VFile file(tmpFile.c_str(),VFile::CREATE_WRITE|VFile::SHARE_EXCLUSIVE,true);
+        if (file.getFile()!=nullptr)
+        {
+            file.getFile()->write(&_header[0],_header.size());
+            file.getFile()->write((const char*)&data->at(0),data->size());
+            success=file.flush();
+            file.close();
+        }
+    }
+    if (success)
+        success=VFile::replaceFile(tmpFile.c_str(),_pathAndFilename.c_str());
+    if (!success)
+        VFile::eraseFile(tmpFile.c_str());
+    unsigned long long int writeTime=VDateTime::getTimeInUs()-stTime;
+
+    _header.clear();
+    _data.clear();
+    std::unique_lock<std::mutex> lock(_mutex);
+    _success=success;
+    _compressionTimeInMs=int(compressionTime/1000);
+    _writeTimeInMs=int(writeTime/1000);
+    _finished=true;
+    _busy=false;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// FULLY STATIC CLASS
+// Writes binary scene files from a background thread: the data, as produced by CSer::writeCloseWithoutCompressing,
+// is compressed there and written to a temporary file, which then replaces the target file. One write at a time
+class CSceneFileWriter
+{
+public:
+    static bool startWrite(const char* pathAndFilename,std::vector<char>& header,std::vector<unsigned char>& data,bool compress); // buffers are taken over. False if a write is still in progress
+    static bool isBusy();
+    static bool getFinishedWrite(std::string& pathAndFilename,bool& success,int& compressionTimeInMs,int& writeTimeInMs); // reports each write once
+    static void waitUntilDone();
+
+private:
+    static void _writeThread();
+};
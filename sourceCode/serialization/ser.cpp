@@ -9,6 +9,7 @@
 #include "imgLoaderSaver.h"
 #include "pluginContainer.h"
 #include "simFlavor.h"
+#include "workerPool.h"
 
 int CSer::SER_SERIALIZATION_VERSION=22; // 9 since 2008/09/01,
                                         // 10 since 2009/02/14,
@@ -79,6 +80,8 @@ void CSer::_commonInit()
     _fileBuffer.reserve(1000000);
     _fileBuffer.clear();
     _fileBufferReadPointer=0;
+    _thumbnailSectionStart=-1;
+    _thumbnailSectionEnd=-1;
     _foundUnknownCommands=false;
 }
 
@@ -87,9 +90,9 @@ bool CSer::writeOpenBinary(bool compress)
     bool retVal=false;
     _storing=true;
     _compress=compress;
-    if ( (_filetype==filetype_csim_bin_scene_file)||(_filetype==filetype_csim_bin_model_file)||
+    if ( (_bufferArchive==nullptr)&&( (_filetype==filetype_csim_bin_scene_file)||(_filetype==filetype_csim_bin_model_file)||
          (_filetype==filetype_xr_bin_scene_file)||(_filetype==filetype_xr_bin_model_file)||
-         (_filetype==filetype_csim_bin_thumbnails_file)||(_filetype==filetype_csim_bin_ui_file) )
+         (_filetype==filetype_csim_bin_thumbnails_file)||(_filetype==filetype_csim_bin_ui_file) ) )
     {
         theFile=new VFile(_filename.c_str(),VFile::CREATE_WRITE|VFile::SHARE_EXCLUSIVE,true);
         if (theFile->getFile()!=nullptr)
@@ -105,6 +108,8 @@ bool CSer::writeOpenBinary(bool compress)
     }
     if ( (_filetype==filetype_csim_bin_scene_buff)||(_filetype==filetype_csim_bin_model_buff) )
         retVal=true;
+    if ( (_bufferArchive!=nullptr)&&((_filetype==filetype_csim_bin_scene_file)||(_filetype==filetype_csim_bin_model_file)) )
+        retVal=true; // file content serialized into memory, e.g. written later by CSceneFileWriter
     return(retVal);
 }
 
@@ -153,6 +158,9 @@ void CSer::writeClose()
         _writeXmlFooter();
     else
     { // we write the whole file from the fileBuffer:
+        std::vector<unsigned char> thumbnailSection;
+        if (_thumbnailSectionEnd>_thumbnailSectionStart)
+            thumbnailSection.assign(_fileBuffer.begin()+_thumbnailSectionStart,_fileBuffer.begin()+_thumbnailSectionEnd);
         if (!_noHeader)
             _writeBinaryHeader();
         // Now we write all the data:
@@ -188,10 +196,47 @@ void CSer::writeClose()
                     (*_bufferArchive).push_back(_fileBuffer[i]);
             }
         }
+        // The sections listed in the header come last, uncompressed:
+        for (size_t i=0;i<thumbnailSection.size();i++)
+        {
+            if (theArchive!=nullptr)
+                (*theArchive) << thumbnailSection[i];
+            else
+                (*_bufferArchive).push_back(thumbnailSection[i]);
+        }
         _fileBuffer.clear();
     }
 }
 
+void CSer::writeCloseWithoutCompressing(std::vector<unsigned char>& data)
+{ // binary buffers only. Like writeClose, except that the data is moved into 'data' instead of being appended
+  // to the buffer. When compression is on, 'data' is compressed with compressData, e.g. in another thread.
+  // The full file is the buffer (i.e. the header), followed by 'data'
+    _thumbnailSectionStart=-1; // sections are not supported here
+    _thumbnailSectionEnd=-1;
+    _writeBinaryHeader();
+    if (_compress)
+        CSimFlavor::handleBrFile(_filetype,(char*)&_fileBuffer[0]);
+    data.clear();
+    data.swap(_fileBuffer);
+}
+
+void CSer::compressData(std::vector<unsigned char>& data,std::vector<unsigned char>& compressed)
+{ // same compression as in writeClose. Does not access any other data, and can run in any thread
+    compressed.resize(data.size()+400); // actually 384
+    int outSize=Huffman_Compress(&data[0],&compressed[0],(int)data.size());
+    compressed.resize(outSize);
+}
+
+void CSer::setThumbnailSection(int fileBufferStart,int fileBufferEnd)
+{ // the thumbnail and model infos are in that part of the data. They are also written uncompressed at the end of the
+  // file, so that the model browser can read them without reading and uncompressing the whole file
+    if ( (_filetype==filetype_csim_bin_model_file)&&(!_noHeader) )
+    {
+        _thumbnailSectionStart=fileBufferStart;
+        _thumbnailSectionEnd=fileBufferEnd;
+    }
+}
 
 void CSer::_writeBinaryHeader()
 {
@@ -338,13 +383,25 @@ void CSer::_writeBinaryHeader()
     else
         (*_bufferArchive).push_back(_filetype);
 
-    // We write 1000-8 bytes for future use:
+    // We write 1000-8 bytes for future use. They start with the section table (since 2026/10), which older
+    // versions ignore:
+    char reserved[992];
+    memset(reserved,0,992);
+    if (_thumbnailSectionEnd>_thumbnailSectionStart)
+    {
+        int sectionCnt=1;
+        int sectionSize=_thumbnailSectionEnd-_thumbnailSectionStart;
+        memcpy(reserved+0,SER_SECTION_TABLE,4);
+        memcpy(reserved+4,&sectionCnt,4);
+        memcpy(reserved+8,SER_THUMBNAIL_SECTION,4);
+        memcpy(reserved+12,&sectionSize,4);
+    }
     for (int i=0;i<992;i++)
     {
         if (theArchive!=nullptr)
-            (*theArchive) << (char)0;
+            (*theArchive) << reserved[i];
         else
-            (*_bufferArchive).push_back((char)0);
+            (*_bufferArchive).push_back(reserved[i]);
     }
 
     if ( (_filetype==CSer::filetype_xr_bin_scene_file)||(_filetype==CSer::filetype_xr_bin_model_file) )
@@ -558,6 +615,7 @@ int CSer::readOpenBinary(int& serializationVersion,unsigned short& coppeliaSimVe
     char compressMethod=0;
     int originalDataSize=0;
     int bufferArchivePointer=0;
+    int sectionsSize=0;
 
     if (!_noHeader)
     {
@@ -685,14 +743,15 @@ int CSer::readOpenBinary(int& serializationVersion,unsigned short& coppeliaSimVe
                 else
                     filetype=(*_bufferArchive)[bufferArchivePointer++];
 
+                char reserved[992];
                 for (int i=0;i<992;i++)
-                { // for future use!
-                    char dummy;
+                {
                     if (theArchive!=nullptr)
-                        (*theArchive) >> dummy; // not used for now
+                        (*theArchive) >> reserved[i];
                     else
-                        dummy=(*_bufferArchive)[bufferArchivePointer++];
+                        reserved[i]=(*_bufferArchive)[bufferArchivePointer++];
                 }
+                sectionsSize=_readSectionTable(reserved,nullptr,nullptr,nullptr);
                 alreadyReadDataCount+=1004;
             }
         }
@@ -711,17 +770,20 @@ int CSer::readOpenBinary(int& serializationVersion,unsigned short& coppeliaSimVe
         if (serializationVersion>SER_SERIALIZATION_VERSION)
         { // we might have problems reading this (even if it should be supported). Some functions might not be available.
 #ifdef SIM_WITH_GUI
-            App::uiThread->messageBox_warning(App::mainWindow,"Serialization",IDS_READING_NEWER_SERIALIZATION_FILE_WARNING,VMESSAGEBOX_OKELI,VMESSAGEBOX_REPLY_OK);
-#else
-            App::logMsg(sim_verbosity_warnings,"%s.",IDS_READING_NEWER_SERIALIZATION_FILE_WARNING);
+            if (!CWorkerPool::isWorkerThread())
+                App::uiThread->messageBox_warning(App::mainWindow,"Serialization",IDS_READING_NEWER_SERIALIZATION_FILE_WARNING,VMESSAGEBOX_OKELI,VMESSAGEBOX_REPLY_OK);
+            else
 #endif
+                App::logMsg(sim_verbosity_warnings,"%s.",IDS_READING_NEWER_SERIALIZATION_FILE_WARNING);
         }
     }
 
-    // We read the whole file:
+    // We read the whole file, except for the sections at the end:
     if (theArchive!=nullptr)
     {
         unsigned long l=(unsigned long)theArchive->getFile()->getLength()-alreadyReadDataCount;
+        if ((unsigned long)sectionsSize<=l)
+            l-=sectionsSize;
         char dummy;
         for (unsigned long i=0;i<l;i++)
         {
@@ -731,7 +793,10 @@ int CSer::readOpenBinary(int& serializationVersion,unsigned short& coppeliaSimVe
     }
     else
     {
-        for (unsigned long i=bufferArchivePointer;i<(*_bufferArchive).size();i++)
+        unsigned long l=(unsigned long)(*_bufferArchive).size();
+        if ((unsigned long)(bufferArchivePointer+sectionsSize)<=l)
+            l-=sectionsSize;
+        for (unsigned long i=bufferArchivePointer;i<l;i++)
             _fileBuffer.push_back((*_bufferArchive)[i]);
     }
 
@@ -754,6 +819,86 @@ int CSer::readOpenBinary(int& serializationVersion,unsigned short& coppeliaSimVe
     return(0); // error, unknown compressor
 }
 
+int CSer::readOpenBinaryThumbnailSection()
+{ // return values: -4 file can't be opened, -3=wrong fileformat or no thumbnail section, -2=format too old, -1=format too new, 1=alright!
+  // Reads the header and the thumbnail section at the end of the file, i.e. only a few KB. Does not display
+  // anything, and can be called from any thread
+    _storing=false;
+    if (_filetype!=filetype_csim_bin_model_file)
+        return(-3);
+    VFile file(_filename.c_str(),VFile::READ|VFile::SHARE_DENY_NONE,true);
+    if (file.getFile()==nullptr)
+        return(-4);
+    const int headerSize=29+992;
+    char header[headerSize];
+    quint64 fileLength=file.getLength();
+    if ( (fileLength<quint64(headerSize))||(!file.readBytes(0,header,headerSize)) )
+        return(-3);
+    if (memcmp(header,SER_SIM_HEADER,strlen(SER_SIM_HEADER))!=0)
+        return(-3);
+    int serializationVersion;
+    int minSerializationVersionThatCanReadThis;
+    memcpy(&serializationVersion,header+4,4);
+    memcpy(&minSerializationVersionThatCanReadThis,header+8,4);
+    if (serializationVersion<=12)
+        return(-3); // no reserved part in the header
+    if (serializationVersion<SER_MIN_SERIALIZATION_VERSION_THAT_THIS_CAN_READ)
+        return(-2);
+    if (minSerializationVersionThatCanReadThis>SER_SERIALIZATION_VERSION)
+        return(-1);
+    _serializationVersionThatWroteThisFile=serializationVersion;
+    memcpy(&_coppeliaSimVersionThatWroteThis,header+21,2);
+    unsigned int licenseTypeThatWroteThisTmp;
+    memcpy(&licenseTypeThatWroteThisTmp,header+23,4);
+    _licenseTypeThatWroteThis=licenseTypeThatWroteThisTmp-1;
+
+    int sectionPos,sectionSize;
+    int sectionsSize=_readSectionTable(header+29,SER_THUMBNAIL_SECTION,&sectionPos,&sectionSize);
+    if ( (sectionSize<=0)||(quint64(headerSize+sectionsSize)>fileLength) )
+        return(-3);
+    _fileBuffer.resize(sectionSize);
+    if (!file.readBytes(fileLength-sectionsSize+sectionPos,(char*)&_fileBuffer[0],sectionSize))
+    {
+        _fileBuffer.clear();
+        return(-3);
+    }
+    _fileBufferReadPointer=0;
+    return(1);
+}
+
+int CSer::_readSectionTable(const char* table,const char* sectionTag,int* sectionPos,int* sectionSize)
+{ // returns the size of all sections at the end of the file. sectionPos is relative to the first section
+    int retVal=0;
+    if (sectionSize!=nullptr)
+        sectionSize[0]=-1;
+    if (memcmp(table,SER_SECTION_TABLE,4)==0)
+    {
+        int sectionCnt;
+        memcpy(&sectionCnt,table+4,4);
+        if ( (sectionCnt>0)&&(sectionCnt<=(992-8)/8) )
+        {
+            for (int i=0;i<sectionCnt;i++)
+            {
+                int s;
+                memcpy(&s,table+8+i*8+4,4);
+                if (s<0)
+                { // corrupt table
+                    if (sectionSize!=nullptr)
+                        sectionSize[0]=-1;
+                    return(0);
+                }
+                if ( (sectionTag!=nullptr)&&(memcmp(table+8+i*8,sectionTag,4)==0) )
+                {
+                    sectionPos[0]=retVal;
+                    sectionSize[0]=s;
+                }
+                retVal+=s;
+            }
+        }
+    }
+    return(retVal);
+}
+
 void CSer::readClose()
 {
     _fileBuffer.clear();
@@ -934,6 +1079,27 @@ void CSer::addOffsetToFileBufferReadPointer(int off)
     _fileBufferReadPointer+=off;
 }
 
+bool CSer::skipFileBufferBytes(int byteQuantity)
+{ // returns false if the bytes are not all in the file buffer (corrupt data). The read pointer then moves to the end
+    if ( (byteQuantity<0)||(size_t(_fileBufferReadPointer)+size_t(byteQuantity)>_fileBuffer.size()) )
+    {
+        _fileBufferReadPointer=int(_fileBuffer.size());
+        return(false);
+    }
+    _fileBufferReadPointer+=byteQuantity;
+    return(true);
+}
+
+bool CSer::readFileBufferBytes(std::vector<unsigned char>& data,int byteQuantity)
+{ // copies the bytes at the read pointer into data (cleared if out of bounds), and moves the read pointer past them
+    int pos=_fileBufferReadPointer;
+    data.clear();
+    if (!skipFileBufferBytes(byteQuantity))
+        return(false);
+    data.assign(_fileBuffer.begin()+pos,_fileBuffer.begin()+pos+byteQuantity);
+    return(true);
+}
+
 CSer& CSer::operator>> (int& v)
 {
     unsigned char* tmp=(unsigned char*)(&v);
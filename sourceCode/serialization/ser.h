@@ -9,6 +9,8 @@
 #define SER_END_OF_OBJECT "EOO"
 #define SER_NEXT_STEP "NXT"
 #define SER_END_OF_FILE "EOF"
+#define SER_SECTION_TABLE "SCTN" // in the reserved part of the header: the sections that are appended uncompressed at the end of the file
+#define SER_THUMBNAIL_SECTION "THMB"
 typedef sim::tinyxml2::XMLElement xmlNode;
 
 class CSer
@@ -42,10 +44,14 @@ public:
     bool writeOpenXml(int maxInlineBufferSize,bool useImageAndMeshFileformats);
     bool writeOpenBinaryNoHeader(bool compress);
     void writeClose();
+    void writeCloseWithoutCompressing(std::vector<unsigned char>& data);
+    static void compressData(std::vector<unsigned char>& data,std::vector<unsigned char>& compressed);
+    void setThumbnailSection(int fileBufferStart,int fileBufferEnd); // model files only. That data is also appended uncompressed at the end of the file
 
     int readOpenBinary(int& serializationVersion,unsigned short& coppeliaSimVersionThatWroteThis,int& licenseTypeThatWroteThis,char& revNumber,bool ignoreTooOldSerializationVersion);
     int readOpenXml(int& serializationVersion,unsigned short& coppeliaSimVersionThatWroteThis,int& licenseTypeThatWroteThis,char& revNumber,bool ignoreTooOldSerializationVersion);
     int readOpenBinaryNoHeader();
+    int readOpenBinaryThumbnailSection();
     void readClose();
 
     char getFileType() const;
@@ -82,6 +88,8 @@ public:
     std::vector<unsigned char>* getFileBuffer();
     int getFileBufferReadPointer() const;
     void addOffsetToFileBufferReadPointer(int off);
+    bool skipFileBufferBytes(int byteQuantity);
+    bool readFileBufferBytes(std::vector<unsigned char>& data,int byteQuantity);
     int getCounter() const;
 
     void loadUnknownData();
@@ -187,6 +195,7 @@ public:
 private:
     void _commonInit();
     void _writeBinaryHeader();
+    static int _readSectionTable(const char* table,const char* sectionTag,int* sectionPos,int* sectionSize);
     void _writeXmlHeader();
     void _writeXmlFooter();
     int _readXmlHeader(int& serializationVersion,unsigned short& coppeliaSimVersionThatWroteThis,char& revNumber);
@@ -212,6 +221,8 @@ private:
     std::vector<unsigned char> buffer;
     std::vector<unsigned char> _fileBuffer;
     int _fileBufferReadPointer;
+    int _thumbnailSectionStart;
+    int _thumbnailSectionEnd;
     bool _foundUnknownCommands;
 
     unsigned short _coppeliaSimVersionThatWroteThis;
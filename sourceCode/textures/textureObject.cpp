@@ -158,6 +158,16 @@ void CTextureObject::addDependentObject(int objectID,int subObjectID)
     _dependentSubObjects.push_back(subObjectID);
 }
 
+bool CTextureObject::hasDependentObjectNotIn(const std::set<int>& objectIDs) const
+{
+    for (size_t i=0;i<_dependentObjects.size();i++)
+    {
+        if (objectIDs.find(_dependentObjects[i])==objectIDs.end())
+            return(true);
+    }
+    return(false);
+}
+
 void CTextureObject::clearAllDependencies()
 {
     _dependentObjects.clear();
@@ -419,6 +429,39 @@ bool CTextureObject::writePortionOfTexture(const unsigned char* rgbData,int posX
     return(true);
 }
 
+void CTextureObject::decodeLoadedData()
+{
+    if (_textureLoadingData.size()>0)
+    {
+        int pixelSize=3;
+        if (_providedImageWasRGBA)
+            pixelSize=4;
+        if ( (_textureSize[0]<0)||(_textureSize[1]<0)||(_textureLoadingData.size()<size_t(pixelSize)*size_t(_textureSize[0])*size_t(_textureSize[1])) )
+        { // corrupt data block: we keep a valid, opaque texture (we can run in a worker thread: no logging here)
+            if ( (_textureSize[0]<0)||(_textureSize[1]<0) )
+            {
+                _textureSize[0]=0;
+                _textureSize[1]=0;
+            }
+            _textureBuffer.assign(4*_textureSize[0]*_textureSize[1],255);
+            std::vector<unsigned char>().swap(_textureLoadingData);
+            return;
+        }
+        _textureBuffer.resize(4*_textureSize[0]*_textureSize[1],0);
+        for (int i=0;i<_textureSize[0]*_textureSize[1];i++)
+        {
+            _textureBuffer[4*i+0]=_textureLoadingData[pixelSize*i+0];
+            _textureBuffer[4*i+1]=_textureLoadingData[pixelSize*i+1];
+            _textureBuffer[4*i+2]=_textureLoadingData[pixelSize*i+2];
+            if (_providedImageWasRGBA)
+                _textureBuffer[4*i+3]=_textureLoadingData[pixelSize*i+3];
+            else
+                _textureBuffer[4*i+3]=255;
+        }
+        std::vector<unsigned char>().swap(_textureLoadingData);
+    }
+}
+
 void CTextureObject::serialize(CSer& ar)
 {
     if (ar.isBinary())
@@ -510,17 +553,8 @@ void CTextureObject::serialize(CSer& ar)
                         {
                             noHit=false;
                             ar >> byteQuantity;
-                            _textureBuffer.resize(4*_textureSize[0]*_textureSize[1],0);
-                            for (int i=0;i<_textureSize[0]*_textureSize[1];i++)
-                            {
-                                ar >> _textureBuffer[4*i+0];
-                                ar >> _textureBuffer[4*i+1];
-                                ar >> _textureBuffer[4*i+2];
-                                if (_providedImageWasRGBA)
-                                    ar >> _textureBuffer[4*i+3];
-                                else
-                                    _textureBuffer[4*i+3]=255;
-                            }
+                            // decoded in decodeLoadedData:
+                            ar.readFileBufferBytes(_textureLoadingData,byteQuantity);
                             _changedFlag=true;
                             _currentTextureContentUniqueId=_textureContentUniqueId++;
                         }
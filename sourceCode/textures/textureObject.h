@@ -2,6 +2,7 @@
 #pragma once
 
 #include "ser.h"
+#include <set>
 
 class CTextureObject
 {
@@ -19,6 +20,7 @@ public:
     void setImage(bool rgba,bool horizFlip,bool vertFlip,const unsigned char* data);
     CTextureObject* copyYourself() const;
     void serialize(CSer& ar);
+    void decodeLoadedData(); // CPU-heavy part of loading, done after serialize. Can run in a worker thread
     void setTextureBuffer(const std::vector<unsigned char>& tb);
     void getTextureBuffer(std::vector<unsigned char>& tb) const;
     const unsigned char* getTextureBufferPointer() const;
@@ -27,6 +29,7 @@ public:
 
     bool announceGeneralObjectWillBeErased(int objectID,int subObjectID);
     void addDependentObject(int objectID,int subObjectID);
+    bool hasDependentObjectNotIn(const std::set<int>& objectIDs) const;
     void clearAllDependencies();
     void transferDependenciesToThere(CTextureObject* receivingObject);
 
@@ -42,6 +45,7 @@ public:
 
 protected:
     std::vector<unsigned char> _textureBuffer;
+    std::vector<unsigned char> _textureLoadingData; // RGB or RGBA data, until decodeLoadedData is called
     unsigned int _oglTextureName;
     int _objectID;
     std::string _objectName;
@@ -0,0 +1,708 @@
+#include "benchmarks.h"
+#include "interfaceStack.h"
+#include "octree.h"
+#include "pointCloud.h"
+#include "visionSensor.h"
+#include "imageKernels.h"
+#include "nearestNodeIndex_old.h"
+#include "pathPlanningInterface.h"
+#include "mill.h"
+#include "meshCalcStructures.h"
+#include "meshCalcStructureCache.h"
+#include "addOperations.h"
+#include "simInternal.h"
+#include "app.h"
+#include "pluginContainer.h"
+#include "vDateTime.h"
+#include <set>
+#include <boost/lexical_cast.hpp>
+
+bool CBenchmarks::run(const char* benchmarkName,int iterations,std::string& report,std::vector<float>& results)
+{
+    report.clear();
+    results.clear();
+    std::string name(benchmarkName);
+    if (name.compare("interfaceStack")==0)
+    {
+        if (iterations<=0)
+            iterations=100000;
+        _interfaceStack(iterations,report,results);
+        return(true);
+    }
+    if (name.compare("pointCloudInsert")==0)
+    {
+        if (iterations<=0)
+            iterations=100;
+        _pointCloudInsert(iterations,report,results);
+        return(true);
+    }
+    if (name.compare("visionSensorDepth")==0)
+    {
+        if (iterations<=0)
+            iterations=20;
+        _visionSensorDepth(iterations,report,results);
+        return(true);
+    }
+    if (name.compare("imageKernels")==0)
+    {
+        if (iterations<=0)
+            iterations=100;
+        _imageKernels(iterations,report,results);
+        return(true);
+    }
+    if (name.compare("rrtNearestNode")==0)
+    {
+        if (iterations<=0)
+            iterations=50000;
+        _rrtNearestNode(iterations,report,results);
+        return(true);
+    }
+    if (name.compare("millOctree")==0)
+    {
+        if (iterations<=0)
+            iterations=1000;
+        _millOctree(iterations,report,results);
+        return(true);
+    }
+    if (name.compare("copyPasteObjects")==0)
+    {
+        if (iterations<=0)
+            iterations=200;
+        _copyPasteObjects(iterations,report,results);
+        return(true);
+    }
+    if (name.compare("sharedGeometry")==0)
+    {
+        if (iterations<=0)
+            iterations=1000;
+        _sharedGeometry(iterations,report,results);
+        return(true);
+    }
+    if (name.compare("calcStructureCache")==0)
+    {
+        if (iterations<=0)
+            iterations=300;
+        _calcStructureCache(iterations,report,results);
+        return(true);
+    }
+    return(false);
+}
+
+void CBenchmarks::_interfaceStack(int iterations,std::string& report,std::vector<float>& results)
+{ // results: push/pop, array table and stack copy, in us per iteration, first with the object pool disabled, then enabled
+    const char* names[3]={"push/pop","array table","stack copy"};
+    float arr[64];
+    for (size_t i=0;i<64;i++)
+        arr[i]=float(i);
+    bool poolingWasEnabled=CInterfaceStackObject::getPoolingEnabled();
+    for (size_t pass=0;pass<2;pass++)
+    {
+        CInterfaceStackObject::setPoolingEnabled(pass==1);
+        CInterfaceStack stack;
+        unsigned long long allocs0,recycled0;
+        CInterfaceStackObject::getPoolStatistics(allocs0,recycled0);
+
+        // Scalar push/pop, typical for script function arguments:
+        unsigned long long t=VDateTime::getTimeInUs();
+        for (int it=0;it<iterations;it++)
+        {
+            for (int i=0;i<8;i++)
+            {
+                stack.pushInt32OntoStack(i);
+                stack.pushNumberOntoStack(double(i));
+            }
+            stack.pushBoolOntoStack(true);
+            stack.pushStringOntoStack("benchmark",0);
+            stack.popStackValue(0);
+        }
+        results.push_back(float(VDateTime::getTimeInUs()-t)/float(iterations));
+
+        // Numeric array table, typical for batched callbacks:
+        t=VDateTime::getTimeInUs();
+        for (int it=0;it<iterations/10;it++)
+        {
+            stack.pushFloatArrayTableOntoStack(arr,64);
+            stack.getStackFloatArray(arr,64);
+            stack.clear();
+        }
+        results.push_back(float(VDateTime::getTimeInUs()-t)/float(std::max(1,iterations/10)));
+
+        // Copy of a whole stack (i.e. transfer between stacks/threads):
+        stack.pushTableOntoStack();
+        stack.pushStringOntoStack("data",0);
+        stack.pushFloatArrayTableOntoStack(arr,64);
+        stack.insertDataIntoStackTable();
+        stack.pushInt32OntoStack(42);
+        t=VDateTime::getTimeInUs();
+        for (int it=0;it<iterations/10;it++)
+        {
+            CInterfaceStack* cp=stack.copyYourself();
+            delete cp;
+        }
+        results.push_back(float(VDateTime::getTimeInUs()-t)/float(std::max(1,iterations/10)));
+        stack.clear();
+
+        unsigned long long allocs1,recycled1;
+        CInterfaceStackObject::getPoolStatistics(allocs1,recycled1);
+        report+=(pass==0)?"Pooling disabled:\n":"Pooling enabled:\n";
+        for (size_t i=0;i<3;i++)
+        {
+            report+="    ";
+            report+=names[i];
+            report+=": ";
+            report+=boost::lexical_cast<std::string>(results[pass*3+i]);
+            report+=" us/iteration\n";
+        }
+        if (pass==1)
+        {
+            report+="    recycled objects: ";
+            report+=boost::lexical_cast<std::string>(recycled1-recycled0);
+            report+="/";
+            report+=boost::lexical_cast<std::string>(allocs1-allocs0);
+            report+="\n";
+        }
+    }
+    CInterfaceStackObject::setPoolingEnabled(poolingWasEnabled);
+}
+
+void CBenchmarks::_pointCloudInsert(int iterations,std::string& report,std::vector<float>& results)
+{ // Streams 'iterations' frames of 5000 points (i.e. a depth camera) into an octree and a point cloud.
+  // results: for the octree, then the point cloud, first with full re-reads, then with incremental updates:
+  // 5 times [map size, us per frame], sampled every iterations/5 frames
+    if (!CPluginContainer::isGeomPluginAvailable())
+    {
+        report="The geometry plugin is not available.\n";
+        return;
+    }
+    const int ptsPerFrame=5000;
+    const int checkpoints=5;
+    if (iterations<checkpoints)
+        iterations=checkpoints;
+    std::vector<float> pts(ptsPerFrame*3);
+    bool octreeWasIncremental=COctree::getIncrementalUpdates();
+    bool ptcloudWasIncremental=CPointCloud::getIncrementalUpdates();
+    for (size_t obj=0;obj<2;obj++)
+    {
+        for (size_t pass=0;pass<2;pass++)
+        {
+            COctree::setIncrementalUpdates(pass==1);
+            CPointCloud::setIncrementalUpdates(pass==1);
+            COctree* octree=nullptr;
+            CPointCloud* ptcloud=nullptr;
+            if (obj==0)
+            {
+                octree=new COctree();
+                octree->setCellSize(0.02f);
+            }
+            else
+                ptcloud=new CPointCloud();
+            report+=(obj==0)?"Octree":"Point cloud";
+            report+=(pass==0)?", full re-read:\n":", incremental:\n";
+            unsigned int seed=12345;
+            int frame=0;
+            for (int cp=0;cp<checkpoints;cp++)
+            {
+                unsigned long long t=VDateTime::getTimeInUs();
+                int frames=iterations/checkpoints;
+                for (int f=0;f<frames;f++)
+                { // each frame covers a new 0.5x0.5 m patch of a 4x4 m floor, with some overlap:
+                    float ox=0.4f*float(frame%10);
+                    float oy=0.4f*float((frame/10)%10);
+                    float oz=0.1f*float(frame/100);
+                    for (int i=0;i<ptsPerFrame*3;i++)
+                    {
+                        seed=seed*1103515245+12345;
+                        pts[i]=float((seed>>8)&0xffff)/65535.0f*0.5f;
+                    }
+                    for (int i=0;i<ptsPerFrame;i++)
+                    {
+                        pts[3*i+0]+=ox;
+                        pts[3*i+1]+=oy;
+                        pts[3*i+2]=oz+pts[3*i+2]*0.2f;
+                    }
+                    if (octree!=nullptr)
+                        octree->insertPoints(&pts[0],ptsPerFrame,true,nullptr,false,nullptr,0);
+                    else
+                        ptcloud->insertPoints(&pts[0],ptsPerFrame,true,nullptr,false);
+                    frame++;
+                }
+                float usPerFrame=float(VDateTime::getTimeInUs()-t)/float(frames);
+                int mapSize;
+                if (octree!=nullptr)
+                    mapSize=int(octree->getCubePositions()->size()/3);
+                else
+                    mapSize=int(ptcloud->getPoints()->size()/3);
+                results.push_back(float(mapSize));
+                results.push_back(usPerFrame);
+                report+="    map size ";
+                report+=boost::lexical_cast<std::string>(mapSize);
+                report+=": ";
+                report+=boost::lexical_cast<std::string>(usPerFrame);
+                report+=" us/frame (";
+                report+=boost::lexical_cast<std::string>(usPerFrame>0.0f?1000000.0f/usPerFrame:0.0f);
+                report+=" Hz)\n";
+            }
+            delete octree;
+            delete ptcloud;
+        }
+    }
+    COctree::setIncrementalUpdates(octreeWasIncremental);
+    CPointCloud::setIncrementalUpdates(ptcloudWasIncremental);
+}
+
+void CBenchmarks::_visionSensorDepth(int iterations,std::string& report,std::vector<float>& results)
+{ // Renders the depth of each vision sensor in the current scene, with OpenGL, then with CPU ray casting.
+  // results: for each sensor, [us per frame with OpenGL, us per frame with ray casting, max. depth difference]
+    if (App::currentWorld->sceneObjects->getVisionSensorCount()==0)
+    {
+        report="No vision sensor in the current scene.\n";
+        return;
+    }
+    bool rayCastingWasEnabled=App::userSettings->visionSensorsDepthRayCasting;
+    for (size_t i=0;i<App::currentWorld->sceneObjects->getVisionSensorCount();i++)
+    {
+        CVisionSensor* sensor=App::currentWorld->sceneObjects->getVisionSensorFromIndex(i);
+        bool ignoredRgb=sensor->getIgnoreRGBInfo();
+        sensor->setIgnoreRGBInfo(true);
+        int res[2];
+        sensor->getRealResolution(res);
+        report+=sensor->getObjectName();
+        report+=" (";
+        report+=boost::lexical_cast<std::string>(res[0]);
+        report+="x";
+        report+=boost::lexical_cast<std::string>(res[1]);
+        report+="):\n";
+        float* depth[2]={nullptr,nullptr};
+        for (size_t pass=0;pass<2;pass++)
+        {
+            App::userSettings->visionSensorsDepthRayCasting=(pass==1);
+            unsigned long long t=VDateTime::getTimeInUs();
+            for (int it=0;it<iterations;it++)
+            {
+                delete[] depth[pass];
+                depth[pass]=sensor->checkSensorEx(sensor->getDetectableEntityHandle(),false,false,false,false);
+            }
+            float usPerFrame=float(VDateTime::getTimeInUs()-t)/float(iterations);
+            results.push_back(usPerFrame);
+            report+=(pass==0)?"    OpenGL: ":"    ray casting: ";
+            report+=boost::lexical_cast<std::string>(usPerFrame);
+            report+=" us/frame\n";
+        }
+        float maxDiff=0.0f;
+        if ( (depth[0]!=nullptr)&&(depth[1]!=nullptr) )
+        {
+            for (int j=0;j<res[0]*res[1];j++)
+                maxDiff=std::max<float>(maxDiff,fabs(depth[0][j]-depth[1][j]));
+        }
+        results.push_back(maxDiff);
+        report+="    max. depth difference: ";
+        report+=boost::lexical_cast<std::string>(maxDiff);
+        report+="\n";
+        delete[] depth[0];
+        delete[] depth[1];
+        sensor->setIgnoreRGBInfo(ignoredRgb);
+    }
+    App::userSettings->visionSensorsDepthRayCasting=rayCastingWasEnabled;
+}
+
+void CBenchmarks::_imageKernels(int iterations,std::string& report,std::vector<float>& results)
+{ // Runs the vision sensor image kernels on 1920x1080 buffers.
+  // results: us per frame for each kernel, in the order of the report
+    const int resX=1920;
+    const int resY=1080;
+    const int n=resX*resY;
+    std::vector<unsigned char> rgb(n*3);
+    std::vector<float> depth(n);
+    unsigned int seed=12345;
+    for (int i=0;i<n*3;i++)
+    {
+        seed=seed*1103515245+12345;
+        rgb[i]=(unsigned char)((seed>>16)&0xff);
+    }
+    for (int i=0;i<n;i++)
+        depth[i]=float(rgb[3*i])/255.0f;
+    std::vector<float> floatBuff(n*3);
+    std::vector<unsigned char> charBuff(n*4);
+    report="1920x1080, instruction set: ";
+    report+=CImageKernels::getInstructionSet();
+    report+="\n";
+    const char* names[8]={"char to float (RGB)","float to char (RGB)","RGB to grey (float)","RGB to grey (char)","grey to RGB (char)","depth threshold (alpha)","region copy (half image)","statistics"};
+    SImageStats stats;
+    for (int k=0;k<8;k++)
+    {
+        unsigned long long t=VDateTime::getTimeInUs();
+        for (int it=0;it<iterations;it++)
+        {
+            if (k==0)
+                CImageKernels::charToFloat(&rgb[0],&floatBuff[0],n*3);
+            if (k==1)
+                CImageKernels::floatToChar(&floatBuff[0],&charBuff[0],n*3);
+            if (k==2)
+                CImageKernels::rgbToGreyFloat(&rgb[0],&floatBuff[0],n);
+            if (k==3)
+                CImageKernels::rgbToGreyChar(&rgb[0],&charBuff[0],1,n);
+            if (k==4)
+                CImageKernels::greyCharToRgb(&charBuff[0],&rgb[0],n);
+            if (k==5)
+                CImageKernels::depthThreshold(&depth[0],0.5f,&charBuff[3],4,n);
+            if (k==6)
+                CImageKernels::copyRegion(&rgb[0],resX,resX/4,resY/4,resX/2,resY/2,3,&charBuff[0]);
+            if (k==7)
+                CImageKernels::getStats(&rgb[0],&depth[0],n,stats);
+        }
+        float usPerFrame=float(VDateTime::getTimeInUs()-t)/float(iterations);
+        results.push_back(usPerFrame);
+        report+="    ";
+        report+=names[k];
+        report+=": ";
+        report+=boost::lexical_cast<std::string>(usPerFrame);
+        report+=" us/frame\n";
+    }
+}
+
+void CBenchmarks::_rrtNearestNode(int iterations,std::string& report,std::vector<float>& results)
+{ // Grows an RRT of 'iterations' nodes for a mobile base (x, y and gamma, as with sim_holonomicpathplanning_xyg), without
+  // obstacles, first with a linear scan for the closest node (as previously done by the planners), then with the node index.
+  // results: 2 times 5 times [tree size, nodes per second], sampled every iterations/5 nodes
+    const int checkpoints=5;
+    const float angularCoeff=0.5f;
+    const float stepSize=0.05f;
+    if (iterations<checkpoints)
+        iterations=checkpoints;
+    bool angular[NEAREST_NODE_INDEX_MAX_DIM]={false,false,true,false};
+    float weights[NEAREST_NODE_INDEX_MAX_DIM]={1.0f,1.0f,angularCoeff*angularCoeff,1.0f};
+    for (size_t pass=0;pass<2;pass++)
+    {
+        CNearestNodeIndex_old index;
+        index.setDimensions(3,angular);
+        index.setWeights(weights);
+        std::vector<float> nodes;
+        nodes.push_back(0.0f);
+        nodes.push_back(0.0f);
+        nodes.push_back(0.0f);
+        index.addPoint(&nodes[0]);
+        float sample[3];
+        auto distance=[&](int i)->float
+        {
+            float dx=sample[0]-nodes[3*i+0];
+            float dy=sample[1]-nodes[3*i+1];
+            float dg=CPathPlanningInterface::getNormalizedAngle(sample[2]-nodes[3*i+2])*angularCoeff;
+            return(dx*dx+dy*dy+dg*dg);
+        };
+        report+=(pass==0)?"Linear scan:\n":"Node index:\n";
+        unsigned int seed=12345;
+        for (int cp=0;cp<checkpoints;cp++)
+        {
+            unsigned long long t=VDateTime::getTimeInUs();
+            int cnt=iterations/checkpoints;
+            for (int it=0;it<cnt;it++)
+            { // sample a 10x10 m area, and extend the closest node by one step towards the sample:
+                for (int i=0;i<3;i++)
+                {
+                    seed=seed*1103515245+12345;
+                    sample[i]=float((seed>>8)&0xffff)/65535.0f;
+                }
+                sample[0]=sample[0]*10.0f-5.0f;
+                sample[1]=sample[1]*10.0f-5.0f;
+                sample[2]=sample[2]*piValTimes2_f-piValue_f;
+                int closest=-1;
+                if (pass==0)
+                {
+                    float minD=SIM_MAX_FLOAT;
+                    for (int i=0;i<int(nodes.size()/3);i++)
+                    {
+                        float d=distance(i);
+                        if (d<minD)
+                        {
+                            minD=d;
+                            closest=i;
+                        }
+                    }
+                }
+                else
+                    closest=index.getClosestPoint(sample,distance);
+                float l=sqrt(distance(closest));
+                float f=1.0f;
+                if (l>stepSize)
+                    f=stepSize/l;
+                float node[3];
+                node[0]=nodes[3*closest+0]+(sample[0]-nodes[3*closest+0])*f;
+                node[1]=nodes[3*closest+1]+(sample[1]-nodes[3*closest+1])*f;
+                node[2]=CPathPlanningInterface::getNormalizedAngle(nodes[3*closest+2]+CPathPlanningInterface::getNormalizedAngle(sample[2]-nodes[3*closest+2])*f);
+                nodes.insert(nodes.end(),node,node+3);
+                index.addPoint(node);
+            }
+            float nodesPerSecond=0.0f;
+            unsigned long long dt=VDateTime::getTimeInUs()-t;
+            if (dt>0)
+                nodesPerSecond=float(cnt)*1000000.0f/float(dt);
+            int treeSize=int(nodes.size()/3);
+            results.push_back(float(treeSize));
+            results.push_back(nodesPerSecond);
+            report+="    tree size ";
+            report+=boost::lexical_cast<std::string>(treeSize);
+            report+=": ";
+            report+=boost::lexical_cast<std::string>(nodesPerSecond);
+            report+=" nodes/s\n";
+        }
+    }
+}
+
+void CBenchmarks::_millOctree(int iterations,std::string& report,std::vector<float>& results)
+{ // Moves a cylindrical mill (radius 5 mm) through a 100x100x20 mm octree workpiece for 'iterations' steps of 0.5 mm,
+  // at cell sizes of 4, 2 and 1 mm, first with full re-reads of the octree, then with incremental updates.
+  // results: 2 times 3 times [cell size, voxels in the workpiece, us per step, removed voxels per second]
+    if (!CPluginContainer::isGeomPluginAvailable())
+    {
+        report="The geometry plugin is not available.\n";
+        return;
+    }
+    const float cellSizes[3]={0.004f,0.002f,0.001f};
+    bool octreeWasIncremental=COctree::getIncrementalUpdates();
+    CMill* mill=new CMill(sim_mill_cylinder_subtype);
+    mill->convexVolume->setRadius(0.005f);
+    mill->convexVolume->setRange(0.03f);
+    for (size_t pass=0;pass<2;pass++)
+    {
+        COctree::setIncrementalUpdates(pass==1);
+        report+=(pass==0)?"Full re-read:\n":"Incremental:\n";
+        for (size_t c=0;c<3;c++)
+        {
+            float cellSize=cellSizes[c];
+            COctree* octree=new COctree();
+            octree->setCellSize(cellSize);
+            int n[3]={int(0.1f/cellSize+0.5f),int(0.1f/cellSize+0.5f),int(0.02f/cellSize+0.5f)};
+            std::vector<float> pts;
+            for (int x=0;x<n[0];x++)
+            {
+                for (int y=0;y<n[1];y++)
+                {
+                    for (int z=0;z<n[2];z++)
+                    {
+                        pts.push_back(-0.05f+(float(x)+0.5f)*cellSize);
+                        pts.push_back(-0.05f+(float(y)+0.5f)*cellSize);
+                        pts.push_back((float(z)+0.5f)*cellSize);
+                    }
+                }
+            }
+            octree->insertPoints(&pts[0],int(pts.size()/3),true,nullptr,false,nullptr,0);
+            int voxelCnt=int(octree->getCubePositions()->size()/3);
+
+            int removedCnt=0;
+            unsigned long long t=VDateTime::getTimeInUs();
+            for (int step=0;step<iterations;step++)
+            { // rows of 200 steps along x, 8 mm apart. The volume reaches through the workpiece:
+                C7Vector tr;
+                tr.setIdentity();
+                tr.X(0)=-0.05f+0.0005f*float(step%200);
+                tr.X(1)=-0.045f+0.008f*float((step/200)%12);
+                tr.X(2)=-0.005f;
+                removedCnt+=octree->subtractConvexVolume(mill->convexVolume,tr);
+            }
+            unsigned long long dt=VDateTime::getTimeInUs()-t;
+            float usPerStep=float(dt)/float(iterations);
+            float voxelsPerSecond=0.0f;
+            if (dt>0)
+                voxelsPerSecond=float(removedCnt)*1000000.0f/float(dt);
+            results.push_back(cellSize);
+            results.push_back(float(voxelCnt));
+            results.push_back(usPerStep);
+            results.push_back(voxelsPerSecond);
+            report+="    cell size ";
+            report+=boost::lexical_cast<std::string>(cellSize*1000.0f);
+            report+=" mm, ";
+            report+=boost::lexical_cast<std::string>(voxelCnt);
+            report+=" voxels: ";
+            report+=boost::lexical_cast<std::string>(usPerStep);
+            report+=" us/step, ";
+            report+=boost::lexical_cast<std::string>(voxelsPerSecond);
+            report+=" removed voxels/s\n";
+            delete octree;
+        }
+    }
+    delete mill;
+    COctree::setIncrementalUpdates(octreeWasIncremental);
+}
+
+void CBenchmarks::_copyPasteObjects(int iterations,std::string& report,std::vector<float>& results)
+{ // Duplicates a model made of 1, 10 and 50 cuboids 'iterations' times with sim.copyPasteObjects, in the current scene.
+  // The added objects are removed afterwards.
+  // results: 3 times [objects per model, copies per second, objects per second]
+    const int modelSizes[3]={1,10,50};
+    std::set<int> initialHandles;
+    for (size_t i=0;i<App::currentWorld->sceneObjects->getObjectCount();i++)
+        initialHandles.insert(App::currentWorld->sceneObjects->getObjectFromIndex(i)->getObjectHandle());
+    for (size_t m=0;m<3;m++)
+    {
+        C3Vector sizes(0.1f,0.1f,0.1f);
+        CShape* base=CAddOperations::addPrimitiveShape(1,sizes,nullptr,0,0,0,false,0,false,true,false,1000.0f,false,0.5f);
+        base->setModelBase(true);
+        for (int i=1;i<modelSizes[m];i++)
+        {
+            CShape* shape=CAddOperations::addPrimitiveShape(1,sizes,nullptr,0,0,0,false,0,false,true,false,1000.0f,false,0.5f);
+            shape->setParent(base,false);
+            C7Vector tr;
+            tr.setIdentity();
+            tr.X(0)=0.1f*float(i%10);
+            tr.X(1)=0.1f*float(i/10);
+            shape->setLocalTransformation(tr);
+        }
+        int copyCnt=0;
+        std::vector<int> handles(modelSizes[m]);
+        unsigned long long t=VDateTime::getTimeInUs();
+        for (int it=0;it<iterations;it++)
+        {
+            handles[0]=base->getObjectHandle();
+            if (simCopyPasteObjects_internal(&handles[0],1,1)>0)
+                copyCnt++;
+        }
+        unsigned long long dt=VDateTime::getTimeInUs()-t;
+        float copiesPerSecond=0.0f;
+        if (dt>0)
+            copiesPerSecond=float(copyCnt)*1000000.0f/float(dt);
+        results.push_back(float(modelSizes[m]));
+        results.push_back(copiesPerSecond);
+        results.push_back(copiesPerSecond*float(modelSizes[m]));
+        report+="    ";
+        report+=boost::lexical_cast<std::string>(modelSizes[m]);
+        report+=" object(s) per model: ";
+        report+=boost::lexical_cast<std::string>(copiesPerSecond);
+        report+=" copies/s, ";
+        report+=boost::lexical_cast<std::string>(copiesPerSecond*float(modelSizes[m]));
+        report+=" objects/s\n";
+
+        std::vector<int> added;
+        for (size_t i=0;i<App::currentWorld->sceneObjects->getObjectCount();i++)
+        {
+            int h=App::currentWorld->sceneObjects->getObjectFromIndex(i)->getObjectHandle();
+            if (initialHandles.find(h)==initialHandles.end())
+                added.push_back(h);
+        }
+        App::currentWorld->sceneObjects->eraseSeveralObjects(added,true);
+    }
+}
+
+void CBenchmarks::_sharedGeometry(int iterations,std::string& report,std::vector<float>& results)
+{ // Duplicates a cuboid 'iterations' times with sim.copyPasteObjects in the current scene, then initializes the
+  // calculation structures of all copies. The added objects are removed afterwards.
+  // results: [shapes, distinct geometries, added calculation structures, calculation structure initialization in us per shape]
+    C3Vector sizes(0.1f,0.1f,0.1f);
+    CShape* original=CAddOperations::addPrimitiveShape(1,sizes,nullptr,0,0,0,false,0,false,true,false,1000.0f,false,0.5f);
+    std::vector<int> handles;
+    handles.push_back(original->getObjectHandle());
+    for (int it=0;it<iterations;it++)
+    {
+        int h=original->getObjectHandle();
+        if (simCopyPasteObjects_internal(&h,1,0)>0)
+            handles.push_back(h);
+    }
+    int structCnt=CMeshCalcStructures::getStructureCount();
+    std::set<int> geometries;
+    unsigned long long t=VDateTime::getTimeInUs();
+    for (size_t i=0;i<handles.size();i++)
+    {
+        CShape* shape=App::currentWorld->sceneObjects->getShapeFromHandle(handles[i]);
+        shape->initializeMeshCalculationStructureIfNeeded();
+        if (shape->getMeshWrapper()->isMesh())
+            geometries.insert(shape->getSingleMesh()->getGeometryUniqueId());
+    }
+    unsigned long long dt=VDateTime::getTimeInUs()-t;
+    structCnt=CMeshCalcStructures::getStructureCount()-structCnt;
+    float usPerShape=float(dt)/float(handles.size());
+    results.push_back(float(handles.size()));
+    results.push_back(float(geometries.size()));
+    results.push_back(float(structCnt));
+    results.push_back(usPerShape);
+    report+="    ";
+    report+=boost::lexical_cast<std::string>(handles.size());
+    report+=" shapes, ";
+    report+=boost::lexical_cast<std::string>(geometries.size());
+    report+=" distinct geometries, ";
+    report+=boost::lexical_cast<std::string>(structCnt);
+    report+=" calculation structures built, ";
+    report+=boost::lexical_cast<std::string>(usPerShape);
+    report+=" us per shape\n";
+    App::currentWorld->sceneObjects->eraseSeveralObjects(handles,true);
+}
+
+void CBenchmarks::_calcStructureCache(int iterations,std::string& report,std::vector<float>& results)
+{ // Builds the calculation structure of a grid mesh with 'iterations' x 'iterations' quads, stores it into the disk
+  // cache, then loads it back from there. The grid is slightly different on each run, so that the build is never skipped.
+  // Grids with less than MESH_CALC_STRUCTURE_CACHE_MIN_TRIANGLES triangles (i.e. 'iterations'<50) are not cached.
+  // The entry is erased from the cache afterwards.
+  // results: [triangles, build in ms, store in ms, cached load in ms, hits, misses, stores, evictions]
+    if (iterations<1)
+        iterations=1;
+    std::vector<float> vertices;
+    std::vector<int> indices;
+    float salt=float(VDateTime::getTimeInMs()%1000)*0.000001f;
+    for (int i=0;i<=iterations;i++)
+    {
+        for (int j=0;j<=iterations;j++)
+        {
+            vertices.push_back(float(i)*0.01f);
+            vertices.push_back(float(j)*0.01f);
+            vertices.push_back(0.02f*sin(float(i)*0.1f)*cos(float(j)*0.1f)+salt);
+        }
+    }
+    for (int i=0;i<iterations;i++)
+    {
+        for (int j=0;j<iterations;j++)
+        {
+            int v=i*(iterations+1)+j;
+            indices.push_back(v);
+            indices.push_back(v+iterations+1);
+            indices.push_back(v+1);
+            indices.push_back(v+1);
+            indices.push_back(v+iterations+1);
+            indices.push_back(v+iterations+2);
+        }
+    }
+    float maxTriSize=App::currentWorld->environment->getCalculationMaxTriangleSize();
+    int triCountInObb=App::userSettings->triCountInOBB;
+    unsigned long long t=VDateTime::getTimeInUs();
+    void* built=CPluginContainer::geomPlugin_createMesh(&vertices[0],int(vertices.size()),&indices[0],int(indices.size()),nullptr,maxTriSize,triCountInObb);
+    float buildTime=float(VDateTime::getTimeInUs()-t)*0.001f;
+    t=VDateTime::getTimeInUs();
+    CMeshCalcStructureCache::store(built,vertices,indices,maxTriSize,triCountInObb,true);
+    float storeTime=float(VDateTime::getTimeInUs()-t)*0.001f;
+    t=VDateTime::getTimeInUs();
+    void* loaded=CMeshCalcStructureCache::load(vertices,indices,maxTriSize,triCountInObb);
+    float loadTime=float(VDateTime::getTimeInUs()-t)*0.001f;
+    CMeshCalcStructureCache::erase(vertices,indices,maxTriSize,triCountInObb); // don't fill the user's cache with benchmark grids
+    if (built!=nullptr)
+        CPluginContainer::geomPlugin_destroyMesh(built);
+    if (loaded!=nullptr)
+        CPluginContainer::geomPlugin_destroyMesh(loaded);
+    int hits,misses,stores,evictions;
+    CMeshCalcStructureCache::getStatistics(hits,misses,stores,evictions);
+    results.push_back(float(indices.size()/3));
+    results.push_back(buildTime);
+    results.push_back(storeTime);
+    results.push_back(loadTime);
+    results.push_back(float(hits));
+    results.push_back(float(misses));
+    results.push_back(float(stores));
+    results.push_back(float(evictions));
+    report+="    ";
+    report+=boost::lexical_cast<std::string>(indices.size()/3);
+    report+=" triangles: build ";
+    report+=boost::lexical_cast<std::string>(buildTime);
+    report+=" ms, store ";
+    report+=boost::lexical_cast<std::string>(storeTime);
+    report+=" ms, cached load ";
+    report+=boost::lexical_cast<std::string>(loadTime);
+    if (loaded==nullptr)
+        report+=" ms (not cached: cache disabled or not writable)\n";
+    else
+        report+=" ms\n";
+    report+="    cache: ";
+    report+=boost::lexical_cast<std::string>(hits);
+    report+=" hits, ";
+    report+=boost::lexical_cast<std::string>(misses);
+    report+=" misses, ";
+    report+=boost::lexical_cast<std::string>(stores);
+    report+=" stores, ";
+    report+=boost::lexical_cast<std::string>(evictions);
+    report+=" evictions\n";
+}
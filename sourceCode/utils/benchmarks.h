@@ -0,0 +1,23 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// FULLY STATIC CLASS
+// Micro-benchmarks for internal use. Reachable via sim.test(benchmarkName,iterations)
+class CBenchmarks
+{
+public:
+    static bool run(const char* benchmarkName,int iterations,std::string& report,std::vector<float>& results);
+
+protected:
+    static void _interfaceStack(int iterations,std::string& report,std::vector<float>& results);
+    static void _pointCloudInsert(int iterations,std::string& report,std::vector<float>& results);
+    static void _visionSensorDepth(int iterations,std::string& report,std::vector<float>& results);
+    static void _imageKernels(int iterations,std::string& report,std::vector<float>& results);
+    static void _rrtNearestNode(int iterations,std::string& report,std::vector<float>& results);
+    static void _millOctree(int iterations,std::string& report,std::vector<float>& results);
+    static void _copyPasteObjects(int iterations,std::string& report,std::vector<float>& results);
+    static void _sharedGeometry(int iterations,std::string& report,std::vector<float>& results);
+    static void _calcStructureCache(int iterations,std::string& report,std::vector<float>& results);
+};
@@ -0,0 +1,167 @@
+#include "workerPool.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+struct SParallelForTask
+{
+    const std::function<void(int)>* job;
+    int itemCount;
+    int nextItem;
+    int doneItems;
+    int maxThreads;
+    int activeThreads;
+};
+
+static std::mutex _mutex;
+static std::condition_variable _workAvailable;
+static std::condition_variable _taskDone;
+static std::vector<std::thread> _workers;
+static std::vector<SParallelForTask*> _tasks;
+static bool _stopWorkers=false;
+static int _maxThreadCount=0;
+static thread_local bool _isWorkerThread=false;
+
+struct SWorkerPoolGuard
+{ // in case shutdown was not called, e.g. when the library is unloaded without clean-up
+    ~SWorkerPoolGuard()
+    {
+        for (size_t i=0;i<_workers.size();i++)
+            _workers[i].detach();
+    }
+};
+static SWorkerPoolGuard _guard;
+
+void CWorkerPool::parallelFor(int itemCount,const std::function<void(int)>& job,int maxThreads)
+{
+    if (itemCount<=0)
+        return;
+    int cores=int(std::thread::hardware_concurrency());
+    if (cores<1)
+        cores=1;
+    if ( (_maxThreadCount>0)&&(_maxThreadCount<cores) )
+        cores=_maxThreadCount;
+    if ( (maxThreads<=0)||(maxThreads>cores) )
+        maxThreads=cores;
+    if ( (itemCount==1)||(maxThreads==1)||_isWorkerThread )
+    { // nested calls run inline, to avoid waiting on our own workers
+        for (int i=0;i<itemCount;i++)
+            job(i);
+        return;
+    }
+
+    SParallelForTask task;
+    task.job=&job;
+    task.itemCount=itemCount;
+    task.nextItem=0;
+    task.doneItems=0;
+    task.maxThreads=maxThreads;
+    task.activeThreads=1; // the calling thread participates
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stopWorkers=false;
+        while (int(_workers.size())<cores-1)
+            _workers.push_back(std::thread(_workerLoop));
+        _tasks.push_back(&task);
+    }
+    _workAvailable.notify_all();
+
+    while (true)
+    {
+        int item;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (task.nextItem>=task.itemCount)
+                break;
+            item=task.nextItem++;
+        }
+        job(item);
+        std::unique_lock<std::mutex> lock(_mutex);
+        task.doneItems++;
+    }
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    for (size_t i=0;i<_tasks.size();i++)
+    {
+        if (_tasks[i]==&task)
+        {
+            _tasks.erase(_tasks.begin()+i);
+            break;
+        }
+    }
+    while (task.doneItems<task.itemCount)
+        _taskDone.wait(lock);
+}
+
+int CWorkerPool::getWorkerCount()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    return(int(_workers.size()));
+}
+
+void CWorkerPool::setMaxThreadCount(int cnt)
+{
+    _maxThreadCount=cnt;
+    if (_maxThreadCount<0)
+        _maxThreadCount=0;
+}
+
+int CWorkerPool::getMaxThreadCount()
+{
+    return(_maxThreadCount);
+}
+
+bool CWorkerPool::isWorkerThread()
+{
+    return(_isWorkerThread);
+}
+
+void CWorkerPool::shutdown()
+{
+    std::vector<std::thread> workers;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _stopWorkers=true;
+        workers.swap(_workers);
+    }
+    _workAvailable.notify_all();
+    for (size_t i=0;i<workers.size();i++)
+        workers[i].join();
+}
+
+bool CWorkerPool::_runOneItem()
+{ // _mutex is locked when entering and leaving
+    for (size_t i=0;i<_tasks.size();i++)
+    {
+        SParallelForTask* task=_tasks[i];
+        if ( (task->nextItem<task->itemCount)&&(task->activeThreads<task->maxThreads) )
+        {
+            task->activeThreads++;
+            while (task->nextItem<task->itemCount)
+            {
+                int item=task->nextItem++;
+                _mutex.unlock();
+                (*task->job)(item);
+                _mutex.lock();
+                task->doneItems++;
+            }
+            task->activeThreads--;
+            if (task->doneItems==task->itemCount)
+                _taskDone.notify_all();
+            return(true);
+        }
+    }
+    return(false);
+}
+
+void CWorkerPool::_workerLoop()
+{
+    _isWorkerThread=true;
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (!_stopWorkers)
+    {
+        if (!_runOneItem())
+            _workAvailable.wait(lock);
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <functional>
+
+// FULLY STATIC CLASS
+// Pool of worker threads for data-parallel loops. Jobs run outside of the simulation thread:
+// they must not touch the UI, and must only read shared scene data
+class CWorkerPool
+{
+public:
+    static void parallelFor(int itemCount,const std::function<void(int)>& job,int maxThreads=0); // blocks until all items are done. maxThreads=0: one per core
+    static int getWorkerCount();
+    static void setMaxThreadCount(int cnt); // 0: one per core, 1: everything runs in the calling thread
+    static int getMaxThreadCount();
+    static bool isWorkerThread();
+    static void shutdown();
+
+private:
+    static void _workerLoop();
+    static bool _runOneItem();
+};
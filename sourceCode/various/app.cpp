@@ -14,6 +14,8 @@
 #include "rendering.h"
 #include "simFlavor.h"
 #include "threadPool.h"
+#include "workerPool.h"
+#include "sceneFileWriter.h"
 #include <sstream>
 #include <iomanip>
 #include <boost/algorithm/string/replace.hpp>
@@ -39,7 +41,8 @@ CFolderSystem* App::folders=nullptr;
 int App::operationalUIParts=0; // sim_gui_menubar,sim_gui_popupmenus,sim_gui_toolbar1,sim_gui_toolbar2, etc.
 std::string App::_applicationName="CoppeliaSim (Customized)";
 CWorldContainer* App::worldContainer=nullptr;
-CWorld* App::currentWorld=nullptr;
+CCurrentWorld App::currentWorld;
+thread_local CWorld* CCurrentWorld::_threadWorld=nullptr;
 bool App::_exitRequest=false;
 bool App::_browserEnabled=true;
 bool App::_canInitSimThread=false;
@@ -283,6 +286,16 @@ bool App::getBrowserEnabled()
     return(_browserEnabled);
 }
 
+void CCurrentWorld::setThreadWorld(CWorld* w)
+{
+    _threadWorld=w;
+}
+
+CWorld* CCurrentWorld::getThreadWorld()
+{
+    return(_threadWorld);
+}
+
 App::App(bool headless)
 {
     TRACE_INTERNAL;
@@ -389,6 +402,8 @@ App::App(bool headless)
 App::~App()
 {
     TRACE_INTERNAL;
+    CSceneFileWriter::waitUntilDone();
+    CWorkerPool::shutdown();
     VThread::unsetUiThreadId();
     delete uiThread;
     uiThread=nullptr;
@@ -754,6 +769,14 @@ void App::setRebuildHierarchyFlag()
 #endif
 }
 
+void App::setHierarchyObjectChangedFlag(int objectHandle)
+{ // helper
+#ifdef SIM_WITH_GUI
+    if (mainWindow!=nullptr)
+        mainWindow->oglSurface->hierarchy->setObjectChangedFlag(objectHandle);
+#endif
+}
+
 void App::setResetHierarchyViewFlag()
 { // helper
 #ifdef SIM_WITH_GUI
@@ -14,6 +14,22 @@
     #include "mainWindow.h"
 #endif
 
+class CCurrentWorld
+{ // behaves like a CWorld*. Threads of a simulation batch see their own world instead of the global one
+public:
+    CCurrentWorld() {_world=nullptr;}
+    inline CWorld* operator->() const {return((_threadWorld!=nullptr)?_threadWorld:_world);}
+    inline operator CWorld*() const {return((_threadWorld!=nullptr)?_threadWorld:_world);}
+    inline CCurrentWorld& operator=(CWorld* w) {_world=w;return(*this);}
+
+    static void setThreadWorld(CWorld* w); // nullptr: the thread uses the global world again
+    static CWorld* getThreadWorld();
+
+private:
+    CWorld* _world;
+    static thread_local CWorld* _threadWorld;
+};
+
 class App
 {
 public:
@@ -58,6 +74,7 @@ public:
 
     static int getEditModeType(); // helper
     static void setRebuildHierarchyFlag(); // helper
+    static void setHierarchyObjectChangedFlag(int objectHandle); // helper
     static void setResetHierarchyViewFlag(); // helper
     static void setRefreshHierarchyViewFlag(); // helper
     static void setLightDialogRefreshFlag(); // helper
@@ -100,7 +117,7 @@ public:
     static CFolderSystem* folders;
     static CUserSettings* userSettings;
     static CWorldContainer* worldContainer;
-    static CWorld* currentWorld; // actually worldContainer->currentWorld
+    static CCurrentWorld currentWorld; // actually worldContainer->currentWorld, or the calling thread's batch world
     static CUiThread* uiThread;
     static CSimThread* simThread;
 
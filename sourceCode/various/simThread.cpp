@@ -19,6 +19,7 @@
 #include "graphingRoutines_old.h"
 #include "simStringTable_openGl.h"
 #include "simFlavor.h"
+#include "sceneFileWriter.h"
 #ifdef SIM_WITH_GUI
     #include "toolBarCommand.h"
     #include "vMessageBox.h"
@@ -27,6 +28,9 @@
 CSimThread::CSimThread()
 {
     _renderingAllowed=true;
+#ifdef SIM_WITH_GUI
+    _autoSaveWorldHandle=-1;
+#endif
 }
 
 CSimThread::~CSimThread()
@@ -5024,19 +5028,45 @@ void CSimThread::_handleAutoSaveSceneCommand(SSimulationThreadCommand cmd)
         {
             // First repost a same command:
             App::appendSimulationThreadCommand(cmd,1000);
+            std::string writtenFile;
+            bool writeSuccess;
+            int compressionTime,writeTime;
+            if (CSceneFileWriter::getFinishedWrite(writtenFile,writeSuccess,compressionTime,writeTime))
+            {
+                if (writeSuccess)
+                {
+                    std::string msg("auto-saved scene written to "+writtenFile+" (compression: "+tt::FNb(compressionTime)+" ms, write: "+tt::FNb(writeTime)+" ms).");
+                    App::logMsg(sim_verbosity_infos,msg.c_str());
+                }
+                else
+                {
+                    App::logMsg(sim_verbosity_warnings,"failed writing auto-saved scene to %s.",writtenFile.c_str());
+                    CWorld* savedWorld=App::worldContainer->getWorldFromHandle(_autoSaveWorldHandle);
+                    if (savedWorld!=nullptr)
+                        savedWorld->environment->autoSaveLastSceneDataHash=0; // write again next time, even if nothing changed
+                }
+            }
             if ( CSimFlavor::getBoolVal(14)&&(App::userSettings->autoSaveDelay>0)&&(!App::currentWorld->environment->getSceneLocked()) )
             {
                 if (VDateTime::getSecondsSince1970()>(App::currentWorld->environment->autoSaveLastSaveTimeInSecondsSince1970+App::userSettings->autoSaveDelay*60))
                 {
-                    std::string savedLoc=App::currentWorld->mainSettings->getScenePathAndName();
+                    // the scene is serialized here, but compressed and written in the background (and not written
+                    // at all if the serialized scene didn't change since the last auto-save):
                     std::string testScene=App::folders->getExecutablePath()+"/";
                     testScene+="AUTO_SAVED_INSTANCE_";
                     testScene+=tt::FNb(App::worldContainer->getCurrentWorldIndex()+1);
                     testScene+=".";
                     testScene+=SIM_SCENE_EXTENSION;
-                    CFileOperations::saveScene(testScene.c_str(),false,false,false,false);
-                    App::currentWorld->mainSettings->setScenePathAndName(savedLoc.c_str());
-                    App::currentWorld->environment->autoSaveLastSaveTimeInSecondsSince1970=VDateTime::getSecondsSince1970();
+                    int snapshotTime;
+                    unsigned long long previousHash=App::currentWorld->environment->autoSaveLastSceneDataHash;
+                    if (CFileOperations::saveSceneInBackground(testScene.c_str(),snapshotTime,&App::currentWorld->environment->autoSaveLastSceneDataHash))
+                    {
+                        App::logMsg(sim_verbosity_infos,"auto-save: scene serialized in %i ms.",snapshotTime);
+                        if (App::currentWorld->environment->autoSaveLastSceneDataHash!=previousHash)
+                            _autoSaveWorldHandle=App::currentWorld->getWorldHandle(); // a write was started
+                        App::currentWorld->environment->autoSaveLastSaveTimeInSecondsSince1970=VDateTime::getSecondsSince1970();
+                    }
+                    // otherwise the previous write is still in progress: we retry with next command
                 }
             }
         }
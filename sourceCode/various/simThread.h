@@ -55,6 +55,7 @@ private:
 private:
     void _handleClickRayIntersection(SSimulationThreadCommand cmd);
     void _handleAutoSaveSceneCommand(SSimulationThreadCommand cmd);
+    int _autoSaveWorldHandle; // the world whose auto-save is being written
     void _displayVariousWaningMessagesDuringSimulation();
     int _prepareSceneForRenderIfNeeded();
 #endif
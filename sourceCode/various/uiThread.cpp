@@ -152,7 +152,19 @@ void CUiThread::__executeCommandViaUiThread(SUIThreadCommand* cmdIn,SUIThreadCom
 #endif
 
     if (cmdIn->cmdId==DETECT_VISION_SENSOR_ENTITY_UITHREADCMD)
+    {
+        unsigned long long int stTime=VDateTime::getTimeInUs();
         ((CVisionSensor*)cmdIn->objectParams[0])->detectVisionSensorEntity_executedViaUiThread(cmdIn->intParams[0],cmdIn->boolParams[0],cmdIn->boolParams[1],cmdIn->boolParams[2],cmdIn->boolParams[3]);
+        cmdOut->uintParams.push_back((unsigned int)(VDateTime::getTimeInUs()-stTime));
+    }
+
+    if (cmdIn->cmdId==RENDER_VISION_SENSORS_UITHREADCMD)
+    {
+        std::vector<CVisionSensor*> sensors;
+        for (size_t i=0;i<cmdIn->objectParams.size();i++)
+            sensors.push_back((CVisionSensor*)cmdIn->objectParams[i]);
+        cmdOut->uintParams.push_back((unsigned int)CVisionSensor::renderSensors_executedViaUiThread(sensors));
+    }
 
 
 #ifdef SIM_WITH_GUI
@@ -119,6 +119,7 @@ enum {  OPEN_OR_CLOSE_UITHREADCMD=0,
 
         JOB_NAME_UITHREADCMD,
         MENUBAR_COLOR_UITHREADCMD,
+        RENDER_VISION_SENSORS_UITHREADCMD,
      };
 
 #ifndef SIM_WITH_QT
@@ -3,6 +3,7 @@
 #include "userSettings.h"
 #include "global.h"
 #include "threadPool.h"
+#include "workerPool.h"
 #include "tt.h"
 #include "easyLock.h"
 #include "vVarious.h"
@@ -29,6 +30,9 @@
 #define _USR_REMOVE_IDENTICAL_TRIANGLES "removeIdenticalTriangles"
 #define _USR_TRIANGLE_WINDING_CHECK "triangleWindingCheck"
 #define _USR_PROCESSOR_CORE_AFFINITY "processorCoreAffinity"
+#define _USR_WORKER_THREAD_COUNT "workerThreadCount"
+#define _USR_DETERMINISTIC_REAL_TIME "deterministicRealTime"
+#define _USR_REAL_TIME_SPIN_TIME "realTimeSpinTime"
 #define _USR_DYNAMIC_ACTIVITY_RANGE "dynamicActivityRange"
 #define _USR_FREE_SERVER_PORT_START "freeServerPortStart"
 #define _USR_FREE_SERVER_PORT_RANGE "freeServerPortRange"
@@ -39,6 +43,7 @@
 #define _USR_ROTATION_STEP_SIZE "objectRotationStepSize"
 #define _USR_COMPRESS_FILES "compressFiles"
 #define _USR_TRIANGLE_COUNT_IN_OBB "triCountInOBB"
+#define _USR_CALC_STRUCTURE_CACHE_SIZE "calcStructureCacheSize"
 #define _USR_APPROXIMATED_NORMALS "saveApproxNormals"
 #define _USR_PACK_INDICES "packIndices"
 #define _USR_UNDO_REDO_ENABLED "undoRedoEnabled"
@@ -171,6 +176,8 @@
 
 #define _USR_VISION_SENSORS_USE_GUI_WINDOWED "visionSensorsUseGuiThread_windowed"
 #define _USR_VISION_SENSORS_USE_GUI_HEADLESS "visionSensorsUseGuiThread_headless"
+#define _USR_VISION_SENSORS_DEPTH_RAY_CASTING "visionSensorsDepthRayCasting"
+#define _USR_VISION_SENSORS_ASYNC_READBACK "visionSensorsAsyncReadback"
 #define _USR_FILE_DIALOGS_NATIVE "fileDialogs"
 #define _USR_MOUSE_WHEEL_ZOOM_FACTOR "mouseWheelZoomFactor"
 
@@ -219,6 +226,8 @@ CUserSettings::CUserSettings()
     oglCompatibilityTweak1=false;
     visionSensorsUseGuiThread_windowed=-1; // default
     visionSensorsUseGuiThread_headless=-1; // default
+    visionSensorsDepthRayCasting=false;
+    visionSensorsAsyncReadback=0;
     useGlFinish=false;
     useGlFinish_visionSensors=false;
     vsync=0;
@@ -371,11 +380,14 @@ CUserSettings::CUserSettings()
     dynamicActivityRange=1000.0f;
     _translationStepSize=0.025f;
     _rotationStepSize=5.0f*degToRad_f;
+    deterministicRealTime=false;
+    realTimeSpinTime=2000;
     freeServerPortStart=20000;
     _nextfreeServerPortToUse=freeServerPortStart;
     freeServerPortRange=2000;
     _abortScriptExecutionButton=3;
     triCountInOBB=8; // gave best results in 2009/07/21
+    calcStructureCacheSize=256;
     identicalVerticesCheck=true;
     identicalVerticesTolerance=0.0001f;
     identicalTrianglesCheck=true;
@@ -575,6 +587,8 @@ void CUserSettings::saveUserSettings()
     c.addBoolean(_USR_OGL_COMPATIBILITY_TWEAK_1,oglCompatibilityTweak1,"recommended to keep false since it causes small memory leaks.");
     c.addInteger(_USR_VISION_SENSORS_USE_GUI_WINDOWED,visionSensorsUseGuiThread_windowed,"recommended to keep -1 (-1=default, 0=GUI when not otherwise possible, 1=always GUI).");
     c.addInteger(_USR_VISION_SENSORS_USE_GUI_HEADLESS,visionSensorsUseGuiThread_headless,"recommended to keep -1 (-1=default, 0=GUI when not otherwise possible, 1=always GUI).");
+    c.addBoolean(_USR_VISION_SENSORS_DEPTH_RAY_CASTING,visionSensorsDepthRayCasting,"if true, vision sensors that ignore RGB info compute depth by ray casting on the CPU, without OpenGL.");
+    c.addInteger(_USR_VISION_SENSORS_ASYNC_READBACK,visionSensorsAsyncReadback,"0=read images directly, 1=read via pixel buffer objects, 2=same as 1, but images are one frame late (no waiting for the GPU).");
     c.addBoolean(_USR_USE_GLFINISH,useGlFinish,"recommended to keep false. Graphic card dependent.");
     c.addBoolean(_USR_USE_GLFINISH_VISION_SENSORS,useGlFinish_visionSensors,"recommended to keep false. Graphic card dependent.");
     c.addInteger(_USR_VSYNC,vsync,"recommended to keep at 0. Graphic card dependent.");
@@ -752,10 +766,14 @@ void CUserSettings::saveUserSettings()
     c.addFloat(_USR_TRANSLATION_STEP_SIZE,_translationStepSize,"");
     c.addFloat(_USR_ROTATION_STEP_SIZE,_rotationStepSize*radToDeg_f,"");
     c.addInteger(_USR_PROCESSOR_CORE_AFFINITY,CThreadPool::getProcessorCoreAffinity(),"recommended to keep 0 (-1:os default, 0:all threads on same core, m: affinity mask (bit1=core1, bit2=core2, etc.))");
+    c.addInteger(_USR_WORKER_THREAD_COUNT,CWorkerPool::getMaxThreadCount(),"threads used for parallel calculations, e.g. proximity sensors (0: one per core, 1: no parallel calculations)");
+    c.addBoolean(_USR_DETERMINISTIC_REAL_TIME,deterministicRealTime,"if true, real-time simulation steps are released on a microsecond schedule instead of being polled for.");
+    c.addInteger(_USR_REAL_TIME_SPIN_TIME,realTimeSpinTime,"in microseconds. With deterministicRealTime, the simulation thread sleeps until that time before a step's release, then spins.");
     c.addInteger(_USR_FREE_SERVER_PORT_START,freeServerPortStart,"");
     c.addInteger(_USR_FREE_SERVER_PORT_RANGE,freeServerPortRange,"");
     c.addInteger(_USR_ABORT_SCRIPT_EXECUTION_BUTTON,_abortScriptExecutionButton,"in seconds. Zero to disable.");
     c.addInteger(_USR_TRIANGLE_COUNT_IN_OBB,triCountInOBB,"");
+    c.addInteger(_USR_CALC_STRUCTURE_CACHE_SIZE,calcStructureCacheSize,"in MB. Disk cache for mesh calculation structures (OBB trees), in the system folder. 0 to disable.");
     c.addBoolean(_USR_REMOVE_IDENTICAL_VERTICES,identicalVerticesCheck,"");
     c.addFloat(_USR_IDENTICAL_VERTICES_TOLERANCE,identicalVerticesTolerance,"");
     c.addBoolean(_USR_REMOVE_IDENTICAL_TRIANGLES,identicalTrianglesCheck,"");
@@ -901,6 +919,8 @@ void CUserSettings::loadUserSettings()
     c.getBoolean(_USR_OGL_COMPATIBILITY_TWEAK_1,oglCompatibilityTweak1);
     c.getInteger(_USR_VISION_SENSORS_USE_GUI_WINDOWED,visionSensorsUseGuiThread_windowed);
     c.getInteger(_USR_VISION_SENSORS_USE_GUI_HEADLESS,visionSensorsUseGuiThread_headless);
+    c.getBoolean(_USR_VISION_SENSORS_DEPTH_RAY_CASTING,visionSensorsDepthRayCasting);
+    c.getInteger(_USR_VISION_SENSORS_ASYNC_READBACK,visionSensorsAsyncReadback);
     c.getBoolean(_USR_USE_GLFINISH,useGlFinish);
     c.getBoolean(_USR_USE_GLFINISH_VISION_SENSORS,useGlFinish_visionSensors);
     c.getInteger(_USR_VSYNC,vsync);
@@ -1063,11 +1083,17 @@ void CUserSettings::loadUserSettings()
     int processorCoreAffinity=0;
     if (c.getInteger(_USR_PROCESSOR_CORE_AFFINITY,processorCoreAffinity))
         CThreadPool::setProcessorCoreAffinity(processorCoreAffinity);
+    int workerThreadCount=0;
+    if (c.getInteger(_USR_WORKER_THREAD_COUNT,workerThreadCount))
+        CWorkerPool::setMaxThreadCount(workerThreadCount);
+    c.getBoolean(_USR_DETERMINISTIC_REAL_TIME,deterministicRealTime);
+    c.getInteger(_USR_REAL_TIME_SPIN_TIME,realTimeSpinTime);
     c.getInteger(_USR_FREE_SERVER_PORT_START,freeServerPortStart);
     _nextfreeServerPortToUse=freeServerPortStart;
     c.getInteger(_USR_FREE_SERVER_PORT_RANGE,freeServerPortRange);
     c.getInteger(_USR_ABORT_SCRIPT_EXECUTION_BUTTON,_abortScriptExecutionButton);
     c.getInteger(_USR_TRIANGLE_COUNT_IN_OBB,triCountInOBB);
+    c.getInteger(_USR_CALC_STRUCTURE_CACHE_SIZE,calcStructureCacheSize);
     c.getBoolean(_USR_REMOVE_IDENTICAL_VERTICES,identicalVerticesCheck);
     c.getFloat(_USR_IDENTICAL_VERTICES_TOLERANCE,identicalVerticesTolerance);
     c.getBoolean(_USR_REMOVE_IDENTICAL_TRIANGLES,identicalTrianglesCheck);
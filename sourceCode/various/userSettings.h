@@ -52,6 +52,7 @@ public:
     bool identicalTrianglesWindingCheck;
     bool compressFiles;
     int triCountInOBB;
+    int calcStructureCacheSize;
     bool saveApproxNormals;
     bool packIndices;
     bool runCustomizationScripts;
@@ -86,6 +87,8 @@ public:
     bool displayBoundingBoxeWhenObjectSelected;
     bool antiAliasing;
     float dynamicActivityRange;
+    bool deterministicRealTime;
+    int realTimeSpinTime;
     int freeServerPortStart;
     int freeServerPortRange;
     bool darkMode;
@@ -100,6 +103,8 @@ public:
     int desiredOpenGlMinor;
     int visionSensorsUseGuiThread_windowed;
     int visionSensorsUseGuiThread_headless;
+    bool visionSensorsDepthRayCasting;
+    int visionSensorsAsyncReadback;
     int fileDialogs;
     float mouseWheelZoomFactor;
 
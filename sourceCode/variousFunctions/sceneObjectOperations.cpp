@@ -212,7 +212,7 @@ bool CSceneObjectOperations::processCommand(int commandID)
                                     childrenTr.push_back(child->getLocalTransformation());
                                 }
                                 App::currentWorld->sceneObjects->eraseObject(siblings[i],true);
-                                App::worldContainer->copyBuffer->pasteBuffer(App::currentWorld->environment->getSceneLocked(),1);
+                                App::worldContainer->copyBuffer->pasteBuffer(App::currentWorld->environment->getSceneLocked(),1,i==int(siblings.size())-1); // the last paste can take the buffer over
                                 CSceneObject* newObj=App::currentWorld->sceneObjects->getLastSelectionObject();
                                 App::currentWorld->sceneObjects->deselectObjects();
                                 if (newObj!=nullptr)
@@ -256,7 +256,7 @@ bool CSceneObjectOperations::processCommand(int commandID)
                                 C7Vector tr(siblings[i]->getFullLocalTransformation());
                                 CSceneObject* parent(siblings[i]->getParent());
                                 App::currentWorld->sceneObjects->eraseSeveralObjects(objs,true);
-                                App::worldContainer->copyBuffer->pasteBuffer(App::currentWorld->environment->getSceneLocked(),2);
+                                App::worldContainer->copyBuffer->pasteBuffer(App::currentWorld->environment->getSceneLocked(),2,i==int(siblings.size())-1); // the last paste can take the buffer over
                                 CSceneObject* newObj=App::currentWorld->sceneObjects->getLastSelectionObject();
                                 App::currentWorld->sceneObjects->deselectObjects();
                                 if (newObj!=nullptr)